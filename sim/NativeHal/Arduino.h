@@ -0,0 +1,272 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+//================================================================================
+// Arduino-Ersatz für die native Umgebung
+//================================================================================
+// Bildet nur den Teil der Arduino-API nach, den die Firmware verwendet. Zeit, UART und
+// Interrupts laufen über den Simulationskern (SimCore.h).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+
+#define CHANGE  2
+#define FALLING 3
+#define RISING  4
+
+// Pin-Namen des STM32F103 (nur als Kennungen)
+enum {
+  PA0, PA1, PA2, PA3, PA4, PA5, PA6, PA7, PA8, PA9, PA10, PA11, PA12, PA13, PA14, PA15,
+  PB0, PB1, PB2, PB3, PB4, PB5, PB6, PB7, PB8, PB9, PB10, PB11, PB12, PB13, PB14, PB15,
+  PC13, PC14, PC15
+};
+
+//--------------------------------------------------------------------------------
+// String
+//--------------------------------------------------------------------------------
+
+class String {
+public:
+  String() {}
+  String(const char* cstr) : buffer(cstr ? cstr : "") {}
+  String(const String& other) = default;
+  String(String&& other) = default;
+  explicit String(char c) : buffer(1, c) {}
+  explicit String(unsigned char value, unsigned char base = DEC) { fromUnsigned(value, base); }
+  explicit String(int value, unsigned char base = DEC) { fromSigned(value, base); }
+  explicit String(unsigned int value, unsigned char base = DEC) { fromUnsigned(value, base); }
+  explicit String(long value, unsigned char base = DEC) { fromSigned(value, base); }
+  explicit String(unsigned long value, unsigned char base = DEC) { fromUnsigned(value, base); }
+  explicit String(float value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+  explicit String(double value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+
+  String& operator=(const String& rhs) = default;
+  String& operator=(String&& rhs) = default;
+  String& operator=(const char* cstr) { buffer = cstr ? cstr : ""; return *this; }
+
+  bool reserve(unsigned int size) { buffer.reserve(size); return true; }
+  unsigned int length() const { return buffer.size(); }
+  const char* c_str() const { return buffer.c_str(); }
+
+  bool concat(const String& s) { buffer += s.buffer; return true; }
+  bool concat(const char* cstr) { if (cstr) buffer += cstr; return true; }
+  bool concat(const char* cstr, unsigned int len) { buffer.append(cstr, len); return true; }
+  bool concat(char c) { buffer += c; return true; }
+
+  String& operator+=(const String& rhs) { concat(rhs); return *this; }
+  String& operator+=(const char* cstr) { concat(cstr); return *this; }
+  String& operator+=(char c) { concat(c); return *this; }
+
+  bool equals(const String& s) const { return buffer == s.buffer; }
+  bool equals(const char* cstr) const { return buffer == (cstr ? cstr : ""); }
+  bool operator==(const String& rhs) const { return equals(rhs); }
+  bool operator==(const char* cstr) const { return equals(cstr); }
+  bool operator!=(const String& rhs) const { return !equals(rhs); }
+  bool operator!=(const char* cstr) const { return !equals(cstr); }
+  bool equalsIgnoreCase(const String& s) const { return strcasecmp(c_str(), s.c_str()) == 0; }
+
+  bool startsWith(const String& prefix) const { return buffer.compare(0, prefix.buffer.size(), prefix.buffer) == 0; }
+  bool endsWith(const String& suffix) const {
+    return buffer.size() >= suffix.buffer.size() &&
+           buffer.compare(buffer.size() - suffix.buffer.size(), suffix.buffer.size(), suffix.buffer) == 0;
+  }
+
+  char charAt(unsigned int index) const { return index < buffer.size() ? buffer[index] : 0; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  int indexOf(char c, unsigned int from = 0) const { size_t i = buffer.find(c, from); return i == std::string::npos ? -1 : (int)i; }
+  String substring(unsigned int from) const { return from < buffer.size() ? String(buffer.substr(from).c_str()) : String(); }
+  String substring(unsigned int from, unsigned int to) const {
+    return from < buffer.size() && to > from ? String(buffer.substr(from, to - from).c_str()) : String();
+  }
+
+  void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+    if (bufsize == 0) return;
+    size_t n = buffer.size() > index ? buffer.size() - index : 0;
+    if (n > bufsize - 1) n = bufsize - 1;
+    memcpy(buf, buffer.c_str() + index, n);
+    buf[n] = 0;
+  }
+  void toLowerCase() { for (char& c : buffer) c = tolower((unsigned char)c); }
+  void toUpperCase() { for (char& c : buffer) c = toupper((unsigned char)c); }
+  void trim() {
+    size_t b = buffer.find_first_not_of(" \t\r\n");
+    size_t e = buffer.find_last_not_of(" \t\r\n");
+    buffer = (b == std::string::npos) ? "" : buffer.substr(b, e - b + 1);
+  }
+  long toInt() const { return atol(c_str()); }
+  float toFloat() const { return atof(c_str()); }
+
+private:
+  void fromSigned(long value, unsigned char base) {
+    if (base == DEC) { buffer = std::to_string(value); } else { fromUnsigned((unsigned long)value, base); }
+  }
+  void fromUnsigned(unsigned long value, unsigned char base) {
+    char tmp[33];
+    char* p = &tmp[32];
+    *p = 0;
+    do { unsigned long d = value % base; *--p = d < 10 ? '0' + d : 'a' + d - 10; value /= base; } while (value);
+    buffer = p;
+  }
+  void fromDouble(double value, unsigned char decimals) {
+    char tmp[48];
+    snprintf(tmp, sizeof(tmp), "%.*f", decimals, value);
+    buffer = tmp;
+  }
+
+  std::string buffer;
+};
+
+inline String operator+(const String& lhs, const String& rhs) { String r(lhs); r += rhs; return r; }
+inline String operator+(const String& lhs, const char* rhs) { String r(lhs); r += rhs; return r; }
+inline String operator+(const char* lhs, const String& rhs) { String r(lhs); r += rhs; return r; }
+inline String operator+(const String& lhs, char rhs) { String r(lhs); r += rhs; return r; }
+
+//--------------------------------------------------------------------------------
+// Print / Stream
+//--------------------------------------------------------------------------------
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+  }
+  size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+  size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+
+  size_t print(const char* s) { return write(s); }
+  size_t print(const String& s) { return write(s.c_str(), s.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(int n, int base = DEC) { return print((long)n, base); }
+  size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+  size_t print(long n, int base = DEC) { return print(String(n, (unsigned char)base)); }
+  size_t print(unsigned long n, int base = DEC) { return print(String(n, (unsigned char)base)); }
+  size_t print(double n, int digits = 2) { return print(String(n, (unsigned char)digits)); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+  template <typename T> size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(char* buffer, size_t length) {
+    size_t n = 0;
+    while (n < length && available() > 0) buffer[n++] = (char)read();
+    return n;
+  }
+};
+
+/**
+ * @brief Simulierter UART. Ausgabe landet auf stdout und wird mit der eingestellten
+ *        Baudrate "gesendet"; Eingaben werden vom Szenario zeitgesteuert eingespielt.
+ */
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud);
+  void end();
+
+  int available() override;
+  int read() override;
+  int peek() override;
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int availableForWrite() override;
+  void flush() override;
+};
+
+extern HardwareSerial Serial;
+
+//--------------------------------------------------------------------------------
+// Zeit, GPIO, Interrupts, System
+//--------------------------------------------------------------------------------
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint32_t pin, uint32_t mode);
+void digitalWrite(uint32_t pin, uint32_t value);
+int digitalRead(uint32_t pin);
+
+void noInterrupts();
+void interrupts();
+
+// Schläft bis zum nächsten Ereignis oder SysTick (1 ms); siehe simGetSleepStats()
+void __WFI();
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+void NVIC_SystemReset();
+
+// Kerntakt des STM32F103 (für die Umrechnung von Zyklen, siehe latency.h)
+extern uint32_t SystemCoreClock;
+
+// 96-Bit-Seriennummer des Chips (feste Werte in der Simulation)
+uint32_t HAL_GetUIDw0(void);
+uint32_t HAL_GetUIDw1(void);
+uint32_t HAL_GetUIDw2(void);
+
+//--------------------------------------------------------------------------------
+// Flash (Teilmenge der STM32F1-HAL, nur die letzten Seiten werden nachgebildet)
+//--------------------------------------------------------------------------------
+
+#define FLASH_BASE       0x08000000UL
+#define FLASH_BANK1_END  0x0801FFFFUL // STM32F103CB, 128 KB
+#define FLASH_PAGE_SIZE  0x400U
+
+#define FLASH_TYPEERASE_PAGES      0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+
+typedef enum { HAL_OK = 0x00U, HAL_ERROR = 0x01U, HAL_BUSY = 0x02U, HAL_TIMEOUT = 0x03U } HAL_StatusTypeDef;
+
+typedef struct {
+  uint32_t TypeErase;
+  uint32_t Banks;
+  uint32_t PageAddress;
+  uint32_t NbPages;
+} FLASH_EraseInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* pEraseInit, uint32_t* PageError);
+
+/**
+ * @brief Lesezugriff auf den nachgebildeten Flash (auf dem STM32 direkt per Zeiger).
+ */
+const uint8_t* simFlashPointer(uint32_t address);
+
+#endif // ARDUINO_H
@@ -0,0 +1,186 @@
+#ifndef RADIOLIB_SIM_H
+#define RADIOLIB_SIM_H
+
+//================================================================================
+// RadioLib-Ersatz für die native Umgebung: simuliertes SX1262
+//================================================================================
+// Bildet die von der Firmware genutzten Methoden von SX1262 nach. Jede Methode wird als
+// SPI-Transaktion mit typischer Dauer verbucht und protokolliert. Pakete werden über
+// simRadioInjectPacket() zeitgesteuert "empfangen"; Senden dauert die berechnete Time-on-Air.
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#define RADIOLIB_ERR_NONE                     (0)
+#define RADIOLIB_ERR_UNKNOWN                  (-1)
+#define RADIOLIB_ERR_PACKET_TOO_LONG          (-4)
+#define RADIOLIB_ERR_TX_TIMEOUT               (-5)
+#define RADIOLIB_ERR_RX_TIMEOUT               (-6)
+#define RADIOLIB_ERR_CRC_MISMATCH             (-7)
+#define RADIOLIB_ERR_INVALID_BANDWIDTH        (-8)
+#define RADIOLIB_ERR_INVALID_SPREADING_FACTOR (-9)
+#define RADIOLIB_ERR_INVALID_CODING_RATE      (-10)
+#define RADIOLIB_ERR_INVALID_FREQUENCY        (-12)
+#define RADIOLIB_ERR_INVALID_OUTPUT_POWER     (-13)
+#define RADIOLIB_ERR_INVALID_PREAMBLE_LENGTH  (-18)
+#define RADIOLIB_CHANNEL_FREE                 (-15)
+#define RADIOLIB_LORA_DETECTED                (-702)
+
+#define RADIOLIB_SX126X_CAD_ON_1_SYMB   0x00
+#define RADIOLIB_SX126X_CAD_ON_2_SYMB   0x01
+#define RADIOLIB_SX126X_CAD_ON_4_SYMB   0x02
+#define RADIOLIB_SX126X_CAD_ON_8_SYMB   0x03
+#define RADIOLIB_SX126X_CAD_ON_16_SYMB  0x04
+#define RADIOLIB_SX126X_CAD_GOTO_STDBY  0x00
+#define RADIOLIB_SX126X_CAD_PARAM_DEFAULT 0xFF
+
+// Befehle und IRQ-Bits für den direkten Zugriff über Module (Auslesen nach RxDone)
+#define RADIOLIB_SX126X_CMD_CLEAR_IRQ_STATUS     0x02
+#define RADIOLIB_SX126X_CMD_GET_IRQ_STATUS       0x12
+#define RADIOLIB_SX126X_CMD_GET_RX_BUFFER_STATUS 0x13
+#define RADIOLIB_SX126X_CMD_GET_PACKET_STATUS    0x14
+#define RADIOLIB_SX126X_CMD_READ_BUFFER          0x1E
+#define RADIOLIB_SX126X_CMD_SET_RX_DUTY_CYCLE    0x94
+#define RADIOLIB_SX126X_IRQ_RX_DONE       0x0002
+#define RADIOLIB_SX126X_IRQ_HEADER_VALID  0x0010
+#define RADIOLIB_SX126X_IRQ_HEADER_ERR    0x0020
+#define RADIOLIB_SX126X_IRQ_CRC_ERR       0x0040
+#define RADIOLIB_SX126X_IRQ_ALL           0x43FF
+
+typedef uint32_t RadioLibTime_t;
+typedef uint32_t RadioLibIrqFlags_t;
+
+#define RADIOLIB_IRQ_CAD_DEFAULT_FLAGS 0x0180UL // CadDone | CadDetected
+#define RADIOLIB_IRQ_CAD_DEFAULT_MASK  0x0080UL // DIO1 bei CadDone
+
+struct CADScanConfig_t {
+  uint8_t symNum;
+  uint8_t detPeak;
+  uint8_t detMin;
+  uint8_t exitMode;
+  RadioLibTime_t timeout;
+  RadioLibIrqFlags_t irqFlags;
+  RadioLibIrqFlags_t irqMask;
+};
+
+struct RSSIScanConfig_t {
+  size_t sampleCount;
+  uint8_t paramsFSK;
+};
+
+union ChannelScanConfig_t {
+  CADScanConfig_t cad;
+  RSSIScanConfig_t rssi;
+};
+
+// Ohne SPISettings verwendet RadioLib 2 MHz
+class Module {
+public:
+  Module(uint32_t cs, uint32_t irq, uint32_t rst, uint32_t gpio);
+  Module(uint32_t cs, uint32_t irq, uint32_t rst, uint32_t gpio, SPIClass& spi, SPISettings spiSettings);
+
+  // Rohe SX126x-Befehle; der Statusbyte-Austausch ist wie bei RadioLib bereits abgezogen
+  int16_t SPIreadStream(uint16_t cmd, uint8_t* data, size_t numBytes, bool waitForGpio = true, bool verify = true);
+  int16_t SPIreadStream(const uint8_t* cmd, uint8_t cmdLen, uint8_t* data, size_t numBytes,
+                        bool waitForGpio = true, bool verify = true);
+  int16_t SPIwriteStream(uint16_t cmd, const uint8_t* data, size_t numBytes, bool waitForGpio = true,
+                         bool verify = true);
+  int16_t SPIreadRegisterBurst(uint32_t reg, size_t numBytes, uint8_t* inBytes);
+};
+
+class SX1262 {
+public:
+  SX1262(Module* mod) : mod(mod) {}
+  Module* getMod() { return mod; }
+
+  int16_t begin(float freq, float bw, uint8_t sf, uint8_t cr, uint8_t syncWord, int8_t power,
+                uint16_t preambleLength, float tcxoVoltage, bool useRegulatorLDO);
+
+  void setRfSwitchPins(uint32_t rxEn, uint32_t txEn);
+  void setPacketReceivedAction(void (*func)(void));
+  void setPacketSentAction(void (*func)(void));
+
+  int16_t startReceive();
+  int16_t startReceiveDutyCycle(uint32_t rxPeriod, uint32_t sleepPeriod);
+  int16_t startTransmit(const uint8_t* data, size_t len, uint8_t addr = 0);
+  int16_t finishTransmit();
+  int16_t transmit(const uint8_t* data, size_t len, uint8_t addr = 0);
+  int16_t standby();
+
+  int16_t startChannelScan();
+  int16_t startChannelScan(const ChannelScanConfig_t& config);
+  int16_t getChannelScanResult();
+
+  size_t getPacketLength(bool update = true);
+  int16_t readData(uint8_t* data, size_t len);
+  float getRSSI();
+  float getSNR();
+  float getFrequencyError();
+  uint32_t getTimeOnAir(size_t len);
+
+  int16_t setFrequency(float freq);
+  int16_t setBandwidth(float bw);
+  int16_t setSpreadingFactor(uint8_t sf);
+  int16_t setCodingRate(uint8_t cr);
+  int16_t setSyncWord(uint8_t syncWord);
+  int16_t setOutputPower(int8_t power);
+  int16_t setPreambleLength(uint16_t preambleLength);
+
+private:
+  Module* mod;
+};
+
+//--------------------------------------------------------------------------------
+// Steuerung und Auswertung der Simulation
+//--------------------------------------------------------------------------------
+
+/**
+ * @brief Plant ein Paket, dessen letztes Symbol zum Zeitpunkt 'end_us' empfangen ist.
+ *        Es kommt nur an, wenn das Modul dann empfängt; ein noch nicht ausgelesenes
+ *        Paket wird im kontinuierlichen Empfang überschrieben.
+ *        Mit 'frequency_MHz' (0 = jede Frequenz) kommt es nur an, wenn das Modul auf diese
+ *        Frequenz (±25 kHz) abgestimmt ist und spätestens 5 Symbole vor dem Ende der Präambel
+ *        empfängt; die Sendedauer wird mit den Funkparametern beim Einspielen berechnet.
+ */
+void simRadioInjectPacket(uint64_t end_us, const uint8_t* payload, size_t len,
+                          int16_t rssi, float snr, float frequencyError, bool crcOk = true,
+                          float frequency_MHz = 0.0f);
+
+struct SimRadioStats {
+  uint32_t injected;         // Eingespielte Pakete
+  uint32_t delivered;        // Pakete mit RxDone-Interrupt
+  uint32_t lostNotListening; // Verloren, weil das Modul nicht im Empfang war
+  uint32_t lostOtherChannel; // Verloren, weil das Modul auf eine andere Frequenz abgestimmt war
+  uint32_t overwritten;      // Verloren, weil das vorherige Paket noch nicht ausgelesen war
+  uint32_t readOut;          // Per readData() abgeholte Pakete
+  uint32_t transmitted;      // Gesendete Pakete
+  uint64_t txAirtime_us;     // Summe der Sendedauer
+  uint64_t rxBlind_us;       // Zeit außerhalb des Empfangsmodus
+  uint32_t cadRuns;          // Durchgeführte Kanalbelegungsprüfungen (CAD)
+  uint32_t cadBusy;          // ... davon mit erkannter LoRa-Aktivität
+  uint32_t lostDutySleep;    // Verloren, weil die Präambel im Duty-Cycle ganz in die Schlafphase fiel
+  uint32_t dutyStarts;       // Starts des Empfangs im Duty-Cycle (auch per SetRxDutyCycle)
+};
+
+SimRadioStats simRadioGetStats();
+
+/**
+ * @brief Markiert den Kanal von 'start_us' bis 'end_us' als belegt (fremder Sender),
+ *        mit 'frequency_MHz' nur diese Frequenz (0 = jede Frequenz).
+ *        Eine CAD, die diesen Zeitraum überlappt, meldet Aktivität. Eingespielte Pakete
+ *        belegen den Kanal automatisch für ihre Sendedauer.
+ */
+void simRadioAddBusy(uint64_t start_us, uint64_t end_us, float frequency_MHz = 0.0f);
+
+/**
+ * @brief Gibt die Anzahl und Gesamtdauer der SPI-Transaktionen je Methode auf stderr aus.
+ */
+void simRadioPrintSpiStats();
+
+/**
+ * @brief Callback beim Start einer Übertragung (für Latenzmessungen im Szenario und
+ *        für Gegenstellen, die auf gesendete Pakete antworten, z.B. mit Quittungen).
+ */
+void simRadioSetTxStartHandler(void (*handler)(uint64_t at_us, const uint8_t* payload, size_t len));
+
+#endif // RADIOLIB_SIM_H
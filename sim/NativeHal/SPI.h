@@ -0,0 +1,28 @@
+#ifndef SPI_H
+#define SPI_H
+
+#include <Arduino.h>
+
+#ifndef MSBFIRST
+#define MSBFIRST 1
+#endif
+#define SPI_MODE0 0x00
+
+// SPI-Ersatz für die native Umgebung; die Buszugriffe bildet SX1262 (RadioLib.h) selbst nach.
+class SPIClass {
+public:
+  void begin() {}
+  void end() {}
+};
+
+// Nur der Takt wird ausgewertet (Dauer der simulierten Transaktionen)
+class SPISettings {
+public:
+  SPISettings(uint32_t clock = 4000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0)
+    : clock(clock) { (void)bitOrder; (void)dataMode; }
+  uint32_t clock;
+};
+
+extern SPIClass SPI;
+
+#endif // SPI_H
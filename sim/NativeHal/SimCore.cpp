@@ -0,0 +1,302 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <stdio.h>
+#include <deque>
+#include <map>
+#include <string>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+
+#ifndef SERIAL_TX_BUFFER_SIZE
+#define SERIAL_TX_BUFFER_SIZE 64
+#endif
+
+bool simTraceEnabled = false;
+
+uint32_t SystemCoreClock = 72000000;
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+//--------------------------------------------------------------------------------
+// Zeit und Ereignisse
+//--------------------------------------------------------------------------------
+
+static uint64_t nowUs = 0;
+static std::multimap<uint64_t, std::function<void()>> events;
+static bool processingEvents = false;
+
+static bool interruptsEnabled = true;
+static bool inIsr = false;
+static std::deque<void (*)(void)> pendingIsrs;
+
+uint64_t simNow() {
+  return nowUs;
+}
+
+bool simInIsr() {
+  return inIsr;
+}
+
+void simSchedule(uint64_t at_us, std::function<void()> action) {
+  events.emplace(at_us, std::move(action));
+}
+
+void simAdvance(uint64_t us) {
+  uint64_t target = nowUs + us;
+
+  // In einer ISR oder während ein Ereignis läuft, wird nur die Zeit verbucht
+  if (inIsr || processingEvents) {
+    nowUs = target;
+    return;
+  }
+
+  processingEvents = true;
+  while (!events.empty() && events.begin()->first <= target) {
+    auto it = events.begin();
+    if (it->first > nowUs) {
+      nowUs = it->first;
+    }
+    std::function<void()> action = std::move(it->second);
+    events.erase(it);
+    action();
+  }
+  processingEvents = false;
+
+  if (target > nowUs) {
+    nowUs = target;
+  }
+}
+
+static void runIsr(void (*isr)(void)) {
+  inIsr = true;
+  isr();
+  inIsr = false;
+}
+
+void simRaiseInterrupt(void (*isr)(void)) {
+  if (isr == nullptr) {
+    return;
+  }
+  if (!interruptsEnabled || inIsr) {
+    pendingIsrs.push_back(isr);
+    return;
+  }
+  runIsr(isr);
+}
+
+void noInterrupts() {
+  interruptsEnabled = false;
+}
+
+void interrupts() {
+  interruptsEnabled = true;
+  while (!pendingIsrs.empty() && !inIsr) {
+    void (*isr)(void) = pendingIsrs.front();
+    pendingIsrs.pop_front();
+    runIsr(isr);
+  }
+}
+
+unsigned long millis() {
+  return (unsigned long)(nowUs / 1000);
+}
+
+unsigned long micros() {
+  return (unsigned long)nowUs;
+}
+
+void delay(unsigned long ms) {
+  simAdvance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+  simAdvance(us);
+}
+
+//--------------------------------------------------------------------------------
+// GPIO und System
+//--------------------------------------------------------------------------------
+
+static uint32_t pinStates[64];
+static uint32_t pinWrites = 0;
+static uint32_t pinChanges = 0;
+
+void pinMode(uint32_t pin, uint32_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint32_t pin, uint32_t value) {
+  pinWrites++;
+  if (pin < 64 && pinStates[pin] != value) {
+    pinStates[pin] = value;
+    pinChanges++;
+  }
+}
+
+int digitalRead(uint32_t pin) {
+  return pin < 64 ? pinStates[pin] : LOW;
+}
+
+static uint32_t wfiCount = 0;
+static uint64_t sleptUs = 0;
+
+void __WFI() {
+  // Geweckt wird vom nächsten Ereignis (DIO1, UART, ...) oder spätestens vom SysTick
+  uint64_t wake = (nowUs / 1000 + 1) * 1000;
+  if (!events.empty() && events.begin()->first < wake) {
+    wake = events.begin()->first > nowUs ? events.begin()->first : nowUs;
+  }
+  wfiCount++;
+  sleptUs += wake - nowUs;
+  simAdvance(wake - nowUs);
+}
+
+void simGetSleepStats(uint32_t& count, uint64_t& slept_us) {
+  count = wfiCount;
+  slept_us = sleptUs;
+}
+
+void simGetPinStats(uint32_t& writes, uint32_t& changes) {
+  writes = pinWrites;
+  changes = pinChanges;
+}
+
+long random(long howbig) {
+  return howbig > 0 ? ::random() % howbig : 0;
+}
+
+long random(long howsmall, long howbig) {
+  return howbig > howsmall ? howsmall + random(howbig - howsmall) : howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  srandom(seed);
+}
+
+uint32_t HAL_GetUIDw0(void) {
+  return 0x0036FF32;
+}
+
+uint32_t HAL_GetUIDw1(void) {
+  return 0x4E4B3336;
+}
+
+uint32_t HAL_GetUIDw2(void) {
+  return 0x43173234;
+}
+
+void NVIC_SystemReset() {
+  fflush(stdout);
+  fprintf(stderr, "[sim] NVIC_SystemReset() aufgerufen, Simulation beendet.\n");
+  exit(0);
+}
+
+//--------------------------------------------------------------------------------
+// UART
+//--------------------------------------------------------------------------------
+
+static unsigned long uartBaud = 115200;
+static uint64_t uartTxBusyUntil = 0;  // Zeitpunkt, zu dem das letzte Byte hinausgeschoben ist
+static std::deque<uint8_t> uartRx;
+static std::string uartCurrentLine;
+static SimSerialLineHandler uartLineHandler = nullptr;
+static uint64_t uartTxBytes = 0;
+
+static uint64_t byteTimeUs() {
+  return 10000000ULL / uartBaud; // 8N1 = 10 Bit pro Byte
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+  uartBaud = baud;
+}
+
+void HardwareSerial::end() {
+  flush();
+}
+
+int HardwareSerial::available() {
+  return (int)uartRx.size();
+}
+
+int HardwareSerial::read() {
+  if (uartRx.empty()) {
+    return -1;
+  }
+  uint8_t c = uartRx.front();
+  uartRx.pop_front();
+  return c;
+}
+
+int HardwareSerial::peek() {
+  return uartRx.empty() ? -1 : uartRx.front();
+}
+
+int HardwareSerial::availableForWrite() {
+  uint64_t now = simNow();
+  uint64_t queued = uartTxBusyUntil > now ? (uartTxBusyUntil - now + byteTimeUs() - 1) / byteTimeUs() : 0;
+  int space = SERIAL_TX_BUFFER_SIZE - (int)queued;
+  if (space <= 0) {
+    simAdvance(1); // Abfragen kostet Zeit, sonst stünde die Simulation in Warteschleifen still
+    return 0;
+  }
+  return space;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  // Wie im echten Treiber: bei vollem Sendepuffer blockieren
+  while (availableForWrite() <= 0) {
+  }
+
+  uint64_t now = simNow();
+  uartTxBusyUntil = (uartTxBusyUntil > now ? uartTxBusyUntil : now) + byteTimeUs();
+  uartTxBytes++;
+
+  fputc(c, stdout);
+  if (c == '\n') {
+    if (uartLineHandler != nullptr) {
+      uartLineHandler(uartCurrentLine, uartTxBusyUntil);
+    }
+    uartCurrentLine.clear();
+  } else if (c != '\r') {
+    uartCurrentLine += (char)c;
+  }
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  for (size_t i = 0; i < size; i++) {
+    write(buffer[i]);
+  }
+  return size;
+}
+
+void HardwareSerial::flush() {
+  if (uartTxBusyUntil > simNow()) {
+    simAdvance(uartTxBusyUntil - simNow());
+  }
+}
+
+void simSerialInjectRaw(uint64_t at_us, const std::string& bytes) {
+  // Die Bytes sind vollständig da, wenn das letzte davon übertragen wurde
+  uint64_t arrival = at_us + bytes.size() * byteTimeUs();
+  simSchedule(arrival, [bytes]() {
+    for (char c : bytes) {
+      uartRx.push_back((uint8_t)c);
+    }
+  });
+}
+
+void simSerialInject(uint64_t at_us, const std::string& line) {
+  simSerialInjectRaw(at_us, line + "\n");
+}
+
+void simSerialSetLineHandler(SimSerialLineHandler handler) {
+  uartLineHandler = handler;
+}
+
+uint64_t simSerialTxBytes() {
+  return uartTxBytes;
+}
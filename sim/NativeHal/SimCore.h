@@ -0,0 +1,72 @@
+#ifndef SIM_CORE_H
+#define SIM_CORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+
+//================================================================================
+// Simulationskern: virtuelle Zeit, Ereignisse und Interrupts
+//================================================================================
+
+/**
+ * @brief Aktuelle simulierte Zeit in Mikrosekunden seit dem Start.
+ */
+uint64_t simNow();
+
+/**
+ * @brief Lässt die simulierte Zeit voranschreiten. Fällige Ereignisse werden dabei
+ *        zu ihrem Zeitpunkt ausgeführt (Interrupts nur, wenn sie freigegeben sind).
+ */
+void simAdvance(uint64_t us);
+
+/**
+ * @brief Plant ein Ereignis zum absoluten Zeitpunkt 'at_us'.
+ */
+void simSchedule(uint64_t at_us, std::function<void()> action);
+
+/**
+ * @brief Führt eine ISR aus oder merkt sie vor, solange Interrupts gesperrt sind.
+ */
+void simRaiseInterrupt(void (*isr)(void));
+
+/**
+ * @brief Ob gerade eine ISR läuft (Zeitkosten werden dann ohne Ereignisse verbucht).
+ */
+bool simInIsr();
+
+/**
+ * @brief Anzahl aller digitalWrite()-Aufrufe und der tatsächlichen Pegelwechsel.
+ */
+void simGetPinStats(uint32_t& writes, uint32_t& changes);
+
+/**
+ * @brief Anzahl der __WFI()-Aufrufe und darin verschlafene Zeit.
+ */
+void simGetSleepStats(uint32_t& count, uint64_t& slept_us);
+
+/**
+ * @brief Lädt bzw. speichert den nachgebildeten Flash aus/in eine Datei, damit ein
+ *        zweiter Lauf einen Neustart mit gespeicherter Konfiguration zeigen kann.
+ */
+bool simFlashLoad(const char* path);
+bool simFlashSave(const char* path);
+
+/**
+ * @brief Anzahl der Löschvorgänge der Flash-Seite ab 'pageAddress'.
+ */
+uint32_t simFlashEraseCount(uint32_t pageAddress);
+
+/**
+ * @brief Stromausfall beim Schreiben: nach 'writes' weiteren Programmier- bzw. Löschzugriffen
+ *        schlagen alle weiteren fehl, der zuletzt begonnene Datensatz bleibt unvollständig.
+ *        0 stellt den Normalbetrieb wieder her.
+ */
+void simFlashCutPowerAfter(uint32_t writes);
+
+/**
+ * @brief Ablaufverfolgung auf stderr (SPI-Aufrufe, Ereignisse).
+ */
+extern bool simTraceEnabled;
+
+#endif // SIM_CORE_H
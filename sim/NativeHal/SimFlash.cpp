@@ -0,0 +1,138 @@
+//================================================================================
+// Flash-Modell: die letzten Seiten des STM32F103CB
+//================================================================================
+// Löschen setzt eine Seite auf 0xFF, Programmieren ist nur auf gelöschte Halbwörter
+// erlaubt (wie beim F1). Löschen und Programmieren halten die CPU an und kosten
+// entsprechend simulierte Zeit.
+
+#include <Arduino.h>
+#include <stdio.h>
+
+#include "SimCore.h"
+
+static const uint32_t SIM_FLASH_PAGES = 4;
+static const uint32_t SIM_FLASH_START = FLASH_BANK1_END + 1 - SIM_FLASH_PAGES * FLASH_PAGE_SIZE;
+
+static const uint32_t ERASE_TIME_US = 20000;  // Seite löschen (Datenblatt: 20-40 ms)
+static const uint32_t PROGRAM_TIME_US = 52;   // Halbwort programmieren
+
+static uint8_t flashMemory[SIM_FLASH_PAGES * FLASH_PAGE_SIZE];
+static bool flashInitialized = false;
+static bool flashUnlocked = false;
+static uint32_t eraseCounts[SIM_FLASH_PAGES];
+static bool powerCutArmed = false;
+static uint32_t writesBeforePowerCut = 0;
+
+static void initFlash() {
+  if (!flashInitialized) {
+    memset(flashMemory, 0xFF, sizeof(flashMemory));
+    flashInitialized = true;
+  }
+}
+
+// Zählt einen Schreib- oder Löschzugriff; nach Eintritt des Stromausfalls schlagen alle fehl
+static bool consumePower() {
+  if (!powerCutArmed) {
+    return true;
+  }
+  if (writesBeforePowerCut == 0) {
+    return false;
+  }
+  writesBeforePowerCut--;
+  return true;
+}
+
+static bool inRange(uint32_t address, uint32_t len) {
+  return address >= SIM_FLASH_START && address + len <= FLASH_BANK1_END + 1;
+}
+
+const uint8_t* simFlashPointer(uint32_t address) {
+  initFlash();
+  if (!inRange(address, 1)) {
+    fprintf(stderr, "[sim] Flash-Lesezugriff außerhalb des Modells: 0x%08x\n", address);
+    abort();
+  }
+  return &flashMemory[address - SIM_FLASH_START];
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) {
+  flashUnlocked = true;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void) {
+  flashUnlocked = false;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data) {
+  initFlash();
+  if (!flashUnlocked || TypeProgram != FLASH_TYPEPROGRAM_HALFWORD || (Address & 1) || !inRange(Address, 2)) {
+    return HAL_ERROR;
+  }
+  uint8_t* cell = &flashMemory[Address - SIM_FLASH_START];
+  if (cell[0] != 0xFF || cell[1] != 0xFF) {
+    return HAL_ERROR; // F1: nur gelöschte Halbwörter dürfen programmiert werden
+  }
+  if (!consumePower()) {
+    return HAL_ERROR;
+  }
+  cell[0] = (uint8_t)Data;
+  cell[1] = (uint8_t)(Data >> 8);
+  simAdvance(PROGRAM_TIME_US);
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* pEraseInit, uint32_t* PageError) {
+  initFlash();
+  *PageError = 0xFFFFFFFFU;
+  if (!flashUnlocked || pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES ||
+      !inRange(pEraseInit->PageAddress, pEraseInit->NbPages * FLASH_PAGE_SIZE)) {
+    *PageError = pEraseInit->PageAddress;
+    return HAL_ERROR;
+  }
+  if (!consumePower()) {
+    *PageError = pEraseInit->PageAddress;
+    return HAL_ERROR;
+  }
+  memset(&flashMemory[pEraseInit->PageAddress - SIM_FLASH_START], 0xFF, pEraseInit->NbPages * FLASH_PAGE_SIZE);
+  for (uint32_t i = 0; i < pEraseInit->NbPages; i++) {
+    eraseCounts[(pEraseInit->PageAddress - SIM_FLASH_START) / FLASH_PAGE_SIZE + i]++;
+  }
+  simAdvance((uint64_t)ERASE_TIME_US * pEraseInit->NbPages);
+  return HAL_OK;
+}
+
+bool simFlashLoad(const char* path) {
+  initFlash();
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false; // Erster Lauf: Flash bleibt gelöscht
+  }
+  size_t n = fread(flashMemory, 1, sizeof(flashMemory), file);
+  fclose(file);
+  return n == sizeof(flashMemory);
+}
+
+bool simFlashSave(const char* path) {
+  initFlash();
+  FILE* file = fopen(path, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  size_t n = fwrite(flashMemory, 1, sizeof(flashMemory), file);
+  fclose(file);
+  return n == sizeof(flashMemory);
+}
+
+uint32_t simFlashEraseCount(uint32_t pageAddress) {
+  if (!inRange(pageAddress, FLASH_PAGE_SIZE)) {
+    return 0;
+  }
+  return eraseCounts[(pageAddress - SIM_FLASH_START) / FLASH_PAGE_SIZE];
+}
+
+void simFlashCutPowerAfter(uint32_t writes) {
+  powerCutArmed = writes != 0;
+  writesBeforePowerCut = writes;
+}
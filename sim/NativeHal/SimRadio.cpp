@@ -0,0 +1,581 @@
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <stdio.h>
+#include <map>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "SimCore.h"
+
+// Feste Dauer einer SPI-Transaktion (NSS, BUSY-Wartezeit, HAL-Aufruf) plus die Bytes beim
+// eingestellten Takt. Ohne SPISettings verwendet RadioLib 2 MHz.
+static const uint32_t SPI_COMMAND_US = 16;
+static uint32_t spiClock_Hz = 2000000;
+
+enum SimRadioMode { MODE_SLEEP, MODE_STANDBY, MODE_RX, MODE_TX, MODE_CAD };
+
+struct SimPacket {
+  uint8_t payload[256];
+  size_t len;
+  int16_t rssi;
+  float snr;
+  float frequencyError;  // Sendefrequenz minus Empfangsfrequenz beim Einspeisen
+  bool crcOk;
+  float frequency_MHz; // 0 = auf jeder Frequenz empfangbar
+  float injectedTuning_MHz; // Empfangsfrequenz beim Einspeisen (nur ohne feste Sendefrequenz)
+  uint64_t start_us;
+  uint64_t preambleEnd_us;
+};
+
+struct SimBusyInterval {
+  uint64_t start_us;
+  uint64_t end_us;
+  float frequency_MHz;
+};
+
+struct SpiStat {
+  uint32_t count;
+  uint64_t time_us;
+};
+
+static SimRadioMode mode = MODE_SLEEP;
+static uint64_t leftRxAt = 0;
+static uint64_t enteredRxAt = 0;
+static void (*dio1Action)(void) = nullptr;
+static bool irqPending = false;  // DIO1-Pegel: gesetzt bis clearIrq
+static SimPacket rxPacket;
+static bool rxPacketValid = false;
+static uint8_t rxBufferOffset = 0; // Startadresse des Pakets im Datenpuffer (kontinuierlicher Empfang)
+static uint64_t txDoneAt = 0;
+
+// Empfang im Duty-Cycle: Fenster von 'dutyRx_us' ab 'dutyStart' im Abstand rx + sleep
+static bool dutyActive = false;
+static uint64_t dutyStart = 0;
+static uint32_t dutyRx_us = 0;
+static uint32_t dutySleep_us = 0;
+
+// Belegte Zeiträume des Kanals und Ergebnis der laufenden CAD
+static std::vector<SimBusyInterval> busyIntervals;
+static uint64_t cadDoneAt = 0;
+static bool cadDetected = false;
+static bool cadResultValid = false;
+
+static float cfgFrequency = 869.525f;
+static float cfgBandwidth = 250.0f;
+static uint8_t cfgSpreadingFactor = 11;
+static uint8_t cfgCodingRate = 5;
+static uint16_t cfgPreamble = 16;
+
+static SimRadioStats stats = {};
+static std::map<std::string, SpiStat> spiStats;
+static void (*txStartHandler)(uint64_t, const uint8_t*, size_t) = nullptr;
+
+// Verbucht 'commands' Transaktionen mit zusammen 'bytes' Bytes unter einem Namen
+static void spi(const char* name, uint32_t bytes = 0, uint32_t commands = 1) {
+  uint32_t us = commands * SPI_COMMAND_US + (uint32_t)((uint64_t)bytes * 8000000 / spiClock_Hz);
+  SpiStat& s = spiStats[name];
+  s.count++;
+  s.time_us += us;
+  if (simTraceEnabled) {
+    fprintf(stderr, "[%10.3f ms] SPI %s (%u us)\n", simNow() / 1000.0, name, us);
+  }
+  simAdvance(us);
+}
+
+static void setMode(SimRadioMode newMode) {
+  if (mode == MODE_RX && newMode != MODE_RX) {
+    leftRxAt = simNow();
+  } else if (mode != MODE_RX && newMode == MODE_RX) {
+    stats.rxBlind_us += simNow() - leftRxAt;
+    enteredRxAt = simNow();
+  }
+  mode = newMode;
+}
+
+// DIO1 löst nur bei einer steigenden Flanke aus
+static void raiseIrq() {
+  if (irqPending) {
+    return;
+  }
+  irqPending = true;
+  simRaiseInterrupt(dio1Action);
+}
+
+static void clearIrq() {
+  irqPending = false;
+}
+
+int16_t SX1262::begin(float freq, float bw, uint8_t sf, uint8_t cr, uint8_t syncWord, int8_t power,
+                      uint16_t preambleLength, float tcxoVoltage, bool useRegulatorLDO) {
+  (void)syncWord; (void)power; (void)tcxoVoltage; (void)useRegulatorLDO;
+  spi("begin", 40);
+  cfgFrequency = freq;
+  cfgBandwidth = bw;
+  cfgSpreadingFactor = sf;
+  cfgCodingRate = cr;
+  cfgPreamble = preambleLength;
+  leftRxAt = simNow();
+  setMode(MODE_STANDBY);
+  return RADIOLIB_ERR_NONE;
+}
+
+void SX1262::setRfSwitchPins(uint32_t rxEn, uint32_t txEn) {
+  (void)rxEn; (void)txEn;
+}
+
+void SX1262::setPacketReceivedAction(void (*func)(void)) {
+  dio1Action = func;
+}
+
+void SX1262::setPacketSentAction(void (*func)(void)) {
+  dio1Action = func;
+}
+
+int16_t SX1262::startReceive() {
+  // SetDioIrqParams, SetBufferBaseAddress, ClearIrqStatus, SetRx
+  spi("startReceive", 19, 4);
+  rxBufferOffset = 0;
+  clearIrq();
+  rxPacketValid = false;
+  dutyActive = false;
+  setMode(MODE_RX);
+  return RADIOLIB_ERR_NONE;
+}
+
+static void startDutyCycle(uint32_t rx_us, uint32_t sleep_us) {
+  rxBufferOffset = 0;
+  rxPacketValid = false;
+  dutyActive = true;
+  dutyStart = simNow();
+  dutyRx_us = rx_us;
+  dutySleep_us = sleep_us;
+  stats.dutyStarts++;
+  setMode(MODE_RX);
+}
+
+int16_t SX1262::startReceiveDutyCycle(uint32_t rxPeriod, uint32_t sleepPeriod) {
+  // SetDioIrqParams, SetBufferBaseAddress, ClearIrqStatus, SetRxDutyCycle
+  spi("startReceiveDutyCycle", 21, 4);
+  clearIrq();
+  startDutyCycle(rxPeriod, sleepPeriod);
+  return RADIOLIB_ERR_NONE;
+}
+
+// Ob ein Empfangsfenster die Präambel (bis zum spätesten Einrasten) überdeckt
+static bool dutyWindowCatches(uint64_t start_us, uint64_t preambleEnd_us) {
+  uint64_t period = (uint64_t)dutyRx_us + dutySleep_us;
+  uint64_t window = dutyStart;
+  if (start_us > dutyStart) {
+    window = dutyStart + (start_us - dutyStart) / period * period;
+    if (window + dutyRx_us <= start_us) {
+      window += period;
+    }
+  }
+  return window <= preambleEnd_us;
+}
+
+int16_t SX1262::startTransmit(const uint8_t* data, size_t len, uint8_t addr) {
+  (void)addr;
+  if (len > 255) {
+    return RADIOLIB_ERR_PACKET_TOO_LONG;
+  }
+  spi("startTransmit", 20 + len);
+  clearIrq();
+  setMode(MODE_TX);
+
+  uint32_t toa = getTimeOnAir(len);
+  txDoneAt = simNow() + toa;
+  stats.transmitted++;
+  stats.txAirtime_us += toa;
+  if (txStartHandler != nullptr) {
+    txStartHandler(simNow(), data, len);
+  }
+
+  uint64_t doneAt = txDoneAt;
+  simSchedule(doneAt, [doneAt]() {
+    if (mode == MODE_TX && txDoneAt == doneAt) {
+      setMode(MODE_STANDBY);
+      raiseIrq();
+    }
+  });
+  return RADIOLIB_ERR_NONE;
+}
+
+int16_t SX1262::finishTransmit() {
+  spi("finishTransmit", 8);
+  clearIrq();
+  setMode(MODE_STANDBY);
+  return RADIOLIB_ERR_NONE;
+}
+
+int16_t SX1262::transmit(const uint8_t* data, size_t len, uint8_t addr) {
+  int16_t state = startTransmit(data, len, addr);
+  if (state != RADIOLIB_ERR_NONE) {
+    return state;
+  }
+  while (mode == MODE_TX) {
+    simAdvance(100);
+  }
+  return finishTransmit();
+}
+
+static uint8_t cadSymbols(uint8_t symNum) {
+  switch (symNum) {
+    case RADIOLIB_SX126X_CAD_ON_1_SYMB: return 1;
+    case RADIOLIB_SX126X_CAD_ON_4_SYMB: return 4;
+    case RADIOLIB_SX126X_CAD_ON_8_SYMB: return 8;
+    case RADIOLIB_SX126X_CAD_ON_16_SYMB: return 16;
+    default: return 2;
+  }
+}
+
+// Frequenz 0 steht für "jede Frequenz"
+static bool onTunedFrequency(float frequency_MHz) {
+  return frequency_MHz == 0.0f || fabsf(frequency_MHz - cfgFrequency) < 0.025f;
+}
+
+static bool channelBusy(uint64_t from_us, uint64_t to_us) {
+  for (const auto& interval : busyIntervals) {
+    if (interval.start_us < to_us && interval.end_us > from_us && onTunedFrequency(interval.frequency_MHz)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int16_t SX1262::startChannelScan() {
+  ChannelScanConfig_t config = {};
+  config.cad.symNum = RADIOLIB_SX126X_CAD_ON_2_SYMB;
+  config.cad.detPeak = RADIOLIB_SX126X_CAD_PARAM_DEFAULT;
+  config.cad.detMin = RADIOLIB_SX126X_CAD_PARAM_DEFAULT;
+  config.cad.exitMode = RADIOLIB_SX126X_CAD_GOTO_STDBY;
+  return startChannelScan(config);
+}
+
+int16_t SX1262::startChannelScan(const ChannelScanConfig_t& config) {
+  spi("startChannelScan", 24);
+  clearIrq();
+  cadResultValid = false;
+  setMode(MODE_CAD);
+
+  // CAD dauert die gewählte Symbolanzahl plus etwa ein halbes Symbol Auswertung
+  double symbolTime_us = (double)(1UL << cfgSpreadingFactor) * 1000.0 / cfgBandwidth;
+  uint64_t start = simNow();
+  uint64_t doneAt = start + (uint64_t)((cadSymbols(config.cad.symNum) + 0.5) * symbolTime_us);
+  cadDoneAt = doneAt;
+  simSchedule(doneAt, [start, doneAt]() {
+    if (mode == MODE_CAD && cadDoneAt == doneAt) {
+      cadDetected = channelBusy(start, doneAt);
+      cadResultValid = true;
+      stats.cadRuns++;
+      if (cadDetected) {
+        stats.cadBusy++;
+      }
+      setMode(MODE_STANDBY);
+      raiseIrq();
+    }
+  });
+  return RADIOLIB_ERR_NONE;
+}
+
+int16_t SX1262::getChannelScanResult() {
+  spi("getChannelScanResult", 4);
+  if (!cadResultValid) {
+    return RADIOLIB_ERR_UNKNOWN;
+  }
+  return cadDetected ? RADIOLIB_LORA_DETECTED : RADIOLIB_CHANNEL_FREE;
+}
+
+int16_t SX1262::standby() {
+  spi("standby", 2);
+  setMode(MODE_STANDBY);
+  return RADIOLIB_ERR_NONE;
+}
+
+size_t SX1262::getPacketLength(bool update) {
+  (void)update;
+  spi("getPacketLength", 4);
+  return rxPacketValid ? rxPacket.len : 0;
+}
+
+int16_t SX1262::readData(uint8_t* data, size_t len) {
+  // GetStatus, GetIrqStatus, GetRxBufferStatus, ReadBuffer, ClearIrqStatus
+  spi("readData", 16 + len, 5);
+  if (!rxPacketValid) {
+    return RADIOLIB_ERR_UNKNOWN;
+  }
+  size_t n = len < rxPacket.len ? len : rxPacket.len;
+  memcpy(data, rxPacket.payload, n);
+  stats.readOut++;
+  clearIrq();
+  return rxPacket.crcOk ? RADIOLIB_ERR_NONE : RADIOLIB_ERR_CRC_MISMATCH;
+}
+
+float SX1262::getRSSI() {
+  spi("getRSSI", 5);
+  return rxPacket.rssi;
+}
+
+float SX1262::getSNR() {
+  spi("getSNR", 5);
+  return rxPacket.snr;
+}
+
+float SX1262::getFrequencyError() {
+  // GetPacketType und drei einzelne Registerzugriffe
+  spi("getFrequencyError", 18, 4);
+  return rxPacket.frequencyError;
+}
+
+Module::Module(uint32_t cs, uint32_t irq, uint32_t rst, uint32_t gpio) {
+  (void)cs; (void)irq; (void)rst; (void)gpio;
+}
+
+Module::Module(uint32_t cs, uint32_t irq, uint32_t rst, uint32_t gpio, SPIClass& spi, SPISettings spiSettings) {
+  (void)cs; (void)irq; (void)rst; (void)gpio; (void)spi;
+  spiClock_Hz = spiSettings.clock;
+}
+
+int16_t Module::SPIreadStream(uint16_t cmd, uint8_t* data, size_t numBytes, bool waitForGpio, bool verify) {
+  (void)waitForGpio; (void)verify;
+  memset(data, 0, numBytes);
+  switch (cmd) {
+    case RADIOLIB_SX126X_CMD_GET_IRQ_STATUS: {
+      spi("GetIrqStatus", 2 + numBytes);
+      uint16_t flags = 0;
+      if (irqPending && rxPacketValid) {
+        flags = RADIOLIB_SX126X_IRQ_RX_DONE | RADIOLIB_SX126X_IRQ_HEADER_VALID;
+        if (!rxPacket.crcOk) {
+          flags |= RADIOLIB_SX126X_IRQ_CRC_ERR;
+        }
+      }
+      if (numBytes >= 2) {
+        data[0] = flags >> 8;
+        data[1] = flags & 0xFF;
+      }
+      return RADIOLIB_ERR_NONE;
+    }
+    case RADIOLIB_SX126X_CMD_GET_RX_BUFFER_STATUS:
+      spi("GetRxBufferStatus", 2 + numBytes);
+      if (numBytes >= 2) {
+        data[0] = rxPacketValid ? (uint8_t)rxPacket.len : 0;
+        data[1] = rxBufferOffset;
+      }
+      return RADIOLIB_ERR_NONE;
+    case RADIOLIB_SX126X_CMD_GET_PACKET_STATUS: {
+      spi("GetPacketStatus", 2 + numBytes);
+      // Signal-RSSI: Anteil des Nutzsignals, unter dem Rauschen um den SNR geringer
+      float signal = rxPacket.snr < 0 ? rxPacket.rssi + rxPacket.snr : rxPacket.rssi;
+      // Die Register sind 8 Bit breit: RSSI-Werte reichen bis -127.5 dBm
+      if (numBytes >= 3) {
+        data[0] = (uint8_t)std::min(255L, lroundf(-rxPacket.rssi * 2.0f));
+        data[1] = (uint8_t)(int8_t)lroundf(rxPacket.snr * 4.0f);
+        data[2] = (uint8_t)std::min(255L, lroundf(-signal * 2.0f));
+      }
+      return RADIOLIB_ERR_NONE;
+    }
+  }
+  spi("readStream", 2 + numBytes);
+  return RADIOLIB_ERR_UNKNOWN;
+}
+
+int16_t Module::SPIreadStream(const uint8_t* cmd, uint8_t cmdLen, uint8_t* data, size_t numBytes,
+                              bool waitForGpio, bool verify) {
+  (void)waitForGpio; (void)verify;
+  if (cmdLen == 2 && cmd[0] == RADIOLIB_SX126X_CMD_READ_BUFFER) {
+    spi("ReadBuffer", 3 + numBytes);
+    if (!rxPacketValid || cmd[1] != rxBufferOffset) {
+      return RADIOLIB_ERR_UNKNOWN;
+    }
+    size_t n = numBytes < rxPacket.len ? numBytes : rxPacket.len;
+    memcpy(data, rxPacket.payload, n);
+    stats.readOut++;
+    return RADIOLIB_ERR_NONE;
+  }
+  spi("readStream", cmdLen + 1 + numBytes);
+  return RADIOLIB_ERR_UNKNOWN;
+}
+
+int16_t Module::SPIwriteStream(uint16_t cmd, const uint8_t* data, size_t numBytes, bool waitForGpio, bool verify) {
+  (void)data; (void)waitForGpio; (void)verify;
+  if (cmd == RADIOLIB_SX126X_CMD_CLEAR_IRQ_STATUS) {
+    spi("ClearIrqStatus", 1 + numBytes);
+    clearIrq();
+    return RADIOLIB_ERR_NONE;
+  }
+  if (cmd == RADIOLIB_SX126X_CMD_SET_RX_DUTY_CYCLE && numBytes == 6) {
+    spi("SetRxDutyCycle", 1 + numBytes);
+    uint32_t rxRaw = ((uint32_t)data[0] << 16) | ((uint32_t)data[1] << 8) | data[2];
+    uint32_t sleepRaw = ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 8) | data[5];
+    startDutyCycle(rxRaw * 125 / 8, sleepRaw * 125 / 8);
+    return RADIOLIB_ERR_NONE;
+  }
+  spi("writeStream", 1 + numBytes);
+  return RADIOLIB_ERR_UNKNOWN;
+}
+
+// Nur das Frequenzfehler-Register (0x076B, 20 Bit vorzeichenbehaftet, Einheit 1.55 * BW / 1600 Hz)
+int16_t Module::SPIreadRegisterBurst(uint32_t reg, size_t numBytes, uint8_t* inBytes) {
+  spi("ReadRegister", 4 + numBytes);
+  memset(inBytes, 0, numBytes);
+  if (reg != 0x076B || numBytes != 3) {
+    return RADIOLIB_ERR_UNKNOWN;
+  }
+  int32_t raw = (int32_t)lroundf(rxPacket.frequencyError * (1600.0f / cfgBandwidth) / 1.55f);
+  uint32_t efe = (uint32_t)raw & 0x0FFFFF;
+  inBytes[0] = efe >> 16;
+  inBytes[1] = (efe >> 8) & 0xFF;
+  inBytes[2] = efe & 0xFF;
+  return RADIOLIB_ERR_NONE;
+}
+
+// Semtech-Formel, expliziter Header, CRC an
+static uint32_t timeOnAir(size_t len) {
+  double symbolTime_us = (double)(1UL << cfgSpreadingFactor) * 1000.0 / cfgBandwidth;
+  int lowDataRateOpt = symbolTime_us > 16000.0 ? 1 : 0;
+  double numerator = 8.0 * len - 4.0 * cfgSpreadingFactor + 28 + 16;
+  double denominator = 4.0 * (cfgSpreadingFactor - 2 * lowDataRateOpt);
+  double payloadSymbols = ceil(numerator / denominator) * cfgCodingRate;
+  if (payloadSymbols < 0) {
+    payloadSymbols = 0;
+  }
+  double symbols = cfgPreamble + 4.25 + 8 + payloadSymbols;
+  return (uint32_t)(symbols * symbolTime_us);
+}
+
+uint32_t SX1262::getTimeOnAir(size_t len) {
+  return timeOnAir(len);
+}
+
+int16_t SX1262::setFrequency(float freq) {
+  spi("setFrequency", 4);
+  cfgFrequency = freq;
+  return RADIOLIB_ERR_NONE;
+}
+
+int16_t SX1262::setBandwidth(float bw) {
+  spi("setBandwidth", 4);
+  cfgBandwidth = bw;
+  return RADIOLIB_ERR_NONE;
+}
+
+int16_t SX1262::setSpreadingFactor(uint8_t sf) {
+  spi("setSpreadingFactor", 4);
+  if (sf < 5 || sf > 12) {
+    return RADIOLIB_ERR_INVALID_SPREADING_FACTOR;
+  }
+  cfgSpreadingFactor = sf;
+  return RADIOLIB_ERR_NONE;
+}
+
+int16_t SX1262::setCodingRate(uint8_t cr) {
+  spi("setCodingRate", 4);
+  if (cr < 5 || cr > 8) {
+    return RADIOLIB_ERR_INVALID_CODING_RATE;
+  }
+  cfgCodingRate = cr;
+  return RADIOLIB_ERR_NONE;
+}
+
+int16_t SX1262::setSyncWord(uint8_t syncWord) {
+  (void)syncWord;
+  spi("setSyncWord", 4);
+  return RADIOLIB_ERR_NONE;
+}
+
+int16_t SX1262::setOutputPower(int8_t power) {
+  spi("setOutputPower", 4);
+  if (power < -9 || power > 22) {
+    return RADIOLIB_ERR_INVALID_OUTPUT_POWER;
+  }
+  return RADIOLIB_ERR_NONE;
+}
+
+int16_t SX1262::setPreambleLength(uint16_t preambleLength) {
+  spi("setPreambleLength", 4);
+  cfgPreamble = preambleLength;
+  return RADIOLIB_ERR_NONE;
+}
+
+void simRadioInjectPacket(uint64_t end_us, const uint8_t* payload, size_t len,
+                          int16_t rssi, float snr, float frequencyError, bool crcOk, float frequency_MHz) {
+  SimPacket packet;
+  packet.len = len > sizeof(packet.payload) ? sizeof(packet.payload) : len;
+  memcpy(packet.payload, payload, packet.len);
+  packet.rssi = rssi;
+  packet.snr = snr;
+  packet.frequencyError = frequencyError;
+  packet.crcOk = crcOk;
+  packet.frequency_MHz = frequency_MHz;
+  packet.injectedTuning_MHz = cfgFrequency;
+
+  // Der Kanal ist während der gesamten Sendedauer des Pakets belegt
+  uint64_t toa = timeOnAir(packet.len);
+  uint64_t start_us = end_us > toa ? end_us - toa : 0;
+  simRadioAddBusy(start_us, end_us, frequency_MHz);
+
+  // Der Empfänger muss die Präambel noch mindestens 5 Symbole lang hören
+  double symbolTime_us = (double)(1UL << cfgSpreadingFactor) * 1000.0 / cfgBandwidth;
+  double lockBefore_us = (cfgPreamble > 5 ? cfgPreamble - 5 : 0) * symbolTime_us;
+  packet.start_us = start_us;
+  packet.preambleEnd_us = start_us + (uint64_t)lockBefore_us;
+
+  simSchedule(end_us, [packet]() {
+    stats.injected++;
+    if (mode != MODE_RX) {
+      stats.lostNotListening++;
+      return;
+    }
+    if (packet.frequency_MHz != 0.0f && (!onTunedFrequency(packet.frequency_MHz) || enteredRxAt > packet.preambleEnd_us)) {
+      stats.lostOtherChannel++;
+      return;
+    }
+    if (dutyActive) {
+      if (!dutyWindowCatches(packet.start_us, packet.preambleEnd_us)) {
+        stats.lostDutySleep++;
+        return;
+      }
+      // Nach dem Paket verlässt das Modul den Duty-Cycle und steht im Standby
+      dutyActive = false;
+      setMode(MODE_STANDBY);
+    }
+    if (rxPacketValid && irqPending) {
+      stats.overwritten++; // Vorheriges Paket wurde nie ausgelesen
+    }
+    // Im kontinuierlichen Empfang liegt jedes Paket hinter dem vorherigen im Datenpuffer
+    if (rxPacketValid) {
+      rxBufferOffset += rxPacket.len;
+    }
+    rxPacket = packet;
+    // Seit dem Einspeisen umgestimmt (z.B. durch AFC): Der gemessene Fehler verschiebt sich mit
+    if (packet.frequency_MHz == 0.0f) {
+      rxPacket.frequencyError -= (float)(((double)cfgFrequency - packet.injectedTuning_MHz) * 1e6);
+    }
+    rxPacketValid = true;
+    if (!irqPending) {
+      stats.delivered++;
+    }
+    raiseIrq();
+  });
+}
+
+void simRadioAddBusy(uint64_t start_us, uint64_t end_us, float frequency_MHz) {
+  busyIntervals.push_back({start_us, end_us, frequency_MHz});
+}
+
+SimRadioStats simRadioGetStats() {
+  return stats;
+}
+
+void simRadioPrintSpiStats() {
+  fprintf(stderr, "SPI-Transaktionen:\n");
+  for (const auto& entry : spiStats) {
+    fprintf(stderr, "  %-20s %8u x %10.3f ms\n", entry.first.c_str(), entry.second.count,
+            entry.second.time_us / 1000.0);
+  }
+}
+
+void simRadioSetTxStartHandler(void (*handler)(uint64_t at_us, const uint8_t* payload, size_t len)) {
+  txStartHandler = handler;
+}
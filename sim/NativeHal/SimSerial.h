@@ -0,0 +1,30 @@
+#ifndef SIM_SERIAL_H
+#define SIM_SERIAL_H
+
+#include <stdint.h>
+#include <string>
+
+/**
+ * @brief Wird für jede vollständig gesendete Ausgabezeile aufgerufen.
+ *        'done_us' ist der Zeitpunkt, zu dem ihr letztes Byte den UART verlassen hat.
+ */
+typedef void (*SimSerialLineHandler)(const std::string& line, uint64_t done_us);
+
+/**
+ * @brief Spielt eine Eingabezeile des Hosts ein, die ab 'at_us' übertragen wird.
+ */
+void simSerialInject(uint64_t at_us, const std::string& line);
+
+/**
+ * @brief Wie simSerialInject(), aber ohne angehängten Zeilenumbruch.
+ */
+void simSerialInjectRaw(uint64_t at_us, const std::string& bytes);
+
+void simSerialSetLineHandler(SimSerialLineHandler handler);
+
+/**
+ * @brief Anzahl aller bisher ausgegebenen Bytes.
+ */
+uint64_t simSerialTxBytes();
+
+#endif // SIM_SERIAL_H
@@ -0,0 +1,453 @@
+//================================================================================
+// Szenario-Runner für die native Umgebung
+//================================================================================
+//
+// Aufruf:  program [--trace] [--loop-us N] [--flash datei] szenario.txt
+//          program --bench-compress korpus.txt ...
+//          program --bench-crypto
+//
+// Die Firmware (setup()/loop()) läuft gegen das simulierte SX1262 und den simulierten UART.
+// Die Ausgabe der Firmware erscheint auf stdout, die Auswertung auf stderr.
+// Mit --flash wird der Flash-Inhalt vor dem Start geladen und am Ende (auch bei
+// NVIC_SystemReset) gespeichert; ein zweiter Lauf entspricht dann einem Neustart.
+//
+// Szenario-Zeilen (Zeiten in ms, '#' leitet Kommentare ein):
+//   rx     <t> <rssi> <snr> <hex-payload>             Ein Paket, fertig empfangen zum Zeitpunkt t
+//   burst  <t> <anzahl> <abstand> <länge> <rssi> <snr>  Pakete mit Zufallsinhalt
+//   rxf    <t> <MHz> <rssi> <snr> <hex-payload>       Wie 'rx', aber nur auf dieser Frequenz (Kanalscan)
+//   burstf <t> <MHz> <anzahl> <abstand> <länge> <rssi> <snr>  Wie 'burst' auf einer Frequenz
+//   crcerr <t> <länge>                                 Paket mit CRC-Fehler
+//   busy   <t> <dauer> [anzahl abstand]                Kanal belegt (fremder Sender, für LBT/CAD)
+//   serial <t> <text ...>                              Eingabezeile des Hosts ab Zeitpunkt t
+//   run    <dauer>                                     Gesamte Simulationsdauer
+//
+// --bench-compress misst die Nutzdatenkompression (compress.h) ohne Simulation: Jede Zeile
+// eines Korpus (siehe sim/corpora) ist ein Paket. Ausgegeben werden Kompressionsrate,
+// eingesparte Sendezeit mit den Standardeinstellungen und die Rechenzeit pro Byte auf dem Host.
+//
+// --bench-crypto misst die Rechenzeit pro Byte von AES-128-CCM (aes.h) für Pakete verschiedener
+// Länge; die Testvektoren aus FIPS-197 und NIST SP 800-38C prüft test/test_crypto.
+//
+// Unter 'pio test -e native' entfällt der Runner; die Tests in test/ bringen ihr eigenes main() mit.
+
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <stdio.h>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "0_config.h"
+#include "airtime.h"
+#include "compress.h"
+#include "aes.h"
+#include "crypto.h"
+
+void setup();
+void loop();
+
+struct LatencyStat {
+  uint32_t count = 0;
+  uint64_t min_us = UINT64_MAX;
+  uint64_t max_us = 0;
+  uint64_t sum_us = 0;
+
+  void add(uint64_t us) {
+    count++;
+    sum_us += us;
+    if (us < min_us) min_us = us;
+    if (us > max_us) max_us = us;
+  }
+
+  void print(const char* name) const {
+    if (count == 0) {
+      fprintf(stderr, "  %-22s keine Messwerte\n", name);
+      return;
+    }
+    fprintf(stderr, "  %-22s n=%u min=%.3f ms avg=%.3f ms max=%.3f ms\n", name, count,
+            min_us / 1000.0, sum_us / 1000.0 / count, max_us / 1000.0);
+  }
+};
+
+// Base64-Payload -> Zeitpunkte der Einspielung (für die Zuordnung der lora_rx-Zeilen)
+static std::map<std::string, std::deque<uint64_t>> injectedPayloads;
+static std::deque<uint64_t> pendingTxCommands;
+static LatencyStat rxToJson;
+static LatencyStat commandToTx;
+static uint32_t publishedRx = 0;
+static const char* flashFile = nullptr;
+
+static void saveFlashAtExit() {
+  if (flashFile != nullptr && !simFlashSave(flashFile)) {
+    fprintf(stderr, "Flash-Datei '%s' kann nicht geschrieben werden.\n", flashFile);
+  }
+}
+
+static std::string toBase64(const uint8_t* data, size_t len) {
+  static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = (uint32_t)data[i] << 16;
+    if (i + 1 < len) v |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < len) v |= data[i + 2];
+    out += alphabet[(v >> 18) & 0x3F];
+    out += alphabet[(v >> 12) & 0x3F];
+    out += i + 1 < len ? alphabet[(v >> 6) & 0x3F] : '=';
+    out += i + 2 < len ? alphabet[v & 0x3F] : '=';
+  }
+  return out;
+}
+
+static void injectPacket(uint64_t at_us, const std::vector<uint8_t>& payload, int16_t rssi, float snr, bool crcOk,
+                         float frequency_MHz = 0.0f) {
+  simRadioInjectPacket(at_us, payload.data(), payload.size(), rssi, snr, 0.0f, crcOk, frequency_MHz);
+  if (crcOk) {
+    injectedPayloads[toBase64(payload.data(), payload.size())].push_back(at_us);
+  }
+}
+
+static void onSerialLine(const std::string& line, uint64_t done_us) {
+  if (line.find("\"lora_rx\"") == std::string::npos) {
+    return;
+  }
+  publishedRx++;
+
+  size_t start = line.find("\"payload\":\"");
+  if (start == std::string::npos) {
+    return;
+  }
+  start += 11;
+  size_t end = line.find('"', start);
+  auto it = injectedPayloads.find(line.substr(start, end - start));
+  if (it != injectedPayloads.end() && !it->second.empty()) {
+    rxToJson.add(done_us - it->second.front());
+    it->second.pop_front();
+  }
+}
+
+static void onTxStart(uint64_t at_us, const uint8_t* payload, size_t len) {
+  (void)payload;
+  (void)len;
+  if (!pendingTxCommands.empty()) {
+    commandToTx.add(at_us - pendingTxCommands.front());
+    pendingTxCommands.pop_front();
+  }
+}
+
+static bool loadScenario(const char* path, uint64_t& duration_us) {
+  std::ifstream file(path);
+  if (!file) {
+    fprintf(stderr, "Szenario '%s' kann nicht geöffnet werden.\n", path);
+    return false;
+  }
+
+  std::string line;
+  int lineNo = 0;
+  while (std::getline(file, line)) {
+    lineNo++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) {
+      line.erase(hash);
+    }
+    std::istringstream in(line);
+    std::string cmd;
+    if (!(in >> cmd)) {
+      continue;
+    }
+
+    double t_ms = 0;
+    if (cmd != "run") {
+      in >> t_ms;
+    }
+    uint64_t t_us = (uint64_t)(t_ms * 1000.0);
+
+    if (cmd == "rx" || cmd == "rxf") {
+      float frequency = 0.0f;
+      if (cmd == "rxf") {
+        in >> frequency;
+      }
+      int rssi;
+      float snr;
+      std::string hex;
+      in >> rssi >> snr >> hex;
+      std::vector<uint8_t> payload;
+      for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        payload.push_back((uint8_t)strtoul(hex.substr(i, 2).c_str(), nullptr, 16));
+      }
+      injectPacket(t_us, payload, rssi, snr, true, frequency);
+    } else if (cmd == "burst" || cmd == "burstf") {
+      float frequency = 0.0f;
+      if (cmd == "burstf") {
+        in >> frequency;
+      }
+      int count, len, rssi;
+      double interval_ms;
+      float snr;
+      in >> count >> interval_ms >> len >> rssi >> snr;
+      for (int i = 0; i < count; i++) {
+        std::vector<uint8_t> payload(len);
+        for (auto& b : payload) b = (uint8_t)::random();
+        injectPacket(t_us + (uint64_t)(i * interval_ms * 1000.0), payload, rssi, snr, true, frequency);
+      }
+    } else if (cmd == "crcerr") {
+      int len;
+      in >> len;
+      std::vector<uint8_t> payload(len, 0xAA);
+      injectPacket(t_us, payload, -120, -10.0f, false);
+    } else if (cmd == "busy") {
+      double len_ms, interval_ms = 0;
+      int count = 1;
+      in >> len_ms;
+      if (in >> count) {
+        in >> interval_ms;
+      }
+      for (int i = 0; i < count; i++) {
+        uint64_t start = t_us + (uint64_t)(i * interval_ms * 1000.0);
+        simRadioAddBusy(start, start + (uint64_t)(len_ms * 1000.0));
+      }
+    } else if (cmd == "serial") {
+      std::string text;
+      std::getline(in, text);
+      size_t first = text.find_first_not_of(' ');
+      text = first == std::string::npos ? "" : text.substr(first);
+      simSerialInject(t_us, text);
+      std::string lower = text;
+      for (auto& c : lower) c = tolower((unsigned char)c);
+      if (lower.find("sendlora") != std::string::npos) {
+        // Bezugspunkt: letztes Byte der Zeile bei 115200 Baud
+        pendingTxCommands.push_back(t_us + (text.size() + 1) * 10000000ULL / 115200);
+      }
+    } else if (cmd == "run") {
+      double d_ms;
+      in >> d_ms;
+      duration_us = (uint64_t)(d_ms * 1000.0);
+    } else {
+      fprintf(stderr, "%s:%d: unbekannter Befehl '%s'\n", path, lineNo, cmd.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint64_t hostCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static bool benchCorpus(const char* path, bool dict) {
+  std::ifstream file(path);
+  if (!file) {
+    fprintf(stderr, "Korpus '%s' kann nicht geöffnet werden.\n", path);
+    return false;
+  }
+
+  // Sendezeit mit den Standardparametern, ohne setup()
+  rebuildAirtimeTables(LORA_BW, LORA_SF, LORA_CR, LORA_PREAMBLE);
+  setCompressTxEnabled(true);
+  setCompressRxEnabled(true);
+  setCompressDictEnabled(dict);
+
+  const int repeats = 200; // Wiederholungen je Paket für stabile Zeitmessung
+  uint32_t packets = 0, compressed = 0, bytesIn = 0, bytesOut = 0, unpackedBytes = 0, mismatches = 0;
+  uint64_t airtimeRaw = 0, airtimeSent = 0;
+  uint64_t compressCycles = 0, decompressCycles = 0, compressNs = 0;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#' || line.size() > 255) {
+      continue;
+    }
+    const uint8_t* raw = (const uint8_t*)line.data();
+    uint8_t packed[255], unpacked[255];
+    uint32_t saved = 0;
+    size_t packedLen = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t c0 = hostCycles();
+    for (int r = 0; r < repeats; r++) {
+      packedLen = compressForTx(raw, line.size(), packed, saved);
+    }
+    uint64_t c1 = hostCycles();
+    compressNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    size_t unpackedLen = 0;
+    for (int r = 0; r < repeats; r++) {
+      unpackedLen = decompressRx(packed, packedLen, unpacked);
+    }
+    uint64_t c2 = hostCycles();
+
+    // Unkomprimiert gesendete Pakete kommen unverändert an (decompressRx liefert 0)
+    bool same = unpackedLen == 0 ? (packedLen == line.size() && memcmp(packed, raw, packedLen) == 0)
+                                 : (unpackedLen == line.size() && memcmp(unpacked, raw, unpackedLen) == 0);
+    if (!same) {
+      mismatches++;
+    }
+    if (unpackedLen > 0) {
+      compressed++;
+      unpackedBytes += unpackedLen;
+      decompressCycles += c2 - c1;
+    }
+    packets++;
+    bytesIn += line.size();
+    bytesOut += packedLen;
+    airtimeRaw += getAirtimeMicros(line.size());
+    airtimeSent += getAirtimeMicros(packedLen);
+    compressCycles += c1 - c0;
+  }
+  if (packets == 0) {
+    fprintf(stderr, "Korpus '%s' enthält keine Pakete.\n", path);
+    return false;
+  }
+
+  double processed = (double)bytesIn * repeats;
+  fprintf(stderr, "%s (%s Wörterbuch): %u Pakete, davon %u komprimiert, %u -> %u Bytes (%.1f %%), Sendezeit %.1f -> %.1f ms\n",
+          path, dict ? "mit" : "ohne", packets, compressed, bytesIn, bytesOut, bytesOut * 100.0 / bytesIn,
+          airtimeRaw / 1000.0, airtimeSent / 1000.0);
+  fprintf(stderr, "  Host: Kompression %.1f ns/Byte bzw. %.1f Zyklen/Byte, Dekompression %.1f Zyklen/Byte, Fehler=%u\n",
+          compressNs / processed, compressCycles / processed,
+          unpackedBytes > 0 ? decompressCycles / ((double)unpackedBytes * repeats) : 0.0, mismatches);
+  return mismatches == 0;
+}
+
+static int benchCompress(const std::vector<const char*>& corpora) {
+  bool ok = true;
+  for (const char* path : corpora) {
+    ok = benchCorpus(path, false) && ok;
+    ok = benchCorpus(path, true) && ok;
+  }
+  return ok ? 0 : 1;
+}
+
+static int benchCrypto() {
+  AesKey key;
+  uint8_t raw[16];
+  for (uint8_t i = 0; i < sizeof(raw); i++) {
+    raw[i] = 0x40 + i;
+  }
+  aesSetKey(key, raw);
+
+  // Rechenzeit im Paketformat von crypto.h (7 Bytes Nonce, ohne zusätzliche Daten)
+  const int repeats = 2000;
+  const size_t lengths[] = {16, 64, 255 - LORA_CRYPTO_OVERHEAD};
+  uint8_t nonce[LORA_CRYPTO_HEADER_BYTES] = {0xC7, 1, 0, 0, 0, 0, 0};
+  uint8_t plain[255], cipher[255], tag[16];
+  for (size_t i = 0; i < sizeof(plain); i++) {
+    plain[i] = (uint8_t)random(256);
+  }
+  for (size_t len : lengths) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t c0 = hostCycles();
+    for (int r = 0; r < repeats; r++) {
+      nonce[3] = (uint8_t)r;
+      aesCcmEncrypt(key, nonce, sizeof(nonce), nullptr, 0, plain, len, cipher, tag, LORA_CRYPTO_TAG_BYTES);
+    }
+    uint64_t c1 = hostCycles();
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    for (int r = 0; r < repeats; r++) {
+      aesCcmDecrypt(key, nonce, sizeof(nonce), nullptr, 0, cipher, len, plain, tag, LORA_CRYPTO_TAG_BYTES);
+    }
+    uint64_t c2 = hostCycles();
+    double processed = (double)len * repeats;
+    fprintf(stderr, "CCM %3zu Bytes (+%d Bytes): Host %.1f ns/Byte, Verschlüsseln %.1f Zyklen/Byte, Entschlüsseln %.1f Zyklen/Byte\n",
+            len, LORA_CRYPTO_OVERHEAD, ns / processed, (c1 - c0) / processed, (c2 - c1) / processed);
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  const char* scenario = nullptr;
+  uint64_t loopCost_us = 5;
+  bool benchMode = false;
+  std::vector<const char*> corpora;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--trace") {
+      simTraceEnabled = true;
+    } else if (arg == "--loop-us" && i + 1 < argc) {
+      loopCost_us = strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--flash" && i + 1 < argc) {
+      flashFile = argv[++i];
+    } else if (arg == "--bench-compress") {
+      benchMode = true;
+    } else if (arg == "--bench-crypto") {
+      return benchCrypto();
+    } else if (benchMode) {
+      corpora.push_back(argv[i]);
+    } else {
+      scenario = argv[i];
+    }
+  }
+  if (benchMode) {
+    return benchCompress(corpora);
+  }
+  if (scenario == nullptr) {
+    fprintf(stderr, "Aufruf: %s [--trace] [--loop-us N] [--flash datei] szenario.txt\n", argv[0]);
+    fprintf(stderr, "        %s --bench-compress korpus.txt ...\n", argv[0]);
+    fprintf(stderr, "        %s --bench-crypto\n", argv[0]);
+    return 2;
+  }
+
+  randomSeed(1);
+  uint64_t duration_us = 10000000;
+  if (!loadScenario(scenario, duration_us)) {
+    return 2;
+  }
+
+  simSerialSetLineHandler(onSerialLine);
+  simRadioSetTxStartHandler(onTxStart);
+  if (flashFile != nullptr) {
+    simFlashLoad(flashFile);
+    atexit(saveFlashAtExit);
+  }
+
+  setup();
+  uint64_t iterations = 0;
+  while (simNow() < duration_us) {
+    loop();
+    simAdvance(loopCost_us);
+    iterations++;
+  }
+  Serial.flush();
+  fflush(stdout);
+
+  SimRadioStats radio = simRadioGetStats();
+  uint32_t pinWrites, pinChanges;
+  simGetPinStats(pinWrites, pinChanges);
+
+  fprintf(stderr, "\n=== Simulation: %.1f ms, %llu Schleifendurchläufe ===\n", simNow() / 1000.0,
+          (unsigned long long)iterations);
+  fprintf(stderr, "Funk: eingespielt=%u, RxDone=%u, ausgelesen=%u, verpasst (kein RX)=%u, anderer Kanal=%u, überschrieben=%u\n",
+          radio.injected, radio.delivered, radio.readOut, radio.lostNotListening, radio.lostOtherChannel, radio.overwritten);
+  fprintf(stderr, "      gesendet=%u, Sendedauer=%.1f ms, RX-Blindzeit=%.3f ms\n", radio.transmitted,
+          radio.txAirtime_us / 1000.0, radio.rxBlind_us / 1000.0);
+  fprintf(stderr, "      CAD=%u, davon belegt=%u\n", radio.cadRuns, radio.cadBusy);
+  fprintf(stderr, "      Duty-Cycle-Starts=%u, verpasst (Schlafphase)=%u\n", radio.dutyStarts, radio.lostDutySleep);
+  fprintf(stderr, "Host: lora_rx-Zeilen=%u\n", publishedRx);
+  fprintf(stderr, "GPIO: digitalWrite=%u, Pegelwechsel=%u\n", pinWrites, pinChanges);
+  uint32_t wfiCount;
+  uint64_t slept_us;
+  simGetSleepStats(wfiCount, slept_us);
+  fprintf(stderr, "MCU: WFI=%u, geschlafen=%.1f ms (%.1f %%)\n", wfiCount, slept_us / 1000.0,
+          simNow() > 0 ? 100.0 * slept_us / simNow() : 0.0);
+  fprintf(stderr, "Latenzen:\n");
+  rxToJson.print("RxDone -> lora_rx");
+  commandToTx.print("sendlora -> TX-Start");
+  simRadioPrintSpiStats();
+  return 0;
+}
+
+#endif // PIO_UNIT_TESTING
@@ -7,6 +7,21 @@
 // Logging Konfiguration
 //================================================================================
 #define DEFAULT_LOGGING_STATE true
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO // Niedrigere Meldungen entfernt bereits der Compiler (siehe logger.h)
+#endif
+#define LOG_RING_SIZE 32             // Gespeicherte Meldungen für 'dumplog' (Zweierpotenz)
+#define LOG_MAX_ARGS 3               // Argumente je Meldung
+#define LOG_TEXT_MAX 160             // Länge eines formatierten Meldungstexts inkl. Nullterminator
+
+//================================================================================
+// Serielle Schnittstelle
+//================================================================================
+#define SERIAL_BAUD_DEFAULT 115200   // Baudrate nach dem Start (per 'baud'-Befehl änderbar)
+#define JSON_INPUT_BUFFER_SIZE 512   // Maximale Länge einer Eingabezeile inkl. Nullterminator
+#define DEFAULT_SERIAL_ECHO false    // Eingabe zeichenweise zurücksenden
+#define SERIAL_OUT_BUFFER_SIZE 2048  // Ausgabepuffer für Datensätze an den Host (Zweierpotenz)
+#define SERIAL_OUT_RX_RESERVE 512    // Mindestens freier Ausgabepuffer, bevor ein Empfangspaket publiziert wird
 
 //================================================================================
 // Hardware Pin-Definitionen
@@ -19,6 +34,7 @@
 #define TXEN PA0  // RF Switch: TX Enable
 
 #define SX1262_TCXOVOLTAGE 0 // Spannung für den TCXO (falls vorhanden, sonst 0)
+#define SX1262_SPI_CLOCK 9000000 // SPI1 an APB2 (72 MHz) / 8; das SX1262 erlaubt bis 16 MHz (RadioLib: 2 MHz)
 
 const int ledPin = PC13;    // Onboard-LED
 const int buttonPin = PB12; // Onboard-Taster
@@ -35,26 +51,152 @@ const int buttonPin = PB12; // Onboard-Taster
 #define LORA_PREAMBLE 16       // Länge der Präambel
 #define LORA_FREQUENCY_OFFSET 10.5 // Frequenz-Offset in kHz zur Kompensation
 
-#endif // CONFIG_H
+//================================================================================
+// Empfangspuffer
+//================================================================================
+#define LORA_RX_RING_SIZE 8 // Anzahl gepufferter Empfangspakete (Zweierpotenz)
+#define LORA_RX_FREQ_ERROR_DEFAULT true // Frequenzfehler je Paket auslesen (ein zusätzlicher Registerzugriff)
+#define LORA_RX_DUTY_MIN_SYMBOLS 8     // Präambelsymbole, die ein Empfangsfenster im Duty-Cycle mindestens hört
+#define LORA_RX_DUTY_WAKE_US 1000      // Wechsel Schlaf -> Empfang und zurück (plus TCXO-Anlauf, falls vorhanden)
+
+//================================================================================
+// Empfangsfilter (siehe rxfilter.h, per 'rxFilter'-Befehl einstellbar)
+//================================================================================
+#define LORA_RX_FILTER_RULES 8     // Maximale Anzahl an Regeln in der Kette
+#define LORA_RX_FILTER_MAX_BYTES 8 // Maximale Anzahl verglichener Bytes je MATCH/DENY-Regel
+
+//================================================================================
+// Duplikatunterdrückung (siehe dedup.h, per 'dedup'-Befehl einstellbar)
+//================================================================================
+#define LORA_DEDUP_MODE_DEFAULT 0       // 0 = aus, 1 = Kopien verwerfen, 2 = beste Kopie publizieren
+#define LORA_DEDUP_WINDOW_MS 30000      // Zeitfenster, in dem Kopien als Duplikat gelten
+#define LORA_DEDUP_WINDOW_MIN_MS 100
+#define LORA_DEDUP_WINDOW_MAX_MS 600000
+#define LORA_DEDUP_HOLD_MS 500          // Haltezeit der ersten Kopie im Modus 2
+#define LORA_DEDUP_TABLE_SIZE 32        // Einträge der Hash-Tabelle (Zweierpotenz, max. 128)
+#define LORA_DEDUP_MAX_PROBE 8          // Längste Sondierkette, danach wird der älteste Eintrag verdrängt
+#define LORA_DEDUP_HOLD_SLOTS 2         // Gleichzeitig zurückgehaltene Pakete im Modus 2
+
+//================================================================================
+// Repeater (siehe repeater.h, per 'repeater'-Befehl einstellbar)
+//================================================================================
+#define LORA_REPEATER_ENABLED_DEFAULT false
+#define LORA_REPEATER_DELAY_MIN_MS 50       // Kürzeste zufällige Wartezeit vor dem Weitersenden
+#define LORA_REPEATER_DELAY_MAX_MS 500      // Längste zufällige Wartezeit
+#define LORA_REPEATER_DELAY_LIMIT_MS 10000  // Obergrenze beider Wartezeiten
+#define LORA_REPEATER_WINDOW_MS 30000       // Zeitfenster, in dem Kopien nicht erneut weitergesendet werden
+#define LORA_REPEATER_SEEN_SIZE 16          // Gemerkte Pakete (Hash und Zeitpunkt, je 8 Bytes)
+#define LORA_REPEATER_SLOTS 2               // Gleichzeitig wartende Pakete (je 266 Bytes RAM)
+#define LORA_REPEATER_RESERVE_PERCENT 25    // Anteil des Duty-Cycle-Budgets, der für Aufträge des Hosts frei bleibt
+
+//================================================================================
+// Automatische Frequenzkorrektur (siehe afc.h, per 'afc'-Befehl einschaltbar)
+//================================================================================
+#define LORA_AFC_ENABLED_DEFAULT false   // Benötigt die Frequenzfehler-Messung (LORA_RX_FREQ_ERROR_DEFAULT)
+#define LORA_AFC_SENDERS 8               // Getrennte Schätzungen im Modus "je Sender" (Median aller Sender)
+#define LORA_AFC_KEY_MAX_BYTES 4         // Längste Senderkennung in den Nutzdaten
+#define LORA_AFC_ALPHA 0.125f            // Glättung des gleitenden Mittels nach der Anlaufphase
+#define LORA_AFC_MIN_SAMPLES 5           // Messwerte je Schätzung, bevor sie zählt
+#define LORA_AFC_OUTLIER_FACTOR 4.0f     // Ausreißer: Abweichung größer als Faktor * mittlere Abweichung
+#define LORA_AFC_MIN_DEVIATION_HZ 150.0f // Untergrenze der mittleren Abweichung in der Ausreißerprüfung
+#define LORA_AFC_OUTLIER_RUN 4           // Aufeinanderfolgende Ausreißer gelten als Sprung (Neustart der Schätzung)
+#define LORA_AFC_SENDER_TIMEOUT_MS 900000 // Sender ohne Paket in dieser Zeit zählen nicht mehr
+#define LORA_AFC_HYSTERESIS_HZ 400       // Kleinere Fehler werden nicht korrigiert
+#define LORA_AFC_MAX_STEP_HZ 2000        // Größte Korrektur je Schritt
+#define LORA_AFC_MIN_INTERVAL_MS 60000   // Mindestabstand zweier Korrekturen
+#define LORA_AFC_MAX_CORRECTION_KHZ 20.0f // Größte Abweichung vom Ausgangs-Offset
+#define LORA_AFC_ERROR_SIGN 1            // +1: positiver Fehler = Sender liegt höher, Offset wird erhöht
+#define LORA_AFC_HISTORY 8               // Gespeicherte Korrekturen
+
+//================================================================================
+// Scheduler der Hauptschleife (siehe scheduler.h, Statistik per 'tasks'-Befehl)
+//================================================================================
+#define SCHEDULER_RX_FALLBACK_MS 10 // Empfangsaufgabe zusätzlich periodisch (Haltezeit der Dedup, Gegendruck)
+#define SCHEDULER_AFC_PERIOD_MS 1000 // Prüfintervall der Frequenzkorrektur
+#define SCHEDULER_TIME_PERIOD_MS 60000 // Fortschreiben der Zeitbasis (micros() läuft nach 71 min über)
+
+//================================================================================
+// Energieprofile (siehe power.h, Auswahl per 'power'-Befehl)
+//================================================================================
+#define POWER_PROFILE_DEFAULT 0         // 0 = dauerhaft, 1 = Ruhe mit WFI, 2 = zusätzlich Duty-Cycle-Empfang
+#define POWER_MCU_WAKE_US 2             // Wecken aus WFI bis zur Hauptschleife (Interrupt-Eintritt und Rückkehr)
+#define POWER_MCU_RUN_MA 36.0f          // STM32F103 bei 72 MHz, Peripherie aktiv
+#define POWER_MCU_SLEEP_MA 14.4f        // STM32F103 im Sleep-Modus (WFI), Peripherie aktiv
+#define POWER_RADIO_RX_MA 4.6f          // SX1262 im Empfang (DC-DC)
+#define POWER_RADIO_STANDBY_MA 0.6f     // SX1262 im Standby (RC), Anteil der Wechsel im Duty-Cycle
+#define POWER_RADIO_SLEEP_MA 0.0012f    // SX1262 im Schlaf (warm start, RTC an)
+#define POWER_IDLE_AWAKE_DEFAULT 0.05f  // Angenommener Wachanteil für noch nicht gemessene Profile
+
+//================================================================================
+// Sendewarteschlange
+//================================================================================
+#define LORA_TX_QUEUE_SIZE 4          // Anzahl wartender Sendeaufträge
+#define LORA_TX_TIMEOUT_MARGIN_MS 100 // Reserve auf die doppelte Sendedauer bis zum Abbruch
+#define LORA_TX_SCHEDULE_LEAD_US 300  // Startwert: Aufruf von startTransmit() bis Sendebeginn (wird nachgeführt)
+#define LORA_TX_SCHEDULE_GUARD_US 2000 // Ab hier läuft die Sendeaufgabe vor jeder anderen Aufgabe, kein WFI
+#define LORA_TX_SCHEDULE_SPIN_US 100  // Nur so lange vor dem Sendezeitpunkt wartet sie aktiv (Modul gesperrt)
+#define LORA_TX_SCHEDULE_LATE_US 1000 // Größere Verspätung: geplanter Auftrag wird verworfen
+#define LORA_TX_SCHEDULE_MAX_AHEAD_MS 600000 // Weiteste Vorausplanung eines Sendezeitpunkts
+
+//================================================================================
+// Listen-before-talk (Kanalprüfung per CAD vor jedem Senden)
+//================================================================================
+#define LORA_LBT_ENABLED_DEFAULT false // Per 'lbt'-Befehl umschaltbar
+#define LORA_LBT_MAX_RETRIES 6         // Belegte Prüfungen je Paket, danach wird es verworfen
+#define LORA_LBT_SLOT_SYMBOLS 8        // Grundeinheit der Wartezeit in Symbolen
+#define LORA_LBT_MAX_BACKOFF_EXP 5     // Zufällige Wartezeit höchstens Slot * 2^5
+
+//================================================================================
+// Blockübertragung großer Nutzdaten (siehe bulk.h, per 'bulk'-Befehl einschaltbar)
+//================================================================================
+#define LORA_BULK_ENABLED_DEFAULT false // Aus: Rahmen mit Kennbyte 0xB5 werden normal publiziert
+#define LORA_BULK_BUFFER_SIZE 3072      // Gemeinsamer Puffer für eine Übertragung (16 Fragmente, Bitmaske erlaubt max. 32)
+#define LORA_BULK_FRAGMENT_SIZE 200     // Nutzdaten je Fragment (max. 250)
+#define LORA_BULK_WINDOW 4              // Fragmente je Sendefenster (max. LORA_TX_QUEUE_SIZE)
+#define LORA_BULK_ACK_MARGIN_MS 1500    // Wartezeit auf die Quittung zusätzlich zu ihrer Sendedauer
+#define LORA_BULK_MAX_RETRIES 5         // Zeitüberschreitungen ohne Fortschritt bis zum Abbruch
+#define LORA_BULK_RX_TIMEOUT_MS 30000   // Unvollständige Empfangsübertragung danach verwerfen
+#define LORA_BULK_EVENT_CHUNK 192       // Bytes je 'lora_bulk_data'-Datensatz an den Host
+
+//================================================================================
+// Kanalscan (mehrere Profile reihum per CAD abhören, siehe lora.h)
+//================================================================================
+#define LORA_SCAN_MAX_CHANNELS 4       // Kanäle in der Scan-Liste
+#define LORA_SCAN_MAX_WEIGHT 8         // Höchstes Gewicht (Besuche je Umlauf) eines Kanals
+#define LORA_SCAN_DWELL_MS_DEFAULT 0   // Mindestverweildauer je Besuch (0 = eine CAD)
+#define LORA_SCAN_LOCK_MARGIN_MS 50    // Reserve auf die längste Paketdauer nach erkannter Präambel
+#define LORA_SCAN_NO_CHANNEL 0xFF      // Kanalkennung für Pakete außerhalb des Scans
+
+//================================================================================
+// Kompression der Nutzdaten (siehe compress.h)
+//================================================================================
+#define LORA_COMPRESS_TX_DEFAULT false   // Gesendete Pakete komprimieren, falls kürzer
+#define LORA_COMPRESS_RX_DEFAULT false   // Empfangene Pakete mit Kennbyte 0xC5/0xC6 entpacken
+#define LORA_COMPRESS_DICT_DEFAULT true  // Eingebautes Telemetrie-Wörterbuch beim Senden verwenden
 
-// ======================================================================
-// === Meshtastic Long Fast =====================================       
-// ======================================================================
-//#define LORA_FREQUENCY      869.525       // LoRa Frequenz in MHz
-//#define LORA_BW             250.0       // LoRa Bandbreite in kHz (z.B. 125.0, 250.0, 500.0)
-//#define LORA_SF             11           // LoRa Spreading Factor (z.B. 7, 8, 9, 10, 11, 12)
-//#define LORA_CR             5           // LoRa Coding Rate (z.B. 5, 6, 7, 8)
-//#define LORA_SYNC_WORD      0x1B        // LoRa Synchronisationswort (Standard: 0x12 für Public, 0x34 für Private)
-//#define LORA_TX_POWER       22          // LoRa Sendeleistung in dBm (0 bis 22 dBm)
-//#define LORA_PREAMBLE       16           // LoRa Präambellänge (Standard: 8 für SX126x)
-
-// ======================================================================
-// === MeshCore  =====================================       
-// ======================================================================
-//#define LORA_FREQUENCY      869.618       // LoRa Frequenz in MHz
-//#define LORA_BW             62.5       // LoRa Bandbreite in kHz (z.B. 125.0, 250.0, 500.0)
-//#define LORA_SF             8           // LoRa Spreading Factor (z.B. 7, 8, 9, 10, 11, 12)
-//#define LORA_CR             8           // LoRa Coding Rate (z.B. 5, 6, 7, 8)
-//#define LORA_SYNC_WORD      0x12        // LoRa Synchronisationswort (Standard: 0x12 für Public, 0x34 für Private)
-//#define LORA_TX_POWER       22          // LoRa Sendeleistung in dBm (0 bis 22 dBm)
-//#define LORA_PREAMBLE       16           // LoRa Präambellänge (Standard: 8 für SX126x)
\ No newline at end of file
+//================================================================================
+// Verschlüsselung der Nutzdaten (siehe crypto.h, Schlüssel per 'crypto'-Befehl)
+//================================================================================
+#define LORA_CRYPTO_TX_DEFAULT false      // Gesendete Pakete verschlüsseln (nur mit Schlüssel)
+#define LORA_CRYPTO_RX_DEFAULT false      // Empfangene Pakete mit Kennbyte 0xC7 entschlüsseln
+#define LORA_CRYPTO_TAG_BYTES 4           // Länge des gekürzten Prüfwerts (4-16, gerade)
+#define LORA_CRYPTO_COUNTER_LEASE 1024    // Im Flash vorab reservierte Zählerstände
+
+//================================================================================
+// Duty-Cycle (ETSI EN 300 220, Teilband 869.4-869.65 MHz: 10 %)
+//================================================================================
+#define LORA_DUTY_CYCLE_PERCENT 10        // Erlaubter Sendeanteil in Prozent (0 = keine Begrenzung)
+#define LORA_DUTY_CYCLE_WINDOW_S 3600     // Beobachtungsfenster in Sekunden
+#define LORA_DUTY_CYCLE_MAX_DEFER_MS 60000 // Längste Wartezeit auf Budget, darüber wird abgelehnt
+
+//================================================================================
+// Profile (eingebaute Profile "meshtastic_longfast" und "meshcore" siehe presets.cpp)
+//================================================================================
+#define LORA_USER_PRESET_SLOTS 4 // Anzahl der Benutzerplätze "user1".."userN" (max. 8)
+
+//================================================================================
+// Dauerhafte Konfiguration (letzte Flash-Seiten, siehe storage.h)
+//================================================================================
+#define CONFIG_STORE_PAGES 2 // Anzahl der reservierten Flash-Seiten à 1 KB (mind. 2)
+
+#endif // CONFIG_H
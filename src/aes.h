@@ -0,0 +1,53 @@
+#ifndef AES_H
+#define AES_H
+
+#include <Arduino.h>
+
+//================================================================================
+// AES-128 und CCM (Software, für den Cortex-M3 ohne Krypto-Hardware)
+//================================================================================
+//
+// Nur die Verschlüsselungsrichtung von AES wird gebraucht: CCM entschlüsselt im Zählermodus.
+// Eine Runde arbeitet spaltenweise mit einer einzigen T-Tabelle (SubBytes und MixColumns
+// zusammengefasst, 1 KB konstant im Flash, um die 20 KB RAM zu schonen; die Wartezyklen des
+// Flash kosten etwas Durchsatz). Die drei übrigen Zeilen ergeben sich durch Rotation, die der
+// Cortex-M3 im zweiten Operanden von EOR kostenlos ausführt. Die S-Box steckt im zweiten Byte.
+// Der Cortex-M3 hat keinen Datencache, die Tabellenzugriffe verraten über die Laufzeit also
+// nichts über Schlüssel oder Daten (auf dem Host gilt das nicht).
+//
+// CCM nach NIST SP 800-38C: CBC-MAC über Längen, zusätzliche Daten und Klartext, danach
+// Zählermodus für Nutzdaten und Prüfwert. Nonce 7-13 Bytes, Prüfwert 4-16 Bytes (gerade).
+
+/**
+ * @brief Erweiterter AES-128-Schlüssel (11 Rundenschlüssel).
+ */
+struct AesKey {
+    uint32_t rk[44];
+};
+
+/**
+ * @brief Erweitert einen 16-Byte-Schlüssel.
+ */
+void aesSetKey(AesKey& key, const uint8_t* raw);
+
+/**
+ * @brief Verschlüsselt einen Block (in und out dürfen gleich sein).
+ */
+void aesEncryptBlock(const AesKey& key, const uint8_t* in, uint8_t* out);
+
+/**
+ * @brief Verschlüsselt 'len' Bytes nach CCM und berechnet den Prüfwert.
+ * @param out Erhält den Geheimtext (darf gleich 'in' sein).
+ * @param tag Erhält 'tagLen' Bytes Prüfwert.
+ */
+void aesCcmEncrypt(const AesKey& key, const uint8_t* nonce, uint8_t nonceLen, const uint8_t* aad, size_t aadLen,
+                   const uint8_t* in, size_t len, uint8_t* out, uint8_t* tag, uint8_t tagLen);
+
+/**
+ * @brief Entschlüsselt nach CCM und prüft den Prüfwert (Vergleich mit fester Laufzeit).
+ * @return false, wenn der Prüfwert nicht passt; 'out' ist dann mit Nullen überschrieben.
+ */
+bool aesCcmDecrypt(const AesKey& key, const uint8_t* nonce, uint8_t nonceLen, const uint8_t* aad, size_t aadLen,
+                   const uint8_t* in, size_t len, uint8_t* out, const uint8_t* tag, uint8_t tagLen);
+
+#endif // AES_H
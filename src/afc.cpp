@@ -0,0 +1,301 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "afc.h"
+#include "lora.h"
+#include "logger.h"
+
+static_assert(LORA_AFC_SENDERS >= 1 && LORA_AFC_SENDERS <= 32, "LORA_AFC_SENDERS außerhalb 1..32");
+static_assert(LORA_AFC_MIN_SAMPLES >= 1, "LORA_AFC_MIN_SAMPLES muss mindestens 1 sein");
+#if LORA_AFC_ENABLED_DEFAULT && !LORA_RX_FREQ_ERROR_DEFAULT
+#error "LORA_AFC_ENABLED_DEFAULT benötigt LORA_RX_FREQ_ERROR_DEFAULT"
+#endif
+
+// Gleitendes Mittel des Frequenzfehlers eines Senders (bzw. aller Pakete)
+struct AfcEstimator {
+  bool used;
+  uint8_t key[LORA_AFC_KEY_MAX_BYTES];
+  uint16_t count;     // Angenommene Messwerte seit dem (Neu-)Start, begrenzt
+  uint8_t outlierRun; // Aufeinanderfolgende Ausreißer
+  float mean_Hz;
+  float deviation_Hz; // Gleitendes Mittel der absoluten Abweichung
+  uint32_t last_ms;
+};
+
+static AfcEstimator estimators[LORA_AFC_SENDERS];
+static AfcAdjustment history[LORA_AFC_HISTORY];
+static uint8_t historyHead = 0;  // Nächster Schreibplatz
+static uint8_t historyCount = 0;
+
+static AfcSettings settings = {LORA_AFC_ENABLED_DEFAULT, false, 0, 1};
+static AfcStats stats = {};
+
+static float referenceOffset_kHz = 0;
+static float expectedOffset_kHz = 0; // Offset nach der letzten eigenen Korrektur
+static bool referenceSet = false;
+static uint32_t lastAdjust_ms = 0;
+static bool adjustedOnce = false;
+static uint32_t ignoreBefore_ms = 0; // Pakete davor wurden noch mit dem alten Offset gemessen
+static uint16_t samplesSinceAdjust = 0;
+
+static void clearEstimators() {
+  memset(estimators, 0, sizeof(estimators));
+  samplesSinceAdjust = 0;
+}
+
+// Der aktuelle Offset wird Ausgangswert aller weiteren Korrekturen
+static void rebase() {
+  LoRaSettings current = getCurrentLoRaSettings();
+  referenceOffset_kHz = current.frequency_offset_kHz;
+  expectedOffset_kHz = current.frequency_offset_kHz;
+  referenceSet = true;
+  ignoreBefore_ms = millis();
+  clearEstimators();
+}
+
+static AfcEstimator* findEstimator(const LoRaRxPacket* packet, uint32_t now_ms) {
+  if (!settings.perSender) {
+    estimators[0].used = true;
+    return &estimators[0];
+  }
+  if (settings.keyOffset + settings.keyLength > packet->len) {
+    return nullptr;
+  }
+  const uint8_t* key = packet->payload + settings.keyOffset;
+
+  // Bekannter Sender, sonst freier oder am längsten stummer Platz
+  AfcEstimator* victim = &estimators[0];
+  for (uint8_t i = 0; i < LORA_AFC_SENDERS; i++) {
+    AfcEstimator& e = estimators[i];
+    if (e.used && memcmp(e.key, key, settings.keyLength) == 0) {
+      return &e;
+    }
+    if (!e.used) {
+      if (victim->used) {
+        victim = &e;
+      }
+    } else if (victim->used && now_ms - e.last_ms > now_ms - victim->last_ms) {
+      victim = &e;
+    }
+  }
+  memset(victim, 0, sizeof(*victim));
+  victim->used = true;
+  memcpy(victim->key, key, settings.keyLength);
+  return victim;
+}
+
+void afcHandlePacket(const LoRaRxPacket* packet) {
+  if (!settings.enabled || isnan(packet->frequencyError) ||
+      (int32_t)(packet->timestamp_ms - ignoreBefore_ms) < 0) {
+    return;
+  }
+  AfcEstimator* e = findEstimator(packet, packet->timestamp_ms);
+  if (e == nullptr) {
+    return;
+  }
+  e->last_ms = packet->timestamp_ms;
+
+  float x = packet->frequencyError;
+  if (e->count == 0) {
+    e->mean_Hz = x;
+    e->deviation_Hz = LORA_AFC_MIN_DEVIATION_HZ;
+    e->count = 1;
+    stats.samples++;
+    samplesSinceAdjust++;
+    return;
+  }
+
+  float residual = x - e->mean_Hz;
+  float spread = e->deviation_Hz > LORA_AFC_MIN_DEVIATION_HZ ? e->deviation_Hz : LORA_AFC_MIN_DEVIATION_HZ;
+  float limit = LORA_AFC_OUTLIER_FACTOR * spread;
+  if (fabsf(residual) > limit) {
+    stats.outliers++;
+    if (++e->outlierRun < LORA_AFC_OUTLIER_RUN) {
+      return;
+    }
+    // Dauerhaft daneben: Der Fehler ist tatsächlich gesprungen (z.B. Temperatur, anderer Sender)
+    stats.restarts++;
+    e->outlierRun = 0;
+    e->mean_Hz = x;
+    e->deviation_Hz = LORA_AFC_MIN_DEVIATION_HZ;
+    e->count = 1;
+    return;
+  }
+  e->outlierRun = 0;
+
+  // In der Anlaufphase arithmetisches Mittel, danach exponentiell geglättet
+  float alpha = e->count < LORA_AFC_MIN_SAMPLES ? 1.0f / (e->count + 1) : LORA_AFC_ALPHA;
+  e->mean_Hz += alpha * residual;
+  e->deviation_Hz += alpha * (fabsf(residual) - e->deviation_Hz);
+  if (e->count < 0xFFFF) {
+    e->count++;
+  }
+  stats.samples++;
+  if (samplesSinceAdjust < 0xFFFF) {
+    samplesSinceAdjust++;
+  }
+}
+
+// Median der ausreichend belegten, nicht verwaisten Schätzungen
+static bool combinedEstimate(uint32_t now_ms, float& estimate_Hz, float& deviation_Hz, uint8_t& senders) {
+  float means[LORA_AFC_SENDERS];
+  float deviations[LORA_AFC_SENDERS];
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < LORA_AFC_SENDERS; i++) {
+    const AfcEstimator& e = estimators[i];
+    if (!e.used || e.count < LORA_AFC_MIN_SAMPLES || now_ms - e.last_ms > LORA_AFC_SENDER_TIMEOUT_MS) {
+      continue;
+    }
+    // Einfügen in sortierter Reihenfolge
+    uint8_t j = n++;
+    for (; j > 0 && means[j - 1] > e.mean_Hz; j--) {
+      means[j] = means[j - 1];
+      deviations[j] = deviations[j - 1];
+    }
+    means[j] = e.mean_Hz;
+    deviations[j] = e.deviation_Hz;
+  }
+  senders = n;
+  if (n == 0) {
+    return false;
+  }
+  if (n % 2 == 1) {
+    estimate_Hz = means[n / 2];
+    deviation_Hz = deviations[n / 2];
+  } else {
+    estimate_Hz = (means[n / 2 - 1] + means[n / 2]) / 2;
+    deviation_Hz = (deviations[n / 2 - 1] + deviations[n / 2]) / 2;
+  }
+  return true;
+}
+
+static void recordAdjustment(uint32_t now_ms, int16_t step_Hz, float offset_kHz, int32_t estimate_Hz) {
+  history[historyHead] = {now_ms, step_Hz, offset_kHz, estimate_Hz};
+  historyHead = (historyHead + 1) % LORA_AFC_HISTORY;
+  if (historyCount < LORA_AFC_HISTORY) {
+    historyCount++;
+  }
+}
+
+void handleAfc() {
+  if (!settings.enabled) {
+    return;
+  }
+  LoRaSettings current = getCurrentLoRaSettings();
+  if (!referenceSet || current.frequency_offset_kHz != expectedOffset_kHz) {
+    // Offset wurde von Hand geändert: Er gilt als neuer Ausgangswert
+    rebase();
+    return;
+  }
+
+  uint32_t now_ms = millis();
+  if (adjustedOnce && now_ms - lastAdjust_ms < LORA_AFC_MIN_INTERVAL_MS) {
+    return;
+  }
+  if (samplesSinceAdjust < LORA_AFC_MIN_SAMPLES) {
+    return;
+  }
+  float estimate_Hz, deviation_Hz;
+  uint8_t senders;
+  if (!combinedEstimate(now_ms, estimate_Hz, deviation_Hz, senders) || fabsf(estimate_Hz) < LORA_AFC_HYSTERESIS_HZ) {
+    return;
+  }
+  // Nicht in einen Sendevorgang hinein umstimmen; die Korrektur folgt bei leerer Warteschlange
+  if (getLoRaTxQueueCount() != 0) {
+    return;
+  }
+
+  float step_Hz = estimate_Hz;
+  if (step_Hz > LORA_AFC_MAX_STEP_HZ) {
+    step_Hz = LORA_AFC_MAX_STEP_HZ;
+  } else if (step_Hz < -LORA_AFC_MAX_STEP_HZ) {
+    step_Hz = -LORA_AFC_MAX_STEP_HZ;
+  }
+  float target_kHz = current.frequency_offset_kHz + LORA_AFC_ERROR_SIGN * step_Hz / 1000.0f;
+  if (target_kHz > referenceOffset_kHz + LORA_AFC_MAX_CORRECTION_KHZ) {
+    target_kHz = referenceOffset_kHz + LORA_AFC_MAX_CORRECTION_KHZ;
+  } else if (target_kHz < referenceOffset_kHz - LORA_AFC_MAX_CORRECTION_KHZ) {
+    target_kHz = referenceOffset_kHz - LORA_AFC_MAX_CORRECTION_KHZ;
+  }
+  float applied_Hz = (target_kHz - current.frequency_offset_kHz) * 1000.0f * LORA_AFC_ERROR_SIGN;
+
+  lastAdjust_ms = now_ms;
+  adjustedOnce = true;
+  if (fabsf(applied_Hz) < LORA_AFC_HYSTERESIS_HZ) {
+    stats.limited++;
+    logEvent<LOG_AFC_LIMIT>((int32_t)estimate_Hz, current.frequency_offset_kHz);
+    return;
+  }
+
+  LoRaSettings target = current;
+  target.frequency_offset_kHz = target_kHz;
+  if (applyLoRaSettings(target).startsWith("ERROR")) {
+    return;
+  }
+  expectedOffset_kHz = getCurrentLoRaSettings().frequency_offset_kHz;
+
+  // Die Schätzungen beziehen sich ab jetzt auf den neuen Offset
+  for (uint8_t i = 0; i < LORA_AFC_SENDERS; i++) {
+    estimators[i].mean_Hz -= applied_Hz;
+  }
+  ignoreBefore_ms = millis();
+  samplesSinceAdjust = 0;
+  stats.adjustments++;
+  recordAdjustment(now_ms, (int16_t)lroundf(applied_Hz), expectedOffset_kHz, (int32_t)estimate_Hz);
+  logEvent<LOG_AFC_ADJUST>(current.frequency_offset_kHz, expectedOffset_kHz, (int32_t)estimate_Hz);
+}
+
+void setAfcSettings(const AfcSettings& requested) {
+  AfcSettings next = requested;
+  if (next.keyLength < 1) {
+    next.keyLength = 1;
+  } else if (next.keyLength > LORA_AFC_KEY_MAX_BYTES) {
+    next.keyLength = LORA_AFC_KEY_MAX_BYTES;
+  }
+  bool keyChanged = next.perSender != settings.perSender || next.keyOffset != settings.keyOffset ||
+                    next.keyLength != settings.keyLength;
+  bool switchedOn = next.enabled && !settings.enabled;
+  settings = next;
+
+  if (switchedOn) {
+    setLoRaRxFrequencyErrorEnabled(true);
+    rebase();
+  } else if (keyChanged) {
+    clearEstimators();
+  }
+}
+
+AfcSettings getAfcSettings() {
+  return settings;
+}
+
+AfcStats getAfcStats() {
+  AfcStats result = stats;
+  float estimate_Hz = 0, deviation_Hz = 0;
+  result.valid = combinedEstimate(millis(), estimate_Hz, deviation_Hz, result.senders);
+  result.estimate_Hz = (int32_t)lroundf(estimate_Hz);
+  result.deviation_Hz = (int32_t)lroundf(deviation_Hz);
+  result.reference_kHz = referenceSet ? referenceOffset_kHz : getCurrentLoRaSettings().frequency_offset_kHz;
+  return result;
+}
+
+float getAfcReferenceOffset() {
+  float current_kHz = getCurrentLoRaSettings().frequency_offset_kHz;
+  return referenceSet && current_kHz == expectedOffset_kHz ? referenceOffset_kHz : current_kHz;
+}
+
+uint8_t getAfcHistoryCount() {
+  return historyCount;
+}
+
+AfcAdjustment getAfcHistory(uint8_t index) {
+  return history[(historyHead + LORA_AFC_HISTORY - 1 - index) % LORA_AFC_HISTORY];
+}
+
+void resetAfc() {
+  stats = {};
+  historyHead = 0;
+  historyCount = 0;
+  adjustedOnce = false;
+  rebase();
+}
@@ -0,0 +1,102 @@
+#ifndef AFC_H
+#define AFC_H
+
+#include <Arduino.h>
+#include "0_config.h"
+#include "rxbuffer.h"
+
+//================================================================================
+// Automatische Frequenzkorrektur (AFC) aus dem gemessenen Frequenzfehler
+//================================================================================
+//
+// Jedes fehlerfrei empfangene Paket mit Frequenzfehler fließt in ein gleitendes Mittel mit
+// Ausreißerunterdrückung: Messwerte, die mehr als LORA_AFC_OUTLIER_FACTOR mittlere Abweichungen
+// vom Mittel entfernt liegen, werden verworfen. Folgen LORA_AFC_OUTLIER_RUN Ausreißer
+// aufeinander, gilt das als echter Sprung und die Schätzung beginnt neu.
+//
+// Im Modus "je Sender" führt jede Senderkennung (Bytes ab 'keyOffset' in den Nutzdaten) eine
+// eigene Schätzung; korrigiert wird um den Median aller Sender. Ein einzelner Sender mit
+// schlecht abgeglichenem Quarz verschiebt den Offset so nicht.
+//
+// handleAfc() korrigiert 'frequency_offset_kHz' über applyLoRaSettings(), sobald die Schätzung
+// die Hysterese übersteigt: höchstens LORA_AFC_MAX_STEP_HZ je Schritt, frühestens nach
+// LORA_AFC_MIN_INTERVAL_MS und nie weiter als LORA_AFC_MAX_CORRECTION_KHZ vom Offset beim
+// Einschalten. Die Korrektur wird nicht im Flash gespeichert: saveStoredConfig() sichert den
+// Ausgangswert (getAfcReferenceOffset()), nach einem Neustart beginnt die Schätzung neu.
+
+/**
+ * @brief Einstellungen der Frequenzkorrektur.
+ */
+struct AfcSettings {
+    bool enabled;
+    bool perSender;    // Getrennte Schätzung je Senderkennung
+    uint8_t keyOffset; // Erstes Byte der Senderkennung in den Nutzdaten
+    uint8_t keyLength; // Länge der Senderkennung (1 bis LORA_AFC_KEY_MAX_BYTES)
+};
+
+/**
+ * @brief Zähler und aktueller Stand der Schätzung.
+ */
+struct AfcStats {
+    uint32_t samples;     // Verwendete Messwerte
+    uint32_t outliers;    // Verworfene Ausreißer
+    uint32_t restarts;    // Neu begonnene Schätzungen nach einem Sprung
+    uint32_t adjustments; // Angewendete Korrekturen
+    uint32_t limited;     // Korrekturen, die an LORA_AFC_MAX_CORRECTION_KHZ scheiterten
+    bool valid;           // Schätzung ausreichend belegt
+    int32_t estimate_Hz;  // Geschätzter Frequenzfehler (Median über die Sender)
+    int32_t deviation_Hz; // Mittlere Abweichung der Messwerte
+    uint8_t senders;      // Zur Schätzung beitragende Sender
+    float reference_kHz;  // Offset beim Einschalten bzw. nach einer manuellen Änderung
+};
+
+/**
+ * @brief Eine angewendete Korrektur.
+ */
+struct AfcAdjustment {
+    uint32_t time_ms;
+    int16_t step_Hz;     // Korrektur des Offsets
+    float offset_kHz;    // Offset danach
+    int32_t estimate_Hz; // Auslösende Schätzung
+};
+
+/**
+ * @brief Übernimmt den Frequenzfehler eines fehlerfrei empfangenen Pakets in die Schätzung.
+ *        Pakete ohne Messwert (Messung abgeschaltet) werden ignoriert.
+ */
+void afcHandlePacket(const LoRaRxPacket* packet);
+
+/**
+ * @brief Prüft die Schätzung und korrigiert den Offset bei Bedarf.
+ *        Muss regelmäßig in der Hauptschleife aufgerufen werden.
+ */
+void handleAfc();
+
+/**
+ * @brief Übernimmt neue Einstellungen. Beim Einschalten wird die Frequenzfehler-Messung
+ *        aktiviert und der aktuelle Offset als Ausgangswert gemerkt; ändert sich die
+ *        Senderkennung, beginnen die Schätzungen neu.
+ */
+void setAfcSettings(const AfcSettings& settings);
+AfcSettings getAfcSettings();
+
+AfcStats getAfcStats();
+
+/**
+ * @brief Offset ohne die eigenen Korrekturen der AFC, zum Speichern im Flash. Wurde der Offset
+ *        seit der letzten Korrektur von Hand geändert, ist es der aktuelle Offset.
+ */
+float getAfcReferenceOffset();
+
+/**
+ * @brief Gespeicherte Korrekturen, 0 = neueste.
+ */
+uint8_t getAfcHistoryCount();
+AfcAdjustment getAfcHistory(uint8_t index);
+
+/**
+ * @brief Verwirft Schätzungen, Zähler und Verlauf; der aktuelle Offset wird neuer Ausgangswert.
+ */
+void resetAfc();
+
+#endif // AFC_H
@@ -0,0 +1,146 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "airtime.h"
+
+//--------------------------------------------------------------------------------
+// Sendedauer
+//--------------------------------------------------------------------------------
+
+// Symboldauer in Nanosekunden und Präambel samt Sync-Symbolen in Viertelsymbolen
+static uint32_t symbolTime_ns = 0;
+static uint32_t preambleQuarterSymbols = 0;
+
+// Anzahl der Symbole nach der Präambel (Kopfzeile + Nutzdaten + CRC) je Nutzdatenlänge
+static uint16_t payloadSymbols[256];
+
+static float airtimePerByte_us = 0.0f;
+
+// Symbole nach der Präambel (Kopfzeile + Nutzdaten + CRC) für 'len' Nutzdatenbytes
+static uint16_t countPayloadSymbols(uint16_t len, uint8_t spreadingFactor, uint8_t codingRate, bool ldro) {
+  bool lowSf = spreadingFactor < 7;
+  int32_t bitsPerSymbolGroup = 4 * (spreadingFactor - (ldro ? 2 : 0));
+
+  // Explizite Kopfzeile (20 Bit) und CRC (16 Bit) sind immer aktiv
+  int32_t bits = 8 * (int32_t)len + 16 - 4 * spreadingFactor + 20 + (lowSf ? 0 : 8);
+  if (bits < 0) {
+    bits = 0;
+  }
+  uint32_t groups = (bits + bitsPerSymbolGroup - 1) / bitsPerSymbolGroup;
+  return 8 + groups * codingRate;
+}
+
+void rebuildAirtimeTables(float bandwidth_kHz, uint8_t spreadingFactor, uint8_t codingRate, uint16_t preambleLength) {
+  symbolTime_ns = (uint32_t)(((uint32_t)1 << spreadingFactor) * 1000000.0f / bandwidth_kHz);
+
+  // RadioLib aktiviert die Low-Data-Rate-Optimierung automatisch ab 16 ms Symboldauer
+  bool ldro = symbolTime_ns >= 16000000UL;
+  bool lowSf = spreadingFactor < 7;
+
+  // SF5/6 verwenden 6.25 statt 4.25 Sync-Symbole und keine 8 Bit Kopfzeilenreserve
+  preambleQuarterSymbols = (uint32_t)preambleLength * 4 + (lowSf ? 25 : 17);
+
+  for (uint16_t len = 0; len < 256; len++) {
+    payloadSymbols[len] = countPayloadSymbols(len, spreadingFactor, codingRate, ldro);
+  }
+
+  // Ein Byte entspricht im Mittel 8 / (4 * (SF - 2*LDRO)) Symbolgruppen à 'codingRate' Symbolen
+  int32_t bitsPerSymbolGroup = 4 * (spreadingFactor - (ldro ? 2 : 0));
+  airtimePerByte_us = 8.0f * codingRate * symbolTime_ns / (bitsPerSymbolGroup * 1000.0f);
+}
+
+uint32_t computeAirtimeMicros(float bandwidth_kHz, uint8_t spreadingFactor, uint8_t codingRate,
+                              uint16_t preambleLength, uint8_t len) {
+  uint32_t symbol_ns = (uint32_t)(((uint32_t)1 << spreadingFactor) * 1000000.0f / bandwidth_kHz);
+  bool ldro = symbol_ns >= 16000000UL;
+  uint32_t quarterSymbols = (uint32_t)preambleLength * 4 + (spreadingFactor < 7 ? 25 : 17) +
+                            4UL * countPayloadSymbols(len, spreadingFactor, codingRate, ldro);
+  return (uint32_t)(((uint64_t)quarterSymbols * symbol_ns) / 4000ULL);
+}
+
+uint32_t getAirtimeMicros(uint8_t len) {
+  uint32_t quarterSymbols = preambleQuarterSymbols + 4UL * payloadSymbols[len];
+  return (uint32_t)(((uint64_t)quarterSymbols * symbolTime_ns) / 4000ULL);
+}
+
+float getAirtimePerByteMicros() {
+  return airtimePerByte_us;
+}
+
+uint32_t getSymbolTimeMicros() {
+  return symbolTime_ns / 1000;
+}
+
+//--------------------------------------------------------------------------------
+// Duty-Cycle (Token-Bucket über das gleitende Beobachtungsfenster)
+//--------------------------------------------------------------------------------
+
+// Budget eines vollen Fensters: Anteil * Fensterlänge
+static const uint32_t DUTY_CYCLE_CAPACITY_US = (uint32_t)LORA_DUTY_CYCLE_PERCENT * LORA_DUTY_CYCLE_WINDOW_S * 10000UL;
+
+static uint32_t budget_us = DUTY_CYCLE_CAPACITY_US; // Nach dem Start steht das volle Budget bereit
+static uint32_t lastRefill_ms = 0;
+static DutyCycleStats dutyStats = {0, 0};
+
+// Füllt den Eimer entsprechend der seit dem letzten Aufruf vergangenen Zeit auf
+static void refillDutyCycleBudget() {
+  uint32_t now = millis();
+  uint32_t elapsed_ms = now - lastRefill_ms;
+  lastRefill_ms = now;
+
+  // Pro Millisekunde wächst das Budget um LORA_DUTY_CYCLE_PERCENT * 10 µs
+  uint64_t refilled = (uint64_t)budget_us + (uint64_t)elapsed_ms * LORA_DUTY_CYCLE_PERCENT * 10UL;
+  budget_us = refilled > DUTY_CYCLE_CAPACITY_US ? DUTY_CYCLE_CAPACITY_US : (uint32_t)refilled;
+}
+
+uint32_t getDutyCycleWaitMillis(uint32_t airtime_us, uint32_t queued_us) {
+  if (DUTY_CYCLE_CAPACITY_US == 0) {
+    return 0; // Begrenzung abgeschaltet
+  }
+  refillDutyCycleBudget();
+
+  uint64_t needed = (uint64_t)airtime_us + queued_us;
+  if (needed <= budget_us) {
+    return 0;
+  }
+  uint64_t missing_us = needed - budget_us;
+  uint64_t wait_ms = (missing_us + LORA_DUTY_CYCLE_PERCENT * 10UL - 1) / (LORA_DUTY_CYCLE_PERCENT * 10UL);
+  return wait_ms > UINT32_MAX ? UINT32_MAX : (uint32_t)wait_ms;
+}
+
+bool consumeDutyCycleBudget(uint32_t airtime_us) {
+  if (DUTY_CYCLE_CAPACITY_US == 0) {
+    return true;
+  }
+  refillDutyCycleBudget();
+
+  if (airtime_us > budget_us) {
+    return false;
+  }
+  budget_us -= airtime_us;
+  return true;
+}
+
+void countDutyCycleDeferred() {
+  dutyStats.deferred++;
+}
+
+void countDutyCycleRejected() {
+  dutyStats.rejected++;
+}
+
+uint32_t getDutyCycleBudgetMicros() {
+  if (DUTY_CYCLE_CAPACITY_US == 0) {
+    return 0;
+  }
+  refillDutyCycleBudget();
+  return budget_us;
+}
+
+uint32_t getDutyCycleCapacityMicros() {
+  return DUTY_CYCLE_CAPACITY_US;
+}
+
+DutyCycleStats getDutyCycleStats() {
+  return dutyStats;
+}
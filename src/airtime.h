@@ -0,0 +1,83 @@
+#ifndef AIRTIME_H
+#define AIRTIME_H
+
+#include <Arduino.h>
+
+//================================================================================
+// Sendedauer (Time on Air) und Duty-Cycle-Begrenzung
+//================================================================================
+
+/**
+ * @brief Berechnet die Tabellen für die Sendedauer neu (SX126x-Formel mit expliziter
+ *        Kopfzeile, CRC und automatischer Low-Data-Rate-Optimierung ab 16 ms Symboldauer).
+ *        Muss nach jeder erfolgreichen Änderung der Funkparameter aufgerufen werden.
+ *
+ * @param bandwidth_kHz   Bandbreite in kHz.
+ * @param spreadingFactor Spreading Factor (5-12).
+ * @param codingRate      Coding Rate (5-8, entspricht 4/5 bis 4/8).
+ * @param preambleLength  Präambellänge in Symbolen.
+ */
+void rebuildAirtimeTables(float bandwidth_kHz, uint8_t spreadingFactor, uint8_t codingRate, uint16_t preambleLength);
+
+/**
+ * @brief Sendedauer eines Pakets mit 'len' Nutzdatenbytes in Mikrosekunden (Tabellenzugriff).
+ */
+uint32_t getAirtimeMicros(uint8_t len);
+
+/**
+ * @brief Sendedauer eines Pakets mit beliebigen Funkparametern (ohne Tabellen, z.B. für
+ *        Kanäle des Scan-Modus). Gleiche Formel wie rebuildAirtimeTables().
+ */
+uint32_t computeAirtimeMicros(float bandwidth_kHz, uint8_t spreadingFactor, uint8_t codingRate,
+                              uint16_t preambleLength, uint8_t len);
+
+/**
+ * @brief Mittlere zusätzliche Sendedauer pro Nutzdatenbyte in Mikrosekunden.
+ */
+float getAirtimePerByteMicros();
+
+/**
+ * @brief Dauer eines LoRa-Symbols mit den aktuellen Parametern in Mikrosekunden.
+ */
+uint32_t getSymbolTimeMicros();
+
+/**
+ * @brief Zähler der Duty-Cycle-Begrenzung.
+ */
+struct DutyCycleStats {
+    uint32_t deferred;  // Sendeaufträge, die auf Budget warten mussten
+    uint32_t rejected;  // Abgelehnte Sendeaufträge (Wartezeit zu lang)
+};
+
+/**
+ * @brief Wie lange (in ms) ein Paket mit der Sendedauer 'airtime_us' warten müsste, wenn
+ *        vorher noch 'queued_us' an bereits eingereihter Sendedauer verbraucht wird.
+ * @return 0, wenn sofort genug Budget vorhanden ist.
+ */
+uint32_t getDutyCycleWaitMillis(uint32_t airtime_us, uint32_t queued_us);
+
+/**
+ * @brief Bucht die Sendedauer vom Budget ab, falls genug vorhanden ist.
+ * @return true, wenn gesendet werden darf.
+ */
+bool consumeDutyCycleBudget(uint32_t airtime_us);
+
+/**
+ * @brief Zählt einen zurückgestellten bzw. abgelehnten Sendeauftrag.
+ */
+void countDutyCycleDeferred();
+void countDutyCycleRejected();
+
+/**
+ * @brief Verbleibendes Sendebudget in Mikrosekunden.
+ */
+uint32_t getDutyCycleBudgetMicros();
+
+/**
+ * @brief Größe des Budgets (voller Eimer) in Mikrosekunden; 0 = Begrenzung abgeschaltet.
+ */
+uint32_t getDutyCycleCapacityMicros();
+
+DutyCycleStats getDutyCycleStats();
+
+#endif // AIRTIME_H
@@ -0,0 +1,309 @@
+#include <Arduino.h>
+#include <optional>
+
+#include "0_config.h"
+#include "binproto.h"
+#include "codec.h"
+#include "lora.h"
+#include "command.h"
+#include "serialout.h"
+#include "latency.h"
+#include "bulk.h"
+#include "compress.h"
+#include "crypto.h"
+#include "scratch.h"
+
+// Größter unkodierter Rahmen: Typ + 10 Byte Kopf + 255 Byte Payload + CRC16
+static const size_t BIN_FRAME_MAX_RAW = 1 + 10 + 255 + 2;
+static const size_t BIN_FRAME_MAX_ENCODED = BIN_FRAME_MAX_RAW + BIN_FRAME_MAX_RAW / 254 + 1;
+
+// Länge der Konfigurationsfelder in CONFIG und CONFIG_SET
+static const size_t BIN_CONFIG_LEN = 18;
+
+// Maximale Textlänge in LOG-Rahmen
+static const size_t BIN_LOG_MAX_TEXT = 240;
+
+// Eingangspuffer für einen kodierten Rahmen
+static uint8_t binInputBuffer[BIN_FRAME_MAX_ENCODED];
+static size_t binInputLen = 0;
+static bool binInputOverflow = false;
+
+static uint8_t binRawBuffer[BIN_FRAME_MAX_RAW];
+static uint8_t binEncodedBuffer[BIN_FRAME_MAX_ENCODED + 1];
+
+static inline void putU16(uint8_t* p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static inline void putU32(uint8_t* p, uint32_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  p[2] = (v >> 16) & 0xFF;
+  p[3] = v >> 24;
+}
+
+static inline uint16_t getU16(const uint8_t* p) {
+  return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+static inline void putFloat(uint8_t* p, float v) {
+  memcpy(p, &v, sizeof(v)); // Cortex-M3 ist Little-Endian
+}
+
+static inline float getFloat(const uint8_t* p) {
+  float v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+// Ergänzt den CRC, kodiert den in 'binRawBuffer' vorbereiteten Rahmen und gibt ihn aus.
+static void sendRawFrame(size_t len) {
+  uint16_t crc = crc16_ccitt(binRawBuffer, len);
+  putU16(&binRawBuffer[len], crc);
+  len += 2;
+
+  size_t encodedLen = cobs_encode(binRawBuffer, len, binEncodedBuffer);
+  binEncodedBuffer[encodedLen++] = 0x00; // Rahmenende
+
+  serialOut.beginRecord();
+  serialOut.write(binEncodedBuffer, encodedLen);
+  serialOut.endRecord();
+}
+
+void publishBinaryRx(const uint8_t* payload, size_t len, int16_t rssi, float snr, float frequencyError, uint8_t channel) {
+  if (len > 255) {
+    return;
+  }
+  // Mit Scan-Kanal verschiebt sich der Rest des Rahmens um ein Byte
+  size_t pos = 1;
+  if (channel != LORA_SCAN_NO_CHANNEL) {
+    binRawBuffer[0] = BIN_FRAME_RX_SCAN_EVENT;
+    binRawBuffer[pos++] = channel;
+  } else {
+    binRawBuffer[0] = BIN_FRAME_RX_EVENT;
+  }
+  putU16(&binRawBuffer[pos], (uint16_t)rssi);
+  putU16(&binRawBuffer[pos + 2], (uint16_t)(int16_t)lroundf(snr * 4.0f));
+  putU32(&binRawBuffer[pos + 4], isnan(frequencyError) ? 0 : (uint32_t)(int32_t)lroundf(frequencyError));
+  memcpy(&binRawBuffer[pos + 8], payload, len);
+  sendRawFrame(pos + 8 + len);
+}
+
+void publishBinaryTxDone(uint16_t id, size_t len, int state, uint32_t airtime_us, uint8_t cadBusy, uint32_t backoff_us) {
+  binRawBuffer[0] = BIN_FRAME_TX_DONE;
+  putU16(&binRawBuffer[1], id);
+  binRawBuffer[3] = (uint8_t)len;
+  putU16(&binRawBuffer[4], (uint16_t)(int16_t)state);
+  putU32(&binRawBuffer[6], airtime_us);
+  binRawBuffer[10] = cadBusy;
+  putU32(&binRawBuffer[11], backoff_us);
+  sendRawFrame(15);
+}
+
+void publishBinaryBulkTxDone(uint8_t id, uint16_t len, bool ok, uint8_t fragments, uint16_t retransmissions,
+                             uint16_t timeouts, uint32_t duration_ms) {
+  binRawBuffer[0] = BIN_FRAME_BULK_TX_DONE;
+  binRawBuffer[1] = id;
+  putU16(&binRawBuffer[2], len);
+  binRawBuffer[4] = ok ? 1 : 0;
+  binRawBuffer[5] = fragments;
+  putU16(&binRawBuffer[6], retransmissions);
+  putU16(&binRawBuffer[8], timeouts);
+  putU32(&binRawBuffer[10], duration_ms);
+  sendRawFrame(14);
+}
+
+void publishBinaryBulkRx(uint8_t id, uint16_t len, uint8_t fragments, uint32_t duration_ms) {
+  binRawBuffer[0] = BIN_FRAME_BULK_RX;
+  binRawBuffer[1] = id;
+  putU16(&binRawBuffer[2], len);
+  binRawBuffer[4] = fragments;
+  putU32(&binRawBuffer[5], duration_ms);
+  sendRawFrame(9);
+}
+
+void publishBinaryBulkData(uint8_t id, uint16_t offset, const uint8_t* data, size_t len) {
+  if (len > 255) {
+    return;
+  }
+  binRawBuffer[0] = BIN_FRAME_BULK_DATA;
+  binRawBuffer[1] = id;
+  putU16(&binRawBuffer[2], offset);
+  memcpy(&binRawBuffer[4], data, len);
+  sendRawFrame(4 + len);
+}
+
+static uint8_t logLevelCode(const char* level) {
+  if (strcmp(level, "DEBUG") == 0) return 0;
+  if (strcmp(level, "WARN") == 0) return 2;
+  if (strcmp(level, "ERROR") == 0) return 3;
+  if (strcmp(level, "STATUS") == 0) return 4;
+  return 1; // INFO und Unbekanntes
+}
+
+void publishBinaryLog(const char* level, const char* message) {
+  size_t textLen = strlen(message);
+  if (textLen > BIN_LOG_MAX_TEXT) {
+    textLen = BIN_LOG_MAX_TEXT;
+  }
+  binRawBuffer[0] = BIN_FRAME_LOG;
+  binRawBuffer[1] = logLevelCode(level);
+  memcpy(&binRawBuffer[2], message, textLen);
+  sendRawFrame(2 + textLen);
+}
+
+void publishBinaryLog(const char* level, const String& message) {
+  publishBinaryLog(level, message.c_str());
+}
+
+static void publishBinaryConfig() {
+  LoRaSettings settings = getCurrentLoRaSettings();
+
+  binRawBuffer[0] = BIN_FRAME_CONFIG;
+  putFloat(&binRawBuffer[1], settings.base_frequency_MHz);
+  putFloat(&binRawBuffer[5], settings.frequency_offset_kHz);
+  putFloat(&binRawBuffer[9], settings.bandwidth_kHz);
+  binRawBuffer[13] = settings.spreadingFactor;
+  binRawBuffer[14] = settings.codingRate;
+  binRawBuffer[15] = settings.syncWord;
+  binRawBuffer[16] = (uint8_t)settings.outputPower_dBm;
+  putU16(&binRawBuffer[17], settings.preambleLength);
+  sendRawFrame(1 + BIN_CONFIG_LEN);
+}
+
+static void handleBinaryConfigSet(const uint8_t* data, size_t len) {
+  if (len != 1 + BIN_CONFIG_LEN) {
+    publishBinaryLog("ERROR", "CONFIG_SET mit ungültiger Länge.");
+    return;
+  }
+  uint8_t mask = data[0];
+  const uint8_t* f = &data[1];
+
+  std::optional<float> baseFreq, offset, bw;
+  std::optional<uint8_t> sf, cr, sync;
+  std::optional<int8_t> power;
+  std::optional<uint16_t> preamble;
+
+  if (mask & 0x01) baseFreq = getFloat(&f[0]);
+  if (mask & 0x02) offset   = getFloat(&f[4]);
+  if (mask & 0x04) bw       = getFloat(&f[8]);
+  if (mask & 0x08) sf       = f[12];
+  if (mask & 0x10) cr       = f[13];
+  if (mask & 0x20) sync     = f[14];
+  if (mask & 0x40) power    = (int8_t)f[15];
+  if (mask & 0x80) preamble = getU16(&f[16]);
+
+  String result = setLoraConfig(baseFreq, offset, bw, sf, cr, sync, power, preamble);
+  publishBinaryLog(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+  publishBinaryConfig();
+}
+
+static void handleBinaryTxRequest(const uint8_t* data, size_t len) {
+  // Zu lange Rahmen unverändert durchreichen, queueLoRaPacket lehnt sie mit Fehlermeldung ab
+  // Wie sendLoraPayload im gemeinsamen Arbeitspuffer (siehe scratch.h)
+  uint8_t* payload = packetScratch;
+  uint8_t* txPayload = packetScratch + PACKET_SCRATCH_HALF;
+  uint32_t airtimeSaved = 0;
+  String result;
+  if (len > 0 && len <= PACKET_SCRATCH_HALF) {
+    len = compressForTx(data, len, payload, airtimeSaved);
+    data = payload;
+    if (len == 0) {
+      result = "Payload beginnt mit einem Kennbyte (0xC5-0xC7) und passt eingepackt nicht in 255 Bytes.";
+    } else {
+      // Wie sendLoraPayload: erst komprimieren, dann verschlüsseln
+      size_t txLen = 0;
+      result = encryptForTx(payload, len, txPayload, txLen);
+      data = txPayload;
+      len = txLen;
+    }
+  }
+
+  uint16_t txId = 0;
+  if (result.length() == 0) {
+    result = queueLoRaPacket(data, len, txId);
+  }
+
+  binRawBuffer[0] = BIN_FRAME_TX_QUEUED;
+  putU16(&binRawBuffer[1], txId);
+  sendRawFrame(3);
+
+  if (result.length() > 0) {
+    publishBinaryLog("ERROR", result);
+  }
+}
+
+// Führt einen dekodierten, CRC-geprüften Rahmen aus.
+static bool dispatchBinaryFrame(const uint8_t* frame, size_t len) {
+  const uint8_t* data = &frame[1];
+  size_t dataLen = len - 1;
+
+  switch (frame[0]) {
+    case BIN_FRAME_TX_REQUEST:
+      handleBinaryTxRequest(data, dataLen);
+      break;
+    case BIN_FRAME_CONFIG_GET:
+      publishBinaryConfig();
+      break;
+    case BIN_FRAME_CONFIG_SET:
+      handleBinaryConfigSet(data, dataLen);
+      break;
+    case BIN_FRAME_BULK_APPEND: {
+      String error = bulkAppend(data, dataLen);
+      if (error.length() > 0) {
+        publishBinaryLog("ERROR", error);
+      }
+      break;
+    }
+    case BIN_FRAME_BULK_SEND: {
+      String result = sendBulk();
+      publishBinaryLog(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+      break;
+    }
+    case BIN_FRAME_ESCAPE:
+      return false;
+    default:
+      publishBinaryLog("WARN", "Unbekannter Rahmentyp: 0x" + String(frame[0], HEX));
+      break;
+  }
+  return true;
+}
+
+void resetBinaryInput() {
+  binInputLen = 0;
+  binInputOverflow = false;
+}
+
+bool handleBinaryInputByte(uint8_t c) {
+  if (c != 0x00) {
+    if (binInputLen < sizeof(binInputBuffer)) {
+      binInputBuffer[binInputLen++] = c;
+    } else {
+      binInputOverflow = true;
+    }
+    return true;
+  }
+
+  // Rahmenende erreicht
+  latencyMarkCommandStart();
+  bool stayBinary = true;
+  if (binInputOverflow) {
+    publishBinaryLog("ERROR", "Binärrahmen zu lang, verworfen.");
+  } else if (binInputLen > 0) {
+    size_t rawLen = cobs_decode(binInputBuffer, binInputLen, binRawBuffer, sizeof(binRawBuffer));
+    if (rawLen < 3) {
+      publishBinaryLog("ERROR", "Ungültiger Binärrahmen (COBS).");
+    } else if (crc16_ccitt(binRawBuffer, rawLen - 2) != getU16(&binRawBuffer[rawLen - 2])) {
+      publishBinaryLog("ERROR", "Binärrahmen mit CRC-Fehler verworfen.");
+    } else {
+      latencyRecord(LAT_CMD_PARSE, latencyCommandStart());
+      // Der Rahmen wird aus einer Kopie ausgeführt, da Antworten 'binRawBuffer' wiederverwenden
+      uint8_t frame[BIN_FRAME_MAX_RAW];
+      memcpy(frame, binRawBuffer, rawLen - 2);
+      stayBinary = dispatchBinaryFrame(frame, rawLen - 2);
+    }
+  }
+  resetBinaryInput();
+  return stayBinary;
+}
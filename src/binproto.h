@@ -0,0 +1,93 @@
+#ifndef BINPROTO_H
+#define BINPROTO_H
+
+#include <Arduino.h>
+
+//================================================================================
+// Binäres Rahmenprotokoll (Alternative zum JSON-Protokoll)
+//================================================================================
+//
+// Rahmenaufbau vor der Kodierung:  [Typ][Nutzdaten ...][CRC16 LSB][CRC16 MSB]
+// Der CRC16 (CCITT-FALSE) läuft über Typ und Nutzdaten. Der Rahmen wird COBS-kodiert
+// und mit 0x00 abgeschlossen. Mehrbyte-Werte sind Little-Endian.
+//
+// Gerät -> Host:
+//   RX_EVENT   : int16 RSSI [dBm], int16 SNR [0.25 dB], int32 Frequenzfehler [Hz] (0, wenn abgeschaltet),
+//                Payload roh
+//   RX_SCAN_EVENT: uint8 Profil-Index des Scan-Kanals, danach wie RX_EVENT (nur im Scan-Modus)
+//   TX_DONE    : uint16 ID, uint8 Länge, int16 Status, uint32 Sendedauer [µs],
+//                uint8 belegte Kanalprüfungen, uint32 Wartezeit vor dem Senden [µs]
+//   TX_QUEUED  : uint16 ID (oder 0 bei Fehler, dann folgt ein LOG-Rahmen)
+//   LOG        : uint8 Level (0=DEBUG, 1=INFO, 2=WARN, 3=ERROR, 4=STATUS), Text
+//   CONFIG     : float Basisfrequenz [MHz], float Offset [kHz], float BW [kHz],
+//                uint8 SF, uint8 CR, uint8 Sync, int8 Leistung [dBm], uint16 Präambel
+//   BULK_RX    : uint8 ID, uint16 Länge, uint8 Fragmente, uint32 Dauer [ms] (danach BULK_DATA)
+//   BULK_DATA  : uint8 ID, uint16 Offset, Daten
+//   BULK_TX_DONE: uint8 ID, uint16 Länge, uint8 Ergebnis (1 = quittiert), uint8 Fragmente,
+//                uint16 Wiederholungen, uint16 Zeitüberschreitungen, uint32 Dauer [ms]
+//
+// Host -> Gerät:
+//   TX_REQUEST : Payload roh (1-255 Bytes)
+//   CONFIG_GET : keine Nutzdaten, Antwort ist ein CONFIG-Rahmen
+//   CONFIG_SET : uint8 Maske (Bit 0..7 = Freq, Offset, BW, SF, CR, Sync, Leistung, Präambel),
+//                danach dieselben 18 Bytes wie CONFIG; nur maskierte Felder werden übernommen
+//   BULK_APPEND: Daten roh, werden an den Puffer der Blockübertragung angehängt
+//   BULK_SEND  : keine Nutzdaten, startet die Blockübertragung (Antwort als LOG-Rahmen)
+//   ESCAPE     : keine Nutzdaten, kehrt in den JSON-Modus zurück
+
+enum BinaryFrameType : uint8_t {
+    BIN_FRAME_RX_EVENT   = 0x01,
+    BIN_FRAME_TX_DONE    = 0x02,
+    BIN_FRAME_TX_QUEUED  = 0x03,
+    BIN_FRAME_LOG        = 0x04,
+    BIN_FRAME_CONFIG     = 0x05,
+    BIN_FRAME_BULK_RX    = 0x06,
+    BIN_FRAME_BULK_DATA  = 0x07,
+    BIN_FRAME_BULK_TX_DONE = 0x08,
+    BIN_FRAME_RX_SCAN_EVENT = 0x09,
+
+    BIN_FRAME_TX_REQUEST = 0x81,
+    BIN_FRAME_CONFIG_GET = 0x82,
+    BIN_FRAME_CONFIG_SET = 0x83,
+    BIN_FRAME_BULK_APPEND = 0x84,
+    BIN_FRAME_BULK_SEND  = 0x85,
+    BIN_FRAME_ESCAPE     = 0xFF
+};
+
+/**
+ * @brief Sendet ein empfangenes LoRa-Paket als RX_EVENT-Rahmen bzw. mit Scan-Kanal als RX_SCAN_EVENT.
+ */
+void publishBinaryRx(const uint8_t* payload, size_t len, int16_t rssi, float snr, float frequencyError, uint8_t channel);
+
+/**
+ * @brief Sendet den Abschluss eines Sendeauftrags als TX_DONE-Rahmen.
+ */
+void publishBinaryTxDone(uint16_t id, size_t len, int state, uint32_t airtime_us, uint8_t cadBusy, uint32_t backoff_us);
+
+/**
+ * @brief Sendet die Rahmen der Blockübertragung (siehe publishBulkTxDone() usw. in interface.h).
+ */
+void publishBinaryBulkTxDone(uint8_t id, uint16_t len, bool ok, uint8_t fragments, uint16_t retransmissions,
+                             uint16_t timeouts, uint32_t duration_ms);
+void publishBinaryBulkRx(uint8_t id, uint16_t len, uint8_t fragments, uint32_t duration_ms);
+void publishBinaryBulkData(uint8_t id, uint16_t offset, const uint8_t* data, size_t len);
+
+/**
+ * @brief Sendet eine Log-Nachricht als LOG-Rahmen.
+ */
+void publishBinaryLog(const char* level, const String& message);
+void publishBinaryLog(const char* level, const char* message);
+
+/**
+ * @brief Verarbeitet ein empfangenes Byte im Binärmodus. Ein vollständiger Rahmen
+ *        (abgeschlossen durch 0x00) wird geprüft und ausgeführt.
+ * @return false, wenn ein ESCAPE-Rahmen empfangen wurde und der Binärmodus endet.
+ */
+bool handleBinaryInputByte(uint8_t c);
+
+/**
+ * @brief Verwirft einen eventuell halb empfangenen Rahmen (z.B. beim Moduswechsel).
+ */
+void resetBinaryInput();
+
+#endif // BINPROTO_H
@@ -0,0 +1,415 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "bulk.h"
+#include "lora.h"
+#include "interface.h"
+#include "logger.h"
+#include "airtime.h"
+#include "serialout.h"
+
+static const uint8_t BULK_MAGIC        = 0xB5;
+static const uint8_t BULK_TYPE_DATA    = 0x01;
+static const uint8_t BULK_TYPE_ACK     = 0x02;
+static const uint8_t BULK_FLAG_ACK_REQ = 0x80;
+static const uint8_t BULK_FLAG_NAK     = 0x40;
+static const uint8_t BULK_DATA_HEADER  = 5;
+static const uint8_t BULK_ACK_LEN      = 8;
+
+static const uint8_t BULK_MAX_FRAGMENTS = (LORA_BULK_BUFFER_SIZE + LORA_BULK_FRAGMENT_SIZE - 1) / LORA_BULK_FRAGMENT_SIZE;
+
+static_assert(BULK_MAX_FRAGMENTS <= 32, "Höchstens 32 Fragmente (Bitmaske der Quittung)");
+static_assert(LORA_BULK_FRAGMENT_SIZE + BULK_DATA_HEADER <= 255, "LORA_BULK_FRAGMENT_SIZE zu groß");
+static_assert(LORA_BULK_WINDOW <= LORA_TX_QUEUE_SIZE, "LORA_BULK_WINDOW größer als die Sendewarteschlange");
+
+enum BulkState : uint8_t {
+  BULK_IDLE,
+  BULK_STAGING,      // Host füllt den Sendepuffer
+  BULK_TX_SENDING,   // Nächstes Fenster einreihen (sobald die Warteschlange Platz hat)
+  BULK_TX_WAIT_SENT, // Fenster eingereiht, warten bis es gesendet ist
+  BULK_TX_WAIT_ACK,  // Warten auf die Quittung
+  BULK_RX,           // Fragmente werden empfangen
+  BULK_RX_DELIVER    // Vollständig empfangen, Daten gehen an den Host
+};
+
+static const char* const STATE_NAMES[] = {
+  "idle", "staging", "tx_sending", "tx_wait_sent", "tx_wait_ack", "rx", "rx_deliver"
+};
+
+static uint8_t buffer[LORA_BULK_BUFFER_SIZE];
+static uint16_t length = 0;
+static BulkState state = BULK_IDLE;
+static bool enabled = LORA_BULK_ENABLED_DEFAULT;
+
+// Laufende Übertragung
+static uint8_t transferId = 0;
+static uint8_t nextTransferId = 1;
+static uint8_t fragmentCount = 0;
+static uint32_t doneMask = 0;     // Senden: quittiert, Empfangen: vorhanden
+static uint32_t sentMask = 0;     // Senden: mindestens einmal gesendet
+static uint32_t startMillis = 0;
+static uint32_t deadlineMillis = 0; // Senden: Quittungsfrist, Empfangen: letzte Aktivität
+static uint8_t retriesWithoutProgress = 0;
+static uint16_t transferRetransmissions = 0;
+static uint16_t transferTimeouts = 0;
+static uint16_t deliverOffset = 0;
+static uint8_t completedRxId = 0; // Zuletzt vollständig empfangen (für erneute Quittungen)
+static uint32_t completedRxMillis = 0;
+static uint8_t rejectedRxId = 0;  // Zuletzt abgelehnt (nur einmal melden)
+
+static BulkStats stats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+static inline uint32_t allFragmentsMask(uint8_t count) {
+  return count >= 32 ? 0xFFFFFFFFUL : ((1UL << count) - 1);
+}
+
+static inline uint16_t fragmentLength(uint8_t seq) {
+  return seq + 1 < fragmentCount ? LORA_BULK_FRAGMENT_SIZE : length - (uint16_t)seq * LORA_BULK_FRAGMENT_SIZE;
+}
+
+static inline uint32_t goodputBps(uint16_t bytes, uint32_t duration_ms) {
+  return duration_ms == 0 ? 0 : (uint32_t)((uint64_t)bytes * 8000 / duration_ms);
+}
+
+static void resetTransfer(BulkState next) {
+  state = next;
+  doneMask = 0;
+  sentMask = 0;
+  retriesWithoutProgress = 0;
+  transferRetransmissions = 0;
+  transferTimeouts = 0;
+  deliverOffset = 0;
+}
+
+//--------------------------------------------------------------------------------
+// Senden
+//--------------------------------------------------------------------------------
+
+static void finishSend(bool ok) {
+  uint32_t duration_ms = millis() - startMillis;
+  if (ok) {
+    stats.txTransfers++;
+    stats.txGoodput_bps = goodputBps(length, duration_ms);
+  } else {
+    stats.txFailed++;
+  }
+  publishBulkTxDone(transferId, length, ok, fragmentCount, transferRetransmissions, transferTimeouts, duration_ms);
+  length = 0;
+  resetTransfer(BULK_IDLE);
+}
+
+// Reiht die ältesten noch nicht quittierten Fragmente ein (höchstens ein Fenster bzw. so viele,
+// wie in der Sendewarteschlange Platz haben). Das letzte fordert die Quittung an.
+static void sendWindow() {
+  uint8_t space = LORA_TX_QUEUE_SIZE - getLoRaTxQueueCount();
+  if (space == 0) {
+    return; // Später erneut versuchen
+  }
+  uint8_t window = space < LORA_BULK_WINDOW ? space : LORA_BULK_WINDOW;
+
+  uint8_t picks[LORA_BULK_WINDOW];
+  uint8_t count = 0;
+  for (uint8_t seq = 0; seq < fragmentCount && count < window; seq++) {
+    if (!(doneMask & (1UL << seq))) {
+      picks[count++] = seq;
+    }
+  }
+
+  uint8_t frame[BULK_DATA_HEADER + LORA_BULK_FRAGMENT_SIZE];
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t seq = picks[i];
+    uint16_t fragLen = fragmentLength(seq);
+    frame[0] = BULK_MAGIC;
+    frame[1] = BULK_TYPE_DATA | (i + 1 == count ? BULK_FLAG_ACK_REQ : 0);
+    frame[2] = transferId;
+    frame[3] = seq;
+    frame[4] = fragmentCount;
+    memcpy(&frame[BULK_DATA_HEADER], &buffer[(uint16_t)seq * LORA_BULK_FRAGMENT_SIZE], fragLen);
+
+    uint16_t txId;
+    String error = queueLoRaPacket(frame, BULK_DATA_HEADER + fragLen, txId, false);
+    if (error.length() > 0) {
+      // Z.B. Duty-Cycle-Budget erschöpft: wie eine ausgebliebene Quittung behandeln
+      logEvent<LOG_BULK_QUEUE_FAILED>(transferId, seq);
+      break;
+    }
+    stats.fragmentsSent++;
+    if (sentMask & (1UL << seq)) {
+      stats.retransmissions++;
+      transferRetransmissions++;
+    }
+    sentMask |= 1UL << seq;
+  }
+  state = BULK_TX_WAIT_SENT;
+}
+
+static void handleAck(const uint8_t* frame, size_t len) {
+  if (len < BULK_ACK_LEN || frame[2] != transferId || frame[3] != fragmentCount ||
+      (state != BULK_TX_WAIT_SENT && state != BULK_TX_WAIT_ACK)) {
+    return; // Verspätete Quittung einer früheren Übertragung
+  }
+  if (frame[1] & BULK_FLAG_NAK) {
+    // Der Empfänger hat keinen Platz für die Übertragung, Wiederholen ist zwecklos
+    logEvent<LOG_BULK_TX_REJECTED>(transferId);
+    finishSend(false);
+    return;
+  }
+  uint32_t mask = (uint32_t)frame[4] | ((uint32_t)frame[5] << 8) | ((uint32_t)frame[6] << 16) | ((uint32_t)frame[7] << 24);
+  mask &= allFragmentsMask(fragmentCount);
+
+  if ((doneMask | mask) != doneMask) {
+    retriesWithoutProgress = 0;
+  }
+  doneMask |= mask;
+
+  if (doneMask == allFragmentsMask(fragmentCount)) {
+    finishSend(true);
+  } else if (state == BULK_TX_WAIT_ACK) {
+    state = BULK_TX_SENDING; // Fehlende Fragmente sofort wiederholen
+  }
+}
+
+//--------------------------------------------------------------------------------
+// Empfangen
+//--------------------------------------------------------------------------------
+
+static void sendAck(uint8_t id, uint8_t count, uint32_t mask, bool reject = false) {
+  uint8_t frame[BULK_ACK_LEN] = {
+    BULK_MAGIC, (uint8_t)(BULK_TYPE_ACK | (reject ? BULK_FLAG_NAK : 0)), id, count,
+    (uint8_t)mask, (uint8_t)(mask >> 8), (uint8_t)(mask >> 16), (uint8_t)(mask >> 24)
+  };
+  uint16_t txId;
+  queueLoRaPacket(frame, sizeof(frame), txId, false); // Geht sie verloren, wiederholt der Sender
+}
+
+static void handleData(const uint8_t* frame, size_t len) {
+  uint8_t id = frame[2];
+  uint8_t seq = frame[3];
+  uint8_t count = frame[4];
+  uint16_t dataLen = len - BULK_DATA_HEADER;
+  bool ackRequested = frame[1] & BULK_FLAG_ACK_REQ;
+
+  if (count == 0 || seq >= count || dataLen == 0 || dataLen > LORA_BULK_FRAGMENT_SIZE ||
+      (seq + 1 < count && dataLen != LORA_BULK_FRAGMENT_SIZE)) {
+    return; // Fehlerhafter Rahmen
+  }
+
+  // Gültig, aber größer als der eigene Puffer (Gegenstelle mit größerem LORA_BULK_BUFFER_SIZE)
+  uint32_t total = (uint32_t)(count - 1) * LORA_BULK_FRAGMENT_SIZE + (seq + 1 == count ? dataLen : 1);
+  if (count > BULK_MAX_FRAGMENTS || total > LORA_BULK_BUFFER_SIZE) {
+    if (id != rejectedRxId) {
+      rejectedRxId = id;
+      stats.rxTooLarge++;
+      logEvent<LOG_BULK_RX_TOO_LARGE>(id, total, LORA_BULK_BUFFER_SIZE);
+    }
+    if (state == BULK_RX && id == transferId) {
+      resetTransfer(BULK_IDLE); // Teilweise angenommen, erst das letzte Fragment zeigt die Länge
+      length = 0;
+    }
+    if (ackRequested) {
+      sendAck(id, count, 0, true);
+    }
+    return;
+  }
+
+  // Bereits vollständig empfangen: Die letzte Quittung ging verloren
+  if (id == completedRxId && (state == BULK_IDLE || state == BULK_RX_DELIVER) &&
+      millis() - completedRxMillis < LORA_BULK_RX_TIMEOUT_MS) {
+    stats.rxDuplicates++;
+    if (ackRequested) {
+      sendAck(id, count, allFragmentsMask(count));
+    }
+    return;
+  }
+
+  // Puffer belegt (eigene Übertragung oder Ausgabe an den Host): nicht quittieren
+  if (state != BULK_IDLE && state != BULK_RX) {
+    return;
+  }
+  if (state == BULK_RX && (id != transferId || count != fragmentCount)) {
+    stats.rxIncomplete++; // Neue Übertragung verdrängt die unvollständige
+    state = BULK_IDLE;
+  }
+  if (state == BULK_IDLE) {
+    resetTransfer(BULK_RX);
+    transferId = id;
+    fragmentCount = count;
+    length = 0;
+    startMillis = millis();
+  }
+  deadlineMillis = millis();
+
+  uint32_t bit = 1UL << seq;
+  if (doneMask & bit) {
+    stats.rxDuplicates++;
+  } else {
+    memcpy(&buffer[(uint16_t)seq * LORA_BULK_FRAGMENT_SIZE], &frame[BULK_DATA_HEADER], dataLen);
+    doneMask |= bit;
+    stats.rxFragments++;
+    if (seq + 1 == count) {
+      length = (uint16_t)seq * LORA_BULK_FRAGMENT_SIZE + dataLen;
+    }
+  }
+
+  if (doneMask == allFragmentsMask(count)) {
+    uint32_t duration_ms = millis() - startMillis;
+    stats.rxTransfers++;
+    stats.rxGoodput_bps = goodputBps(length, duration_ms);
+    completedRxId = id;
+    completedRxMillis = millis();
+    sendAck(id, count, doneMask);
+    publishBulkRx(id, length, count, duration_ms);
+    state = BULK_RX_DELIVER;
+    deliverOffset = 0;
+  } else if (ackRequested) {
+    sendAck(id, count, doneMask);
+  }
+}
+
+bool bulkHandlePacket(const LoRaRxPacket* packet) {
+  if (!enabled || packet->len < BULK_DATA_HEADER || packet->payload[0] != BULK_MAGIC) {
+    return false;
+  }
+  uint8_t type = packet->payload[1] & 0x0F;
+  if (type == BULK_TYPE_DATA && packet->len > BULK_DATA_HEADER) {
+    handleData(packet->payload, packet->len);
+    return true;
+  }
+  if (type == BULK_TYPE_ACK) {
+    handleAck(packet->payload, packet->len);
+    return true;
+  }
+  return false;
+}
+
+//--------------------------------------------------------------------------------
+// Hauptschleife und Befehle
+//--------------------------------------------------------------------------------
+
+void handleBulkTransfer() {
+  uint32_t now = millis();
+
+  switch (state) {
+    case BULK_TX_SENDING:
+      sendWindow();
+      break;
+
+    case BULK_TX_WAIT_SENT:
+      // Die Frist beginnt erst, wenn das Fenster (samt Duty-Cycle- und LBT-Wartezeit) gesendet ist
+      if (getLoRaTxQueueCount() == 0) {
+        deadlineMillis = now + getAirtimeMicros(BULK_ACK_LEN) / 1000 + LORA_BULK_ACK_MARGIN_MS;
+        state = BULK_TX_WAIT_ACK;
+      }
+      break;
+
+    case BULK_TX_WAIT_ACK:
+      if ((int32_t)(now - deadlineMillis) >= 0) {
+        stats.ackTimeouts++;
+        transferTimeouts++;
+        if (++retriesWithoutProgress > LORA_BULK_MAX_RETRIES) {
+          finishSend(false);
+        } else {
+          state = BULK_TX_SENDING;
+        }
+      }
+      break;
+
+    case BULK_RX:
+      if (now - deadlineMillis >= LORA_BULK_RX_TIMEOUT_MS) {
+        stats.rxIncomplete++;
+        logEvent<LOG_BULK_RX_INCOMPLETE>(transferId, __builtin_popcount(doneMask), fragmentCount);
+        resetTransfer(BULK_IDLE);
+        length = 0;
+      }
+      break;
+
+    case BULK_RX_DELIVER:
+      // Ein Datensatz pro Aufruf, mit demselben Gegendruck wie beim Empfang
+      if (serialOut.freeSpace() >= SERIAL_OUT_RX_RESERVE) {
+        uint16_t chunk = length - deliverOffset;
+        if (chunk > LORA_BULK_EVENT_CHUNK) {
+          chunk = LORA_BULK_EVENT_CHUNK;
+        }
+        publishBulkData(transferId, deliverOffset, &buffer[deliverOffset], chunk);
+        deliverOffset += chunk;
+        if (deliverOffset >= length) {
+          length = 0;
+          resetTransfer(BULK_IDLE);
+        }
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+String bulkAppend(const uint8_t* data, size_t len) {
+  if (state != BULK_IDLE && state != BULK_STAGING) {
+    return "Blockübertragung läuft (" + String(STATE_NAMES[state]) + ")";
+  }
+  if (state == BULK_IDLE) {
+    length = 0;
+    state = BULK_STAGING;
+  }
+  if (length + len > LORA_BULK_BUFFER_SIZE) {
+    return "Sendepuffer voll (" + String(length) + " + " + String(len) + " > " + String(LORA_BULK_BUFFER_SIZE) + " Bytes)";
+  }
+  memcpy(&buffer[length], data, len);
+  length += len;
+  return "";
+}
+
+String bulkStartSend(uint8_t& id) {
+  if (!enabled) {
+    return "Blockübertragung ist deaktiviert";
+  }
+  if (state != BULK_STAGING || length == 0) {
+    return "Sendepuffer leer (zuerst 'bulkAppend')";
+  }
+
+  resetTransfer(BULK_TX_SENDING);
+  fragmentCount = (length + LORA_BULK_FRAGMENT_SIZE - 1) / LORA_BULK_FRAGMENT_SIZE;
+  transferId = nextTransferId++;
+  if (nextTransferId == 0) {
+    nextTransferId = 1; // 0 kennzeichnet "keine Übertragung"
+  }
+  startMillis = millis();
+  id = transferId;
+  return "";
+}
+
+void bulkAbort() {
+  if (state >= BULK_TX_SENDING && state <= BULK_TX_WAIT_ACK) {
+    finishSend(false);
+  }
+  length = 0;
+  resetTransfer(BULK_IDLE);
+}
+
+void setBulkEnabled(bool value) {
+  enabled = value;
+  if (!enabled) {
+    bulkAbort();
+  }
+}
+
+bool isBulkEnabled() {
+  return enabled;
+}
+
+const char* getBulkStateName() {
+  return STATE_NAMES[state];
+}
+
+uint16_t getBulkLength() {
+  return length;
+}
+
+BulkStats getBulkStats() {
+  return stats;
+}
+
+void resetBulkStats() {
+  stats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+}
@@ -0,0 +1,96 @@
+#ifndef BULK_H
+#define BULK_H
+
+#include <Arduino.h>
+#include "rxbuffer.h"
+
+//================================================================================
+// Blockübertragung großer Nutzdaten (Fragmentierung mit selektiver Wiederholung)
+//================================================================================
+//
+// Der Host füllt den Puffer mit 'bulkAppend' und startet mit 'bulkSend'. Die Daten werden
+// in nummerierte Fragmente zu LORA_BULK_FRAGMENT_SIZE Bytes geteilt und fensterweise
+// (LORA_BULK_WINDOW Fragmente) gesendet; das letzte Fragment eines Fensters fordert eine
+// Quittung an. Die Quittung enthält eine Bitmaske aller empfangenen Fragmente, sodass nur
+// fehlende Fragmente wiederholt werden. Der Empfänger setzt die Fragmente im selben Puffer
+// zusammen und meldet die vollständige Übertragung als ein 'lora_bulk_rx'-Ereignis, dem die
+// Daten in 'lora_bulk_data'-Datensätzen folgen.
+//
+// Es läuft immer nur eine Übertragung (senden oder empfangen), da beide denselben Puffer nutzen.
+//
+// Passt eine Übertragung nicht in den Puffer des Empfängers, beantwortet er angeforderte Quittungen
+// mit einer Ablehnung; der Sender bricht dann sofort ab, statt bis zum Zeitlimit zu wiederholen.
+//
+// Funkrahmen (erstes Byte 0xB5, danach Typ mit Flags und Übertragungsnummer):
+//   DATA : [0xB5][0x01 | 0x80 = Quittung anfordern][ID][Fragment][Anzahl][Daten ...]
+//   ACK  : [0xB5][0x02 | 0x40 = abgelehnt][ID][Anzahl][uint32 Bitmaske der empfangenen Fragmente]
+
+/**
+ * @brief Zähler der Blockübertragung.
+ */
+struct BulkStats {
+    uint32_t txTransfers;      // Vollständig quittierte Übertragungen
+    uint32_t txFailed;         // Abgebrochene Übertragungen (keine Quittung)
+    uint32_t fragmentsSent;    // Gesendete Fragmente einschließlich Wiederholungen
+    uint32_t retransmissions;  // Wiederholte Fragmente
+    uint32_t ackTimeouts;      // Ausgebliebene Quittungen
+    uint32_t txGoodput_bps;    // Nutzdatenrate der letzten gesendeten Übertragung
+    uint32_t rxTransfers;      // Vollständig empfangene Übertragungen
+    uint32_t rxIncomplete;     // Verworfene unvollständige Übertragungen
+    uint32_t rxTooLarge;       // Abgelehnte Übertragungen, die nicht in den Puffer passen
+    uint32_t rxFragments;      // Neu empfangene Fragmente
+    uint32_t rxDuplicates;     // Bereits vorhandene Fragmente (Wiederholungen)
+    uint32_t rxGoodput_bps;    // Nutzdatenrate der letzten empfangenen Übertragung
+};
+
+/**
+ * @brief Nimmt Rahmen der Blockübertragung aus dem Empfangspfad (vor Filter und Dedup).
+ * @return true, wenn das Paket zur Blockübertragung gehört und nicht publiziert werden soll.
+ */
+bool bulkHandlePacket(const LoRaRxPacket* packet);
+
+/**
+ * @brief Treibt Senden, Quittungszeitlimits und die Ausgabe empfangener Daten voran.
+ *        Muss regelmäßig in der Hauptschleife aufgerufen werden.
+ */
+void handleBulkTransfer();
+
+/**
+ * @brief Hängt Daten an den Sendepuffer an.
+ * @return String Leer bei Erfolg, sonst eine Fehlermeldung.
+ */
+String bulkAppend(const uint8_t* data, size_t len);
+
+/**
+ * @brief Startet die Übertragung des gefüllten Sendepuffers.
+ * @param id Erhält die Nummer der Übertragung für das 'lora_bulk_tx_done'-Ereignis.
+ * @return String Leer bei Erfolg, sonst eine Fehlermeldung.
+ */
+String bulkStartSend(uint8_t& id);
+
+/**
+ * @brief Bricht eine laufende Übertragung ab und leert den Puffer.
+ */
+void bulkAbort();
+
+/**
+ * @brief Schaltet die Blockübertragung ein oder aus. Ausgeschaltet werden Rahmen mit
+ *        dem Kennbyte 0xB5 wie jedes andere Paket publiziert.
+ */
+void setBulkEnabled(bool enabled);
+bool isBulkEnabled();
+
+/**
+ * @brief Kurzname des aktuellen Zustands (z.B. "idle", "tx_wait_ack", "rx").
+ */
+const char* getBulkStateName();
+
+/**
+ * @brief Anzahl der Bytes im Puffer (Sendepuffer bzw. bisher bekannte Empfangslänge).
+ */
+uint16_t getBulkLength();
+
+BulkStats getBulkStats();
+void resetBulkStats();
+
+#endif // BULK_H
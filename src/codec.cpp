@@ -1,40 +1,341 @@
-#include <Base64.h> 
 #include <Arduino.h>
 
 #include "codec.h"
 
-void base64_encode(const uint8_t* data, size_t len, String& output) {
-  // 1. Berechnen der benötigten Länge für die Base64-Ausgabe
-  int encodedLen = Base64.encodedLength(len);
-
-  // 2. Erstellen eines temporären Puffers für die Ausgabe
-  char encodedChars[encodedLen + 1];
-
-  // 3. Durchführen der Kodierung direkt mit uint8_t* Daten
-  Base64.encode(encodedChars, (char*)data, len);
-  
-  // 4. Sicherstellen, dass das Ergebnis Null-terminiert ist
-  encodedChars[encodedLen] = '\0';
-  
-  // 5. Zuweisen des Ergebnisses zum output-String
-  output = String(encodedChars);
-}
-
-void base64_decode(const String& input, uint8_t* output, size_t& outputLen) {
-  // Länge des Base64-Eingabe-Strings ermitteln
-  size_t inputLength = input.length();
-  
-  // Erstelle eine mutable Kopie des Eingabe-Strings, da die Base64-Bibliothek
-  // einen char* (nicht-konstant) für die Dekodierung erwartet.
-  char mutableInputChars[inputLength + 1];
-  input.toCharArray(mutableInputChars, inputLength + 1);
-
-  // 1. Berechnen der benötigten Länge für den dekodierten String
-  int decodedLen = Base64.decodedLength(mutableInputChars, inputLength);
-
-  // 2. Durchführen der Dekodierung direkt in den output-Buffer
-  Base64.decode((char*)output, mutableInputChars, inputLength);
-  
-  // 3. Länge zurückgeben
-  outputLen = decodedLen;
-}
\ No newline at end of file
+static const char BASE64_ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Rückwärtstabelle: Zeichen -> 6-Bit-Wert, 0xFF für ungültige Zeichen
+static const uint8_t BASE64_DECODE_TABLE[256] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,   62, 0xFF, 0xFF, 0xFF,   63,
+    52,   53,   54,   55,   56,   57,   58,   59,   60,   61, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF,    0,    1,    2,    3,    4,    5,    6,    7,    8,    9,   10,   11,   12,   13,   14,
+    15,   16,   17,   18,   19,   20,   21,   22,   23,   24,   25, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF,   26,   27,   28,   29,   30,   31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+    41,   42,   43,   44,   45,   46,   47,   48,   49,   50,   51, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+void base64_encode(const uint8_t* data, size_t len, Print& output) {
+  // Kodierung in Blöcken zu 48 Eingabebytes (= 64 Zeichen) auf dem Stack
+  char chunk[64];
+  size_t chunkLen = 0;
+  size_t i = 0;
+
+  while (i + 3 <= len) {
+    uint32_t triple = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | data[i + 2];
+    chunk[chunkLen++] = BASE64_ALPHABET[(triple >> 18) & 0x3F];
+    chunk[chunkLen++] = BASE64_ALPHABET[(triple >> 12) & 0x3F];
+    chunk[chunkLen++] = BASE64_ALPHABET[(triple >> 6) & 0x3F];
+    chunk[chunkLen++] = BASE64_ALPHABET[triple & 0x3F];
+    i += 3;
+
+    if (chunkLen == sizeof(chunk)) {
+      output.write(chunk, chunkLen);
+      chunkLen = 0;
+    }
+  }
+
+  // Rest (1 oder 2 Bytes) mit Padding
+  size_t remaining = len - i;
+  if (remaining > 0) {
+    uint32_t triple = (uint32_t)data[i] << 16;
+    if (remaining == 2) {
+      triple |= (uint32_t)data[i + 1] << 8;
+    }
+    chunk[chunkLen++] = BASE64_ALPHABET[(triple >> 18) & 0x3F];
+    chunk[chunkLen++] = BASE64_ALPHABET[(triple >> 12) & 0x3F];
+    chunk[chunkLen++] = (remaining == 2) ? BASE64_ALPHABET[(triple >> 6) & 0x3F] : '=';
+    chunk[chunkLen++] = '=';
+  }
+
+  if (chunkLen > 0) {
+    output.write(chunk, chunkLen);
+  }
+}
+
+size_t base64_decoded_length(const char* input, size_t inputLength) {
+  // Padding am Ende ignorieren
+  while (inputLength > 0 && input[inputLength - 1] == '=') {
+    inputLength--;
+  }
+  return (inputLength * 3) / 4;
+}
+
+bool base64_decode(const char* input, size_t inputLength, uint8_t* output, size_t outputSize, size_t& outputLen) {
+  outputLen = 0;
+
+  // Bis zu zwei Padding-Zeichen am Ende abtrennen
+  size_t padding = 0;
+  while (inputLength > 0 && input[inputLength - 1] == '=' && padding < 2) {
+    inputLength--;
+    padding++;
+  }
+  // Mit Padding muss die Gesamtlänge ein Vielfaches von 4 sein; ein einzelnes Restzeichen ist nie gültig
+  if ((padding > 0 && (inputLength + padding) % 4 != 0) || inputLength % 4 == 1) {
+    return false;
+  }
+
+  size_t decodedLen = (inputLength * 3) / 4;
+  if (decodedLen > outputSize) {
+    return false;
+  }
+
+  size_t in = 0;
+  size_t out = 0;
+  while (in + 4 <= inputLength) {
+    uint8_t a = BASE64_DECODE_TABLE[(uint8_t)input[in]];
+    uint8_t b = BASE64_DECODE_TABLE[(uint8_t)input[in + 1]];
+    uint8_t c = BASE64_DECODE_TABLE[(uint8_t)input[in + 2]];
+    uint8_t d = BASE64_DECODE_TABLE[(uint8_t)input[in + 3]];
+    if ((a | b | c | d) & 0x80) { // Gültige Werte sind < 64
+      return false;
+    }
+    uint32_t triple = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6) | d;
+    output[out++] = triple >> 16;
+    output[out++] = (triple >> 8) & 0xFF;
+    output[out++] = triple & 0xFF;
+    in += 4;
+  }
+
+  // Rest aus 2 oder 3 Zeichen ergibt 1 oder 2 Bytes
+  size_t remaining = inputLength - in;
+  if (remaining > 0) {
+    uint8_t a = BASE64_DECODE_TABLE[(uint8_t)input[in]];
+    uint8_t b = BASE64_DECODE_TABLE[(uint8_t)input[in + 1]];
+    uint8_t c = (remaining == 3) ? BASE64_DECODE_TABLE[(uint8_t)input[in + 2]] : 0;
+    if ((a | b | c) & 0x80) {
+      return false;
+    }
+    uint32_t triple = ((uint32_t)a << 18) | ((uint32_t)b << 12) | ((uint32_t)c << 6);
+    output[out++] = triple >> 16;
+    if (remaining == 3) {
+      output[out++] = (triple >> 8) & 0xFF;
+    }
+  }
+
+  outputLen = out;
+  return true;
+}
+
+size_t cobs_encode(const uint8_t* input, size_t len, uint8_t* output) {
+  size_t codeIndex = 0; // Position des aktuellen Längenbytes
+  size_t outIndex = 1;
+  uint8_t code = 1;
+
+  for (size_t i = 0; i < len; i++) {
+    if (input[i] == 0) {
+      output[codeIndex] = code;
+      codeIndex = outIndex++;
+      code = 1;
+    } else {
+      output[outIndex++] = input[i];
+      code++;
+      if (code == 0xFF) { // Maximale Blocklänge erreicht
+        output[codeIndex] = code;
+        codeIndex = outIndex++;
+        code = 1;
+      }
+    }
+  }
+  output[codeIndex] = code;
+
+  return outIndex;
+}
+
+size_t cobs_decode(const uint8_t* input, size_t len, uint8_t* output, size_t outputSize) {
+  size_t inIndex = 0;
+  size_t outIndex = 0;
+
+  while (inIndex < len) {
+    uint8_t code = input[inIndex++];
+    if (code == 0 || inIndex + code - 1 > len) {
+      return 0; // Null-Byte im Rahmen oder Block über das Rahmenende hinaus
+    }
+    for (uint8_t i = 1; i < code; i++) {
+      if (outIndex >= outputSize || input[inIndex] == 0) {
+        return 0;
+      }
+      output[outIndex++] = input[inIndex++];
+    }
+    // Nach einem kurzen Block folgt ein implizites Null-Byte (außer am Rahmenende)
+    if (code != 0xFF && inIndex < len) {
+      if (outIndex >= outputSize) {
+        return 0;
+      }
+      output[outIndex++] = 0;
+    }
+  }
+
+  return outIndex;
+}
+
+// Suchtabelle der LZ-Kompression: letzte Position (+1) je Hash über drei Bytes
+#define LZ_HASH_BITS 7
+#define LZ_MIN_MATCH 3
+#define LZ_MAX_LITERALS 32
+#define LZ_MAX_OFFSET 8192
+#define LZ_MAX_MATCH (7 + 255 + 2)
+
+static uint16_t lzHashTable[1 << LZ_HASH_BITS];
+
+// Wörterbuch und Eingabe als ein zusammenhängender Verlauf, ohne sie zu kopieren
+struct LzWindow {
+  const uint8_t* dict;
+  size_t dictLen;
+  const uint8_t* input;
+
+  inline uint8_t at(size_t pos) const {
+    return pos < dictLen ? dict[pos] : input[pos - dictLen];
+  }
+};
+
+static inline uint16_t lzHash(const LzWindow& w, size_t pos) {
+  uint32_t v = ((uint32_t)w.at(pos) << 16) | ((uint32_t)w.at(pos + 1) << 8) | w.at(pos + 2);
+  return (uint32_t)(v * 2654435761UL) >> (32 - LZ_HASH_BITS);
+}
+
+// Schreibt die Literale input[from..to) in Läufen zu höchstens LZ_MAX_LITERALS Bytes
+static bool lzFlushLiterals(const uint8_t* input, size_t from, size_t to, uint8_t* output, size_t outputSize, size_t& out) {
+  while (from < to) {
+    size_t run = to - from;
+    if (run > LZ_MAX_LITERALS) {
+      run = LZ_MAX_LITERALS;
+    }
+    if (out + 1 + run > outputSize) {
+      return false;
+    }
+    output[out++] = run - 1;
+    memcpy(&output[out], &input[from], run);
+    out += run;
+    from += run;
+  }
+  return true;
+}
+
+size_t lz_compress(const uint8_t* input, size_t len, const uint8_t* dict, size_t dictLen, uint8_t* output, size_t outputSize) {
+  LzWindow w = {dict, dictLen, input};
+  size_t end = dictLen + len;
+  memset(lzHashTable, 0, sizeof(lzHashTable));
+
+  // Das Wörterbuch nur eintragen, nicht ausgeben
+  for (size_t pos = 0; pos + LZ_MIN_MATCH <= dictLen; pos++) {
+    lzHashTable[lzHash(w, pos)] = pos + 1;
+  }
+
+  size_t out = 0;
+  size_t literalStart = 0; // relativ zu 'input'
+  size_t pos = dictLen;
+  while (pos + LZ_MIN_MATCH <= end) {
+    uint16_t h = lzHash(w, pos);
+    size_t candidate = lzHashTable[h];
+    lzHashTable[h] = pos + 1;
+
+    if (candidate == 0 || pos - (candidate - 1) > LZ_MAX_OFFSET) {
+      pos++;
+      continue;
+    }
+    candidate--;
+    size_t matchLen = 0;
+    while (pos + matchLen < end && matchLen < LZ_MAX_MATCH && w.at(candidate + matchLen) == w.at(pos + matchLen)) {
+      matchLen++;
+    }
+    if (matchLen < LZ_MIN_MATCH) { // Hash-Kollision
+      pos++;
+      continue;
+    }
+
+    if (!lzFlushLiterals(input, literalStart, pos - dictLen, output, outputSize, out)) {
+      return 0;
+    }
+    size_t offset = pos - candidate - 1;
+    size_t lenCode = matchLen - 2;
+    if (out + (lenCode >= 7 ? 3 : 2) > outputSize) {
+      return 0;
+    }
+    if (lenCode >= 7) {
+      output[out++] = (7 << 5) | (offset >> 8);
+      output[out++] = lenCode - 7;
+    } else {
+      output[out++] = (lenCode << 5) | (offset >> 8);
+    }
+    output[out++] = offset & 0xFF;
+
+    // Positionen innerhalb des Treffers eintragen, damit spätere Wiederholungen gefunden werden
+    for (size_t i = pos + 1; i < pos + matchLen && i + LZ_MIN_MATCH <= end; i++) {
+      lzHashTable[lzHash(w, i)] = i + 1;
+    }
+    pos += matchLen;
+    literalStart = pos - dictLen;
+  }
+
+  if (!lzFlushLiterals(input, literalStart, len, output, outputSize, out)) {
+    return 0;
+  }
+  return out;
+}
+
+size_t lz_store(const uint8_t* input, size_t len, uint8_t* output, size_t outputSize) {
+  size_t out = 0;
+  if (!lzFlushLiterals(input, 0, len, output, outputSize, out)) {
+    return 0;
+  }
+  return out;
+}
+
+size_t lz_decompress(const uint8_t* input, size_t len, const uint8_t* dict, size_t dictLen, uint8_t* output, size_t outputSize) {
+  size_t in = 0;
+  size_t out = 0;
+
+  while (in < len) {
+    uint8_t ctrl = input[in++];
+    if (ctrl < (1 << 5)) {
+      size_t run = ctrl + 1;
+      if (in + run > len || out + run > outputSize) {
+        return 0;
+      }
+      memcpy(&output[out], &input[in], run);
+      in += run;
+      out += run;
+      continue;
+    }
+
+    size_t matchLen = (ctrl >> 5) + 2;
+    if ((ctrl >> 5) == 7) {
+      if (in >= len) {
+        return 0;
+      }
+      matchLen += input[in++];
+    }
+    if (in >= len) {
+      return 0;
+    }
+    size_t offset = (((size_t)(ctrl & 0x1F) << 8) | input[in++]) + 1;
+    if (offset > out + dictLen || out + matchLen > outputSize) {
+      return 0;
+    }
+    // Byteweise kopieren: Überlappende Verweise (Wiederholungen) sind erlaubt
+    for (size_t i = 0; i < matchLen; i++, out++) {
+      output[out] = out >= offset ? output[out - offset] : dict[dictLen + out - offset];
+    }
+  }
+  return out;
+}
+
+uint16_t crc16_ccitt(const uint8_t* data, size_t len, uint16_t crc) {
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+  }
+  return crc;
+}
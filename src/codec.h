@@ -1,7 +1,39 @@
 #ifndef CODEC_H
 #define CODEC_H
 
-void base64_encode(const uint8_t* data, size_t len, String& output);
-void base64_decode(const String& input, uint8_t* output, size_t& outputLen);
+// Base64-Kodierung direkt in eine Ausgabe (z.B. Serial), ohne Zwischenpuffer auf dem Heap.
+void base64_encode(const uint8_t* data, size_t len, Print& output);
+
+// Länge der dekodierten Daten (ohne Prüfung der Zeichen). Padding ist optional.
+size_t base64_decoded_length(const char* input, size_t inputLength);
+
+// Base64-Dekodierung aus einem konstanten Eingabebereich in einen Puffer der Größe 'outputSize'.
+// Gibt false zurück bei ungültigen Zeichen, ungültiger Länge oder zu kleinem Ausgabepuffer.
+bool base64_decode(const char* input, size_t inputLength, uint8_t* output, size_t outputSize, size_t& outputLen);
+
+// COBS-Kodierung (Consistent Overhead Byte Stuffing): Die Ausgabe enthält keine Null-Bytes,
+// sodass 0x00 als Rahmenende dienen kann. 'output' muss len + len/254 + 1 Bytes fassen.
+size_t cobs_encode(const uint8_t* input, size_t len, uint8_t* output);
+
+// COBS-Dekodierung eines Rahmens ohne abschließendes 0x00.
+// Gibt die dekodierte Länge zurück oder 0 bei ungültiger Kodierung bzw. zu kleinem Puffer.
+size_t cobs_decode(const uint8_t* input, size_t len, uint8_t* output, size_t outputSize);
+
+// LZ-Kompression (LZF-ähnlich, ohne Heap) für kurze Funkpakete. Ein optionales Wörterbuch
+// wirkt als bereits gesendeter Verlauf vor den Daten; beide Seiten müssen dasselbe verwenden.
+// Steuerbyte 000LLLLL: L+1 Literale folgen. Sonst LLLOOOOO [Zusatzlänge, falls LLL = 7] OOOOOOOO:
+// Rückverweis mit Länge LLL+2 (+ Zusatzlänge) und Abstand O+1 (max. 8192).
+// Gibt die komprimierte Länge zurück oder 0, wenn das Ergebnis nicht in 'outputSize' passt.
+size_t lz_compress(const uint8_t* input, size_t len, const uint8_t* dict, size_t dictLen, uint8_t* output, size_t outputSize);
+
+// LZ-Datenstrom nur aus Literalen (ohne Suche, len + len/32 aufgerundet Bytes).
+// Gibt die Länge zurück oder 0, wenn das Ergebnis nicht in 'outputSize' passt.
+size_t lz_store(const uint8_t* input, size_t len, uint8_t* output, size_t outputSize);
+
+// Gibt die dekodierte Länge zurück oder 0 bei ungültigem Datenstrom bzw. zu kleinem Puffer.
+size_t lz_decompress(const uint8_t* input, size_t len, const uint8_t* dict, size_t dictLen, uint8_t* output, size_t outputSize);
+
+// CRC-16/CCITT-FALSE (Polynom 0x1021, Startwert 0xFFFF)
+uint16_t crc16_ccitt(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
 
 #endif // CODEC_H
\ No newline at end of file
@@ -1,21 +1,79 @@
 #include <Arduino.h> 
 #include <optional>
 
+#include "0_config.h"
 #include "command.h"
 #include "lora.h"    
 #include "codec.h"   
+#include "rxbuffer.h"
+#include "serialout.h"
+#include "latency.h"
+#include "airtime.h"
+#include "presets.h"
+#include "storage.h"
+#include "dedup.h"
+#include "rxfilter.h"
+#include "repeater.h"
+#include "bulk.h"
+#include "compress.h"
+#include "crypto.h"
+#include "afc.h"
+#include "scheduler.h"
+#include "power.h"
+#include "timebase.h"
+#include "scratch.h"
 
-String showHelp() {
-    String helpText = "DX-LR30-LORA Hilfe: ";
-    helpText += "Eingabe als JSON-Objekt mit Hauptschlüssel 'command'. ";
-    helpText += "Verfügbare Befehle: ";
-    helpText += "'help' - Zeigt diese Hilfe an. Bsp: {'command':{'help':{}}} ";
-    helpText += "'getLoraConfig' - Zeigt aktuelle LoRa-Konfiguration an. Bsp: {'command':{'getLoraConfig':{}}} ";
-    helpText += "'sendLora' - Sendet Base64-kodierte Daten. Bsp: {'command':{'sendLora':{'payload':'...Hallo...'}}} ";
-    helpText += "'reset' - Führt einen Software-Reset des Geräts durch. Bsp: {'command':{'reset':{}}} ";
-    helpText += "'setLoraConfig' - Setzt LoRa-Parameter (partiell möglich). Bsp: {'command':{'setLoraConfig':{'Freq':869.618, 'SF':8, 'CR':8, 'BW':62.5, 'Sync': '0x12', 'Offset': 10.3, 'Preamble': 16, 'Power': 21  }}}  ";
+// Wert eines Konfigurationsmakros als Zeichenkette, damit der Hilfetext konstant bleibt
+#define HELP_STR_(x) #x
+#define HELP_STR(x) HELP_STR_(x)
 
-    return helpText;
+// Hilfetext im Flash, ein Datensatz je Befehl: Jede Zeile passt einzeln in die serielle
+// Ausgabe, der Text am Stück (über 4 KB) nicht
+static const char* const HELP_LINES[] = {
+    "'help' - Zeigt diese Hilfe an. Bsp: {'command':{'help':{}}}",
+    "'getLoraConfig' - Zeigt aktuelle LoRa-Konfiguration an. Bsp: {'command':{'getLoraConfig':{}}}",
+    "'sendLora' - Sendet Base64-kodierte Daten, mit 'at_us' zu einem Zeitpunkt in Gerätezeit (ohne Kanalprüfung). Bsp: {'command':{'sendLora':{'payload':'...Hallo...','at_us':123456789}}}",
+    "'getRxStats' - Zeigt die Statistik des Empfangspuffers an. Bsp: {'command':{'getRxStats':{}}}",
+    "'binary' - Wechselt in das binäre COBS/CRC16-Rahmenprotokoll. Bsp: {'command':{'binary':{}}}",
+    "'echo' - Schaltet das Zurücksenden der Eingabe ein/aus. Bsp: {'command':{'echo':{'enabled':true}}}",
+    "'baud' - Stellt die Baudrate um (bis 921600). Bsp: {'command':{'baud':{'rate':921600}}}",
+    "'getSerialStats' - Zeigt die Statistik der seriellen Ausgabe an. Bsp: {'command':{'getSerialStats':{}}}",
+    "'preset' - Profil anwenden. Bsp: {'command':{'preset':{'name':'meshcore'}}}",
+    "'savePreset' / 'listPresets' - Profil sichern/auflisten. Bsp: {'command':{'savePreset':{'slot':1}}}",
+    "'lbt' - Kanalprüfung vor dem Senden ein/aus. Bsp: {'command':{'lbt':{'enabled':true}}}",
+    "'freqError' - Frequenzfehler je Empfangspaket auslesen ein/aus. Bsp: {'command':{'freqError':{'enabled':false}}}",
+    "'bulkAppend' / 'bulkSend' / 'bulkAbort' / 'bulk' - Blockübertragung bis " HELP_STR(LORA_BULK_BUFFER_SIZE) " Bytes (Puffer füllen, senden, abbrechen, Status). Bsp: {'command':{'bulkAppend':{'payload':'...'}}}",
+    "'scan' - Kanalscan über mehrere Profile per CAD (Gewicht = Besuche je Umlauf). Bsp: {'command':{'scan':{'enabled':true,'channels':['meshtastic_longfast',{'preset':'meshcore','weight':2}],'dwell_ms':0}}}",
+    "'compress' - Kompression der Nutzdaten (Senden/Empfang, Telemetrie-Wörterbuch). Bsp: {'command':{'compress':{'tx':true,'rx':true,'dict':true}}}",
+    "'crypto' - AES-128-CCM-Verschlüsselung (Schlüssel als Hex, 'persist' legt ihn im Flash ab, 'node' = Knotennummer in der Nonce, 'clear' löscht ihn). Bsp: {'command':{'crypto':{'key':'000102030405060708090a0b0c0d0e0f','persist':true,'tx':true,'rx':true}}}",
+    "'rxFilter' - Empfangsfilter (rssi/snr/len/match/deny), ersetzt die Kette in einem Schritt. Bsp: {'command':{'rxFilter':{'enabled':true,'rules':[{'type':'rssi','min':-115},{'type':'deny','offset':0,'value':'ffffffff'}]}}}",
+    "'repeater' - Sendet passende Pakete nach zufälliger Wartezeit selbst weiter (Regeln wie rxFilter, Hop-Feld 'ttl'/'count' ab 'hop_offset' mit 'hop_mask', Reserve in % des Duty-Cycle-Budgets), meldet Zähler und Latenz. Bsp: {'command':{'repeater':{'enabled':true,'delay_min':50,'delay_max':500,'hop':'ttl','hop_offset':3,'hop_mask':7,'rules':[{'type':'match','offset':0,'value':'a5'}]}}}",
+    "'afc' - Automatische Frequenzkorrektur (optional je Sender, Kennung ab 'offset' mit 'length' Bytes), meldet Schätzung und Verlauf. Bsp: {'command':{'afc':{'enabled':true,'per_sender':true,'offset':4,'length':4}}}",
+    "'dedup' - Duplikatunterdrückung (off/drop/best, Schlüssel ab 'offset' mit 'length' Bytes). Bsp: {'command':{'dedup':{'mode':'drop','window_ms':30000,'offset':4,'length':8}}}",
+    "'stats' / 'resetStats' - Latenzstatistik ausgeben/zurücksetzen. Bsp: {'command':{'stats':{}}}",
+    "'sync' - Gerätezeit in us (wie 't_us' in lora_rx/lora_tx_done) mit optionaler Host-Zeit zum Abgleich, meldet Gang und Fehler geplanter Sendungen. Bsp: {'command':{'sync':{'host_us':1760000000000000}}}",
+    "'power' - Energieprofil (continuous, idle = WFI, duty_cycle = WFI und Duty-Cycle-Empfang), meldet Strom und Weckverzögerung je Profil. Bsp: {'command':{'power':{'profile':'duty_cycle'}}}",
+    "'tasks' - Laufzeit und Jitter je Aufgabe sowie längste Schleifendauer ('reset' setzt nach der Ausgabe zurück). Bsp: {'command':{'tasks':{'reset':true}}}",
+    "'dumplog' - Gibt die letzten " HELP_STR(LOG_RING_SIZE) " Meldungen des Ereignisprotokolls aus (auch bei abgeschaltetem Logging). Bsp: {'command':{'dumplog':{}}}",
+    "'reset' - Führt einen Software-Reset des Geräts durch. Bsp: {'command':{'reset':{}}}",
+    "'setLoraConfig' - Setzt LoRa-Parameter (partiell möglich). Bsp: {'command':{'setLoraConfig':{'Freq':869.618, 'SF':8, 'CR':8, 'BW':62.5, 'Sync': '0x12', 'Offset': 10.3, 'Preamble': 16, 'Power': 21  }}}",
+};
+static const uint8_t HELP_LINE_COUNT = sizeof(HELP_LINES) / sizeof(HELP_LINES[0]);
+static uint8_t helpNext = HELP_LINE_COUNT;
+
+String startHelp() {
+    helpNext = 0;
+    return "DX-LR30-LORA Hilfe: Eingabe als JSON-Objekt mit Hauptschlüssel 'command'. " +
+           String(HELP_LINE_COUNT) + " Befehle folgen.";
+}
+
+const char* nextHelpLine() {
+    return helpNext < HELP_LINE_COUNT ? HELP_LINES[helpNext++] : nullptr;
+}
+
+// Legt die aktuelle Konfiguration dauerhaft ab; liefert bei einem Fehler einen Hinweis
+static String persistConfig() {
+    return saveStoredConfig() ? "" : " WARN: Speichern im Flash fehlgeschlagen.";
 }
 
 String resetDevice() {
@@ -38,40 +96,114 @@ String getLoraConfig() {
     configText += "Sync=0x" + String(settings.syncWord, HEX) + ", ";
     configText += "Power=" + String(settings.outputPower_dBm) + " dBm, ";
     configText += "Preamble=" + String(settings.preambleLength) + ", ";
-    configText += "Offset=" + String(settings.frequency_offset_kHz, 1) + " kHz";
+    configText += "Offset=" + String(settings.frequency_offset_kHz, 1) + " kHz, ";
+
+    // Sendedauer und Duty-Cycle-Budget, damit der Host den Verkehr takten kann
+    DutyCycleStats duty = getDutyCycleStats();
+    configText += "Airtime0=" + String(getAirtimeMicros(0)) + " us, ";
+    configText += "AirtimePerByte=" + String(getAirtimePerByteMicros(), 1) + " us, ";
+    configText += "DutyCycle=" + String(LORA_DUTY_CYCLE_PERCENT) + "%/" + String(LORA_DUTY_CYCLE_WINDOW_S) + " s, ";
+    configText += "Budget=" + String(getDutyCycleBudgetMicros() / 1000) + "/" + String(getDutyCycleCapacityMicros() / 1000) + " ms, ";
+    configText += "Deferred=" + String(duty.deferred) + ", Rejected=" + String(duty.rejected) + ", ";
+    configText += "Source=" + String(isLoRaConfigFromFlash() ? "Flash" : "Default") + ", ";
+    configText += "BootMs=" + String(getLoRaBootMillis());
     
     return configText;
 }
 
-String sendLoraPayload(const String& base64Payload) {
-    if (base64Payload.length() == 0) {
+String getRxStats() {
+    LoRaRxStats stats = getRxBufferStats();
+
+    String statsText = "RX Stats: ";
+    statsText += "Received=" + String(stats.received) + ", ";
+    statsText += "Overruns=" + String(stats.overruns) + ", ";
+    statsText += "Dropped=" + String(stats.dropped) + ", ";
+    statsText += "Queued=" + String(rxBufferCount()) + "/" + String(LORA_RX_RING_SIZE) + ", ";
+    statsText += "HighWater=" + String(stats.highWater);
+
+    return statsText;
+}
+
+String getSerialStats() {
+    SerialOutputStats stats = getSerialOutputStats();
+
+    String statsText = "Serial Stats: ";
+    statsText += "Baud=" + String(getSerialBaudRate()) + ", ";
+    statsText += "Records=" + String(stats.records) + ", ";
+    statsText += "Dropped=" + String(stats.droppedRecords) + ", ";
+    statsText += "Bytes=" + String(stats.bytesWritten) + ", ";
+    statsText += "Pending=" + String(serialOut.pending()) + "/" + String(SERIAL_OUT_BUFFER_SIZE) + ", ";
+    statsText += "HighWater=" + String(stats.highWater);
+
+    return statsText;
+}
+
+String sendLoraPayload(const char* base64Payload, uint64_t at_us) {
+    size_t base64Len = strlen(base64Payload);
+    if (base64Len == 0) {
         // Leere Payloads sind nicht zulässig.
         return "ERROR: Leerer Base64-Payload empfangen.";
     }
 
-    // Puffer für die dekodierten Daten. Ein LoRa-Paket kann maximal 255 Bytes enthalten.
-    // Wir verwenden 256, um sicherzustellen, dass genügend Platz vorhanden ist.
-    uint8_t decoded_payload[256];
-    size_t decoded_len; // Variable zur Speicherung der tatsächlichen Länge der dekodierten Daten
+    // Dekodiert, komprimiert und verschlüsselt wird abwechselnd in den beiden Hälften des
+    // gemeinsamen Arbeitspuffers (siehe scratch.h). Ein LoRa-Paket kann maximal 255 Bytes enthalten.
+    uint8_t* decoded_payload = packetScratch;
+    size_t decoded_len = 0; // Variable zur Speicherung der tatsächlichen Länge der dekodierten Daten
 
-    // Rufe die base64_decode-Funktion aus dem codec-Modul auf.
-    // Diese Funktion füllt den 'decoded_payload'-Puffer und setzt 'decoded_len'.
-    base64_decode(base64Payload, decoded_payload, decoded_len);
+    // Vorab prüfen, ob die dekodierten Daten in ein einzelnes LoRa-Paket passen.
+    size_t expected_len = base64_decoded_length(base64Payload, base64Len);
+    if (expected_len > PACKET_SCRATCH_HALF) {
+        return "ERROR: Payload nach Dekodierung zu lang (" + String(expected_len) + " > 255 Bytes). Max 255 Bytes erlaubt.";
+    }
 
-     // Prüfen, ob die Dekodierung erfolgreich war und die Länge im zulässigen Bereich liegt.
-    if (decoded_len > 255) {
-        // Falls die dekodierten Daten zu lang für ein einzelnes LoRa-Paket sind.
-        return "ERROR: Payload nach Dekodierung zu lang (" + String(decoded_len) + " > 255 Bytes). Max 255 Bytes erlaubt.";
+    // Rufe die base64_decode-Funktion aus dem codec-Modul auf.
+    // Sie schreibt nie über 'decoded_payload' hinaus und lehnt ungültige Zeichen ab.
+    if (!base64_decode(base64Payload, base64Len, decoded_payload, PACKET_SCRATCH_HALF, decoded_len)) {
+        return "ERROR: Ungültiger Base64-Payload.";
+    } else if (decoded_len == 0) {
+        return "ERROR: Leerer Payload nach Dekodierung.";
     } else {
         // Die dekodierten Daten sind gültig (Länge > 0 und <= 255).
-        // Rufe die sendLoRaPacket-Funktion aus dem lora-Modul auf und verarbeite das Ergebnis.
-        String loraSendResult = sendLoRaPacket(decoded_payload, decoded_len);
+        // Rufe die queueLoRaPacket-Funktion aus dem lora-Modul auf und verarbeite das Ergebnis.
+        // Der Abschluss wird später als 'lora_tx_done'-Ereignis mit derselben ID gemeldet.
+        // Bei eingeschalteter Kompression wird das kürzere Paket gesendet, danach ggf. verschlüsselt.
+        uint8_t* packed_payload = packetScratch + PACKET_SCRATCH_HALF;
+        uint32_t airtimeSaved = 0;
+        size_t packed_len = compressForTx(decoded_payload, decoded_len, packed_payload, airtimeSaved);
+        if (packed_len == 0) {
+            return "ERROR: Payload beginnt mit einem Kennbyte (0xC5-0xC7) und passt eingepackt nicht in 255 Bytes.";
+        }
+        bool compressed = packed_len != decoded_len || packed_payload[0] != decoded_payload[0];
+
+        // Die dekodierten Daten werden nicht mehr gebraucht, ihre Hälfte nimmt das Sendepaket auf
+        uint8_t* tx_payload = packetScratch;
+        size_t tx_len = 0;
+        uint32_t cryptoCounter = getCryptoCounter();
+        String cryptoResult = encryptForTx(packed_payload, packed_len, tx_payload, tx_len);
+        if (cryptoResult.length() > 0) {
+            return "ERROR: " + cryptoResult;
+        }
+
+        uint16_t txId = 0;
+        String loraSendResult = queueLoRaPacket(tx_payload, tx_len, txId, true, at_us);
 
-        if (loraSendResult.length() > 0) { // sendLoRaPacket hat eine Fehlermeldung zurückgegeben
+        if (loraSendResult.length() > 0) { // queueLoRaPacket hat eine Fehlermeldung zurückgegeben
             return "ERROR: " + loraSendResult; // Die Fehlermeldung aus lora.cpp weitergeben
         } else {
-            // sendLoRaPacket hat einen leeren String zurückgegeben (Erfolg)
-            return "LoRa-Paket erfolgreich gesendet. ";
+            // queueLoRaPacket hat einen leeren String zurückgegeben (Erfolg)
+            String sendText = "LoRa-Paket zum Senden eingereiht (ID=" + String(txId) + ", Warteschlange=" + String(getLoRaTxQueueCount()) +
+                              ", Airtime=" + String(getAirtimeMicros(tx_len)) + " us";
+            if (compressed) {
+                sendText += ", Komprimiert=" + String(decoded_len) + "->" + String(packed_len) + " Bytes (" +
+                            String(packed_len * 100 / decoded_len) + " %), AirtimeSaved=" + String(airtimeSaved) + " us";
+            }
+            if (isCryptoTxEnabled()) {
+                sendText += ", Verschlüsselt=Zähler " + String(cryptoCounter);
+            }
+            if (at_us != 0) {
+                sendText += ", Start in " + String((uint32_t)(at_us - timebaseMicros())) + " us";
+            }
+            return sendText + "). ";
         }
     }
 }
@@ -104,5 +236,683 @@ String setLoraConfig(std::optional<float> base_frequency_MHz,
                                   final_spreadingFactor, final_codingRate, final_syncWord, 
                                   final_outputPower_dBm, final_preambleLength);
 
-    return result; // Das String-Ergebnis direkt zurückgeben
-}
\ No newline at end of file
+    return result + persistConfig(); // Unveränderte Stände werden nicht neu geschrieben
+}
+
+String getLatencyStats(uint8_t stage) {
+    const LatencyStageStats& stats = getLatencyStageStats(stage);
+    const float cyclesPerMicro = SystemCoreClock / 1000000.0f;
+
+    String statsText = "Latency " + String(latencyStageName(stage)) + ": ";
+    statsText += "N=" + String(stats.count);
+    if (stats.count == 0) {
+        return statsText;
+    }
+    statsText += ", Min=" + String(stats.min / cyclesPerMicro, 1) + " us";
+    statsText += ", Avg=" + String((float)(stats.sum / stats.count) / cyclesPerMicro, 1) + " us";
+    statsText += ", Max=" + String(stats.max / cyclesPerMicro, 1) + " us";
+
+    // Histogramm: Klasse k enthält Werte unter 2^k Zyklen, leere Klassen werden ausgelassen
+    statsText += ", Hist(log2 Zyklen)=";
+    bool first = true;
+    for (uint8_t bin = 0; bin < LATENCY_HISTOGRAM_BINS; bin++) {
+        if (stats.histogram[bin] == 0) {
+            continue;
+        }
+        if (!first) {
+            statsText += ",";
+        }
+        statsText += String(bin) + ":" + String(stats.histogram[bin]);
+        first = false;
+    }
+
+    return statsText;
+}
+
+String getSchedulerSummary() {
+    const float cyclesPerMicro = SystemCoreClock / 1000000.0f;
+    SchedulerStats stats = getSchedulerStats();
+
+    String summary = "Scheduler: Durchläufe=" + String(stats.rounds);
+    if (stats.rounds > 1) {
+        summary += ", Schleife Avg=" + String((float)(stats.roundCycles / (stats.rounds - 1)) / cyclesPerMicro, 1) + " us";
+        summary += ", Max=" + String(stats.maxRoundCycles / cyclesPerMicro, 1) + " us";
+    }
+    summary += ", Vorgezogen=" + String(stats.preemptions);
+    return summary;
+}
+
+String getSchedulerTaskText(uint8_t id) {
+    const float cyclesPerMicro = SystemCoreClock / 1000000.0f;
+    SchedulerTaskStats stats = getSchedulerTaskStats(id);
+
+    String taskText = "Task " + String(schedulerTaskName(id)) + " (Prio " + String(id) + (isSchedulerTaskEnabled(id) ? "" : ", aus") + "): ";
+    taskText += "N=" + String(stats.runs);
+    if (stats.runs != 0) {
+        taskText += ", Avg=" + String((float)(stats.cycles / stats.runs) / cyclesPerMicro, 1) + " us";
+        taskText += ", Max=" + String(stats.maxCycles / cyclesPerMicro, 1) + " us";
+    }
+    if (stats.timerRuns != 0) {
+        taskText += ", Timer=" + String(stats.timerRuns);
+        taskText += ", Jitter Avg=" + String((uint32_t)(stats.lateness_us / stats.timerRuns)) + " us";
+        taskText += ", Max=" + String(stats.maxLateness_us) + " us";
+    }
+    return taskText;
+}
+
+String getTxScheduleText() {
+    LoRaTxScheduleStats stats = getLoRaTxScheduleStats();
+    String scheduleText = "Geplantes Senden: gesendet=" + String(stats.sent) + ", verspätet=" + String(stats.late);
+    if (stats.sent != 0) {
+        scheduleText += ", Fehler Avg=" + String((uint32_t)(stats.absError_us / stats.sent)) + " us";
+        scheduleText += ", Max=" + String(stats.maxError_us) + " us";
+    }
+    scheduleText += ", Vorlauf=" + String(stats.lead_us) + " us";
+    return scheduleText;
+}
+
+String setPower(std::optional<const char*> profile) {
+    if (profile.has_value()) {
+        int8_t found = -1;
+        for (uint8_t i = 0; i < POWER_PROFILE_COUNT; i++) {
+            if (strcasecmp(profile.value(), powerProfileName(i)) == 0) {
+                found = i;
+            }
+        }
+        if (found < 0) {
+            return "ERROR: Unbekanntes Profil '" + String(profile.value()) + "' (continuous, idle, duty_cycle).";
+        }
+        setPowerProfile((PowerProfile)found);
+    }
+
+    uint32_t sleeps;
+    uint64_t slept_us, elapsed_us;
+    getPowerSleepStats(sleeps, slept_us, elapsed_us);
+    String powerText = "Energie: Profil=" + String(powerProfileName(getPowerProfile()));
+    powerText += ", Schlafphasen=" + String(sleeps);
+    if (elapsed_us > 0) {
+        powerText += ", geschlafen=" + String(100.0f * (float)slept_us / (float)elapsed_us, 1) + " %";
+    }
+    uint32_t rx_us, sleep_us;
+    if (getLoRaRxDutyCycle(rx_us, sleep_us)) {
+        powerText += ", Duty-Cycle RX=" + String(rx_us) + " us, Schlaf=" + String(sleep_us) + " us";
+    } else if (getPowerProfile() == POWER_DUTY_CYCLE) {
+        powerText += ", Empfang dauerhaft (Präambel zu kurz oder Scan aktiv)";
+    }
+    return powerText;
+}
+
+String getPowerProfileText(uint8_t profile) {
+    PowerEstimate e = estimatePower(profile);
+    String profileText = "Profil " + String(powerProfileName(profile)) + (profile == getPowerProfile() ? " (aktiv)" : "") + ": ";
+    profileText += "I=" + String(e.total_mA, 2) + " mA (MCU " + String(e.mcu_mA, 2) + ", Funk " + String(e.radio_mA, 3) + ")";
+    profileText += ", wach=" + String(100.0f * e.awake, 1) + " %" + (e.measured ? "" : " angenommen");
+    if (e.rx_us != 0) {
+        profileText += ", RX=" + String(e.rx_us) + " us, Schlaf=" + String(e.sleep_us) + " us";
+    }
+    profileText += ", Weckverzögerung=" + String(e.latency_us) + " us";
+    return profileText;
+}
+
+String applyPreset(const char* name) {
+    int index = findLoRaPreset(name);
+    if (index < 0) {
+        return "ERROR: Unbekanntes Profil '" + String(name) + "'.";
+    }
+    const LoRaSettings* preset = getLoRaPreset(index);
+    if (preset == nullptr) {
+        return "ERROR: Profil '" + String(getLoRaPresetName(index)) + "' ist leer.";
+    }
+
+    // Der Frequenzoffset ist gerätespezifisch und bleibt beim Umschalten erhalten
+    LoRaSettings target = *preset;
+    target.frequency_offset_kHz = getCurrentLoRaSettings().frequency_offset_kHz;
+
+    return String(getLoRaPresetName(index)) + ": " + applyLoRaSettings(target) + persistConfig();
+}
+
+String savePreset(uint8_t slot) {
+    if (!storeLoRaUserPreset(slot, getCurrentLoRaSettings())) {
+        return "ERROR: Ungültiger Benutzerplatz " + String(slot) + " (1-" + String(LORA_USER_PRESET_SLOTS) + ").";
+    }
+    return "Aktuelle Konfiguration als 'user" + String(slot) + "' gespeichert." + persistConfig();
+}
+
+String listPresets() {
+    String listText = "Presets: ";
+    for (uint8_t i = 0; i < getLoRaPresetCount(); i++) {
+        const LoRaSettings* preset = getLoRaPreset(i);
+        if (i > 0) {
+            listText += "; ";
+        }
+        listText += String(getLoRaPresetName(i)) + "=";
+        if (preset == nullptr) {
+            listText += "leer";
+            continue;
+        }
+        listText += String(preset->base_frequency_MHz, 3) + "/" + String(preset->bandwidth_kHz, 1) +
+                    "/SF" + String(preset->spreadingFactor) + "/CR" + String(preset->codingRate) +
+                    "/0x" + String(preset->syncWord, HEX) + "/" + String(preset->outputPower_dBm) + "dBm/P" +
+                    String(preset->preambleLength);
+    }
+    return listText;
+}
+
+String setLbt(std::optional<bool> enabled) {
+    if (enabled.has_value()) {
+        setLoRaLbtEnabled(enabled.value());
+    }
+    LoRaLbtStats stats = getLoRaLbtStats();
+
+    String lbtText = "LBT " + String(isLoRaLbtEnabled() ? "aktiviert" : "deaktiviert") + ": ";
+    lbtText += "CAD=" + String(stats.cadRuns) + ", ";
+    lbtText += "Busy=" + String(stats.cadBusy) + ", ";
+    lbtText += "Dropped=" + String(stats.dropped) + ", ";
+    lbtText += "Backoff=" + String(stats.backoff_ms) + " ms";
+    return lbtText;
+}
+
+String setFrequencyErrorReadout(std::optional<bool> enabled) {
+    if (enabled.has_value()) {
+        setLoRaRxFrequencyErrorEnabled(enabled.value());
+    }
+    return "Frequenzfehler-Messung " + String(isLoRaRxFrequencyErrorEnabled() ? "aktiviert" : "deaktiviert") +
+           " (SPI=" + String(SX1262_SPI_CLOCK / 1000) + " kHz, Dauer des Auslesens siehe 'stats' rx_turnaround).";
+}
+
+String setDedup(std::optional<const char*> mode, std::optional<uint32_t> window_ms, std::optional<uint16_t> hold_ms,
+                std::optional<uint8_t> offset, std::optional<uint8_t> length, bool reset) {
+    static const char* const MODE_NAMES[] = {"off", "drop", "best"};
+
+    DedupSettings settings = getDedupSettings();
+    if (mode.has_value()) {
+        int8_t found = -1;
+        for (uint8_t i = 0; i < 3; i++) {
+            if (strcasecmp(mode.value(), MODE_NAMES[i]) == 0) {
+                found = i;
+            }
+        }
+        if (found < 0) {
+            return "ERROR: Unbekannter Modus '" + String(mode.value()) + "' (off, drop, best).";
+        }
+        settings.mode = (DedupMode)found;
+    }
+    settings.window_ms = window_ms.value_or(settings.window_ms);
+    settings.hold_ms   = hold_ms.value_or(settings.hold_ms);
+    settings.keyOffset = offset.value_or(settings.keyOffset);
+    settings.keyLength = length.value_or(settings.keyLength);
+    setDedupSettings(settings);
+    if (reset) {
+        resetDedupStats();
+    }
+
+    settings = getDedupSettings();
+    DedupStats stats = getDedupStats();
+
+    String dedupText = "Dedup " + String(MODE_NAMES[settings.mode]) + ": ";
+    dedupText += "Window=" + String(settings.window_ms) + " ms, ";
+    dedupText += "Hold=" + String(settings.hold_ms) + " ms, ";
+    dedupText += "Key=" + String(settings.keyOffset) + "+" + (settings.keyLength == 0 ? String("*") : String(settings.keyLength)) + ", ";
+    dedupText += "Hits=" + String(stats.hits) + ", ";
+    dedupText += "Misses=" + String(stats.misses) + ", ";
+    dedupText += "Evictions=" + String(stats.evictions) + ", ";
+    dedupText += "Replaced=" + String(stats.replaced) + ", ";
+    dedupText += "Table=" + String(getDedupOccupancy()) + "/" + String(LORA_DEDUP_TABLE_SIZE);
+    return dedupText;
+}
+
+String setAfc(std::optional<bool> enabled, std::optional<bool> perSender, std::optional<uint8_t> offset,
+              std::optional<uint8_t> length, bool reset) {
+    AfcSettings settings = getAfcSettings();
+    settings.enabled   = enabled.value_or(settings.enabled);
+    settings.perSender = perSender.value_or(settings.perSender);
+    settings.keyOffset = offset.value_or(settings.keyOffset);
+    settings.keyLength = length.value_or(settings.keyLength);
+    setAfcSettings(settings);
+    if (reset) {
+        resetAfc();
+    }
+
+    settings = getAfcSettings();
+    AfcStats stats = getAfcStats();
+    float offset_kHz = getCurrentLoRaSettings().frequency_offset_kHz;
+    float correction_kHz = offset_kHz - stats.reference_kHz;
+
+    String afcText = "AFC " + String(settings.enabled ? "aktiviert" : "deaktiviert");
+    if (settings.perSender) {
+        afcText += " (je Sender, Kennung=" + String(settings.keyOffset) + "+" + String(settings.keyLength) + ")";
+    }
+    afcText += ": Offset=" + String(offset_kHz, 3) + " kHz (Ausgang " + String(stats.reference_kHz, 3) + " kHz, Korrektur " +
+               (correction_kHz >= 0 ? "+" : "") + String(correction_kHz, 3) + " kHz), ";
+    if (stats.valid) {
+        afcText += "Schätzung=" + String(stats.estimate_Hz) + " Hz ±" + String(stats.deviation_Hz) + " Hz aus " +
+                   String(stats.senders) + " Sender(n), ";
+    } else {
+        afcText += "Schätzung=keine, ";
+    }
+    afcText += "Samples=" + String(stats.samples) + ", ";
+    afcText += "Ausreißer=" + String(stats.outliers) + ", ";
+    afcText += "Neustarts=" + String(stats.restarts) + ", ";
+    afcText += "Korrekturen=" + String(stats.adjustments) + ", ";
+    afcText += "Begrenzt=" + String(stats.limited);
+    if (settings.enabled && !isLoRaRxFrequencyErrorEnabled()) {
+        afcText += " (Frequenzfehler-Messung ist aus, siehe 'freqerror')";
+    }
+    return afcText;
+}
+
+String getAfcHistoryText(uint8_t index) {
+    AfcAdjustment entry = getAfcHistory(index);
+    return "AFC-Korrektur t=" + String(entry.time_ms) + " ms: " + (entry.step_Hz >= 0 ? "+" : "") + String(entry.step_Hz) +
+           " Hz -> Offset " + String(entry.offset_kHz, 3) + " kHz (Schätzung " + String(entry.estimate_Hz) + " Hz)";
+}
+
+// Liest höchstens 'maxBytes' Bytes aus einem Hex-String; liefert -1 bei ungültigen Zeichen
+static int parseHexBytes(const char* hex, uint8_t* out, uint8_t maxBytes) {
+    size_t len = strlen(hex);
+    if (len % 2 != 0 || len / 2 > maxBytes) {
+        return -1;
+    }
+    for (size_t i = 0; i < len; i += 2) {
+        if (!isxdigit((unsigned char)hex[i]) || !isxdigit((unsigned char)hex[i + 1])) {
+            return -1;
+        }
+        char pair[3] = {hex[i], hex[i + 1], 0};
+        out[i / 2] = (uint8_t)strtoul(pair, NULL, 16);
+    }
+    return len / 2;
+}
+
+String makeRxFilterRule(const char* type, std::optional<float> min, std::optional<float> max, uint8_t offset,
+                        const char* value, const char* mask, RxFilterRule& rule) {
+    memset(&rule, 0, sizeof(rule));
+
+    if (strcasecmp(type, "rssi") == 0 || strcasecmp(type, "snr") == 0) {
+        if (!min.has_value()) {
+            return "Regel '" + String(type) + "' ohne 'min'.";
+        }
+        bool rssi = strcasecmp(type, "rssi") == 0;
+        rule.kind = rssi ? RX_RULE_MIN_RSSI : RX_RULE_MIN_SNR;
+        rule.min = (int16_t)lroundf(rssi ? min.value() : min.value() * 4.0f);
+    } else if (strcasecmp(type, "len") == 0) {
+        rule.kind = RX_RULE_LENGTH;
+        rule.min = (int16_t)min.value_or(0);
+        rule.max = (int16_t)max.value_or(255);
+        if (rule.min > rule.max) {
+            return "Regel 'len' mit min > max.";
+        }
+    } else if (strcasecmp(type, "match") == 0 || strcasecmp(type, "deny") == 0) {
+        rule.kind = strcasecmp(type, "match") == 0 ? RX_RULE_MATCH : RX_RULE_DENY;
+        rule.offset = offset;
+        int valueLen = parseHexBytes(value, rule.value, LORA_RX_FILTER_MAX_BYTES);
+        if (valueLen <= 0) {
+            return "Regel '" + String(type) + "' braucht 'value' als Hex-String (1-" + String(LORA_RX_FILTER_MAX_BYTES) + " Bytes).";
+        }
+        rule.length = valueLen;
+        memset(rule.mask, 0xFF, sizeof(rule.mask));
+        if (mask[0] != '\0' && parseHexBytes(mask, rule.mask, LORA_RX_FILTER_MAX_BYTES) != valueLen) {
+            return "Regel '" + String(type) + "': 'mask' muss so lang wie 'value' sein.";
+        }
+        for (uint8_t i = 0; i < rule.length; i++) {
+            rule.value[i] &= rule.mask[i];
+        }
+    } else {
+        return "Unbekannter Regeltyp '" + String(type) + "' (rssi, snr, len, match, deny).";
+    }
+    return "";
+}
+
+static String hexBytes(const uint8_t* data, uint8_t len) {
+    String hex;
+    for (uint8_t i = 0; i < len; i++) {
+        if (data[i] < 0x10) {
+            hex += "0";
+        }
+        hex += String(data[i], HEX);
+    }
+    return hex;
+}
+
+// Eine Filterregel samt Treffern, wie sie 'rxFilter' und 'repeater' melden
+static String ruleText(const RxFilterRule* rule) {
+    String text;
+    switch (rule->kind) {
+        case RX_RULE_MIN_RSSI:
+            text = "rssi>=" + String(rule->min);
+            break;
+        case RX_RULE_MIN_SNR:
+            text = "snr>=" + String(rule->min / 4.0f, 2);
+            break;
+        case RX_RULE_LENGTH:
+            text = "len " + String(rule->min) + "-" + String(rule->max);
+            break;
+        case RX_RULE_MATCH:
+        case RX_RULE_DENY:
+            text = String(rule->kind == RX_RULE_MATCH ? "match@" : "deny@") + String(rule->offset) + " " +
+                   hexBytes(rule->value, rule->length) + "/" + hexBytes(rule->mask, rule->length);
+            break;
+    }
+    return text + " (" + String(rule->hits) + ")";
+}
+
+String setRxFilter(std::optional<bool> enabled, const RxFilterRule* rules, uint8_t count, bool replace, bool reset) {
+    bool nextEnabled = enabled.value_or(isRxFilterEnabled());
+    if (replace) {
+        if (!setRxFilterRules(rules, count, nextEnabled)) {
+            return "ERROR: Zu viele Regeln (max. " + String(LORA_RX_FILTER_RULES) + ").";
+        }
+    } else {
+        if (getRxFilterRuleCount() + count > LORA_RX_FILTER_RULES) {
+            return "ERROR: Zu viele Regeln (max. " + String(LORA_RX_FILTER_RULES) + ").";
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            addRxFilterRule(rules[i]);
+        }
+        setRxFilterEnabled(nextEnabled);
+    }
+    if (reset) {
+        resetRxFilterStats();
+    }
+
+    RxFilterStats stats = getRxFilterStats();
+    String filterText = "RX Filter " + String(isRxFilterEnabled() ? "aktiv" : "inaktiv") + ": ";
+    filterText += "Passed=" + String(stats.passed) + ", ";
+    filterText += "Rejected=" + String(stats.rejected) + ", ";
+    filterText += "Unmatched=" + String(stats.unmatched) + ", ";
+    filterText += "Rules=" + String(getRxFilterRuleCount());
+
+    for (uint8_t i = 0; i < getRxFilterRuleCount(); i++) {
+        filterText += i == 0 ? ": " : "; ";
+        filterText += ruleText(getRxFilterRule(i));
+    }
+    return filterText;
+}
+
+String setRepeater(std::optional<bool> enabled, std::optional<uint16_t> delayMin_ms, std::optional<uint16_t> delayMax_ms,
+                   std::optional<uint32_t> window_ms, std::optional<const char*> hop, std::optional<uint8_t> hopOffset,
+                   std::optional<uint8_t> hopMask, std::optional<uint8_t> maxHops, std::optional<uint8_t> reserve,
+                   const RxFilterRule* rules, int8_t ruleCount, bool reset) {
+    static const char* const HOP_NAMES[] = {"off", "ttl", "count"};
+
+    RepeaterSettings settings = getRepeaterSettings();
+    if (hop.has_value()) {
+        int8_t found = -1;
+        for (uint8_t i = 0; i < 3; i++) {
+            if (strcasecmp(hop.value(), HOP_NAMES[i]) == 0) {
+                found = i;
+            }
+        }
+        if (found < 0) {
+            return "ERROR: Unbekannte Hop-Regel '" + String(hop.value()) + "' (off, ttl, count).";
+        }
+        settings.hopMode = (RepeaterHopMode)found;
+    }
+    if (hopMask.has_value() && hopMask.value() != 0) {
+        // Die Bits des Felds müssen zusammenhängen, sonst lässt es sich nicht zählen
+        uint8_t mask = hopMask.value();
+        while ((mask & 1) == 0) {
+            mask >>= 1;
+        }
+        if ((mask & (mask + 1)) != 0) {
+            return "ERROR: 'hop_mask' muss zusammenhängende Bits enthalten.";
+        }
+    } else if (hopMask.has_value()) {
+        return "ERROR: 'hop_mask' darf nicht 0 sein.";
+    }
+    if (ruleCount >= 0 && !setRepeaterRules(rules, ruleCount)) {
+        return "ERROR: Zu viele Regeln (max. " + String(LORA_RX_FILTER_RULES) + ").";
+    }
+    settings.enabled        = enabled.value_or(settings.enabled);
+    settings.delayMin_ms    = delayMin_ms.value_or(settings.delayMin_ms);
+    settings.delayMax_ms    = delayMax_ms.value_or(settings.delayMax_ms);
+    settings.window_ms      = window_ms.value_or(settings.window_ms);
+    settings.hopOffset      = hopOffset.value_or(settings.hopOffset);
+    settings.hopMask        = hopMask.value_or(settings.hopMask);
+    settings.maxHops        = maxHops.value_or(settings.maxHops);
+    settings.reservePercent = reserve.value_or(settings.reservePercent);
+    setRepeaterSettings(settings);
+    if (reset) {
+        resetRepeaterStats();
+    }
+
+    settings = getRepeaterSettings();
+    RepeaterStats stats = getRepeaterStats();
+    uint32_t suppressed = stats.filtered + stats.duplicates + stats.cancelled + stats.expired + stats.overflow +
+                          stats.budget + stats.failed;
+    String repeaterText = "Repeater " + String(settings.enabled ? "aktiv" : "inaktiv") + ": ";
+    repeaterText += "Delay=" + String(settings.delayMin_ms) + "-" + String(settings.delayMax_ms) + " ms, ";
+    repeaterText += "Window=" + String(settings.window_ms) + " ms, ";
+    repeaterText += "Hop=" + String(HOP_NAMES[settings.hopMode]);
+    if (settings.hopMode != REPEATER_HOP_OFF) {
+        repeaterText += "@" + String(settings.hopOffset) + "/" + hexBytes(&settings.hopMask, 1);
+        if (settings.hopMode == REPEATER_HOP_COUNT) {
+            repeaterText += " max " + String(settings.maxHops);
+        }
+    }
+    repeaterText += ", Reserve=" + String(settings.reservePercent) + " %, ";
+    repeaterText += "Forwarded=" + String(stats.forwarded) + ", ";
+    if (stats.forwarded > 0) {
+        repeaterText += "Latency avg=" + String((uint32_t)(stats.latency_us / stats.forwarded)) + " us (" +
+                        String(stats.minLatency_us) + "-" + String(stats.maxLatency_us) + "), ";
+    }
+    repeaterText += "Suppressed=" + String(suppressed) + " (";
+    repeaterText += "Filtered=" + String(stats.filtered) + ", ";
+    repeaterText += "Duplicates=" + String(stats.duplicates) + ", ";
+    repeaterText += "Cancelled=" + String(stats.cancelled) + ", ";
+    repeaterText += "Expired=" + String(stats.expired) + ", ";
+    repeaterText += "Overflow=" + String(stats.overflow) + ", ";
+    repeaterText += "Budget=" + String(stats.budget) + ", ";
+    repeaterText += "Failed=" + String(stats.failed) + "), ";
+    repeaterText += "Pending=" + String(getRepeaterPending()) + "/" + String(LORA_REPEATER_SLOTS) + ", ";
+    repeaterText += "Rules=" + String(getRepeaterRuleCount());
+    for (uint8_t i = 0; i < getRepeaterRuleCount(); i++) {
+        repeaterText += i == 0 ? ": " : "; ";
+        repeaterText += ruleText(getRepeaterRule(i));
+    }
+    return repeaterText;
+}
+
+String appendBulkPayload(const char* base64Payload) {
+    static_assert(JSON_INPUT_BUFFER_SIZE * 3 / 4 <= PACKET_SCRATCH_SIZE, "Arbeitspuffer zu klein für eine Eingabezeile");
+    size_t base64Len = strlen(base64Payload);
+    size_t decodedLen = 0;
+    if (base64Len == 0 || !base64_decode(base64Payload, base64Len, packetScratch, PACKET_SCRATCH_SIZE, decodedLen)) {
+        return "ERROR: Ungültiger Base64-Payload.";
+    }
+
+    String error = bulkAppend(packetScratch, decodedLen);
+    if (error.length() > 0) {
+        return "ERROR: " + error;
+    }
+    return "Blockpuffer: " + String(getBulkLength()) + "/" + String(LORA_BULK_BUFFER_SIZE) + " Bytes";
+}
+
+String sendBulk() {
+    uint16_t len = getBulkLength();
+    uint8_t id = 0;
+    String error = bulkStartSend(id);
+    if (error.length() > 0) {
+        return "ERROR: " + error;
+    }
+    return "Blockübertragung gestartet (ID=" + String(id) + ", " + String(len) + " Bytes, " +
+           String((len + LORA_BULK_FRAGMENT_SIZE - 1) / LORA_BULK_FRAGMENT_SIZE) + " Fragmente).";
+}
+
+String setBulk(std::optional<bool> enabled, bool reset) {
+    if (enabled.has_value()) {
+        setBulkEnabled(enabled.value());
+    }
+    if (reset) {
+        resetBulkStats();
+    }
+    BulkStats stats = getBulkStats();
+
+    String bulkText = "Bulk " + String(isBulkEnabled() ? "aktiviert" : "deaktiviert") + ": ";
+    bulkText += "State=" + String(getBulkStateName()) + ", ";
+    bulkText += "Buffer=" + String(getBulkLength()) + "/" + String(LORA_BULK_BUFFER_SIZE) + ", ";
+    bulkText += "TX=" + String(stats.txTransfers) + ", ";
+    bulkText += "Failed=" + String(stats.txFailed) + ", ";
+    bulkText += "Fragments=" + String(stats.fragmentsSent) + ", ";
+    bulkText += "Retransmissions=" + String(stats.retransmissions) + ", ";
+    bulkText += "Timeouts=" + String(stats.ackTimeouts) + ", ";
+    bulkText += "TxGoodput=" + String(stats.txGoodput_bps) + " bit/s, ";
+    bulkText += "RX=" + String(stats.rxTransfers) + ", ";
+    bulkText += "Incomplete=" + String(stats.rxIncomplete) + ", ";
+    bulkText += "TooLarge=" + String(stats.rxTooLarge) + ", ";
+    bulkText += "RxFragments=" + String(stats.rxFragments) + ", ";
+    bulkText += "Duplicates=" + String(stats.rxDuplicates) + ", ";
+    bulkText += "RxGoodput=" + String(stats.rxGoodput_bps) + " bit/s";
+    return bulkText;
+}
+
+String setScan(std::optional<bool> enabled, std::optional<uint16_t> dwell_ms, const char* const* names,
+               const uint8_t* weights, int8_t count, bool reset) {
+    if (count >= 0) {
+        uint8_t presets[LORA_SCAN_MAX_CHANNELS];
+        if (count > LORA_SCAN_MAX_CHANNELS) {
+            return "ERROR: Zu viele Scan-Kanäle (max. " + String(LORA_SCAN_MAX_CHANNELS) + ").";
+        }
+        for (int8_t i = 0; i < count; i++) {
+            int index = findLoRaPreset(names[i]);
+            if (index < 0) {
+                return "ERROR: Unbekanntes Profil '" + String(names[i]) + "'.";
+            }
+            presets[i] = index;
+        }
+        String error = setLoRaScanChannels(presets, weights, count);
+        if (error.length() > 0) {
+            return "ERROR: " + error + ".";
+        }
+    }
+    if (dwell_ms.has_value()) {
+        setLoRaScanDwellMillis(dwell_ms.value());
+    }
+    if (enabled.has_value()) {
+        setLoRaScanEnabled(enabled.value());
+    }
+    if (reset) {
+        resetLoRaScanStats();
+    }
+
+    String scanText = "Scan " + String(isLoRaScanEnabled() ? "aktiviert" : "deaktiviert") + ": ";
+    scanText += "Dwell=" + String(getLoRaScanDwellMillis()) + " ms, ";
+    scanText += "Cycle=" + String(getLoRaScanCycleMicros() / 1000.0f, 1) + " ms";
+    for (uint8_t i = 0; i < getLoRaScanChannelCount(); i++) {
+        LoRaScanChannelStats stats = getLoRaScanChannelStats(i);
+        const LoRaSettings* preset = getLoRaPreset(getLoRaScanChannelPreset(i));
+        scanText += "; " + String(getLoRaPresetName(getLoRaScanChannelPreset(i)));
+        scanText += " (Weight=" + String(getLoRaScanChannelWeight(i));
+        if (preset != nullptr) {
+            // Zum Vergleich mit der Umlaufdauer: Präambeln kürzer als ein Umlauf können verpasst werden
+            float preamble_ms = preset->preambleLength * (float)(1UL << preset->spreadingFactor) / preset->bandwidth_kHz;
+            scanText += ", Preamble=" + String(preamble_ms, 1) + " ms";
+        }
+        scanText += "): Visits=" + String(stats.visits);
+        scanText += ", CAD=" + String(stats.cadRuns);
+        scanText += ", Detections=" + String(stats.detections);
+        scanText += ", Packets=" + String(stats.packets);
+        scanText += ", Missed=" + String(stats.missedDwells);
+        scanText += ", Busy=" + String(stats.busy_ms) + " ms";
+    }
+    return scanText;
+}
+
+String setCompress(std::optional<bool> tx, std::optional<bool> rx, std::optional<bool> dict, bool reset) {
+    if (tx.has_value()) {
+        setCompressTxEnabled(tx.value());
+    }
+    if (rx.has_value()) {
+        setCompressRxEnabled(rx.value());
+    }
+    if (dict.has_value()) {
+        setCompressDictEnabled(dict.value());
+    }
+    if (reset) {
+        resetCompressStats();
+    }
+    CompressStats stats = getCompressStats();
+
+    String compressText = "Kompression: TX=" + String(isCompressTxEnabled() ? "an" : "aus") + ", ";
+    compressText += "RX=" + String(isCompressRxEnabled() ? "an" : "aus") + ", ";
+    compressText += "Dict=" + String(isCompressDictEnabled() ? "an" : "aus") + ", ";
+    compressText += "Packets=" + String(stats.txPackets) + ", ";
+    compressText += "Skipped=" + String(stats.txSkipped) + ", ";
+    compressText += "In=" + String(stats.txBytesIn) + " Bytes, ";
+    compressText += "Out=" + String(stats.txBytesOut) + " Bytes, ";
+    if (stats.txBytesIn > 0) {
+        compressText += "Ratio=" + String(stats.txBytesOut * 100.0f / stats.txBytesIn, 1) + " %, ";
+    }
+    compressText += "AirtimeSaved=" + String(stats.airtimeSaved_us / 1000) + " ms, ";
+    if (stats.txCyclesBytes > 0) {
+        compressText += "Cycles/Byte=" + String(stats.txCycles / stats.txCyclesBytes) + ", ";
+    }
+    compressText += "RxDecoded=" + String(stats.rxPackets) + ", ";
+    compressText += "RxErrors=" + String(stats.rxErrors);
+    return compressText;
+}
+
+String setCrypto(std::optional<const char*> key, std::optional<bool> persist, bool clear, std::optional<bool> tx,
+                 std::optional<bool> rx, std::optional<uint16_t> nodeId, bool reset) {
+    uint8_t raw[16];
+    if (key.has_value() && parseHexBytes(key.value(), raw, sizeof(raw)) != sizeof(raw)) {
+        return "ERROR: 'key' muss ein Hex-String mit 16 Bytes sein.";
+    }
+    if (key.has_value() && clear) {
+        return "ERROR: 'key' und 'clear' schließen sich aus.";
+    }
+    if (tx.value_or(false) && !hasCryptoKey() && (!key.has_value() || clear)) {
+        return "ERROR: Verschlüsselung braucht zuerst einen Schlüssel.";
+    }
+
+    String result;
+    bool changed = false;
+    if (key.has_value()) {
+        setCryptoKey(raw, persist.value_or(false));
+        memset(raw, 0, sizeof(raw));
+        changed = true;
+    } else if (clear) {
+        clearCryptoKey();
+        setCryptoTxEnabled(false);
+        changed = true;
+    }
+    if (nodeId.has_value()) {
+        setCryptoNodeId(nodeId.value());
+        changed = true;
+    }
+    if (tx.has_value()) {
+        setCryptoTxEnabled(tx.value());
+        changed = true;
+    }
+    if (rx.has_value()) {
+        setCryptoRxEnabled(rx.value());
+        changed = true;
+    }
+    if (reset) {
+        resetCryptoStats();
+    }
+    if (changed) {
+        result = persistConfig();
+    }
+    CryptoStats stats = getCryptoStats();
+
+    String cryptoText = "Verschlüsselung (AES-128-CCM): Key=";
+    if (!hasCryptoKey()) {
+        cryptoText += "keiner, ";
+    } else {
+        cryptoText += isCryptoKeyStored() ? "Flash, " : "RAM, ";
+    }
+    cryptoText += "TX=" + String(isCryptoTxEnabled() ? "an" : "aus") + ", ";
+    cryptoText += "RX=" + String(isCryptoRxEnabled() ? "an" : "aus") + ", ";
+    cryptoText += "Node=" + String(getCryptoNodeId()) + ", ";
+    cryptoText += "Counter=" + String(getCryptoCounter()) + "/" + String(getCryptoCounterLease()) + ", ";
+    cryptoText += "Tag=" + String(LORA_CRYPTO_TAG_BYTES) + " Bytes, ";
+    cryptoText += "Packets=" + String(stats.txPackets) + ", ";
+    cryptoText += "Bytes=" + String(stats.txBytes) + ", ";
+    if (stats.txBytes > 0) {
+        cryptoText += "Cycles/Byte=" + String(stats.txCycles / stats.txBytes) + ", ";
+    }
+    cryptoText += "LeaseWrites=" + String(stats.leaseWrites) + ", ";
+    cryptoText += "RxDecrypted=" + String(stats.rxPackets) + ", ";
+    cryptoText += "RxRejected=" + String(stats.rxRejected);
+    return cryptoText + result;
+}
@@ -1,12 +1,20 @@
 #ifndef COMMAND_H
 #define COMMAND_H
 
+#include "rxfilter.h"
+
+
+/**
+ * @brief Startet die Ausgabe der Hilfe; die Befehle folgen einzeln über nextHelpLine().
+ * @return String Einleitung mit der Anzahl der folgenden Hilfezeilen.
+ */
+String startHelp();
 
 /**
- * @brief Gibt eine Hilfe-Nachricht als String zurück.
- * @return String Eine formatierte Hilfe-Nachricht.
+ * @brief Liefert die nächste Hilfezeile (ein Befehl, konstant im Flash).
+ * @return const char* Die Zeile oder nullptr, wenn keine Ausgabe läuft bzw. alle Zeilen ausgegeben sind.
  */
-String showHelp();
+const char* nextHelpLine();
 
 /**
  * @brief Löst einen Software-Reset des Mikrocontrollers aus.
@@ -20,14 +28,33 @@ String resetDevice();
  */
 String getLoraConfig();
 
+/**
+ * @brief Gibt die Statistik des Empfangspuffers als String zurück.
+ * @return String Empfangene, übergelaufene und verworfene Pakete sowie Füllstand.
+ */
+String getRxStats();
+
+/**
+ * @brief Gibt die Statistik der gepufferten seriellen Ausgabe als String zurück.
+ * @return String Baudrate, Datensätze, verworfene Datensätze und Füllstand.
+ */
+String getSerialStats();
+
+/**
+ * @brief Gibt die Latenzstatistik eines Abschnitts (siehe latency.h) als String zurück.
+ * @return String Anzahl, Min/Avg/Max in Mikrosekunden und das log2-Histogramm in Zyklen.
+ */
+String getLatencyStats(uint8_t stage);
+
 /**
  * @brief Verarbeitet eine Sendeanforderung für ein LoRa-Paket.
  *        Dekodiert den Base64-Payload und übergibt ihn an das LoRa-Modul.
  * 
- * @param base64Payload Der Base64-kodierte Payload als String.
+ * @param base64Payload Der Base64-kodierte, nullterminierte Payload (wird nicht kopiert).
+ * @param at_us Geplanter Sendebeginn in Gerätezeit (siehe timebase.h), 0 = sofort.
  * @return String Eine Erfolgs- oder Fehlermeldung.
  */
-String sendLoraPayload(const String& base64Payload);
+String sendLoraPayload(const char* base64Payload, uint64_t at_us = 0);
 
 /**
  * @brief Setzt die LoRa-Konfiguration des Moduls anhand der übergebenen (optionalen) Parameter.
@@ -53,4 +80,205 @@ String setLoraConfig(std::optional<float> base_frequency_MHz,
                      std::optional<int8_t> outputPower_dBm, 
                      std::optional<uint16_t> preambleLength);
 
+/**
+ * @brief Wendet ein benanntes Profil (eingebaut oder Benutzerplatz) in einem Schritt an.
+ *        Der gerätespezifische Frequenzoffset bleibt erhalten.
+ * @param name Name des Profils, z.B. "meshtastic_longfast", "meshcore" oder "user1".
+ * @return String Eine Erfolgs- oder Fehlermeldung.
+ */
+String applyPreset(const char* name);
+
+/**
+ * @brief Speichert die aktuelle Konfiguration in einem Benutzerplatz.
+ * @param slot Nummer des Platzes (1 bis LORA_USER_PRESET_SLOTS).
+ * @return String Eine Erfolgs- oder Fehlermeldung.
+ */
+String savePreset(uint8_t slot);
+
+/**
+ * @brief Listet alle Profile mit ihren Parametern auf.
+ * @return String Freq/BW/SF/CR/Sync/Power/Präambel je Profil.
+ */
+String listPresets();
+
+/**
+ * @brief Schaltet Listen-before-talk (CAD vor jedem Senden) um und meldet die Zähler.
+ * @param enabled Optional neuer Zustand; ohne Wert wird nur der Status gemeldet.
+ * @return String Zustand, Anzahl der Prüfungen, belegte Prüfungen, verworfene Pakete, Wartezeit.
+ */
+String setLbt(std::optional<bool> enabled);
+
+/**
+ * @brief Schaltet das Auslesen des Frequenzfehlers je Empfangspaket um.
+ * @param enabled Optional neuer Zustand; ohne Wert wird nur der Status gemeldet.
+ * @return String Zustand und eingestellter SPI-Takt.
+ */
+String setFrequencyErrorReadout(std::optional<bool> enabled);
+
+/**
+ * @brief Durchläufe des Schedulers, mittlerer und größter Abstand zweier Durchläufe.
+ */
+String getSchedulerSummary();
+
+/**
+ * @brief Laufzeit (Mittel/Maximum) und Zeitgeber-Verspätung einer Aufgabe (siehe scheduler.h).
+ */
+String getSchedulerTaskText(uint8_t id);
+
+/**
+ * @brief Zähler der geplanten Sendeaufträge: gesendet, verspätet, Fehler des Sendebeginns, Vorlauf.
+ */
+String getTxScheduleText();
+
+/**
+ * @brief Wählt ein Energieprofil (siehe power.h) und meldet den Stand.
+ * @param profile Optional "continuous", "idle" oder "duty_cycle".
+ * @return String Aktives Profil, Schlafphasen und gemessener Wachanteil oder ERROR.
+ */
+String setPower(std::optional<const char*> profile);
+
+/**
+ * @brief Geschätzter mittlerer Strom und Weckverzögerung eines Profils.
+ */
+String getPowerProfileText(uint8_t profile);
+
+/**
+ * @brief Stellt die automatische Frequenzkorrektur ein (siehe afc.h) und meldet ihren Stand.
+ *        Fehlende Parameter behalten ihren bisherigen Wert.
+ * @param enabled   Optional neuer Zustand (schaltet die Frequenzfehler-Messung mit ein).
+ * @param perSender Optional getrennte Schätzung je Senderkennung.
+ * @param offset    Optional erstes Byte der Senderkennung in den Nutzdaten.
+ * @param length    Optional Länge der Senderkennung in Bytes.
+ * @param reset     Verwirft Schätzungen, Zähler und Verlauf.
+ * @return String Offset, Korrektur, Schätzung und Zähler.
+ */
+String setAfc(std::optional<bool> enabled, std::optional<bool> perSender, std::optional<uint8_t> offset,
+              std::optional<uint8_t> length, bool reset);
+
+/**
+ * @brief Beschreibt eine gespeicherte Korrektur (0 = neueste, siehe getAfcHistoryCount()).
+ */
+String getAfcHistoryText(uint8_t index);
+
+/**
+ * @brief Stellt die Duplikatunterdrückung ein (siehe dedup.h) und meldet ihre Zähler.
+ *        Fehlende Parameter behalten ihren bisherigen Wert.
+ * @param mode      Optional "off", "drop" oder "best".
+ * @param window_ms Optional neues Zeitfenster in Millisekunden.
+ * @param hold_ms   Optional neue Haltezeit im Modus "best".
+ * @param offset    Optional erstes Schlüsselbyte in den Nutzdaten.
+ * @param length    Optional Anzahl der Schlüsselbytes (0 = bis zum Paketende).
+ * @param reset     Setzt die Zähler zurück.
+ * @return String Einstellungen, Treffer, neue Pakete, Verdrängungen und Tabellenbelegung.
+ */
+String setDedup(std::optional<const char*> mode, std::optional<uint32_t> window_ms, std::optional<uint16_t> hold_ms,
+                std::optional<uint8_t> offset, std::optional<uint8_t> length, bool reset);
+
+/**
+ * @brief Baut eine Empfangsfilterregel aus den Befehlsparametern.
+ * @param type   "rssi", "snr", "len", "match" oder "deny".
+ * @param min    Untergrenze (RSSI in dBm, SNR in dB, Länge in Bytes).
+ * @param max    Obergrenze der Länge (nur "len").
+ * @param offset Erstes verglichenes Byte (nur "match"/"deny").
+ * @param value  Zu vergleichende Bytes als Hex-String (nur "match"/"deny").
+ * @param mask   Optionale Bitmaske als Hex-String gleicher Länge (Standard: alle Bits).
+ * @param rule   Erhält die fertige Regel.
+ * @return String Leer bei Erfolg, sonst eine Fehlermeldung.
+ */
+String makeRxFilterRule(const char* type, std::optional<float> min, std::optional<float> max, uint8_t offset,
+                        const char* value, const char* mask, RxFilterRule& rule);
+
+/**
+ * @brief Ändert die Empfangsfilterkette und meldet ihre Zähler.
+ * @param enabled Optional neuer Zustand der gesamten Kette.
+ * @param rules   Neue Regeln (können leer sein).
+ * @param count   Anzahl der Regeln in 'rules'.
+ * @param replace true: Kette durch 'rules' ersetzen, false: 'rules' anhängen.
+ * @param reset   Setzt alle Zähler zurück.
+ * @return String Zustand, Zähler der Kette und jede Regel mit ihren Treffern.
+ */
+String setRxFilter(std::optional<bool> enabled, const RxFilterRule* rules, uint8_t count, bool replace, bool reset);
+
+/**
+ * @brief Stellt den Repeater ein (siehe repeater.h) und meldet Zähler und Latenz.
+ *        Fehlende Parameter behalten ihren bisherigen Wert.
+ * @param enabled     Optional neuer Zustand.
+ * @param delayMin_ms Optional kürzeste zufällige Wartezeit vor dem Weitersenden.
+ * @param delayMax_ms Optional längste Wartezeit.
+ * @param window_ms   Optional Zeitfenster der Duplikatprüfung.
+ * @param hop         Optional "off", "ttl" oder "count".
+ * @param hopOffset   Optional Byte mit dem Hop-Feld.
+ * @param hopMask     Optional Bits des Hop-Felds (zusammenhängend, nicht 0).
+ * @param maxHops     Optional Obergrenze im Modus "count".
+ * @param reserve     Optional für den Host freizuhaltender Anteil des Duty-Cycle-Budgets in Prozent.
+ * @param rules       Neue Regelkette (nur wenn 'ruleCount' >= 0).
+ * @param ruleCount   Anzahl der Regeln oder -1, um die Kette beizubehalten.
+ * @param reset       Setzt die Zähler zurück.
+ * @return String Einstellungen, weitergesendete und unterdrückte Pakete samt Latenz, Regeln.
+ */
+String setRepeater(std::optional<bool> enabled, std::optional<uint16_t> delayMin_ms, std::optional<uint16_t> delayMax_ms,
+                   std::optional<uint32_t> window_ms, std::optional<const char*> hop, std::optional<uint8_t> hopOffset,
+                   std::optional<uint8_t> hopMask, std::optional<uint8_t> maxHops, std::optional<uint8_t> reserve,
+                   const RxFilterRule* rules, int8_t ruleCount, bool reset);
+
+/**
+ * @brief Dekodiert ein Base64-Teilstück und hängt es an den Puffer der Blockübertragung an.
+ * @param base64Payload Der Base64-kodierte, nullterminierte Teil der Nutzdaten.
+ * @return String Bisherige Pufferlänge oder eine Fehlermeldung.
+ */
+String appendBulkPayload(const char* base64Payload);
+
+/**
+ * @brief Startet die Blockübertragung des gefüllten Puffers (siehe bulk.h).
+ * @return String Nummer der Übertragung, Länge und Fragmentanzahl oder eine Fehlermeldung.
+ */
+String sendBulk();
+
+/**
+ * @brief Schaltet die Blockübertragung um und meldet Zustand und Zähler.
+ * @param enabled Optional neuer Zustand; ohne Wert wird nur der Status gemeldet.
+ * @param reset   Setzt die Zähler zurück.
+ * @return String Zustand, Pufferlänge, Sende- und Empfangszähler samt Nutzdatenrate.
+ */
+String setBulk(std::optional<bool> enabled, bool reset);
+
+/**
+ * @brief Stellt den Kanalscan ein und meldet die Zähler je Kanal (siehe lora.h).
+ * @param enabled  Optional neuer Zustand.
+ * @param dwell_ms Optional Mindestverweildauer je Besuch.
+ * @param names    Profilnamen der neuen Scan-Liste (nur wenn 'count' >= 0).
+ * @param weights  Gewichte der Kanäle (Besuche je Umlauf).
+ * @param count    Anzahl der Kanäle oder -1, um die Liste beizubehalten.
+ * @param reset    Setzt die Zähler zurück.
+ * @return String Zustand, Umlaufdauer und Zähler je Kanal oder eine Fehlermeldung.
+ */
+String setScan(std::optional<bool> enabled, std::optional<uint16_t> dwell_ms, const char* const* names,
+               const uint8_t* weights, int8_t count, bool reset);
+
+/**
+ * @brief Stellt die Kompression der Nutzdaten ein und meldet die Zähler (siehe compress.h).
+ * @param tx    Optional: Gesendete Pakete komprimieren.
+ * @param rx    Optional: Empfangene Pakete mit Kennbyte entpacken.
+ * @param dict  Optional: Eingebautes Telemetrie-Wörterbuch beim Senden verwenden.
+ * @param reset Setzt die Zähler zurück.
+ * @return String Zustand, Kompressionsrate, eingesparte Sendezeit und Zyklen pro Byte.
+ */
+String setCompress(std::optional<bool> tx, std::optional<bool> rx, std::optional<bool> dict, bool reset);
+
+/**
+ * @brief Stellt die Verschlüsselung der Nutzdaten ein und meldet die Zähler (siehe crypto.h).
+ *        Änderungen werden sofort in die Konfiguration im Flash übernommen; TX/RX gelten nach
+ *        einem Neustart nur mit dort gespeichertem Schlüssel.
+ * @param key     Optional neuer Schlüssel als Hex-String (16 Bytes).
+ * @param persist Optional: Schlüssel auch im Flash ablegen (Standard: nur im RAM).
+ * @param clear   Löscht den Schlüssel.
+ * @param tx      Optional: Gesendete Pakete verschlüsseln.
+ * @param rx      Optional: Empfangene Pakete mit Kennbyte prüfen und entschlüsseln.
+ * @param nodeId  Optional Knotennummer in der Nonce (0 = aus der Seriennummer).
+ * @param reset   Setzt die Zähler zurück.
+ * @return String Zustand (ohne den Schlüssel), Zählerstand, Paketzähler und Zyklen pro Byte.
+ */
+String setCrypto(std::optional<const char*> key, std::optional<bool> persist, bool clear, std::optional<bool> tx,
+                 std::optional<bool> rx, std::optional<uint16_t> nodeId, bool reset);
+
 #endif // COMMAND_H
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "airtime.h"
+#include "codec.h"
+#include "compress.h"
+#include "crypto.h"
+#include "latency.h"
+
+static const uint8_t COMPRESS_MAGIC_LZ      = 0xC5;
+static const uint8_t COMPRESS_MAGIC_LZ_DICT = 0xC6;
+static const size_t COMPRESS_MAX_PACKET     = 255;
+
+// Eingebautes Wörterbuch: häufige Schlüssel und Fragmente von JSON- und Key=Value-Telemetrie.
+// Häufigste Fragmente stehen am Ende (kürzere Abstände ändern das Format nicht, helfen aber beim Lesen).
+// Achtung: Jede Änderung macht die Firmware inkompatibel zu Gegenstellen mit dem alten Wörterbuch.
+static const uint8_t TELEMETRY_DICT[] =
+    "status=ok;error;uptime=;rssi=-;snr=;voltage=;battery=;humidity=;pressure=;temperature=;"
+    "\"time\":\"2026-\",\"seq\":,\"lat\":,\"lon\":,\"alt\":,\"rssi\":-,\"snr\":,\"bat\":,"
+    "\"hum\":,\"pres\":10,\"temp\":2,\"id\":\"node-\",\"ts\":17,\"v\":";
+
+static bool txEnabled = LORA_COMPRESS_TX_DEFAULT;
+static bool rxEnabled = LORA_COMPRESS_RX_DEFAULT;
+static bool dictEnabled = LORA_COMPRESS_DICT_DEFAULT;
+static CompressStats stats = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+static inline bool isMagic(uint8_t b) {
+  return b == COMPRESS_MAGIC_LZ || b == COMPRESS_MAGIC_LZ_DICT;
+}
+
+// Packt ein Rohpaket, das selbst mit einem Kennbyte beginnt, unkomprimiert ein
+static size_t storeForTx(const uint8_t* data, size_t len, uint8_t* output) {
+  size_t stored = lz_store(data, len, &output[1], COMPRESS_MAX_PACKET - 1);
+  if (stored == 0) {
+    return 0;
+  }
+  output[0] = COMPRESS_MAGIC_LZ;
+  return stored + 1;
+}
+
+size_t compressForTx(const uint8_t* data, size_t len, uint8_t* output, uint32_t& airtimeSaved_us) {
+  airtimeSaved_us = 0;
+  if (len == 0) {
+    return 0;
+  }
+
+  // Abgeschaltet geht jedes Paket unverändert hinaus, auch eines mit Kennbyte (siehe compress.h)
+  if (!txEnabled) {
+    memcpy(output, data, len);
+    return len;
+  }
+
+  // Ein Rohpaket mit Kennbyte muss eingepackt werden, auch wenn es dadurch länger wird; sonst
+  // entpackt die Gegenseite es fälschlich. Das Kennbyte der Verschlüsselung zählt nur auf Knoten
+  // mit Verschlüsselung, deren Gegenstellen es sonst als Geheimtext mit falschem Prüfwert verwerfen
+  bool cryptoNode = isCryptoTxEnabled() || isCryptoRxEnabled();
+  bool mustWrap = isMagic(data[0]) || (cryptoNode && data[0] == LORA_CRYPTO_MARKER);
+
+  // Ohne abschließendes Nullbyte des Stringliterals
+  const uint8_t* dict = dictEnabled ? TELEMETRY_DICT : nullptr;
+  size_t dictLen = dictEnabled ? sizeof(TELEMETRY_DICT) - 1 : 0;
+
+  uint32_t start = cycleCount();
+  size_t packed = lz_compress(data, len, dict, dictLen, &output[1], COMPRESS_MAX_PACKET - 1);
+  stats.txCycles += cycleCount() - start;
+  stats.txCyclesBytes += len;
+
+  if (packed == 0 || (packed + 1 >= len && !mustWrap)) {
+    stats.txSkipped++;
+    if (mustWrap) {
+      return storeForTx(data, len, output);
+    }
+    memcpy(output, data, len);
+    return len;
+  }
+
+  output[0] = dictEnabled ? COMPRESS_MAGIC_LZ_DICT : COMPRESS_MAGIC_LZ;
+  packed++;
+  uint32_t rawAirtime = getAirtimeMicros(len);
+  uint32_t packedAirtime = getAirtimeMicros(packed);
+  airtimeSaved_us = rawAirtime > packedAirtime ? rawAirtime - packedAirtime : 0;
+
+  stats.txPackets++;
+  stats.txBytesIn += len;
+  stats.txBytesOut += packed;
+  stats.airtimeSaved_us += airtimeSaved_us;
+  return packed;
+}
+
+size_t decompressRx(const uint8_t* data, size_t len, uint8_t* output) {
+  if (!rxEnabled || len < 2 || !isMagic(data[0])) {
+    return 0;
+  }
+  bool useDict = data[0] == COMPRESS_MAGIC_LZ_DICT;
+  size_t unpacked = lz_decompress(&data[1], len - 1, useDict ? TELEMETRY_DICT : nullptr,
+                                  useDict ? sizeof(TELEMETRY_DICT) - 1 : 0, output, COMPRESS_MAX_PACKET);
+  if (unpacked == 0) {
+    stats.rxErrors++;
+    return 0;
+  }
+  stats.rxPackets++;
+  return unpacked;
+}
+
+void setCompressTxEnabled(bool enabled) {
+  txEnabled = enabled;
+}
+
+bool isCompressTxEnabled() {
+  return txEnabled;
+}
+
+void setCompressRxEnabled(bool enabled) {
+  rxEnabled = enabled;
+}
+
+bool isCompressRxEnabled() {
+  return rxEnabled;
+}
+
+void setCompressDictEnabled(bool enabled) {
+  dictEnabled = enabled;
+}
+
+bool isCompressDictEnabled() {
+  return dictEnabled;
+}
+
+CompressStats getCompressStats() {
+  return stats;
+}
+
+void resetCompressStats() {
+  stats = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+}
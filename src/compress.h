@@ -0,0 +1,69 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <Arduino.h>
+
+//================================================================================
+// Optionale Kompression der Nutzdaten (spart Sendezeit bei Telemetrie-Texten)
+//================================================================================
+//
+// Komprimierte Pakete beginnen mit einem Kennbyte, danach folgt der LZ-Datenstrom (siehe codec.h):
+//   0xC5 : LZ ohne Wörterbuch
+//   0xC6 : LZ mit dem eingebauten Telemetrie-Wörterbuch
+// Ein Paket wird nur komprimiert gesendet, wenn es dadurch kürzer wird. Beginnt ein Rohpaket
+// selbst mit einem Kennbyte, wird es bei eingeschalteter Kompression immer eingepackt (notfalls
+// als 0xC5 mit reinen Literalen), damit die Gegenseite es nicht fälschlich entpackt. Dasselbe gilt
+// für das Kennbyte der Verschlüsselung (0xC7, siehe crypto.h), aber nur auf Knoten mit ein-
+// geschalteter Ver- oder Entschlüsselung; ohne Verschlüsselung bleibt solcher Verkehr unverändert.
+// Bei abgeschalteter Kompression gehen alle Pakete unverändert hinaus, auch solche mit Kennbyte.
+// Gegenstellen mit eingeschalteter RX-Dekompression dürfen solche Rohpakete daher nicht erhalten:
+// Entweder komprimieren alle Sender im Netz, oder die Anwendung vermeidet 0xC5/0xC6 als erstes Byte.
+
+/**
+ * @brief Zähler der Kompression.
+ */
+struct CompressStats {
+    uint32_t txPackets;       // Komprimiert gesendete Pakete
+    uint32_t txSkipped;       // Unkomprimiert gesendet (kein Gewinn)
+    uint32_t txBytesIn;       // Nutzdaten vor der Kompression (nur komprimierte Pakete)
+    uint32_t txBytesOut;      // ... und danach, einschließlich Kennbyte
+    uint32_t txCycles;        // CPU-Zyklen der Kompression (alle Pakete)
+    uint32_t txCyclesBytes;   // Dabei verarbeitete Bytes
+    uint32_t airtimeSaved_us; // Eingesparte Sendezeit
+    uint32_t rxPackets;       // Entpackte Pakete
+    uint32_t rxErrors;        // Pakete mit Kennbyte, aber ungültigem Datenstrom (roh publiziert)
+};
+
+/**
+ * @brief Bereitet ein Paket für das Senden vor: komprimiert es bei eingeschalteter Kompression,
+ *        sofern es dadurch kürzer wird.
+ * @param output Puffer mit mindestens 255 Bytes.
+ * @param airtimeSaved_us Erhält die eingesparte Sendezeit (0, wenn nicht komprimiert).
+ * @return Länge der zu sendenden Daten in 'output' (ggf. eine unveränderte Kopie) oder 0, wenn
+ *         ein Paket mit Kennbyte bei eingeschalteter Kompression eingepackt nicht mehr in 255 Bytes
+ *         passt (bzw. 'len' 0 ist).
+ */
+size_t compressForTx(const uint8_t* data, size_t len, uint8_t* output, uint32_t& airtimeSaved_us);
+
+/**
+ * @brief Entpackt ein empfangenes Paket mit Kennbyte bei eingeschalteter RX-Dekompression.
+ * @param output Puffer mit mindestens 255 Bytes.
+ * @return Entpackte Länge oder 0, wenn das Paket unverändert publiziert werden soll.
+ */
+size_t decompressRx(const uint8_t* data, size_t len, uint8_t* output);
+
+void setCompressTxEnabled(bool enabled);
+bool isCompressTxEnabled();
+void setCompressRxEnabled(bool enabled);
+bool isCompressRxEnabled();
+
+/**
+ * @brief Wählt, ob der Sender das eingebaute Telemetrie-Wörterbuch verwendet.
+ */
+void setCompressDictEnabled(bool enabled);
+bool isCompressDictEnabled();
+
+CompressStats getCompressStats();
+void resetCompressStats();
+
+#endif // COMPRESS_H
@@ -0,0 +1,188 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "crypto.h"
+#include "aes.h"
+#include "latency.h"
+#include "storage.h"
+
+static_assert(LORA_CRYPTO_TAG_BYTES >= 4 && LORA_CRYPTO_TAG_BYTES <= 16 && LORA_CRYPTO_TAG_BYTES % 2 == 0,
+              "LORA_CRYPTO_TAG_BYTES muss gerade und 4-16 sein");
+
+static uint8_t rawKey[16];
+static bool keyValid = false;
+static bool keyStored = false;
+static bool txEnabled = LORA_CRYPTO_TX_DEFAULT;
+static bool rxEnabled = LORA_CRYPTO_RX_DEFAULT;
+static uint16_t nodeId = 0;
+static uint32_t counter = 0;
+static uint32_t counterLease = 0;
+static CryptoStats stats = {0, 0, 0, 0, 0, 0};
+
+// Knotennummer aus der 96-Bit-Seriennummer des Chips (nie 0)
+static uint16_t chipNodeId() {
+  uint32_t h = HAL_GetUIDw0() ^ HAL_GetUIDw1() ^ HAL_GetUIDw2();
+  uint16_t id = (uint16_t)(h ^ (h >> 16));
+  return id != 0 ? id : 1;
+}
+
+// Sichert vor dem ersten Zählerstand jenseits des Vorrats einen neuen Vorrat im Flash
+static bool reserveCounter() {
+  if (counter < counterLease) {
+    return true;
+  }
+  uint32_t previous = counterLease;
+  counterLease = counter + LORA_CRYPTO_COUNTER_LEASE;
+  if (!saveStoredConfig()) {
+    counterLease = previous;
+    return false;
+  }
+  stats.leaseWrites++;
+  return true;
+}
+
+String encryptForTx(const uint8_t* data, size_t len, uint8_t* output, size_t& outputLen) {
+  if (!txEnabled) {
+    memcpy(output, data, len);
+    outputLen = len;
+    return "";
+  }
+  if (!keyValid) {
+    return "Verschlüsselung ohne Schlüssel eingeschaltet";
+  }
+  if (len > 255 - LORA_CRYPTO_OVERHEAD) {
+    return "Paket zu lang für die Verschlüsselung (" + String(len) + " > " + String(255 - LORA_CRYPTO_OVERHEAD) + " Bytes)";
+  }
+  if (!reserveCounter()) {
+    return "Zählerstand konnte nicht im Flash gesichert werden";
+  }
+
+  uint32_t start = cycleCount();
+  uint16_t node = getCryptoNodeId();
+  output[0] = LORA_CRYPTO_MARKER;
+  output[1] = (uint8_t)node;
+  output[2] = (uint8_t)(node >> 8);
+  for (uint8_t i = 0; i < 4; i++) {
+    output[3 + i] = (uint8_t)(counter >> (8 * i));
+  }
+  // Rundenschlüssel nur für die Dauer des Pakets auf dem Stack (spart 176 Bytes RAM)
+  AesKey aesKey;
+  aesSetKey(aesKey, rawKey);
+  aesCcmEncrypt(aesKey, output, LORA_CRYPTO_HEADER_BYTES, nullptr, 0, data, len,
+                output + LORA_CRYPTO_HEADER_BYTES, output + LORA_CRYPTO_HEADER_BYTES + len, LORA_CRYPTO_TAG_BYTES);
+  memset(&aesKey, 0, sizeof(aesKey));
+  counter++;
+
+  stats.txPackets++;
+  stats.txBytes += len;
+  stats.txCycles += cycleCount() - start;
+  outputLen = len + LORA_CRYPTO_OVERHEAD;
+  return "";
+}
+
+CryptoVerdict decryptRx(const uint8_t* data, size_t len, uint8_t* output, size_t& outputLen, uint16_t& node) {
+  if (!rxEnabled || len == 0 || data[0] != LORA_CRYPTO_MARKER) {
+    return CRYPTO_PLAIN;
+  }
+  if (!keyValid || len < LORA_CRYPTO_OVERHEAD) {
+    stats.rxRejected++;
+    return CRYPTO_REJECTED;
+  }
+  size_t plainLen = len - LORA_CRYPTO_OVERHEAD;
+  AesKey aesKey;
+  aesSetKey(aesKey, rawKey);
+  bool authentic = aesCcmDecrypt(aesKey, data, LORA_CRYPTO_HEADER_BYTES, nullptr, 0, data + LORA_CRYPTO_HEADER_BYTES,
+                                 plainLen, output, data + LORA_CRYPTO_HEADER_BYTES + plainLen, LORA_CRYPTO_TAG_BYTES);
+  memset(&aesKey, 0, sizeof(aesKey));
+  if (!authentic) {
+    stats.rxRejected++;
+    return CRYPTO_REJECTED;
+  }
+  node = data[1] | (uint16_t)data[2] << 8;
+  outputLen = plainLen;
+  stats.rxPackets++;
+  return CRYPTO_DECRYPTED;
+}
+
+void setCryptoKey(const uint8_t* key, bool persist) {
+  memcpy(rawKey, key, sizeof(rawKey));
+  keyValid = true;
+  keyStored = persist;
+}
+
+void clearCryptoKey() {
+  memset(rawKey, 0, sizeof(rawKey));
+  keyValid = false;
+  keyStored = false;
+}
+
+bool hasCryptoKey() {
+  return keyValid;
+}
+
+bool isCryptoKeyStored() {
+  return keyStored;
+}
+
+void setCryptoTxEnabled(bool enabled) {
+  txEnabled = enabled;
+}
+
+bool isCryptoTxEnabled() {
+  return txEnabled;
+}
+
+void setCryptoRxEnabled(bool enabled) {
+  rxEnabled = enabled;
+}
+
+bool isCryptoRxEnabled() {
+  return rxEnabled;
+}
+
+void setCryptoNodeId(uint16_t id) {
+  nodeId = id;
+}
+
+uint16_t getCryptoNodeId() {
+  return nodeId != 0 ? nodeId : chipNodeId();
+}
+
+uint32_t getCryptoCounter() {
+  return counter;
+}
+
+uint32_t getCryptoCounterLease() {
+  return counterLease;
+}
+
+void exportCryptoConfig(CryptoConfig& config) {
+  memset(&config, 0, sizeof(config));
+  config.keyStored = keyValid && keyStored ? 1 : 0;
+  config.flags = (txEnabled ? CRYPTO_FLAG_TX : 0) | (rxEnabled ? CRYPTO_FLAG_RX : 0);
+  config.nodeId = nodeId;
+  config.counterLease = counterLease;
+  if (config.keyStored) {
+    memcpy(config.key, rawKey, sizeof(config.key));
+  }
+}
+
+void importCryptoConfig(const CryptoConfig& config) {
+  nodeId = config.nodeId;
+  // Zählerstände unterhalb des Vorrats können vor dem Neustart verwendet worden sein
+  counterLease = config.counterLease;
+  counter = counterLease;
+  if (config.keyStored == 1) {
+    setCryptoKey(config.key, true);
+    txEnabled = (config.flags & CRYPTO_FLAG_TX) != 0;
+    rxEnabled = (config.flags & CRYPTO_FLAG_RX) != 0;
+  }
+}
+
+CryptoStats getCryptoStats() {
+  return stats;
+}
+
+void resetCryptoStats() {
+  stats = {0, 0, 0, 0, 0, 0};
+}
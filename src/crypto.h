@@ -0,0 +1,124 @@
+#ifndef CRYPTO_H
+#define CRYPTO_H
+
+#include <Arduino.h>
+#include "0_config.h"
+
+//================================================================================
+// Optionale Verschlüsselung der Nutzdaten (AES-128-CCM, siehe aes.h)
+//================================================================================
+//
+// Verschlüsselte Pakete beginnen mit einem Kennbyte:
+//   0xC7 | Knoten (2 Bytes) | Zähler (4 Bytes) | Geheimtext | Prüfwert (LORA_CRYPTO_TAG_BYTES)
+// Die ersten 7 Bytes sind zugleich die CCM-Nonce, Knoten und Zähler little-endian. Jeder Sender
+// verwendet eine eigene Knotennummer (Standard: aus der Seriennummer des Chips) und zählt je
+// Paket hoch. Damit sich eine Nonce auch nach einem Neustart nicht wiederholt, liegt im Flash
+// immer ein noch unbenutzter Zählerstand; ist der Vorrat von LORA_CRYPTO_COUNTER_LEASE Paketen
+// verbraucht, wird vor dem nächsten Paket ein neuer Stand gespeichert.
+//
+// Gesendet wird in der Reihenfolge Kompression, Verschlüsselung; empfangen umgekehrt. Empfangene
+// Pakete ohne Kennbyte werden unverändert publiziert, solche mit falschem Prüfwert verworfen.
+// Klartext, der selbst mit 0xC7 beginnt, packt compressForTx() bei eingeschalteter Kompression
+// auf Knoten mit Ver- oder Entschlüsselung ein (siehe compress.h), damit ihn die Gegenseite nicht
+// als verschlüsseltes Paket verwirft.
+// Wiederholt eingespielte Pakete erkennt diese Schicht nicht.
+//
+// Entschlüsselt wird erst bei der Ausgabe an den Host. AFC, Repeater, Blockübertragung,
+// Empfangsfilter und Dedup sehen das Paket so, wie es gesendet wurde: Byte-Regeln treffen
+// Kennbyte und Knotennummer (Bytes 0-2), aber nicht den Klartext; Dedup erkennt Kopien, weil
+// sie denselben Geheimtext tragen, und der Repeater leitet Pakete ohne Schlüssel weiter.
+//
+// Der Schlüssel liegt im RAM und auf Wunsch im Flash, dann samt den Schaltern für Senden und
+// Empfang. Ältere Datensätze im Flash behalten einen gelöschten Schlüssel, bis ihre Seite neu
+// beschrieben wird (siehe storage.h).
+
+#define LORA_CRYPTO_MARKER 0xC7
+#define LORA_CRYPTO_HEADER_BYTES 7
+#define LORA_CRYPTO_OVERHEAD (LORA_CRYPTO_HEADER_BYTES + LORA_CRYPTO_TAG_BYTES)
+
+enum CryptoVerdict : uint8_t {
+    CRYPTO_PLAIN,     // Kein verschlüsseltes Paket (oder Empfang abgeschaltet), unverändert publizieren
+    CRYPTO_DECRYPTED, // Entschlüsselt und Prüfwert korrekt
+    CRYPTO_REJECTED   // Kennbyte, aber zu kurz, kein Schlüssel oder falscher Prüfwert: verwerfen
+};
+
+/**
+ * @brief Zähler der Verschlüsselung.
+ */
+struct CryptoStats {
+    uint32_t txPackets;   // Verschlüsselt gesendete Pakete
+    uint32_t txBytes;     // Dabei verschlüsselte Nutzdaten
+    uint32_t txCycles;    // CPU-Zyklen dafür
+    uint32_t rxPackets;   // Entschlüsselte Pakete
+    uint32_t rxRejected;  // Verworfene Pakete mit Kennbyte
+    uint32_t leaseWrites; // Gespeicherte Zählerstände
+};
+
+#define CRYPTO_FLAG_TX 0x01
+#define CRYPTO_FLAG_RX 0x02
+
+/**
+ * @brief Dauerhaft gespeicherter Teil (siehe storage.cpp).
+ */
+struct CryptoConfig {
+    uint8_t keyStored;     // 1 = 'key' ist gültig
+    uint8_t flags;         // CRYPTO_FLAG_*, nur mit gespeichertem Schlüssel wirksam
+    uint16_t nodeId;       // 0 = aus der Seriennummer
+    uint32_t counterLease; // Erster noch nicht verwendeter Zählerstand
+    uint8_t key[16];
+};
+
+/**
+ * @brief Bereitet ein Paket für das Senden vor: verschlüsselt es bei eingeschalteter
+ *        Verschlüsselung, sonst wird es unverändert kopiert.
+ * @param output    Puffer mit mindestens 255 Bytes.
+ * @param outputLen Erhält die Länge der zu sendenden Daten.
+ * @return Leer bei Erfolg, sonst eine Fehlermeldung (kein Schlüssel, zu lang, Zählerstand
+ *         nicht gespeichert).
+ */
+String encryptForTx(const uint8_t* data, size_t len, uint8_t* output, size_t& outputLen);
+
+/**
+ * @brief Entschlüsselt ein empfangenes Paket mit Kennbyte bei eingeschaltetem Empfang.
+ * @param output    Puffer mit mindestens 255 Bytes.
+ * @param outputLen Erhält die Länge des Klartexts (nur bei CRYPTO_DECRYPTED).
+ * @param node      Erhält die Knotennummer des Senders (nur bei CRYPTO_DECRYPTED).
+ */
+CryptoVerdict decryptRx(const uint8_t* data, size_t len, uint8_t* output, size_t& outputLen, uint16_t& node);
+
+/**
+ * @brief Setzt einen neuen Schlüssel.
+ * @param persist true: Schlüssel beim nächsten Speichern der Konfiguration mit ablegen.
+ */
+void setCryptoKey(const uint8_t* key, bool persist);
+void clearCryptoKey();
+bool hasCryptoKey();
+bool isCryptoKeyStored();
+
+void setCryptoTxEnabled(bool enabled);
+bool isCryptoTxEnabled();
+void setCryptoRxEnabled(bool enabled);
+bool isCryptoRxEnabled();
+
+/**
+ * @brief Knotennummer in der Nonce (0 = aus der Seriennummer des Chips).
+ */
+void setCryptoNodeId(uint16_t nodeId);
+uint16_t getCryptoNodeId();
+
+/**
+ * @brief Zählerstand des nächsten Pakets und Ende des gespeicherten Vorrats.
+ */
+uint32_t getCryptoCounter();
+uint32_t getCryptoCounterLease();
+
+/**
+ * @brief Austausch mit dem Konfigurationsspeicher.
+ */
+void exportCryptoConfig(CryptoConfig& config);
+void importCryptoConfig(const CryptoConfig& config);
+
+CryptoStats getCryptoStats();
+void resetCryptoStats();
+
+#endif // CRYPTO_H
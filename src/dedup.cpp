@@ -0,0 +1,203 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "dedup.h"
+
+static_assert((LORA_DEDUP_TABLE_SIZE & (LORA_DEDUP_TABLE_SIZE - 1)) == 0, "LORA_DEDUP_TABLE_SIZE muss eine Zweierpotenz sein");
+static_assert(LORA_DEDUP_MAX_PROBE <= LORA_DEDUP_TABLE_SIZE, "LORA_DEDUP_MAX_PROBE größer als die Tabelle");
+
+// Ein Tabelleneintrag; hash == 0 kennzeichnet einen nie belegten Platz (Ende der Sondierkette)
+struct DedupEntry {
+  uint32_t hash;
+  uint32_t seen_ms; // Empfangszeit der ersten Kopie
+};
+
+// Ein zurückgehaltenes Paket im Modus DEDUP_BEST
+struct DedupHoldSlot {
+  bool used;
+  uint32_t hash;
+  uint32_t since_ms;
+  LoRaRxPacket packet;
+};
+
+static DedupEntry table[LORA_DEDUP_TABLE_SIZE];
+static DedupHoldSlot holdSlots[LORA_DEDUP_HOLD_SLOTS];
+static int8_t dueSlot = -1;
+
+static DedupSettings settings = {
+  (DedupMode)LORA_DEDUP_MODE_DEFAULT, LORA_DEDUP_WINDOW_MS, LORA_DEDUP_HOLD_MS, 0, 0
+};
+static DedupStats stats = {0, 0, 0, 0};
+
+// FNV-1a über den Schlüsselbereich; die Länge des Bereichs fließt mit ein
+static uint32_t keyHash(const LoRaRxPacket* packet) {
+  uint16_t start = settings.keyOffset < packet->len ? settings.keyOffset : packet->len;
+  uint16_t end = packet->len;
+  if (settings.keyLength != 0 && start + settings.keyLength < end) {
+    end = start + settings.keyLength;
+  }
+
+  uint32_t hash = 2166136261UL;
+  for (uint16_t i = start; i < end; i++) {
+    hash = (hash ^ packet->payload[i]) * 16777619UL;
+  }
+  hash = (hash ^ (end - start)) * 16777619UL;
+  return hash != 0 ? hash : 1;
+}
+
+static inline bool isExpired(const DedupEntry& entry, uint32_t now_ms) {
+  return now_ms - entry.seen_ms >= settings.window_ms;
+}
+
+// Kopien mit besserem RSSI (bei Gleichstand besserem SNR) ersetzen das zurückgehaltene Paket
+static void offerCopy(uint32_t hash, const LoRaRxPacket* packet) {
+  for (uint8_t i = 0; i < LORA_DEDUP_HOLD_SLOTS; i++) {
+    DedupHoldSlot& slot = holdSlots[i];
+    if (!slot.used || slot.hash != hash || i == dueSlot) {
+      continue;
+    }
+    if (packet->rssi > slot.packet.rssi || (packet->rssi == slot.packet.rssi && packet->snr > slot.packet.snr)) {
+      slot.packet = *packet;
+      stats.replaced++;
+    }
+    return;
+  }
+}
+
+static bool holdPacket(uint32_t hash, const LoRaRxPacket* packet) {
+  for (uint8_t i = 0; i < LORA_DEDUP_HOLD_SLOTS; i++) {
+    DedupHoldSlot& slot = holdSlots[i];
+    if (!slot.used) {
+      slot.used = true;
+      slot.hash = hash;
+      slot.since_ms = millis();
+      slot.packet = *packet;
+      return true;
+    }
+  }
+  return false;
+}
+
+DedupVerdict dedupFilter(const LoRaRxPacket* packet) {
+  if (settings.mode == DEDUP_OFF) {
+    return DEDUP_PASS;
+  }
+
+  uint32_t now = packet->timestamp_ms;
+  uint32_t hash = keyHash(packet);
+  uint8_t home = hash & (LORA_DEDUP_TABLE_SIZE - 1);
+
+  // Freien bzw. verfallenen Platz merken, sonst den ältesten gültigen Eintrag verdrängen
+  int16_t freeIndex = -1;
+  uint8_t oldestIndex = home;
+  uint32_t oldestAge = 0;
+
+  for (uint8_t probe = 0; probe < LORA_DEDUP_MAX_PROBE; probe++) {
+    uint8_t index = (home + probe) & (LORA_DEDUP_TABLE_SIZE - 1);
+    DedupEntry& entry = table[index];
+
+    if (entry.hash == 0) {
+      if (freeIndex < 0) {
+        freeIndex = index;
+      }
+      break;
+    }
+    if (isExpired(entry, now)) {
+      // Nicht abbrechen: Dahinter können noch gültige Einträge derselben Kette liegen
+      if (freeIndex < 0) {
+        freeIndex = index;
+      }
+      continue;
+    }
+    if (entry.hash == hash) {
+      stats.hits++;
+      if (settings.mode == DEDUP_BEST) {
+        offerCopy(hash, packet);
+      }
+      return DEDUP_DUPLICATE;
+    }
+    if (now - entry.seen_ms >= oldestAge) {
+      oldestAge = now - entry.seen_ms;
+      oldestIndex = index;
+    }
+  }
+
+  stats.misses++;
+  if (freeIndex < 0) {
+    freeIndex = oldestIndex;
+    stats.evictions++;
+  }
+  table[freeIndex].hash = hash;
+  table[freeIndex].seen_ms = now;
+
+  if (settings.mode == DEDUP_BEST && holdPacket(hash, packet)) {
+    return DEDUP_HELD;
+  }
+  return DEDUP_PASS;
+}
+
+const LoRaRxPacket* dedupPeekDue(uint32_t now_ms) {
+  dueSlot = -1;
+  uint32_t longest = 0;
+  for (uint8_t i = 0; i < LORA_DEDUP_HOLD_SLOTS; i++) {
+    const DedupHoldSlot& slot = holdSlots[i];
+    uint32_t held = now_ms - slot.since_ms;
+    if (slot.used && held >= settings.hold_ms && (dueSlot < 0 || held > longest)) {
+      dueSlot = i;
+      longest = held;
+    }
+  }
+  return dueSlot >= 0 ? &holdSlots[dueSlot].packet : nullptr;
+}
+
+void dedupReleaseDue() {
+  if (dueSlot >= 0) {
+    holdSlots[dueSlot].used = false;
+    dueSlot = -1;
+  }
+}
+
+void setDedupSettings(const DedupSettings& requested) {
+  DedupSettings next = requested;
+  if (next.mode > DEDUP_BEST) {
+    next.mode = DEDUP_OFF;
+  }
+  if (next.window_ms < LORA_DEDUP_WINDOW_MIN_MS) {
+    next.window_ms = LORA_DEDUP_WINDOW_MIN_MS;
+  } else if (next.window_ms > LORA_DEDUP_WINDOW_MAX_MS) {
+    next.window_ms = LORA_DEDUP_WINDOW_MAX_MS;
+  }
+  if (next.hold_ms > next.window_ms) {
+    next.hold_ms = next.window_ms;
+  }
+
+  bool keyChanged = next.window_ms != settings.window_ms || next.keyOffset != settings.keyOffset ||
+                    next.keyLength != settings.keyLength;
+  settings = next;
+  if (keyChanged) {
+    memset(table, 0, sizeof(table));
+  }
+}
+
+DedupSettings getDedupSettings() {
+  return settings;
+}
+
+uint8_t getDedupOccupancy() {
+  uint32_t now = millis();
+  uint8_t used = 0;
+  for (uint8_t i = 0; i < LORA_DEDUP_TABLE_SIZE; i++) {
+    if (table[i].hash != 0 && !isExpired(table[i], now)) {
+      used++;
+    }
+  }
+  return used;
+}
+
+DedupStats getDedupStats() {
+  return stats;
+}
+
+void resetDedupStats() {
+  stats = {0, 0, 0, 0};
+}
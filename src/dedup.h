@@ -0,0 +1,83 @@
+#ifndef DEDUP_H
+#define DEDUP_H
+
+#include <Arduino.h>
+#include "rxbuffer.h"
+
+//================================================================================
+// Duplikatunterdrückung für geflutete Mesh-Pakete
+//================================================================================
+//
+// Jedes empfangene Paket wird über einen 32-Bit-Hash (FNV-1a) wahlweise der gesamten
+// Nutzdaten oder eines Kopfbereichs erkannt. Die Hashes liegen mit Zeitpunkt in einer
+// offen adressierten Tabelle fester Größe (lineares Sondieren, höchstens
+// LORA_DEDUP_MAX_PROBE Plätze). Einträge verfallen nach dem Zeitfenster; ist der
+// Sondierbereich voll, wird der älteste Eintrag verdrängt.
+
+enum DedupMode : uint8_t {
+    DEDUP_OFF  = 0, // Jedes Paket wird publiziert
+    DEDUP_DROP = 1, // Erste Kopie sofort publizieren, weitere nur zählen
+    DEDUP_BEST = 2  // Erste Kopie kurz zurückhalten und die Kopie mit dem besten RSSI publizieren
+};
+
+enum DedupVerdict : uint8_t {
+    DEDUP_PASS,      // Neues Paket, sofort publizieren
+    DEDUP_DUPLICATE, // Kopie innerhalb des Zeitfensters, verwerfen
+    DEDUP_HELD       // Neues Paket, liegt bis zum Ablauf der Haltezeit im Haltepuffer
+};
+
+/**
+ * @brief Zähler der Duplikatunterdrückung.
+ */
+struct DedupStats {
+    uint32_t hits;      // Erkannte Kopien (nicht publiziert)
+    uint32_t misses;    // Neue Pakete
+    uint32_t evictions; // Vor Ablauf des Zeitfensters verdrängte Einträge
+    uint32_t replaced;  // Zurückgehaltene Pakete, die durch eine Kopie mit besserem RSSI ersetzt wurden
+};
+
+/**
+ * @brief Einstellungen der Duplikatunterdrückung.
+ */
+struct DedupSettings {
+    DedupMode mode;
+    uint32_t window_ms;  // Zeitfenster, in dem Kopien als Duplikat gelten
+    uint16_t hold_ms;    // Haltezeit im Modus DEDUP_BEST
+    uint8_t keyOffset;   // Erstes Byte des Schlüssels in den Nutzdaten
+    uint8_t keyLength;   // Anzahl der Schlüsselbytes (0 = bis zum Paketende)
+};
+
+/**
+ * @brief Prüft ein fehlerfrei empfangenes Paket gegen die Tabelle und trägt es ein.
+ *        Im Modus DEDUP_BEST wird die erste Kopie in den Haltepuffer kopiert; ist dieser
+ *        voll, wird sie sofort publiziert (DEDUP_PASS).
+ */
+DedupVerdict dedupFilter(const LoRaRxPacket* packet);
+
+/**
+ * @brief Liefert das älteste zurückgehaltene Paket, dessen Haltezeit abgelaufen ist.
+ * @return Zeiger in den Haltepuffer oder nullptr. Gültig bis dedupReleaseDue().
+ */
+const LoRaRxPacket* dedupPeekDue(uint32_t now_ms);
+
+/**
+ * @brief Gibt das mit dedupPeekDue() gelieferte Paket im Haltepuffer frei.
+ */
+void dedupReleaseDue();
+
+/**
+ * @brief Übernimmt neue Einstellungen. Ändern sich Zeitfenster oder Schlüssel, wird die
+ *        Tabelle geleert. Ungültige Werte werden auf den zulässigen Bereich begrenzt.
+ */
+void setDedupSettings(const DedupSettings& settings);
+DedupSettings getDedupSettings();
+
+/**
+ * @brief Anzahl der gültigen (nicht verfallenen) Tabelleneinträge.
+ */
+uint8_t getDedupOccupancy();
+
+DedupStats getDedupStats();
+void resetDedupStats();
+
+#endif // DEDUP_H
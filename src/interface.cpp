@@ -2,145 +2,739 @@
 #include <ArduinoJson.h>
 #include <optional>
 
+#include "0_config.h"
 #include "interface.h"
 #include "codec.h"  
 #include "lora.h"   
 #include "command.h"
+#include "binproto.h"
+#include "serialout.h"
+#include "latency.h"
+#include "bulk.h"
+#include "afc.h"
+#include "scheduler.h"
+#include "power.h"
+#include "timebase.h"
+#include "presets.h"
+#include "logger.h"
 
-// Buffer für eingehende serielle Daten
-String jsonInputBuffer;
+// Zeilenpuffer für eingehende serielle Daten (feste Größe, keine Heap-Allokation)
+static char jsonInputBuffer[JSON_INPUT_BUFFER_SIZE];
+static size_t jsonInputLen = 0;
+static bool jsonInputOverflow = false;
+
+// Zurücksenden der Eingabe (standardmäßig aus, halbiert die UART-Last)
+static bool serialEcho = DEFAULT_SERIAL_ECHO;
+
+// Aktiv, solange das binäre Rahmenprotokoll statt JSON verwendet wird
+static bool binaryMode = false;
 
 // Maximale Größe des JSON-Dokuments
 const int JSON_DOC_SIZE_RX = 512; 
-const int JSON_DOC_SIZE_LOG = 1024; 
 
 void setupJsonSerial() {
     publishLogAsJson("INFO", "DX-LR30-LORA - JSON Interface initialisiert."); 
 }
 
+// Schreibt eine Zeichenkette als JSON-String (Anführungszeichen, Backslash und Steuerzeichen maskiert)
+static void printJsonString(const char* text) {
+    serialOut.print('"');
+    const char* run = text; // Beginn der noch nicht geschriebenen unmaskierten Zeichen
+    for (const char* p = text; ; p++) {
+        char c = *p;
+        if (c != '\0' && c != '"' && c != '\\' && (uint8_t)c >= 0x20) {
+            continue;
+        }
+        serialOut.write((const uint8_t*)run, p - run);
+        if (c == '\0') {
+            break;
+        }
+        if (c == '"' || c == '\\') {
+            serialOut.print('\\');
+            serialOut.print(c);
+        } else {
+            static const char HEX_DIGITS[] = "0123456789abcdef";
+            serialOut.print("\\u00");
+            serialOut.print(HEX_DIGITS[c >> 4]);
+            serialOut.print(HEX_DIGITS[c & 0x0F]);
+        }
+        run = p + 1;
+    }
+    serialOut.print('"');
+}
+
 void publishLogAsJson(const char* level, const String& message) {
-    StaticJsonDocument<JSON_DOC_SIZE_LOG> doc;
-    doc["type"] = "log";
-    doc["level"] = level;
-    doc["message"] = message;
-    
-    serializeJson(doc, Serial);
-    Serial.println(); 
+    publishLogAsJson(level, message.c_str());
 }
 
-void handleJsonInput() {
-    while (Serial.available()) {
-        char c = Serial.read();
+void publishLogAsJson(const char* level, const char* message) {
+    if (binaryMode) {
+        publishBinaryLog(level, message);
+        return;
+    }
 
-        Serial.write(c);
+    // Direkt geschrieben statt über ein 1 KB großes JSON-Dokument auf dem Stack
+    serialOut.beginRecord();
+    serialOut.print("{\"type\":\"log\",\"level\":\"");
+    serialOut.print(level);
+    serialOut.print("\",\"message\":");
+    printJsonString(message);
+    serialOut.println('}');
+    serialOut.endRecord();
+}
 
-        if (c == '\n' || c == '\r') {
-            if (jsonInputBuffer.length() > 0) {
-                Serial.println();
-                // NEU: Konvertiere die gesamte Eingabe in Kleinbuchstaben, bevor irgendetwas anderes passiert.
-                jsonInputBuffer.toLowerCase();
-
-                // Prüfe auf den einfachen Befehl "help"
-                if (jsonInputBuffer == "help") { // Einfacher Vergleich, da jetzt alles klein ist
-                    publishLogAsJson("INFO", showHelp());
+void publishLogEntry(const char* type, const char* level, uint32_t time_ms, uint8_t id, const char* message) {
+    if (binaryMode) {
+        publishBinaryLog(level, message);
+        return;
+    }
+
+    serialOut.beginRecord();
+    serialOut.print("{\"type\":\"");
+    serialOut.print(type);
+    serialOut.print("\",\"level\":\"");
+    serialOut.print(level);
+    serialOut.print("\",\"t_ms\":");
+    serialOut.print(time_ms);
+    serialOut.print(",\"id\":");
+    serialOut.print(id);
+    serialOut.print(",\"message\":");
+    printJsonString(message);
+    serialOut.println('}');
+    serialOut.endRecord();
+}
+
+// Wandelt nur JSON-Schlüssel (und Literale außerhalb von Zeichenketten) in Kleinbuchstaben um.
+// Zeichenketten-Werte wie der Base64-Payload bleiben unverändert.
+static void lowercaseJsonKeys(char* line, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        char c = line[i];
+        if (c != '"' && c != '\'') {
+            line[i] = tolower((unsigned char)c);
+            i++;
+            continue;
+        }
+
+        // Zeichenkette bis zum passenden Anführungszeichen überspringen
+        char quote = c;
+        size_t start = ++i;
+        while (i < len && line[i] != quote) {
+            if (line[i] == '\\' && i + 1 < len) {
+                i++;
+            }
+            i++;
+        }
+        size_t end = i;
+        i++;
+
+        // Folgt ein ':', war die Zeichenkette ein Schlüssel
+        size_t next = i;
+        while (next < len && isspace((unsigned char)line[next])) {
+            next++;
+        }
+        if (next < len && line[next] == ':') {
+            for (size_t k = start; k < end; k++) {
+                line[k] = tolower((unsigned char)line[k]);
+            }
+        }
+    }
+}
+
+// Liest eine Empfangsfilterregel aus einem JSON-Objekt; liefert bei einem Fehler die Meldung
+static String parseRxFilterRule(JsonObject ruleObj, RxFilterRule& rule) {
+    const char* type = ruleObj["type"].is<const char*>() ? ruleObj["type"].as<const char*>() : "";
+    std::optional<float> min;
+    if (ruleObj.containsKey("min") && ruleObj["min"].is<float>()) min = ruleObj["min"].as<float>();
+    std::optional<float> max;
+    if (ruleObj.containsKey("max") && ruleObj["max"].is<float>()) max = ruleObj["max"].as<float>();
+    uint8_t offset = ruleObj["offset"].is<uint8_t>() ? ruleObj["offset"].as<uint8_t>() : 0;
+    const char* value = ruleObj["value"].is<const char*>() ? ruleObj["value"].as<const char*>() : "";
+    const char* mask = ruleObj["mask"].is<const char*>() ? ruleObj["mask"].as<const char*>() : "";
+    return makeRxFilterRule(type, min, max, offset, value, mask, rule);
+}
+
+// Gibt die Hilfe zeilenweise aus, jede als eigener Datensatz. Wie der Logverlauf nur bei
+// leerer Ausgabe, damit sie keine Empfangspakete verdrängt.
+static void handleHelpOutput() {
+    if (serialOut.pending() != 0) {
+        return;
+    }
+    const char* line = nextHelpLine();
+    if (line) {
+        publishLogAsJson("INFO", line);
+    }
+}
+
+// Verarbeitet eine vollständige Eingabezeile. Der Puffer wird dabei verändert.
+static void processJsonLine(char* line, size_t len) {
+    // Prüfe auf den einfachen Befehl "help"
+    if (strcasecmp(line, "help") == 0) {
+        publishLogAsJson("INFO", startHelp());
+        return;
+    }
+
+    lowercaseJsonKeys(line, len);
+
+    StaticJsonDocument<JSON_DOC_SIZE_RX> doc;
+    // Zero-Copy: Die Zeichenketten im Dokument zeigen direkt in den Zeilenpuffer
+    DeserializationError error = deserializeJson(doc, line, len);
+    latencyRecord(LAT_CMD_PARSE, latencyCommandStart());
+
+    if (error == DeserializationError::Ok) {
+        // Schlüssel wurden in lowercaseJsonKeys() vereinheitlicht
+        if (doc.containsKey("command") && doc["command"].is<JsonObject>()) {
+            JsonObject commandObj = doc["command"].as<JsonObject>();
+            String result = "";
+
+            // Unterbefehle prüfen (alle in Kleinbuchstaben)
+            if (commandObj.containsKey("getloraconfig")) {
+                result = getLoraConfig();
+                publishLogAsJson("INFO", result);
+            } else if (commandObj.containsKey("getrxstats")) {
+                result = getRxStats();
+                publishLogAsJson("INFO", result);
+            } else if (commandObj.containsKey("binary")) {
+                publishLogAsJson("INFO", "Wechsel in den Binärmodus (COBS/CRC16). Rückkehr per ESCAPE-Rahmen.");
+                resetBinaryInput();
+                binaryMode = true; // Restliche Eingabe wird bereits als Binärrahmen behandelt
+            } else if (commandObj.containsKey("echo")) {
+                JsonObject echoObj = commandObj["echo"].as<JsonObject>();
+                if (echoObj.containsKey("enabled") && echoObj["enabled"].is<bool>()) {
+                    serialEcho = echoObj["enabled"].as<bool>();
+                }
+                publishLogAsJson("INFO", "Echo " + String(serialEcho ? "aktiviert" : "deaktiviert"));
+            } else if (commandObj.containsKey("baud")) {
+                JsonObject baudObj = commandObj["baud"].as<JsonObject>();
+                if (baudObj.containsKey("rate") && baudObj["rate"].is<uint32_t>() &&
+                    isSupportedBaudRate(baudObj["rate"].as<uint32_t>())) {
+                    uint32_t rate = baudObj["rate"].as<uint32_t>();
+                    // Bestätigung noch mit der alten Baudrate senden
+                    publishLogAsJson("INFO", "Baudrate wird auf " + String(rate) + " umgestellt.");
+                    setSerialBaudRate(rate);
                 } else {
-                    StaticJsonDocument<JSON_DOC_SIZE_RX> doc;
-                    DeserializationError error = deserializeJson(doc, jsonInputBuffer);
-
-                    if (error == DeserializationError::Ok) {
-                        // Hauptschlüssel 'command' muss jetzt klein sein
-                        if (doc.containsKey("command") && doc["command"].is<JsonObject>()) {
-                            JsonObject commandObj = doc["command"].as<JsonObject>();
-                            String result = "";
-
-                            // Unterbefehle prüfen (alle in Kleinbuchstaben)
-                            if (commandObj.containsKey("getloraconfig")) {
-                                result = getLoraConfig();
-                                publishLogAsJson("INFO", result);
-                            } else if (commandObj.containsKey("help")) {
-                                result = showHelp();
-                                publishLogAsJson("INFO", result);
-                            } else if (commandObj.containsKey("reset")) {
-                                publishLogAsJson("INFO", "Befehl 'reset' empfangen. Gerät wird neu gestartet.");
-                                delay(100); // Kurze Verzögerung, um sicherzustellen, dass die serielle Nachricht gesendet wird.
-                                resetDevice(); // Diese Funktion kehrt nicht zurück.
-                            } else if (commandObj.containsKey("sendlora")) {
-                                JsonObject sendLoraObj = commandObj["sendlora"].as<JsonObject>();
-                                if (sendLoraObj.containsKey("payload") && sendLoraObj["payload"].is<const char*>()) {
-                                    String payload = sendLoraObj["payload"].as<String>();
-                                    result = sendLoraPayload(payload);
-                                    publishLogAsJson("INFO", "Befehl 'sendLora' ausgeführt: LoRa-Paket erfolgreich gesendet." );
-                                } else {
-                                    publishLogAsJson("ERROR", "Befehl 'sendlora' ohne gültigen 'payload'-String.");
-                                }
-                            } else if (commandObj.containsKey("setloraconfig")) {
-                                JsonObject setLoraConfigObj = commandObj["setloraconfig"].as<JsonObject>();
-                                
-                                // Parameter für setLoraConfig (alle in Kleinbuchstaben)
-                                std::optional<float> baseFreq;
-                                if (setLoraConfigObj.containsKey("freq") && setLoraConfigObj["freq"].is<float>()) baseFreq = setLoraConfigObj["freq"].as<float>();
-                                
-                                std::optional<float> offset;
-                                if (setLoraConfigObj.containsKey("offset") && setLoraConfigObj["offset"].is<float>()) offset = setLoraConfigObj["offset"].as<float>();
-                                
-                                std::optional<float> bw;
-                                if (setLoraConfigObj.containsKey("bw") && setLoraConfigObj["bw"].is<float>()) bw = setLoraConfigObj["bw"].as<float>();
-                                
-                                std::optional<uint8_t> sf;
-                                if (setLoraConfigObj.containsKey("sf") && setLoraConfigObj["sf"].is<uint8_t>()) sf = setLoraConfigObj["sf"].as<uint8_t>();
-                                
-                                std::optional<uint8_t> cr;
-                                if (setLoraConfigObj.containsKey("cr") && setLoraConfigObj["cr"].is<uint8_t>()) cr = setLoraConfigObj["cr"].as<uint8_t>();
-                                
-                                std::optional<uint8_t> sync;
-                                if (setLoraConfigObj.containsKey("sync")) {
-                                    if (setLoraConfigObj["sync"].is<const char*>()) {
-                                        const char* syncStr = setLoraConfigObj["sync"].as<const char*>();
-                                        sync = (uint8_t)strtoul(syncStr, NULL, 0);
-                                    } else if (setLoraConfigObj["sync"].is<uint8_t>()) {
-                                        sync = setLoraConfigObj["sync"].as<uint8_t>();
-                                    }
-                                }
-                                
-                                std::optional<int8_t> power;
-                                if (setLoraConfigObj.containsKey("power") && setLoraConfigObj["power"].is<int8_t>()) power = setLoraConfigObj["power"].as<int8_t>();
-                                
-                                std::optional<uint16_t> preamble;
-                                if (setLoraConfigObj.containsKey("preamble") && setLoraConfigObj["preamble"].is<uint16_t>()) preamble = setLoraConfigObj["preamble"].as<uint16_t>();
-
-                                result = setLoraConfig(baseFreq, offset, bw, sf, cr, sync, power, preamble);
-                                publishLogAsJson("INFO", "Befehl 'setLoraConfig' ausgeführt: " + result); 
-                            } else {
-                                publishLogAsJson("WARN", "Unbekannter Befehlstyp im 'command'-Objekt.");
-                            }
+                    publishLogAsJson("ERROR", "Befehl 'baud' ohne unterstützte 'rate' (9600, 57600, 115200, 230400, 460800, 921600).");
+                }
+            } else if (commandObj.containsKey("getserialstats")) {
+                result = getSerialStats();
+                publishLogAsJson("INFO", result);
+            } else if (commandObj.containsKey("preset")) {
+                JsonObject presetObj = commandObj["preset"].as<JsonObject>();
+                if (presetObj.containsKey("name") && presetObj["name"].is<const char*>()) {
+                    result = applyPreset(presetObj["name"].as<const char*>());
+                    publishLogAsJson("INFO", "Befehl 'preset' ausgeführt: " + result);
+                } else {
+                    publishLogAsJson("ERROR", "Befehl 'preset' ohne gültigen 'name'-String.");
+                }
+            } else if (commandObj.containsKey("savepreset")) {
+                JsonObject savePresetObj = commandObj["savepreset"].as<JsonObject>();
+                if (savePresetObj.containsKey("slot") && savePresetObj["slot"].is<uint8_t>()) {
+                    result = savePreset(savePresetObj["slot"].as<uint8_t>());
+                    publishLogAsJson("INFO", result);
+                } else {
+                    publishLogAsJson("ERROR", "Befehl 'savepreset' ohne gültigen 'slot'.");
+                }
+            } else if (commandObj.containsKey("listpresets")) {
+                result = listPresets();
+                publishLogAsJson("INFO", result);
+            } else if (commandObj.containsKey("lbt")) {
+                JsonObject lbtObj = commandObj["lbt"].as<JsonObject>();
+                std::optional<bool> enabled;
+                if (lbtObj.containsKey("enabled") && lbtObj["enabled"].is<bool>()) enabled = lbtObj["enabled"].as<bool>();
+                result = setLbt(enabled);
+                publishLogAsJson("INFO", result);
+            } else if (commandObj.containsKey("freqerror")) {
+                JsonObject freqObj = commandObj["freqerror"].as<JsonObject>();
+                std::optional<bool> enabled;
+                if (freqObj.containsKey("enabled") && freqObj["enabled"].is<bool>()) enabled = freqObj["enabled"].as<bool>();
+                result = setFrequencyErrorReadout(enabled);
+                publishLogAsJson("INFO", result);
+            } else if (commandObj.containsKey("bulkappend")) {
+                JsonObject appendObj = commandObj["bulkappend"].as<JsonObject>();
+                if (appendObj.containsKey("payload") && appendObj["payload"].is<const char*>()) {
+                    result = appendBulkPayload(appendObj["payload"].as<const char*>());
+                    publishLogAsJson(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+                } else {
+                    publishLogAsJson("ERROR", "Befehl 'bulkappend' ohne gültigen 'payload'-String.");
+                }
+            } else if (commandObj.containsKey("bulksend")) {
+                result = sendBulk();
+                publishLogAsJson(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+            } else if (commandObj.containsKey("bulkabort")) {
+                bulkAbort();
+                publishLogAsJson("INFO", "Blockübertragung abgebrochen, Puffer geleert.");
+            } else if (commandObj.containsKey("bulk")) {
+                JsonObject bulkObj = commandObj["bulk"].as<JsonObject>();
+                std::optional<bool> enabled;
+                if (bulkObj.containsKey("enabled") && bulkObj["enabled"].is<bool>()) enabled = bulkObj["enabled"].as<bool>();
+                bool reset = bulkObj.containsKey("reset") && bulkObj["reset"].as<bool>();
+                result = setBulk(enabled, reset);
+                publishLogAsJson("INFO", result);
+            } else if (commandObj.containsKey("scan")) {
+                // Kanäle als Profilname oder als {'preset': Name, 'weight': Gewicht}
+                JsonObject scanObj = commandObj["scan"].as<JsonObject>();
+                const char* names[LORA_SCAN_MAX_CHANNELS];
+                uint8_t weights[LORA_SCAN_MAX_CHANNELS];
+                int8_t count = -1;
+                String error = "";
+                if (scanObj.containsKey("channels") && scanObj["channels"].is<JsonArray>()) {
+                    count = 0;
+                    for (JsonVariant channelVar : scanObj["channels"].as<JsonArray>()) {
+                        if (count >= LORA_SCAN_MAX_CHANNELS) {
+                            error = "Zu viele Scan-Kanäle (max. " + String(LORA_SCAN_MAX_CHANNELS) + ").";
+                            break;
+                        }
+                        if (channelVar.is<const char*>()) {
+                            names[count] = channelVar.as<const char*>();
+                            weights[count] = 1;
+                        } else if (channelVar["preset"].is<const char*>()) {
+                            names[count] = channelVar["preset"].as<const char*>();
+                            weights[count] = channelVar["weight"].is<uint8_t>() ? channelVar["weight"].as<uint8_t>() : 1;
                         } else {
-                            publishLogAsJson("WARN", "JSON ohne Hauptschlüssel 'command' empfangen.");
+                            error = "Scan-Kanal ohne gültigen Profilnamen.";
+                            break;
+                        }
+                        count++;
+                    }
+                }
+                std::optional<bool> enabled;
+                if (scanObj.containsKey("enabled") && scanObj["enabled"].is<bool>()) enabled = scanObj["enabled"].as<bool>();
+                std::optional<uint16_t> dwell;
+                if (scanObj.containsKey("dwell_ms") && scanObj["dwell_ms"].is<uint16_t>()) dwell = scanObj["dwell_ms"].as<uint16_t>();
+                bool reset = scanObj.containsKey("reset") && scanObj["reset"].as<bool>();
+                if (error.length() > 0) {
+                    publishLogAsJson("ERROR", "Befehl 'scan': " + error);
+                } else {
+                    result = setScan(enabled, dwell, names, weights, count, reset);
+                    publishLogAsJson(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+                }
+            } else if (commandObj.containsKey("compress")) {
+                JsonObject compressObj = commandObj["compress"].as<JsonObject>();
+                std::optional<bool> tx, rx, dict;
+                if (compressObj.containsKey("tx") && compressObj["tx"].is<bool>()) tx = compressObj["tx"].as<bool>();
+                if (compressObj.containsKey("rx") && compressObj["rx"].is<bool>()) rx = compressObj["rx"].as<bool>();
+                if (compressObj.containsKey("dict") && compressObj["dict"].is<bool>()) dict = compressObj["dict"].as<bool>();
+                bool reset = compressObj.containsKey("reset") && compressObj["reset"].as<bool>();
+                result = setCompress(tx, rx, dict, reset);
+                publishLogAsJson("INFO", result);
+            } else if (commandObj.containsKey("crypto")) {
+                JsonObject cryptoObj = commandObj["crypto"].as<JsonObject>();
+                std::optional<const char*> key;
+                std::optional<bool> persist, tx, rx;
+                std::optional<uint16_t> node;
+                if (cryptoObj.containsKey("key") && cryptoObj["key"].is<const char*>()) key = cryptoObj["key"].as<const char*>();
+                if (cryptoObj.containsKey("persist") && cryptoObj["persist"].is<bool>()) persist = cryptoObj["persist"].as<bool>();
+                if (cryptoObj.containsKey("tx") && cryptoObj["tx"].is<bool>()) tx = cryptoObj["tx"].as<bool>();
+                if (cryptoObj.containsKey("rx") && cryptoObj["rx"].is<bool>()) rx = cryptoObj["rx"].as<bool>();
+                if (cryptoObj.containsKey("node") && cryptoObj["node"].is<uint16_t>()) node = cryptoObj["node"].as<uint16_t>();
+                bool clear = cryptoObj.containsKey("clear") && cryptoObj["clear"].as<bool>();
+                bool reset = cryptoObj.containsKey("reset") && cryptoObj["reset"].as<bool>();
+                result = setCrypto(key, persist, clear, tx, rx, node, reset);
+                publishLogAsJson(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+            } else if (commandObj.containsKey("rxfilter")) {
+                // 'rules' ersetzt die Kette, 'add' hängt eine Regel an; beides samt 'enabled' in einem Schritt
+                JsonObject filterObj = commandObj["rxfilter"].as<JsonObject>();
+                RxFilterRule rules[LORA_RX_FILTER_RULES];
+                uint8_t count = 0;
+                String error = "";
+                bool replace = filterObj.containsKey("rules") && filterObj["rules"].is<JsonArray>();
+                if (replace) {
+                    for (JsonVariant ruleVar : filterObj["rules"].as<JsonArray>()) {
+                        if (count >= LORA_RX_FILTER_RULES) {
+                            error = "Zu viele Regeln (max. " + String(LORA_RX_FILTER_RULES) + ").";
+                            break;
+                        }
+                        error = parseRxFilterRule(ruleVar.as<JsonObject>(), rules[count++]);
+                        if (error.length() > 0) break;
+                    }
+                } else if (filterObj.containsKey("add") && filterObj["add"].is<JsonObject>()) {
+                    error = parseRxFilterRule(filterObj["add"].as<JsonObject>(), rules[count++]);
+                }
+                std::optional<bool> enabled;
+                if (filterObj.containsKey("enabled") && filterObj["enabled"].is<bool>()) enabled = filterObj["enabled"].as<bool>();
+                bool reset = filterObj.containsKey("reset") && filterObj["reset"].as<bool>();
+
+                if (error.length() > 0) {
+                    publishLogAsJson("ERROR", "Befehl 'rxFilter' nicht übernommen: " + error);
+                } else {
+                    result = setRxFilter(enabled, rules, count, replace, reset);
+                    publishLogAsJson(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+                }
+            } else if (commandObj.containsKey("repeater")) {
+                JsonObject repeaterObj = commandObj["repeater"].as<JsonObject>();
+                RxFilterRule rules[LORA_RX_FILTER_RULES];
+                int8_t count = -1;
+                String error = "";
+                if (repeaterObj.containsKey("rules") && repeaterObj["rules"].is<JsonArray>()) {
+                    count = 0;
+                    for (JsonVariant ruleVar : repeaterObj["rules"].as<JsonArray>()) {
+                        if (count >= LORA_RX_FILTER_RULES) {
+                            error = "Zu viele Regeln (max. " + String(LORA_RX_FILTER_RULES) + ").";
+                            break;
                         }
-                    } else {
-                        publishLogAsJson("ERROR", "JSON Deserialisierungsfehler: " + String(error.c_str()));
+                        error = parseRxFilterRule(ruleVar.as<JsonObject>(), rules[count++]);
+                        if (error.length() > 0) break;
+                    }
+                }
+                std::optional<bool> enabled;
+                if (repeaterObj.containsKey("enabled") && repeaterObj["enabled"].is<bool>()) enabled = repeaterObj["enabled"].as<bool>();
+                std::optional<uint16_t> delayMin;
+                if (repeaterObj.containsKey("delay_min") && repeaterObj["delay_min"].is<uint16_t>()) delayMin = repeaterObj["delay_min"].as<uint16_t>();
+                std::optional<uint16_t> delayMax;
+                if (repeaterObj.containsKey("delay_max") && repeaterObj["delay_max"].is<uint16_t>()) delayMax = repeaterObj["delay_max"].as<uint16_t>();
+                std::optional<uint32_t> window;
+                if (repeaterObj.containsKey("window_ms") && repeaterObj["window_ms"].is<uint32_t>()) window = repeaterObj["window_ms"].as<uint32_t>();
+                std::optional<const char*> hop;
+                if (repeaterObj.containsKey("hop") && repeaterObj["hop"].is<const char*>()) hop = repeaterObj["hop"].as<const char*>();
+                std::optional<uint8_t> hopOffset;
+                if (repeaterObj.containsKey("hop_offset") && repeaterObj["hop_offset"].is<uint8_t>()) hopOffset = repeaterObj["hop_offset"].as<uint8_t>();
+                std::optional<uint8_t> hopMask;
+                if (repeaterObj.containsKey("hop_mask") && repeaterObj["hop_mask"].is<uint8_t>()) hopMask = repeaterObj["hop_mask"].as<uint8_t>();
+                std::optional<uint8_t> maxHops;
+                if (repeaterObj.containsKey("max_hops") && repeaterObj["max_hops"].is<uint8_t>()) maxHops = repeaterObj["max_hops"].as<uint8_t>();
+                std::optional<uint8_t> reserve;
+                if (repeaterObj.containsKey("reserve") && repeaterObj["reserve"].is<uint8_t>()) reserve = repeaterObj["reserve"].as<uint8_t>();
+                bool reset = repeaterObj.containsKey("reset") && repeaterObj["reset"].as<bool>();
+
+                if (error.length() > 0) {
+                    publishLogAsJson("ERROR", "Befehl 'repeater' nicht übernommen: " + error);
+                } else {
+                    result = setRepeater(enabled, delayMin, delayMax, window, hop, hopOffset, hopMask, maxHops, reserve,
+                                         rules, count, reset);
+                    publishLogAsJson(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+                }
+            } else if (commandObj.containsKey("dedup")) {
+                JsonObject dedupObj = commandObj["dedup"].as<JsonObject>();
+                std::optional<const char*> mode;
+                if (dedupObj.containsKey("mode") && dedupObj["mode"].is<const char*>()) mode = dedupObj["mode"].as<const char*>();
+                std::optional<uint32_t> window;
+                if (dedupObj.containsKey("window_ms") && dedupObj["window_ms"].is<uint32_t>()) window = dedupObj["window_ms"].as<uint32_t>();
+                std::optional<uint16_t> hold;
+                if (dedupObj.containsKey("hold_ms") && dedupObj["hold_ms"].is<uint16_t>()) hold = dedupObj["hold_ms"].as<uint16_t>();
+                std::optional<uint8_t> offset;
+                if (dedupObj.containsKey("offset") && dedupObj["offset"].is<uint8_t>()) offset = dedupObj["offset"].as<uint8_t>();
+                std::optional<uint8_t> length;
+                if (dedupObj.containsKey("length") && dedupObj["length"].is<uint8_t>()) length = dedupObj["length"].as<uint8_t>();
+                bool reset = dedupObj.containsKey("reset") && dedupObj["reset"].as<bool>();
+                result = setDedup(mode, window, hold, offset, length, reset);
+                publishLogAsJson(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+            } else if (commandObj.containsKey("afc")) {
+                JsonObject afcObj = commandObj["afc"].as<JsonObject>();
+                std::optional<bool> enabled;
+                if (afcObj.containsKey("enabled") && afcObj["enabled"].is<bool>()) enabled = afcObj["enabled"].as<bool>();
+                std::optional<bool> perSender;
+                if (afcObj.containsKey("per_sender") && afcObj["per_sender"].is<bool>()) perSender = afcObj["per_sender"].as<bool>();
+                std::optional<uint8_t> offset;
+                if (afcObj.containsKey("offset") && afcObj["offset"].is<uint8_t>()) offset = afcObj["offset"].as<uint8_t>();
+                std::optional<uint8_t> length;
+                if (afcObj.containsKey("length") && afcObj["length"].is<uint8_t>()) length = afcObj["length"].as<uint8_t>();
+                bool reset = afcObj.containsKey("reset") && afcObj["reset"].as<bool>();
+                publishLogAsJson("INFO", setAfc(enabled, perSender, offset, length, reset));
+                // Verlauf als eigene Datensätze, neueste zuerst
+                for (uint8_t i = 0; i < getAfcHistoryCount(); i++) {
+                    publishLogAsJson("INFO", getAfcHistoryText(i));
+                }
+            } else if (commandObj.containsKey("power")) {
+                JsonObject powerObj = commandObj["power"].as<JsonObject>();
+                std::optional<const char*> profile;
+                if (powerObj.containsKey("profile") && powerObj["profile"].is<const char*>()) profile = powerObj["profile"].as<const char*>();
+                result = setPower(profile);
+                publishLogAsJson(result.startsWith("ERROR") ? "ERROR" : "INFO", result);
+                // Schätzung je Profil als eigene Datensätze
+                for (uint8_t id = 0; id < POWER_PROFILE_COUNT; id++) {
+                    publishLogAsJson("INFO", getPowerProfileText(id));
+                }
+            } else if (commandObj.containsKey("stats")) {
+                // Ein Datensatz pro Abschnitt, damit keine Zeile den Ausgabepuffer sprengt
+                for (uint8_t stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+                    publishLogAsJson("INFO", getLatencyStats(stage));
+                }
+            } else if (commandObj.containsKey("tasks")) {
+                // Ein Datensatz pro Aufgabe, wie bei 'stats'
+                publishLogAsJson("INFO", getSchedulerSummary());
+                for (uint8_t id = 0; id < SCHEDULER_TASK_COUNT; id++) {
+                    publishLogAsJson("INFO", getSchedulerTaskText(id));
+                }
+                JsonObject tasksObj = commandObj["tasks"].as<JsonObject>();
+                if (tasksObj.containsKey("reset") && tasksObj["reset"].as<bool>()) {
+                    resetSchedulerStats();
+                }
+            } else if (commandObj.containsKey("sync")) {
+                // Gerätezeit am Zeilenende, nicht erst nach dem Parsen
+                uint64_t deviceUs = timebaseCommandMicros();
+                JsonObject syncObj = commandObj["sync"].as<JsonObject>();
+                if (syncObj.containsKey("host_us") && syncObj["host_us"].is<uint64_t>()) {
+                    timebaseSync(syncObj["host_us"].as<uint64_t>(), deviceUs);
+                }
+                publishTimeSync(deviceUs);
+                publishLogAsJson("INFO", getTxScheduleText());
+            } else if (commandObj.containsKey("dumplog")) {
+                publishLogAsJson("INFO", startLogDump());
+            } else if (commandObj.containsKey("resetstats")) {
+                resetLatencyStats();
+                publishLogAsJson("INFO", "Latenzstatistik zurückgesetzt.");
+            } else if (commandObj.containsKey("help")) {
+                publishLogAsJson("INFO", startHelp());
+            } else if (commandObj.containsKey("reset")) {
+                publishLogAsJson("INFO", "Befehl 'reset' empfangen. Gerät wird neu gestartet.");
+                flushSerialOutput(); // Sicherstellen, dass die serielle Nachricht gesendet wird.
+                resetDevice(); // Diese Funktion kehrt nicht zurück.
+            } else if (commandObj.containsKey("sendlora")) {
+                JsonObject sendLoraObj = commandObj["sendlora"].as<JsonObject>();
+                if (sendLoraObj.containsKey("payload") && sendLoraObj["payload"].is<const char*>()) {
+                    const char* payload = sendLoraObj["payload"].as<const char*>();
+                    uint64_t atUs = 0;
+                    if (sendLoraObj.containsKey("at_us") && sendLoraObj["at_us"].is<uint64_t>()) atUs = sendLoraObj["at_us"].as<uint64_t>();
+                    result = sendLoraPayload(payload, atUs);
+                    publishLogAsJson("INFO", "Befehl 'sendLora' ausgeführt: " + result);
+                } else {
+                    publishLogAsJson("ERROR", "Befehl 'sendlora' ohne gültigen 'payload'-String.");
+                }
+            } else if (commandObj.containsKey("setloraconfig")) {
+                JsonObject setLoraConfigObj = commandObj["setloraconfig"].as<JsonObject>();
+            
+                // Parameter für setLoraConfig (alle in Kleinbuchstaben)
+                std::optional<float> baseFreq;
+                if (setLoraConfigObj.containsKey("freq") && setLoraConfigObj["freq"].is<float>()) baseFreq = setLoraConfigObj["freq"].as<float>();
+            
+                std::optional<float> offset;
+                if (setLoraConfigObj.containsKey("offset") && setLoraConfigObj["offset"].is<float>()) offset = setLoraConfigObj["offset"].as<float>();
+            
+                std::optional<float> bw;
+                if (setLoraConfigObj.containsKey("bw") && setLoraConfigObj["bw"].is<float>()) bw = setLoraConfigObj["bw"].as<float>();
+            
+                std::optional<uint8_t> sf;
+                if (setLoraConfigObj.containsKey("sf") && setLoraConfigObj["sf"].is<uint8_t>()) sf = setLoraConfigObj["sf"].as<uint8_t>();
+            
+                std::optional<uint8_t> cr;
+                if (setLoraConfigObj.containsKey("cr") && setLoraConfigObj["cr"].is<uint8_t>()) cr = setLoraConfigObj["cr"].as<uint8_t>();
+            
+                std::optional<uint8_t> sync;
+                if (setLoraConfigObj.containsKey("sync")) {
+                    if (setLoraConfigObj["sync"].is<const char*>()) {
+                        const char* syncStr = setLoraConfigObj["sync"].as<const char*>();
+                        sync = (uint8_t)strtoul(syncStr, NULL, 0);
+                    } else if (setLoraConfigObj["sync"].is<uint8_t>()) {
+                        sync = setLoraConfigObj["sync"].as<uint8_t>();
                     }
                 }
-                jsonInputBuffer = "";
+            
+                std::optional<int8_t> power;
+                if (setLoraConfigObj.containsKey("power") && setLoraConfigObj["power"].is<int8_t>()) power = setLoraConfigObj["power"].as<int8_t>();
+            
+                std::optional<uint16_t> preamble;
+                if (setLoraConfigObj.containsKey("preamble") && setLoraConfigObj["preamble"].is<uint16_t>()) preamble = setLoraConfigObj["preamble"].as<uint16_t>();
+
+                result = setLoraConfig(baseFreq, offset, bw, sf, cr, sync, power, preamble);
+                publishLogAsJson("INFO", "Befehl 'setLoraConfig' ausgeführt: " + result); 
+            } else {
+                publishLogAsJson("WARN", "Unbekannter Befehlstyp im 'command'-Objekt.");
             }
         } else {
-            jsonInputBuffer += c;
+            publishLogAsJson("WARN", "JSON ohne Hauptschlüssel 'command' empfangen.");
         }
+    } else {
+        publishLogAsJson("ERROR", "JSON Deserialisierungsfehler: " + String(error.c_str()));
     }
 }
 
-void publishReceivedLoRaPacket(const uint8_t* payload, size_t len, int16_t rssi, float snr, float frequencyError) {
+void handleJsonInput() {
+    handleHelpOutput();
+
+    while (Serial.available()) {
+        char c = Serial.read();
+
+        if (binaryMode) {
+            if (!handleBinaryInputByte((uint8_t)c)) {
+                binaryMode = false;
+                publishLogAsJson("INFO", "Binärmodus beendet, JSON-Protokoll aktiv.");
+            }
+            continue;
+        }
+
+        if (serialEcho) {
+            serialOut.write(c);
+        }
+
+        if (c == '\n' || c == '\r') {
+            if (jsonInputOverflow) {
+                if (serialEcho) {
+                    serialOut.println();
+                }
+                publishLogAsJson("ERROR", "Eingabezeile zu lang (max. " + String(JSON_INPUT_BUFFER_SIZE - 1) + " Zeichen), verworfen.");
+            } else if (jsonInputLen > 0) {
+                if (serialEcho) {
+                    serialOut.println();
+                }
+                jsonInputBuffer[jsonInputLen] = '\0';
+                latencyMarkCommandStart();
+                processJsonLine(jsonInputBuffer, jsonInputLen);
+            }
+            jsonInputLen = 0;
+            jsonInputOverflow = false;
+        } else if (jsonInputLen < JSON_INPUT_BUFFER_SIZE - 1) {
+            jsonInputBuffer[jsonInputLen++] = c;
+        } else {
+            // Überlauf: Rest der Zeile bis zum nächsten Zeilenende verwerfen
+            jsonInputOverflow = true;
+        }
+    }
+}
+
+void publishReceivedLoRaPacket(const uint8_t* payload, size_t len, int16_t rssi, int16_t signalRssi, float snr,
+                               float frequencyError, uint8_t channel, uint64_t start_us, int32_t node) {
+  if (binaryMode) {
+    publishBinaryRx(payload, len, rssi, snr, frequencyError, channel);
+    return;
+  }
+
+  // Die Zeile wird direkt geschrieben, damit der Base64-Payload ohne Zwischenpuffer
+  // aus dem Empfangspuffer in die serielle Ausgabe kodiert werden kann.
+  serialOut.beginRecord();
+  serialOut.print("{\"type\":\"lora_rx\",\"t_us\":");
+  serialOut.print(start_us);
+  serialOut.print(",\"rssi\":");
+  serialOut.print(rssi);
+  if (signalRssi != rssi) {
+    // Nur unter dem Rauschen (SNR < 0) aussagekräftig und verschieden vom Paket-RSSI
+    serialOut.print(",\"signalRssi\":");
+    serialOut.print(signalRssi);
+  }
+  serialOut.print(",\"snr\":");
+  serialOut.print(snr, 2);
+  if (!isnan(frequencyError)) {
+    serialOut.print(",\"frequencyError\":");
+    serialOut.print(frequencyError / 1000.0, 2);
+  }
+  if (channel != LORA_SCAN_NO_CHANNEL) {
+    serialOut.print(",\"channel\":\"");
+    serialOut.print(getLoRaPresetName(channel));
+    serialOut.print('"');
+  }
+  if (node >= 0) {
+    serialOut.print(",\"node\":");
+    serialOut.print(node);
+  }
+  serialOut.print(",\"payload\":\"");
+  base64_encode(payload, len, serialOut);
+  serialOut.println("\"}");
+  serialOut.endRecord();
+}
+
+
+void publishLoRaTxDone(uint16_t id, size_t len, int state, uint32_t airtime_us, uint8_t cadBusy, uint32_t backoff_us,
+                       uint64_t start_us, uint64_t at_us) {
+  if (binaryMode) {
+    publishBinaryTxDone(id, len, state, airtime_us, cadBusy, backoff_us);
+    return;
+  }
+
   StaticJsonDocument<JSON_DOC_SIZE_RX> doc;
 
-  doc["type"] = "lora_rx";
-  doc["rssi"] = rssi;
-  doc["snr"] = snr;
-  doc["frequencyError"] = round((frequencyError / 1000.0) * 100.0) / 100.0;
+  doc["type"] = "lora_tx_done";
+  doc["id"] = id;
+  doc["len"] = len;
+  doc["state"] = state;
+  doc["airtime_ms"] = round(airtime_us / 100.0) / 10.0;
+  doc["cad_busy"] = cadBusy;
+  doc["backoff_ms"] = round(backoff_us / 100.0) / 10.0;
+  if (start_us != 0) {
+    doc["t_us"] = start_us;
+  }
+  if (at_us != 0) {
+    doc["at_us"] = at_us;
+    if (start_us != 0) {
+      doc["error_us"] = (int32_t)(int64_t)(start_us - at_us);
+    }
+  }
+
+  serialOut.beginRecord();
+  serializeJson(doc, serialOut);
+  serialOut.println(); 
+  serialOut.endRecord();
+}
+
+void publishTimeSync(uint64_t device_us) {
+  StaticJsonDocument<JSON_DOC_SIZE_RX> doc;
+  TimebaseSync sync = getTimebaseSync();
 
-  String base64Payload;
-  base64_encode(payload, len, base64Payload); 
-  doc["payload"] = base64Payload;
+  doc["type"] = "sync";
+  doc["t_us"] = device_us;
+  if (sync.count > 0) {
+    doc["host_us"] = sync.host_us;
+    doc["device_us"] = sync.device_us;
+    doc["syncs"] = sync.count;
+  }
+  if (sync.driftValid) {
+    doc["drift_ppm"] = round(sync.drift_ppm * 100.0) / 100.0;
+  }
 
-  serializeJson(doc, Serial);
-  Serial.println(); 
+  serialOut.beginRecord();
+  serializeJson(doc, serialOut);
+  serialOut.println();
+  serialOut.endRecord();
 }
 
+void publishBulkTxDone(uint8_t id, uint16_t len, bool ok, uint8_t fragments, uint16_t retransmissions,
+                       uint16_t timeouts, uint32_t duration_ms) {
+  if (binaryMode) {
+    publishBinaryBulkTxDone(id, len, ok, fragments, retransmissions, timeouts, duration_ms);
+    return;
+  }
+
+  StaticJsonDocument<JSON_DOC_SIZE_RX> doc;
+
+  doc["type"] = "lora_bulk_tx_done";
+  doc["id"] = id;
+  doc["len"] = len;
+  doc["ok"] = ok;
+  doc["fragments"] = fragments;
+  doc["retransmissions"] = retransmissions;
+  doc["timeouts"] = timeouts;
+  doc["duration_ms"] = duration_ms;
+  doc["goodput_bps"] = duration_ms == 0 ? 0 : (uint32_t)((uint64_t)len * 8000 / duration_ms);
+
+  serialOut.beginRecord();
+  serializeJson(doc, serialOut);
+  serialOut.println(); 
+  serialOut.endRecord();
+}
+
+void publishBulkRx(uint8_t id, uint16_t len, uint8_t fragments, uint32_t duration_ms) {
+  if (binaryMode) {
+    publishBinaryBulkRx(id, len, fragments, duration_ms);
+    return;
+  }
+
+  StaticJsonDocument<JSON_DOC_SIZE_RX> doc;
+
+  doc["type"] = "lora_bulk_rx";
+  doc["id"] = id;
+  doc["len"] = len;
+  doc["fragments"] = fragments;
+  doc["duration_ms"] = duration_ms;
+  doc["goodput_bps"] = duration_ms == 0 ? 0 : (uint32_t)((uint64_t)len * 8000 / duration_ms);
+
+  serialOut.beginRecord();
+  serializeJson(doc, serialOut);
+  serialOut.println(); 
+  serialOut.endRecord();
+}
+
+void publishBulkData(uint8_t id, uint16_t offset, const uint8_t* data, size_t len) {
+  if (binaryMode) {
+    publishBinaryBulkData(id, offset, data, len);
+    return;
+  }
+
+  // Wie bei lora_rx wird der Base64-Text direkt in die Ausgabe kodiert
+  serialOut.beginRecord();
+  serialOut.print("{\"type\":\"lora_bulk_data\",\"id\":");
+  serialOut.print(id);
+  serialOut.print(",\"offset\":");
+  serialOut.print(offset);
+  serialOut.print(",\"payload\":\"");
+  base64_encode(data, len, serialOut);
+  serialOut.println("\"}");
+  serialOut.endRecord();
+}
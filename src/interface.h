@@ -1,11 +1,36 @@
 #ifndef INTERFACE_H
 #define INTERFACE_H
 
-// Aktuelle Funktion für den Empfang von LoRa-Paketen
-void publishReceivedLoRaPacket(const uint8_t* payload, size_t len, int16_t rssi, float snr, float frequencyError);
+// Aktuelle Funktion für den Empfang von LoRa-Paketen. 'channel' ist der Profil-Index des
+// Scan-Kanals oder LORA_SCAN_NO_CHANNEL (dann ohne Kanalangabe wie bisher).
+// Ein Frequenzfehler NAN (Messung abgeschaltet) und ein Signal-RSSI gleich dem RSSI werden nicht ausgegeben.
+// 'start_us' ist der Paketbeginn in Gerätezeit (siehe timebase.h); im Binärmodus entfällt er.
+// 'node' ist die Knotennummer eines entschlüsselten Pakets (-1 = unverschlüsselt, siehe crypto.h).
+void publishReceivedLoRaPacket(const uint8_t* payload, size_t len, int16_t rssi, int16_t signalRssi, float snr,
+                               float frequencyError, uint8_t channel, uint64_t start_us, int32_t node);
+
+// Meldet den Abschluss eines Sendeauftrags inklusive gemessener Sendedauer sowie
+// der belegten Kanalprüfungen und Wartezeit vor dem Senden (Listen-before-talk).
+// 'start_us' ist der gemessene Sendebeginn (0 = nicht gesendet), 'at_us' der geplante (0 = sofort).
+void publishLoRaTxDone(uint16_t id, size_t len, int state, uint32_t airtime_us, uint8_t cadBusy, uint32_t backoff_us,
+                       uint64_t start_us, uint64_t at_us);
+
+// Antwort auf 'sync': Gerätezeit am Ende der Befehlszeile und Stand des Abgleichs
+void publishTimeSync(uint64_t device_us);
+
+// Blockübertragung: Abschluss einer gesendeten Übertragung, vollständiger Empfang (Kopf)
+// und die empfangenen Daten in Teilstücken
+void publishBulkTxDone(uint8_t id, uint16_t len, bool ok, uint8_t fragments, uint16_t retransmissions,
+                       uint16_t timeouts, uint32_t duration_ms);
+void publishBulkRx(uint8_t id, uint16_t len, uint8_t fragments, uint32_t duration_ms);
+void publishBulkData(uint8_t id, uint16_t offset, const uint8_t* data, size_t len);
 
 // Neue Funktion zur Veröffentlichung von Log-Nachrichten als JSON
 void publishLogAsJson(const char* level, const String& message);
+void publishLogAsJson(const char* level, const char* message);
+
+// Gibt eine formatierte Meldung des Ereignisprotokolls aus ('log' oder 'log_dump', siehe logger.h)
+void publishLogEntry(const char* type, const char* level, uint32_t time_ms, uint8_t id, const char* message);
 
 // Funktionen für die serielle JSON-Kommunikation
 void setupJsonSerial(); // NEU: Deklaration hinzugefügt
@@ -0,0 +1,110 @@
+#include <Arduino.h>
+
+#include "latency.h"
+
+static LatencyStageStats stageStats[LATENCY_STAGE_COUNT];
+
+static const char* const STAGE_NAMES[LATENCY_STAGE_COUNT] = {
+  "rx_read", "rx_status", "rx_turnaround", "rx_queue", "rx_encode", "rx_serial", "rx_total",
+  "cmd_parse", "cmd_tx_start", "tx_airtime"
+};
+
+static uint32_t commandStartCycles = 0;
+
+// Empfangsdatensätze, die noch im Ausgabepuffer stehen
+struct SerialMarker {
+  uint16_t endPosition;
+  uint32_t isrCycles;
+  uint32_t encodedCycles;
+};
+
+static const uint8_t SERIAL_MARKER_COUNT = 8;
+static SerialMarker serialMarkers[SERIAL_MARKER_COUNT];
+static uint8_t markerHead = 0;
+static uint8_t markerTail = 0;
+
+void setupLatencyStats() {
+#ifndef NATIVE_BUILD
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  resetLatencyStats();
+}
+
+void latencyRecordSpan(LatencyStage stage, uint32_t startCycles, uint32_t endCycles) {
+  uint32_t cycles = endCycles - startCycles; // Überlauf des Zählers ist so unschädlich
+  LatencyStageStats& s = stageStats[stage];
+
+  if (s.count == 0 || cycles < s.min) {
+    s.min = cycles;
+  }
+  if (cycles > s.max) {
+    s.max = cycles;
+  }
+  s.count++;
+  s.sum += cycles;
+
+  uint8_t bin = cycles == 0 ? 0 : 32 - __builtin_clz(cycles);
+  if (bin >= LATENCY_HISTOGRAM_BINS) {
+    bin = LATENCY_HISTOGRAM_BINS - 1;
+  }
+  if (s.histogram[bin] < UINT16_MAX) {
+    s.histogram[bin]++;
+  }
+}
+
+void latencyRecord(LatencyStage stage, uint32_t startCycles) {
+  latencyRecordSpan(stage, startCycles, cycleCount());
+}
+
+void latencyMarkCommandStart() {
+  commandStartCycles = cycleCount();
+  if (commandStartCycles == 0) {
+    commandStartCycles = 1; // 0 bedeutet "nicht markiert"
+  }
+}
+
+uint32_t latencyCommandStart() {
+  return commandStartCycles;
+}
+
+void latencyTrackSerial(uint16_t endPosition, uint32_t isrCycles, uint32_t encodedCycles) {
+  if ((uint8_t)(markerHead - markerTail) >= SERIAL_MARKER_COUNT) {
+    return; // Zu viele offene Datensätze, dieser wird nicht vermessen
+  }
+  SerialMarker& m = serialMarkers[markerHead % SERIAL_MARKER_COUNT];
+  m.endPosition   = endPosition;
+  m.isrCycles     = isrCycles;
+  m.encodedCycles = encodedCycles;
+  markerHead++;
+}
+
+void latencyOnSerialDrained(uint16_t tailPosition) {
+  if (markerHead == markerTail) {
+    return;
+  }
+  uint32_t now = cycleCount();
+  while (markerHead != markerTail) {
+    SerialMarker& m = serialMarkers[markerTail % SERIAL_MARKER_COUNT];
+    if ((int16_t)(tailPosition - m.endPosition) < 0) {
+      break; // Datensatz noch nicht vollständig übergeben
+    }
+    latencyRecordSpan(LAT_RX_SERIAL, m.encodedCycles, now);
+    latencyRecordSpan(LAT_RX_TOTAL, m.isrCycles, now);
+    markerTail++;
+  }
+}
+
+void resetLatencyStats() {
+  memset(stageStats, 0, sizeof(stageStats));
+  markerTail = markerHead;
+}
+
+const LatencyStageStats& getLatencyStageStats(uint8_t stage) {
+  return stageStats[stage < LATENCY_STAGE_COUNT ? stage : 0];
+}
+
+const char* latencyStageName(uint8_t stage) {
+  return stage < LATENCY_STAGE_COUNT ? STAGE_NAMES[stage] : "?";
+}
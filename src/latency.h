@@ -0,0 +1,104 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <Arduino.h>
+
+//================================================================================
+// Latenzmessung mit dem DWT-Zykluszähler (Cortex-M3)
+//================================================================================
+
+/**
+ * @brief Gemessene Abschnitte auf dem Empfangs- und Sendepfad.
+ */
+enum LatencyStage : uint8_t {
+    LAT_RX_READ,       // ISR-Eintritt -> readData() fertig
+    LAT_RX_STATUS,     // readData() fertig -> RSSI/SNR/Frequenzfehler gelesen
+    LAT_RX_TURNAROUND, // ISR-Eintritt -> Modul wieder empfangsbereit für das nächste Paket
+    LAT_RX_QUEUE,      // Status gelesen -> Beginn der Kodierung (Wartezeit im Ringpuffer)
+    LAT_RX_ENCODE,     // Kodierung des Datensatzes in den Ausgabepuffer
+    LAT_RX_SERIAL,     // Datensatz kodiert -> letztes Byte an den UART übergeben
+    LAT_RX_TOTAL,      // ISR-Eintritt -> letztes Byte an den UART übergeben
+    LAT_CMD_PARSE,     // Zeilen- bzw. Rahmenende -> Befehl geparst
+    LAT_CMD_TX_START,  // Zeilen- bzw. Rahmenende -> Übertragung gestartet
+    LAT_TX_AIRTIME,    // Übertragung gestartet -> TxDone
+    LATENCY_STAGE_COUNT
+};
+
+// Anzahl der log2-Histogrammklassen (Klasse k zählt Werte mit 2^(k-1) <= Zyklen < 2^k)
+#define LATENCY_HISTOGRAM_BINS 32
+
+/**
+ * @brief Statistik eines Abschnitts in CPU-Zyklen.
+ */
+struct LatencyStageStats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint16_t histogram[LATENCY_HISTOGRAM_BINS];
+};
+
+/**
+ * @brief Aktueller Stand des freilaufenden Zykluszählers.
+ */
+static inline uint32_t cycleCount() {
+#ifdef NATIVE_BUILD
+    return micros() * (SystemCoreClock / 1000000UL);
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+/**
+ * @brief Gibt den Zykluszähler im DWT frei. Muss einmal beim Start aufgerufen werden.
+ */
+void setupLatencyStats();
+
+/**
+ * @brief Verbucht die Spanne von 'startCycles' bis 'endCycles' für einen Abschnitt.
+ *        Nur aus der Hauptschleife aufrufen.
+ */
+void latencyRecordSpan(LatencyStage stage, uint32_t startCycles, uint32_t endCycles);
+
+/**
+ * @brief Verbucht die Spanne von 'startCycles' bis jetzt.
+ */
+void latencyRecord(LatencyStage stage, uint32_t startCycles);
+
+/**
+ * @brief Merkt sich den Zeitpunkt, zu dem eine Befehlszeile bzw. ein Binärrahmen vollständig war.
+ */
+void latencyMarkCommandStart();
+
+/**
+ * @brief Zeitpunkt des zuletzt markierten Befehls (0, wenn keiner markiert ist).
+ */
+uint32_t latencyCommandStart();
+
+/**
+ * @brief Beobachtet einen Empfangsdatensatz im Ausgabepuffer, bis sein letztes Byte
+ *        (Position 'endPosition') an den UART übergeben ist.
+ */
+void latencyTrackSerial(uint16_t endPosition, uint32_t isrCycles, uint32_t encodedCycles);
+
+/**
+ * @brief Wird von der Ausgabe aufgerufen, nachdem Bytes bis 'tailPosition' übergeben wurden.
+ */
+void latencyOnSerialDrained(uint16_t tailPosition);
+
+/**
+ * @brief Setzt alle Abschnitte zurück.
+ */
+void resetLatencyStats();
+
+/**
+ * @brief Lesezugriff auf die Statistik eines Abschnitts.
+ */
+const LatencyStageStats& getLatencyStageStats(uint8_t stage);
+
+/**
+ * @brief Kurzname eines Abschnitts (z.B. "rx_read").
+ */
+const char* latencyStageName(uint8_t stage);
+
+#endif // LATENCY_H
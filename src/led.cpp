@@ -2,6 +2,7 @@
 
 #include "led.h"
 #include "0_config.h"
+#include "scheduler.h"
 
 enum LedMode {
   LED_INIT,
@@ -15,36 +16,51 @@ LedMode ledMode = LED_INIT;
 unsigned long ledTimer = 0;
 bool ledState = false;
 int pulseCount = 0;
+static bool pinState = false; // Zuletzt an den Pin geschriebener Zustand
+
+// Der Pin wird nur bei einer Änderung beschrieben
+static void writeLed(bool on) {
+  if (on != pinState) {
+    pinState = on;
+    digitalWrite(ledPin, on ? HIGH : LOW);
+  }
+}
 
 void setupLED() {
   pinMode(ledPin, OUTPUT);
   digitalWrite(ledPin, LOW);
+  pinState = false;
+  schedulerArm(TASK_LED, 0);
 }
 
+// Läuft als Zeitgeber-Aufgabe: schaltet den Pin und stellt den Zeitgeber auf die nächste Änderung
 void handleLED() {
   unsigned long currentTime = millis();
+  unsigned long next_ms = 0;
 
   switch (ledMode) {
     case LED_INIT:
       if (currentTime - ledTimer >= 200) {
         ledState = !ledState;
-        digitalWrite(ledPin, ledState ? HIGH : LOW);
+        writeLed(ledState);
         ledTimer = currentTime;
       }
+      next_ms = ledTimer + 200 - currentTime;
       break;
 
     case LED_HEARTBEAT: {
+      // Doppelblitz: 2000 ms aus, 100 ms an, 100 ms aus, 100 ms an
       unsigned long elapsed = currentTime - ledTimer;
+      if (elapsed >= 2300) {
+        ledTimer = currentTime;
+        elapsed = 0;
+      }
       if (elapsed < 2000) {
-        digitalWrite(ledPin, LOW);
-      } else if (elapsed < 2100) {
-        digitalWrite(ledPin, HIGH);
-      } else if (elapsed < 2200) {
-        digitalWrite(ledPin, LOW);
-      } else if (elapsed < 2300) {
-        digitalWrite(ledPin, HIGH);
+        writeLed(false);
+        next_ms = 2000 - elapsed;
       } else {
-        ledTimer = currentTime;
+        writeLed(((elapsed - 2000) / 100) % 2 == 0);
+        next_ms = 100 - (elapsed - 2000) % 100;
       }
       break;
     }
@@ -53,31 +69,38 @@ void handleLED() {
       if (pulseCount < 10) { // 5 Blitze = 10 Zustandsänderungen
         if (currentTime - ledTimer >= 50) { // 50ms an/aus
           ledState = !ledState;
-          digitalWrite(ledPin, ledState ? HIGH : LOW);
+          writeLed(ledState);
           ledTimer = currentTime;
           pulseCount++;
         }
+        next_ms = ledTimer + 50 - currentTime;
       } else {
         setHeartbeatMode(); // Zurück zum Heartbeat
+        return;
       }
       break;
 
     case LED_TX_PULSE:
       // Ein einzelner 500ms Puls
       if (currentTime - ledTimer > 500) {
-        digitalWrite(ledPin, LOW);
+        writeLed(false);
         setHeartbeatMode();
+        return;
       }
+      next_ms = ledTimer + 501 - currentTime;
       break;
 
     case LED_ERROR:
       if (currentTime - ledTimer >= 500) {
         ledState = !ledState;
-        digitalWrite(ledPin, ledState ? HIGH : LOW);
+        writeLed(ledState);
         ledTimer = currentTime;
       }
+      next_ms = ledTimer + 500 - currentTime;
       break;
   }
+
+  schedulerArm(TASK_LED, next_ms);
 }
 
 void triggerRxPulse() {
@@ -85,20 +108,24 @@ void triggerRxPulse() {
   ledTimer = millis();
   pulseCount = 0;
   ledState = false;
+  schedulerArm(TASK_LED, 50);
 }
 
 void triggerTxPulse() {
   ledMode = LED_TX_PULSE;
   ledTimer = millis();
-  digitalWrite(ledPin, HIGH);
+  writeLed(true);
+  schedulerArm(TASK_LED, 501);
 }
 
 void setErrorMode() {
   ledMode = LED_ERROR;
   ledTimer = millis();
+  schedulerArm(TASK_LED, 500);
 }
 
 void setHeartbeatMode() {
   ledMode = LED_HEARTBEAT;
   ledTimer = millis();
-}
\ No newline at end of file
+  schedulerArm(TASK_LED, 0);
+}
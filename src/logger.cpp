@@ -2,32 +2,180 @@
 
 #include "logger.h"
 #include "0_config.h"
-#include "interface.h" 
+#include "interface.h"
+#include "serialout.h"
+
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE muss eine Zweierpotenz sein");
 
 // Variable zur Steuerung des Logging-Status zur Laufzeit
 // Initialisiert mit dem Wert aus der Konfigurationsdatei
 static bool loggingActive = DEFAULT_LOGGING_STATE;
 
-void logMessage(const char* level, const String& message) {
-    // Prüfen, ob das Logging zur Laufzeit aktiv ist
-    if (!loggingActive) {
-        return; // Logging ist deaktiviert, also nichts tun
+// Texte unterhalb von LOG_MIN_LEVEL werden nie ausgegeben und belegen keinen Flash
+#define LOG_TEXT_ENTRY(id, level, text) (LOG_LEVEL_##level >= LOG_MIN_LEVEL ? text : ""),
+static const char* const LOG_TEXTS[LOG_ID_COUNT] = { LOG_MESSAGES(LOG_TEXT_ENTRY) };
+#undef LOG_TEXT_ENTRY
+
+static const char* const LOG_LEVEL_NAMES[] = {"DEBUG", "INFO", "WARN", "ERROR"};
+
+// Eine gespeicherte Meldung; der Text wird erst bei der Ausgabe erzeugt
+struct LogEntry {
+    uint32_t time_ms;
+    uint8_t id;
+    uint8_t argCount;
+    LogArg args[LOG_MAX_ARGS];
+};
+
+static LogEntry logRing[LOG_RING_SIZE];
+
+// Freilaufende Indizes: 'logHead' = nächster Schreibplatz, 'logOut' = nächste laufende
+// Ausgabe, 'dumpNext'/'dumpEnd' = Bereich einer laufenden 'dumplog'-Ausgabe
+static uint16_t logHead = 0;
+static uint16_t logOut = 0;
+static uint16_t dumpNext = 0;
+static uint16_t dumpEnd = 0;
+static uint32_t logWritten = 0; // Meldungen seit dem Start
+static uint32_t logLost = 0;    // Vor der laufenden Ausgabe überschriebene Meldungen
+
+void logWrite(LogId id, const LogArg* args, uint8_t count) {
+  LogEntry& entry = logRing[logHead & (LOG_RING_SIZE - 1)];
+  entry.time_ms = millis();
+  entry.id = id;
+  entry.argCount = count;
+  for (uint8_t i = 0; i < count; i++) {
+    entry.args[i] = args[i];
+  }
+  logHead++;
+  logWritten++;
+}
+
+// Hängt eine Zahl an den Text an (ohne printf, damit keine Gleitkomma-Bibliothek nötig ist)
+static size_t appendUnsigned(char* text, size_t pos, uint32_t value, uint8_t base) {
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    uint8_t d = value % base;
+    digits[n++] = d < 10 ? '0' + d : 'a' + d - 10;
+    value /= base;
+  } while (value != 0);
+  while (n > 0 && pos < LOG_TEXT_MAX - 1) {
+    text[pos++] = digits[--n];
+  }
+  return pos;
+}
+
+static size_t appendFloat(char* text, size_t pos, float value) {
+  if (value < 0 && pos < LOG_TEXT_MAX - 1) {
+    text[pos++] = '-';
+    value = -value;
+  }
+  uint32_t milli = (uint32_t)(value * 1000.0f + 0.5f);
+  pos = appendUnsigned(text, pos, milli / 1000, 10);
+  uint16_t frac = milli % 1000;
+  if (frac != 0 && pos < LOG_TEXT_MAX - 1) {
+    text[pos++] = '.';
+    for (uint16_t div = 100; frac != 0 && pos < LOG_TEXT_MAX - 1; div /= 10) {
+      text[pos++] = '0' + frac / div;
+      frac %= div;
     }
+  }
+  return pos;
+}
 
-    // Übergib die Log-Daten an das Interface zur JSON-Formatierung und Ausgabe
-    publishLogAsJson(level, message);
-    Serial.println(); // Neue Zeile nach der JSON-Ausgabe
+// Setzt die Argumente in den Meldungstext ein
+static void formatEntry(const LogEntry& entry, char* text) {
+  const char* format = LOG_TEXTS[entry.id];
+  uint8_t arg = 0;
+  size_t pos = 0;
+  for (const char* p = format; *p != '\0' && pos < LOG_TEXT_MAX - 1; p++) {
+    if (*p != '%' || p[1] == '\0') {
+      text[pos++] = *p;
+      continue;
+    }
+    char spec = *++p;
+    if (spec == '%' || arg >= entry.argCount) {
+      text[pos++] = spec == '%' ? '%' : '?';
+      continue;
+    }
+    const LogArg& value = entry.args[arg++];
+    switch (spec) {
+      case 'd':
+        if (value.i < 0) {
+          text[pos++] = '-';
+          pos = appendUnsigned(text, pos, (uint32_t)-(int64_t)value.i, 10);
+        } else {
+          pos = appendUnsigned(text, pos, (uint32_t)value.i, 10);
+        }
+        break;
+      case 'u': pos = appendUnsigned(text, pos, (uint32_t)value.i, 10); break;
+      case 'x': pos = appendUnsigned(text, pos, (uint32_t)value.i, 16); break;
+      case 'f': pos = appendFloat(text, pos, value.f); break;
+      case 's':
+        for (const char* s = value.s; s != nullptr && *s != '\0' && pos < LOG_TEXT_MAX - 1; s++) {
+          text[pos++] = *s;
+        }
+        break;
+      default: text[pos++] = '?'; break;
+    }
+  }
+  text[pos] = '\0';
 }
 
-void setLogging(bool enabled) {
-    if (loggingActive != enabled) {
-        loggingActive = enabled;
-        // Die Status-Nachricht wird immer gesendet, um die Änderung zu bestätigen.
-        // Das Interface kümmert sich um die JSON-Formatierung.
-        publishLogAsJson("STATUS", "Logging " + String(enabled ? "aktiviert" : "deaktiviert"));
+static void publishEntry(const char* type, uint16_t index) {
+  const LogEntry& entry = logRing[index & (LOG_RING_SIZE - 1)];
+  char text[LOG_TEXT_MAX];
+  formatEntry(entry, text);
+  publishLogEntry(type, LOG_LEVEL_NAMES[LOG_LEVEL_OF[entry.id]], entry.time_ms, entry.id, text);
+}
+
+void handleLogOutput() {
+  if (!loggingActive) {
+    logOut = logHead;
+  } else if ((uint16_t)(logHead - logOut) > LOG_RING_SIZE) {
+    // Ausgabe kam nicht hinterher: Die ältesten Meldungen sind bereits überschrieben
+    logLost += (uint16_t)(logHead - logOut) - LOG_RING_SIZE;
+    logOut = logHead - LOG_RING_SIZE;
+  }
+
+  // Nur bei leerer Ausgabe, damit Meldungen nie Empfangspakete verdrängen
+  if (serialOut.pending() != 0) {
+    return;
+  }
+
+  if (dumpNext != dumpEnd) {
+    // Inzwischen überschriebene Meldungen überspringen
+    if ((uint16_t)(logHead - dumpNext) > LOG_RING_SIZE) {
+      dumpNext = (uint16_t)(logHead - dumpEnd) >= LOG_RING_SIZE ? dumpEnd : logHead - LOG_RING_SIZE;
+    }
+    if (dumpNext != dumpEnd) {
+      publishEntry("log_dump", dumpNext++);
+      return;
     }
+  }
+
+  if (logOut != logHead) {
+    publishEntry("log", logOut++);
+  }
+}
+
+String startLogDump() {
+  uint16_t stored = logWritten < LOG_RING_SIZE ? logWritten : LOG_RING_SIZE;
+  dumpEnd = logHead;
+  dumpNext = logHead - stored;
+  return "Logverlauf: " + String(stored) + " Meldungen folgen als 'log_dump' (t_ms ab Start), " +
+         String(logWritten) + " seit Start, Verloren=" + String(logLost) + ".";
+}
+
+void setLogging(bool enabled) {
+  if (loggingActive != enabled) {
+    loggingActive = enabled;
+    logOut = logHead; // Während der Pause gespeicherte Meldungen nur per 'dumplog'
+    // Die Status-Nachricht wird immer gesendet, um die Änderung zu bestätigen.
+    // Das Interface kümmert sich um die JSON-Formatierung.
+    publishLogAsJson("STATUS", "Logging " + String(enabled ? "aktiviert" : "deaktiviert"));
+  }
 }
 
 bool isLoggingEnabled() {
-    return loggingActive;
-}
\ No newline at end of file
+  return loggingActive;
+}
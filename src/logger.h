@@ -1,27 +1,134 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <Arduino.h>
+#include <type_traits>
+#include "0_config.h"
+
+//================================================================================
+// Ereignisprotokoll (numerische Meldungen mit typisierten Argumenten)
+//================================================================================
+//
+// Eine Meldung besteht aus ihrer Nummer und bis zu LOG_MAX_ARGS Argumenten. Sie wird beim
+// Aufruf nur in einen Ringpuffer im RAM geschrieben; der Text entsteht erst in
+// handleLogOutput(), wenn die serielle Ausgabe leer ist. Meldungen unterhalb von
+// LOG_MIN_LEVEL werden bereits vom Compiler entfernt (siehe logEvent()).
+//
+// Der Ringpuffer hält die letzten LOG_RING_SIZE Meldungen auch bei abgeschaltetem Logging,
+// sodass sie nach einem Fehler mit 'dumplog' abgerufen werden können.
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+
+// Platzhalter im Text: %d (vorzeichenbehaftet), %u, %x (hexadezimal), %f (bis 3 Nachkommastellen),
+// %s (Zeichenkette mit statischer Lebensdauer, sie wird erst bei der Ausgabe gelesen).
+#define LOG_MESSAGES(X) \
+    X(LOG_SYSTEM_READY,        INFO,  "System ist bereit.") \
+    X(LOG_SYSTEM_NOT_READY,    ERROR, "LoRa-Modul nicht bereit. System im Fehlermodus.") \
+    X(LOG_LORA_INIT,           INFO,  "Initialisiere LoRa-Modul...") \
+    X(LOG_LORA_STORED_REJECTED, WARN, "Gespeicherte LoRa-Konfiguration abgelehnt (Code: %d), verwende Standardwerte.") \
+    X(LOG_LORA_BEGIN_FAILED,   ERROR, "LoRa-Modul Initialisierung (radio.begin) fehlgeschlagen, Code: %d") \
+    X(LOG_LORA_RFSWITCH,       INFO,  "RF-Schalter-Pins konfiguriert.") \
+    X(LOG_LORA_RX_START_FAILED, ERROR, "Fehler beim Starten des Empfangsmodus: %d") \
+    X(LOG_LORA_READY,          INFO,  "LoRa-Modul ist bereit und im Empfangsmodus (Konfiguration: %s, boot_ms=%u).") \
+    X(LOG_LORA_RX_CRC,         WARN,  "LoRa-Paket empfangen, aber CRC-Fehler!") \
+    X(LOG_LORA_RX_ERROR,       WARN,  "LoRa-Paket empfangen, aber Empfangsfehler, Code: %d") \
+    X(LOG_LORA_TX_RX_FAILED,   ERROR, "Fehler beim Neustarten des Empfangsmodus nach Senden: %d") \
+    X(LOG_LORA_STANDBY_FAILED, ERROR, "Fehler beim Wechsel in Standby-Modus: %d") \
+    X(LOG_LORA_PARAM_FAILED,   ERROR, "Fehler beim Setzen von %s: %f, Code: %d") \
+    X(LOG_LORA_ROLLBACK_FAILED, ERROR, "Rücknahme fehlgeschlagen. Fehler beim Setzen von %s: %f, Code: %d") \
+    X(LOG_LORA_APPLY_RX_FAILED, ERROR, "Fehler beim Starten des Empfangs nach Parameteränderung: %d") \
+    X(LOG_SCAN_PARAM_FAILED,   ERROR, "Scan: Fehler beim Setzen von %s: %f, Code: %d") \
+    X(LOG_SCAN_HOME_FAILED,    ERROR, "Scan: Rückkehr auf den eingestellten Kanal fehlgeschlagen, Code: %d") \
+    X(LOG_SCAN_RX_FAILED,      ERROR, "Scan: Fehler beim Starten des Empfangs: %d") \
+    X(LOG_BULK_QUEUE_FAILED,   WARN,  "Blockübertragung %u: Fragment %u nicht eingereiht (Warteschlange oder Duty-Cycle).") \
+    X(LOG_BULK_RX_INCOMPLETE,  WARN,  "Blockübertragung %u unvollständig verworfen (%u/%u Fragmente).") \
+    X(LOG_AFC_ADJUST,          INFO,  "AFC: Frequenzoffset %f kHz -> %f kHz (Schätzung %d Hz).") \
+    X(LOG_AFC_LIMIT,           WARN,  "AFC: Korrekturgrenze erreicht (Schätzung %d Hz, Offset %f kHz).") \
+    X(LOG_BULK_RX_TOO_LARGE,   WARN,  "Blockübertragung %u abgelehnt: %u Bytes passen nicht in den Puffer (%u Bytes).") \
+    X(LOG_BULK_TX_REJECTED,    WARN,  "Blockübertragung %u von der Gegenstelle abgelehnt (Puffer zu klein).")
+
+#define LOG_ID_ENTRY(id, level, text) id,
+enum LogId : uint8_t {
+    LOG_MESSAGES(LOG_ID_ENTRY)
+    LOG_ID_COUNT
+};
+#undef LOG_ID_ENTRY
+
+#define LOG_LEVEL_ENTRY(id, level, text) LOG_LEVEL_##level,
+constexpr uint8_t LOG_LEVEL_OF[LOG_ID_COUNT] = { LOG_MESSAGES(LOG_LEVEL_ENTRY) };
+#undef LOG_LEVEL_ENTRY
+
+/**
+ * @brief Ein Argument einer Meldung. Die Deutung ergibt sich aus dem Platzhalter im Text.
+ */
+union LogArg {
+    int32_t i;
+    float f;
+    const char* s;
+
+    LogArg() : i(0) {}
+    LogArg(const char* value) : s(value) {}
+    template <typename T>
+    LogArg(T value) {
+        static_assert(std::is_arithmetic<T>::value, "Nur Zahlen und statische Zeichenketten als Log-Argument");
+        if constexpr (std::is_floating_point<T>::value) {
+            f = (float)value;
+        } else {
+            i = (int32_t)value;
+        }
+    }
+};
+
+/**
+ * @brief Schreibt eine Meldung in den Ringpuffer (Zeitstempel, Nummer, Argumente).
+ *        Nicht aus Interrupts aufrufen.
+ */
+void logWrite(LogId id, const LogArg* args, uint8_t count);
+
+/**
+ * @brief Protokolliert eine Meldung. Liegt ihre Ebene unter LOG_MIN_LEVEL, bleibt vom
+ *        Aufruf nichts übrig; sonst werden nur die Argumente kopiert, nichts formatiert.
+ *        Bsp: logEvent<LOG_LORA_RX_ERROR>(packet->state);
+ */
+template <LogId id, typename... Args>
+inline void logEvent(Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Zu viele Log-Argumente");
+    if constexpr (LOG_LEVEL_OF[id] >= LOG_MIN_LEVEL) {
+        const LogArg packed[sizeof...(Args) + 1] = { LogArg(args)... };
+        logWrite(id, packed, sizeof...(Args));
+    }
+}
+
+/**
+ * @brief Gibt die älteste noch nicht ausgegebene Meldung aus, sobald die serielle Ausgabe
+ *        leer ist (höchstens eine je Aufruf), und treibt eine laufende 'dumplog'-Ausgabe voran.
+ *        Muss regelmäßig in der Hauptschleife vor handleSerialOutput() aufgerufen werden.
+ */
+void handleLogOutput();
+
 /**
- * @brief Sendet eine formatierte JSON-Log-Nachricht über die serielle Schnittstelle.
- *        Die Ausgabe erfolgt nur, wenn das Logging aktiv ist.
- * 
- * @param level Die Log-Ebene (z.B. "INFO", "ERROR", "DEBUG").
- * @param message Die zu protokollierende Nachricht.
+ * @brief Startet die Ausgabe aller Meldungen im Ringpuffer als 'log_dump'-Datensätze,
+ *        unabhängig davon, ob das Logging aktiv ist.
+ * @return String Zusammenfassung (Anzahl, verlorene Meldungen).
  */
-void logMessage(const char* level, const String& message);
+String startLogDump();
 
 /**
- * @brief Aktiviert oder deaktiviert das Logging zur Laufzeit.
- * 
+ * @brief Aktiviert oder deaktiviert die laufende Ausgabe der Meldungen. Der Ringpuffer
+ *        wird in beiden Fällen weiter gefüllt.
+ *
  * @param enabled true, um das Logging zu aktivieren, false, um es zu deaktivieren.
  */
 void setLogging(bool enabled);
 
 /**
  * @brief Gibt zurück, ob das Logging aktuell aktiv ist.
- * 
+ *
  * @return true, wenn das Logging aktiv ist, andernfalls false.
  */
 bool isLoggingEnabled();
 
-#endif // LOGGER_H
\ No newline at end of file
+#endif // LOGGER_H
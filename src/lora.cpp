@@ -1,11 +1,28 @@
 #include <Arduino.h>
 #include <RadioLib.h>     
+#include <SPI.h>
 
 #include "0_config.h"    
 #include "lora.h" 
 #include "interface.h" 
 #include "logger.h"
 #include "led.h"
+#include "rxbuffer.h"
+#include "serialout.h"
+#include "latency.h"
+#include "airtime.h"
+#include "storage.h"
+#include "dedup.h"
+#include "rxfilter.h"
+#include "bulk.h"
+#include "afc.h"
+#include "compress.h"
+#include "crypto.h"
+#include "presets.h"
+#include "scheduler.h"
+#include "timebase.h"
+#include "repeater.h"
+#include "scratch.h"
 
 // Globale, statische Variable zur Speicherung der aktuellen LoRa-Einstellungen
 static LoRaSettings currentLoRaSettings;
@@ -13,14 +30,124 @@ static LoRaSettings currentLoRaSettings;
 // Statusvariable, die anzeigt, ob das Modul einsatzbereit ist
 static bool loraReady = false;
 
-// Definition der globalen Flag-Variable für den Empfang (muss hier sein)
-volatile bool receivedFlag = false;
+// Herkunft der Startkonfiguration und Zeit vom Reset bis zum ersten startReceive()
+static bool configFromFlash = false;
+static uint32_t bootMillis = 0;
 
-// Erstellen Sie eine Instanz der RadioLib LoRa-Klasse
-SX1262 radio = new Module(NSS, DIO1, NRST, BUSY); 
+// Solange die Hauptschleife selbst mit dem Modul spricht (Senden, Konfiguration),
+// darf die ISR nicht auf den SPI-Bus zugreifen. Sie merkt sich das Ereignis dann nur.
+static volatile bool radioLocked = false;
+static volatile bool rxPending = false;
+static volatile uint32_t rxPendingCycles = 0;
+static volatile uint32_t rxPendingMicros = 0;
 
-// Der Puffer zum Speichern der empfangenen Daten
-uint8_t lora_packet_buffer[256];
+// Ein Eintrag der Sendewarteschlange
+struct LoRaTxRequest {
+  uint8_t payload[255];
+  uint8_t len;
+  uint16_t id;
+  uint32_t airtime_us;    // Berechnete Sendedauer beim Einreihen
+  uint32_t cyclesCommand; // Zykluszähler am Ende des auslösenden Befehls (0 = unbekannt)
+  bool report;            // Abschluss als 'lora_tx_done' melden (nicht bei internen Paketen)
+  uint64_t at_us;         // Geplanter Sendebeginn in Gerätezeit (0 = sofort)
+  bool repeat;            // Vom Repeater weitergesendetes Paket
+  uint32_t rxDoneMicros;  // micros() beim RxDone des Originals (nur Repeater)
+};
+
+// Sendewarteschlange; wird nur aus der Hauptschleife verwendet
+static LoRaTxRequest txQueue[LORA_TX_QUEUE_SIZE];
+static uint8_t txHead = 0;
+static uint8_t txTail = 0;
+static uint16_t nextTxId = 1;
+static uint32_t queuedAirtime_us = 0; // Summe der Sendedauer aller wartenden Aufträge
+
+// Zustand des laufenden Sendevorgangs. Während 'txActive' bedeutet DIO1 TxDone.
+static volatile bool txActive = false;
+static volatile bool txDone = false;
+static volatile uint32_t txDoneMicros = 0;
+static volatile uint32_t txDoneCycles = 0;
+static uint32_t txStartCycles = 0;
+static uint32_t txStartMicros = 0;
+static uint32_t txTimeoutMicros = 0;
+static uint16_t activeTxId = 0;
+static uint8_t activeTxLen = 0;
+static bool activeTxReport = true;
+static uint32_t activeAirtime_us = 0;  // Berechnete Sendedauer mit den Parametern beim Start
+static uint64_t activeAt_us = 0;       // Geplanter Sendebeginn (0 = sofort)
+static bool activeRepeat = false;
+static uint32_t activeRxDoneMicros = 0;
+static uint64_t txCallMicros = 0;      // Gerätezeit beim Aufruf von startTransmit()
+static LoRaTxScheduleStats scheduleStats = {0, 0, 0, 0, LORA_TX_SCHEDULE_LEAD_US};
+static uint8_t activeCadBusy = 0;
+static uint32_t activeBackoff_us = 0;
+
+// Listen-before-talk: Während 'cadActive' bedeutet DIO1 CadDone.
+static bool lbtEnabled = LORA_LBT_ENABLED_DEFAULT;
+static volatile bool cadActive = false;
+static volatile bool cadDone = false;
+static uint32_t cadStartMicros = 0;
+static uint32_t cadTimeoutMicros = 0;
+static bool backoffActive = false;
+static uint32_t backoffStartMicros = 0;
+static uint32_t backoffMicros = 0;
+static uint8_t headCadBusy = 0;      // Belegte Prüfungen des vordersten Auftrags
+static uint32_t headBackoff_us = 0;  // Bisherige Wartezeit des vordersten Auftrags
+static LoRaLbtStats lbtStats = {0, 0, 0, 0};
+
+// Kanalscan. Während 'scanState == SCAN_CAD' gehört die CAD (cadActive/cadDone) dem Scan,
+// im Zustand SCAN_LOCKED empfängt das Modul ungesperrt auf dem Scan-Kanal.
+enum LoRaScanState : uint8_t {
+  SCAN_IDLE,   // Keine Prüfung aktiv (Modul gesperrt im Standby, falls auf einen Scan-Kanal abgestimmt)
+  SCAN_CAD,    // Kanalprüfung läuft
+  SCAN_LOCKED  // Präambel erkannt, Empfang auf dem Scan-Kanal
+};
+
+struct LoRaScanChannel {
+  uint8_t preset;
+  uint8_t weight;
+  int16_t credit; // Guthaben der gewichteten Reihenfolge
+  LoRaScanChannelStats stats;
+};
+
+static LoRaScanChannel scanChannels[LORA_SCAN_MAX_CHANNELS];
+static uint8_t scanChannelCount = 0;
+static bool scanEnabled = false;
+static uint16_t scanDwell_ms = LORA_SCAN_DWELL_MS_DEFAULT;
+static LoRaScanState scanState = SCAN_IDLE;
+static int8_t tunedChannel = -1;     // Scan-Kanal, auf den das Modul abgestimmt ist (-1 = eingestellter Kanal)
+static LoRaSettings tunedSettings;   // Dessen Parameter, solange 'tunedValid'
+static bool tunedValid = false;
+static uint32_t visitStartMicros = 0;
+static uint32_t lockStartMicros = 0;
+static uint32_t lockTimeoutMicros = 0;
+static uint32_t lockRxCount = 0;
+static uint16_t cycleVisits = 0;
+static uint32_t cycleStartMicros = 0;
+static uint32_t lastCycle_us = 0;
+static volatile uint8_t rxChannelTag = LORA_SCAN_NO_CHANNEL; // Kennung für Pakete aus der ISR
+static volatile uint32_t scanRxGood = 0;                     // Fehlerfreie Pakete auf Scan-Kanälen
+
+static inline bool scanHoldsRadio() {
+  return scanState != SCAN_IDLE || tunedChannel >= 0;
+}
+
+// Erstellen Sie eine Instanz der RadioLib LoRa-Klasse (SPI-Takt statt RadioLib-Standard von 2 MHz)
+SX1262 radio = new Module(NSS, DIO1, NRST, BUSY, SPI, SPISettings(SX1262_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+
+// Frequenzfehler je Paket auslesen (abschaltbar, kostet dann keinen Registerzugriff)
+static volatile bool rxFrequencyErrorEnabled = LORA_RX_FREQ_ERROR_DEFAULT;
+
+// Register mit dem geschätzten Frequenzfehler des letzten Pakets (20 Bit, vorzeichenbehaftet)
+static const uint16_t SX126X_REG_FREQ_ERROR = 0x076B;
+
+// Empfang im Duty-Cycle (SetRxDutyCycle): Das Modul schläft und hört nur in Fenstern nach einer
+// Präambel. Nach einem Paket steht es im Standby; die ISR startet den Zyklus mit dem
+// gespeicherten Befehl neu.
+static bool rxDutyCycleEnabled = false;
+static volatile bool dutyListening = false;      // Zuletzt im Duty-Cycle gestartet (eingestellter Kanal)
+static uint8_t dutyCycleCommand[6];               // Empfangs- und Schlafdauer in 15.625-us-Schritten
+static uint32_t dutyRx_us = 0;
+static uint32_t dutySleep_us = 0;
 
 LoRaSettings getCurrentLoRaSettings() {
     return currentLoRaSettings;
@@ -31,13 +158,198 @@ bool isLoraReady() {
     return loraReady;
 }
 
+bool isLoRaConfigFromFlash() {
+    return configFromFlash;
+}
+
+uint32_t getLoRaBootMillis() {
+    return bootMillis;
+}
+
+// Rechnet den Rohwert des Frequenzfehler-Registers in Hz um (wie RadioLib getFrequencyError())
+static float decodeFrequencyError(const uint8_t* raw, float bandwidth_kHz) {
+  int32_t efe = ((uint32_t)(raw[0] & 0x0F) << 16) | ((uint32_t)raw[1] << 8) | raw[2];
+  if (efe & 0x80000) {
+    efe -= 0x100000; // Vorzeichen des 20-Bit-Werts
+  }
+  return 1.55f * efe * bandwidth_kHz / 1600.0f;
+}
+
+bool computeLoRaRxDutyCycle(const LoRaSettings& s, uint32_t& rx_us, uint32_t& sleep_us) {
+  // Wie RadioLib startReceiveDutyCycleAuto(): zwischen zwei Fenstern liegen höchstens so viele
+  // Symbole, dass in jedem Fall noch LORA_RX_DUTY_MIN_SYMBOLS der Präambel gehört werden.
+  if (s.preambleLength <= 2 * LORA_RX_DUTY_MIN_SYMBOLS) {
+    return false;
+  }
+  uint32_t symbol_us = (uint32_t)(((uint32_t)1 << s.spreadingFactor) * 1000.0f / s.bandwidth_kHz);
+  uint32_t sleepSymbols = s.preambleLength - 2 * LORA_RX_DUTY_MIN_SYMBOLS;
+  sleep_us = symbol_us * sleepSymbols;
+  // Mit TCXO kommt dessen Anlaufzeit hinzu (RadioLib-Standard 5 ms)
+  const uint32_t wake_us = LORA_RX_DUTY_WAKE_US + (SX1262_TCXOVOLTAGE > 0 ? 5000 : 0);
+  if (sleep_us < wake_us + 16) {
+    return false; // Schlafen lohnt den Wechsel nicht
+  }
+  uint32_t window_us = (symbol_us * (s.preambleLength + 1) - (sleep_us - 1000)) / 2;
+  uint32_t minWindow_us = symbol_us * (LORA_RX_DUTY_MIN_SYMBOLS + 1);
+  rx_us = window_us > minWindow_us ? window_us : minWindow_us;
+  return true;
+}
+
+// Startet den Empfang auf dem eingestellten Kanal, je nach Einstellung dauerhaft oder im Duty-Cycle
+static int startListening(const LoRaSettings& s) {
+  uint32_t rx_us, sleep_us;
+  if (rxDutyCycleEnabled && computeLoRaRxDutyCycle(s, rx_us, sleep_us)) {
+    uint32_t rxRaw = (uint64_t)rx_us * 8 / 125;
+    uint32_t sleepRaw = (uint64_t)sleep_us * 8 / 125;
+    const uint8_t command[6] = {(uint8_t)(rxRaw >> 16), (uint8_t)(rxRaw >> 8), (uint8_t)rxRaw,
+                                (uint8_t)(sleepRaw >> 16), (uint8_t)(sleepRaw >> 8), (uint8_t)sleepRaw};
+    memcpy(dutyCycleCommand, command, sizeof(command));
+    dutyRx_us = rx_us;
+    dutySleep_us = sleep_us;
+    dutyListening = true;
+    return radio.startReceiveDutyCycle(rx_us, sleep_us);
+  }
+  dutyListening = false;
+  return radio.startReceive();
+}
+
+// Liest das fertig empfangene Paket samt Empfangsqualität in den Ringpuffer.
+// Das Modul bleibt im kontinuierlichen Empfang (startReceive() ohne Zeitlimit) und empfängt
+// bereits weiter; es müssen nur die IRQ-Flags gelöscht werden, damit DIO1 wieder auslöst.
+// Statt readData(), getRSSI(), getSNR() und getFrequencyError() (12 Transaktionen, Pufferstatus
+// und Paketstatus je doppelt, dazu startReceive() mit vier weiteren) werden die Befehle direkt
+// gesendet: IRQ-Status, Pufferstatus, Nutzdaten, Paketstatus (RSSI, SNR und Signal-RSSI in
+// einer Antwort), optional das Frequenzfehler-Register als ein Block, IRQ löschen.
+// Im Duty-Cycle steht das Modul nach dem Paket im Standby; dann folgt noch SetRxDutyCycle.
+// Läuft im Interrupt-Kontext oder bei gesperrter ISR - kein Logging hier!
+static void readPacketIntoBuffer(uint32_t cyclesIsr, uint32_t microsIsr) {
+  Module* mod = radio.getMod();
+  LoRaRxPacket* slot = rxBufferReserve();
+  uint8_t status[3];
+
+  if (slot != nullptr) {
+    // [IRQ-Flags MSB, LSB] und [Länge, Startadresse im Datenpuffer]
+    int16_t state = mod->SPIreadStream(RADIOLIB_SX126X_CMD_GET_IRQ_STATUS, &status[0], 2);
+    uint16_t irqFlags = ((uint16_t)status[0] << 8) | status[1];
+    if (state == RADIOLIB_ERR_NONE) {
+      state = mod->SPIreadStream(RADIOLIB_SX126X_CMD_GET_RX_BUFFER_STATUS, &status[0], 2);
+    }
+    size_t numBytes = state == RADIOLIB_ERR_NONE ? status[0] : 0;
+
+    if (numBytes > 0 && numBytes <= sizeof(slot->payload)) {
+      const uint8_t readCommand[2] = {RADIOLIB_SX126X_CMD_READ_BUFFER, status[1]};
+      slot->cyclesIsr = cyclesIsr;
+      slot->rxDoneMicros = microsIsr;
+      slot->state     = mod->SPIreadStream(readCommand, 2, slot->payload, numBytes);
+      slot->cyclesRead = cycleCount();
+      // CRC-Fehler, oder Header-Fehler ohne gültigen Header (wie readData())
+      if (slot->state == RADIOLIB_ERR_NONE &&
+          ((irqFlags & RADIOLIB_SX126X_IRQ_CRC_ERR) ||
+           ((irqFlags & RADIOLIB_SX126X_IRQ_HEADER_ERR) && !(irqFlags & RADIOLIB_SX126X_IRQ_HEADER_VALID)))) {
+        slot->state = RADIOLIB_ERR_CRC_MISMATCH;
+      }
+      slot->len = numBytes;
+
+      // [RssiPkt, SnrPkt, SignalRssiPkt]: -Wert/2 dBm, int8/4 dB, -Wert/2 dBm
+      // Halbe dB auf ganze gerundet (-90.5 -> -91), nicht zur Null hin abgeschnitten
+      mod->SPIreadStream(RADIOLIB_SX126X_CMD_GET_PACKET_STATUS, status, 3);
+      slot->rssi       = -((int16_t)status[0] + 1) / 2;
+      slot->snr        = (int8_t)status[1] / 4.0f;
+      slot->signalRssi = -((int16_t)status[2] + 1) / 2;
+
+      slot->frequencyError = NAN;
+      if (rxFrequencyErrorEnabled && mod->SPIreadRegisterBurst(SX126X_REG_FREQ_ERROR, 3, status) == RADIOLIB_ERR_NONE) {
+        slot->frequencyError = decodeFrequencyError(status, tunedChannel >= 0 ? tunedSettings.bandwidth_kHz
+                                                                              : currentLoRaSettings.bandwidth_kHz);
+      }
+      slot->cyclesStatus = cycleCount();
+      slot->timestamp_ms = millis();
+      slot->channel      = rxChannelTag;
+      if (rxChannelTag != LORA_SCAN_NO_CHANNEL && slot->state == RADIOLIB_ERR_NONE) {
+        scanRxGood++;
+      }
+    } else {
+      rxBufferCountDrop();
+      slot = nullptr;
+    }
+  }
+
+  // Auch bei vollem Puffer die Flags löschen, sonst bliebe DIO1 gesetzt
+  const uint8_t clearAll[2] = {(uint8_t)(RADIOLIB_SX126X_IRQ_ALL >> 8), (uint8_t)(RADIOLIB_SX126X_IRQ_ALL & 0xFF)};
+  mod->SPIwriteStream(RADIOLIB_SX126X_CMD_CLEAR_IRQ_STATUS, clearAll, 2);
+  if (dutyListening) {
+    mod->SPIwriteStream(RADIOLIB_SX126X_CMD_SET_RX_DUTY_CYCLE, dutyCycleCommand, sizeof(dutyCycleCommand));
+  }
+
+  if (slot != nullptr) {
+    slot->cyclesRxReady = cycleCount();
+    rxBufferCommit();
+    schedulerNotify(TASK_RX);
+  }
+}
+
 // ISR-Handler: Wird vom DIO1-Interrupt aufgerufen
 void setFlag(void) {
-  receivedFlag = true;
+  uint32_t cycles = cycleCount();
+  uint32_t now_us = micros();
+  if (cadActive) {
+    cadDone = true;
+    schedulerNotify(TASK_TX);
+    return;
+  }
+  if (txActive) {
+    if (!txDone) {
+      txDoneMicros = now_us;
+      txDoneCycles = cycles;
+      txDone = true;
+      schedulerNotify(TASK_TX);
+    }
+    return;
+  }
+  if (radioLocked) {
+    if (!rxPending) {
+      rxPendingCycles = cycles;
+      rxPendingMicros = now_us;
+    }
+    rxPending = true;
+    return;
+  }
+  readPacketIntoBuffer(cycles, now_us);
+}
+
+// Sperrt den ISR-Zugriff auf das Modul für die Dauer einer Operation aus der Hauptschleife.
+static void lockRadio() {
+  radioLocked = true;
+}
+
+// Hebt die Sperre auf. Ein nach dem letzten startReceive() empfangenes Paket wird
+// vorher noch abgeholt, sonst bliebe DIO1 gesetzt und es käme kein Interrupt mehr.
+static void unlockRadio() {
+  while (true) {
+    noInterrupts();
+    if (!rxPending) {
+      radioLocked = false;
+      interrupts();
+      return;
+    }
+    uint32_t cycles = rxPendingCycles;
+    uint32_t isrMicros = rxPendingMicros;
+    rxPending = false;
+    interrupts();
+    readPacketIntoBuffer(cycles, isrMicros);
+  }
+}
+
+// Initialisiert das Modul in einem Schritt mit dem vollständigen Parametersatz
+static int beginRadio(const LoRaSettings& s) {
+  return radio.begin(s.frequency_MHz, s.bandwidth_kHz, s.spreadingFactor, s.codingRate,
+                     s.syncWord, s.outputPower_dBm, s.preambleLength,
+                     SX1262_TCXOVOLTAGE, false);
 }
 
 void setupLoRa() {
-  logMessage("INFO", "Initialisiere LoRa-Modul...");
+  logEvent<LOG_LORA_INIT>();
+  lockRadio();
 
   // 1. Initiales Laden der Parameter aus der Konfigurationsdatei in die aktuelle Einstellung
   currentLoRaSettings.base_frequency_MHz   = LORA_FREQUENCY;
@@ -50,17 +362,22 @@ void setupLoRa() {
   currentLoRaSettings.outputPower_dBm      = LORA_TX_POWER;
   currentLoRaSettings.preambleLength       = LORA_PREAMBLE;
 
+  // Eine im Flash gespeicherte Konfiguration hat Vorrang. Sie wird direkt an begin()
+  // übergeben, sodass keine zweite Umkonfiguration nach dem Start nötig ist.
+  const LoRaSettings defaults = currentLoRaSettings;
+  configFromFlash = loadStoredConfig(currentLoRaSettings);
+  currentLoRaSettings.frequency_MHz = currentLoRaSettings.base_frequency_MHz + (currentLoRaSettings.frequency_offset_kHz / 1000.0);
+
   // 2. Modul mit den geladenen Parametern initialisieren
-  int state = radio.begin(currentLoRaSettings.frequency_MHz,
-                          currentLoRaSettings.bandwidth_kHz,
-                          currentLoRaSettings.spreadingFactor,
-                          currentLoRaSettings.codingRate,
-                          currentLoRaSettings.syncWord,
-                          currentLoRaSettings.outputPower_dBm,
-                          currentLoRaSettings.preambleLength, 
-                          SX1262_TCXOVOLTAGE, false); 
+  int state = beginRadio(currentLoRaSettings);
+  if (state != RADIOLIB_ERR_NONE && configFromFlash) {
+    logEvent<LOG_LORA_STORED_REJECTED>(state);
+    currentLoRaSettings = defaults;
+    configFromFlash = false;
+    state = beginRadio(currentLoRaSettings);
+  }
   if (state != RADIOLIB_ERR_NONE) {
-    logMessage("ERROR", "LoRa-Modul Initialisierung (radio.begin) fehlgeschlagen, Code: " + String(state));
+    logEvent<LOG_LORA_BEGIN_FAILED>(state);
     loraReady = false;
     setErrorMode(); // NEU: Fehler-LED aktivieren
     return;
@@ -68,206 +385,1109 @@ void setupLoRa() {
 
   // 3. RF-Schalter-Pins konfigurieren. Diese Funktion gibt KEINEN Statuscode zurück.
   radio.setRfSwitchPins(RXEN, TXEN); 
-  logMessage("INFO", "RF-Schalter-Pins konfiguriert."); 
+  logEvent<LOG_LORA_RFSWITCH>();
+
+  rebuildAirtimeTables(currentLoRaSettings.bandwidth_kHz, currentLoRaSettings.spreadingFactor,
+                       currentLoRaSettings.codingRate, currentLoRaSettings.preambleLength);
 
   // 4. Interrupt konfigurieren (NEU!) - wichtig für interrupt-basierten Empfang
   radio.setPacketReceivedAction(setFlag);
 
   // 5. Empfang starten (nach dem das Modul bereit ist und Interrupt konfiguriert wurde)
-  state = radio.startReceive();
+  state = startListening(currentLoRaSettings);
+  bootMillis = millis();
+  unlockRadio();
   if (state != RADIOLIB_ERR_NONE) {
-    logMessage("ERROR", "Fehler beim Starten des Empfangsmodus: " + String(state));
+    logEvent<LOG_LORA_RX_START_FAILED>(state);
     loraReady = false;
     setErrorMode(); // NEU: Fehler-LED aktivieren
     return;
   }
 
-  logMessage("INFO", "LoRa-Modul ist bereit und im Empfangsmodus.");
+  logEvent<LOG_LORA_READY>(configFromFlash ? "Flash" : "Standard", bootMillis);
   loraReady = true;
 }
   
-void checkLoRaReceived() {
-  
-  byte byteArr[256];
-  int numBytes = radio.getPacketLength();
-  
-  if (numBytes > 0 && numBytes <= 256) {
-    int state = radio.readData(byteArr, numBytes);
-    
-    if (state == RADIOLIB_ERR_NONE) {
-      // Paket wurde erfolgreich empfangen
-      triggerRxPulse(); // RX-Puls auslösen
+// Beginn eines Pakets in Gerätezeit: RxDone minus berechnete Sendedauer mit den Parametern
+// des Kanals, auf dem es empfangen wurde
+static uint64_t rxPacketStartMicros(const LoRaRxPacket* packet) {
+  uint32_t airtime_us = getAirtimeMicros(packet->len);
+  const LoRaSettings* preset = packet->channel != LORA_SCAN_NO_CHANNEL ? getLoRaPreset(packet->channel) : nullptr;
+  if (preset != nullptr) {
+    airtime_us = computeAirtimeMicros(preset->bandwidth_kHz, preset->spreadingFactor, preset->codingRate,
+                                      preset->preambleLength, packet->len);
+  }
+  return timebaseExtend(packet->rxDoneMicros) - airtime_us;
+}
 
+// Publiziert ein fehlerfrei empfangenes Paket und erfasst die Latenzen des Empfangspfads.
+static void publishRxPacket(const LoRaRxPacket* packet) {
+  uint32_t encodeStart = cycleCount();
+  uint64_t start_us = rxPacketStartMicros(packet);
+  // Verschlüsselte Pakete nur mit gültigem Prüfwert und entschlüsselt publizieren; Entschlüsseln
+  // und Entpacken wechseln sich in den Hälften des gemeinsamen Arbeitspuffers ab (siehe scratch.h)
+  uint8_t* decrypted = packetScratch;
+  const uint8_t* payload = packet->payload;
+  size_t len = packet->len;
+  int32_t node = -1;
+  uint16_t sender = 0;
+  switch (decryptRx(packet->payload, packet->len, decrypted, len, sender)) {
+    case CRYPTO_REJECTED:
+      return;
+    case CRYPTO_DECRYPTED:
+      payload = decrypted;
+      node = sender;
+      break;
+    default:
+      break;
+  }
+  // Komprimierte Pakete entpackt publizieren; ungültige Datenströme gehen roh an den Host
+  uint8_t* unpacked = packetScratch + PACKET_SCRATCH_HALF;
+  size_t unpackedLen = decompressRx(payload, len, unpacked);
+  if (unpackedLen > 0) {
+    publishReceivedLoRaPacket(unpacked, unpackedLen, packet->rssi, packet->signalRssi, packet->snr, packet->frequencyError,
+                              packet->channel, start_us, node);
+  } else {
+    publishReceivedLoRaPacket(payload, len, packet->rssi, packet->signalRssi, packet->snr, packet->frequencyError,
+                              packet->channel, start_us, node);
+  }
+  uint32_t encodeEnd = cycleCount();
 
-      int16_t rssi = radio.getRSSI();
-      float snr = radio.getSNR();
-      float frequencyError = radio.getFrequencyError();
+  latencyRecordSpan(LAT_RX_READ, packet->cyclesIsr, packet->cyclesRead);
+  latencyRecordSpan(LAT_RX_STATUS, packet->cyclesRead, packet->cyclesStatus);
+  latencyRecordSpan(LAT_RX_TURNAROUND, packet->cyclesIsr, packet->cyclesRxReady);
+  latencyRecordSpan(LAT_RX_QUEUE, packet->cyclesStatus, encodeStart);
+  latencyRecordSpan(LAT_RX_ENCODE, encodeStart, encodeEnd);
+  latencyTrackSerial(serialOut.committedPosition(), packet->cyclesIsr, encodeEnd);
+}
 
-      publishReceivedLoRaPacket(byteArr, numBytes, rssi, snr, frequencyError); 
+static void publishNextRxPacket() {
+  // Gegendruck: Ist der Ausgabepuffer fast voll, bleibt das Paket im Empfangspuffer,
+  // statt als unvollständiger Datensatz verworfen zu werden.
+  if (serialOut.freeSpace() < SERIAL_OUT_RX_RESERVE) {
+    return;
+  }
+
+  // Zurückgehaltene Pakete (beste Kopie) haben Vorrang, sie warten bereits am längsten
+  const LoRaRxPacket* held = dedupPeekDue(millis());
+  if (held != nullptr) {
+    publishRxPacket(held);
+    dedupReleaseDue();
+    return;
+  }
+
+  // Pro Aufruf nur ein Paket publizieren, damit die übrigen Aufgaben der
+  // Hauptschleife (Befehlseingabe, LED) bei einem Burst nicht verhungern.
+  const LoRaRxPacket* packet = rxBufferPeek();
+  if (packet == nullptr) {
+    return;
+  }
+
+  if (packet->state == RADIOLIB_ERR_NONE) {
+    // Paket wurde erfolgreich empfangen
+    triggerRxPulse(); // RX-Puls auslösen
+    afcHandlePacket(packet); // Auch Kopien und gefilterte Pakete sind gültige Messwerte
+    repeaterHandlePacket(packet); // Eigene Regeln, unabhängig von der Ausgabe an den Host
 
-    } else if (state == RADIOLIB_ERR_CRC_MISMATCH) {
-      // Paket wurde empfangen, aber ist fehlerhaft (CRC-Fehler)
-      logMessage("WARN", "LoRa-Paket empfangen, aber CRC-Fehler!");
-      // Optional: setErrorMode() wenn CRC-Fehler als kritisch angesehen werden
-    } else if (state < 0) {
-      // Einige andere Fehler sind aufgetreten
-      logMessage("WARN", "LoRa-Paket empfangen, aber Empfangsfehler, Code: " + String(state));
+    // Gefilterte Pakete und Kopien gefluteter Mesh-Pakete gar nicht erst kodieren.
+    // Der Filter läuft zuerst, damit verworfene Pakete keinen Platz in der Dedup-Tabelle belegen.
+    // Fragmente und Quittungen der Blockübertragung gehen vorher ab (Wiederholungen sind gewollt).
+    // Alle Stufen sehen das Paket wie gesendet, also ggf. verschlüsselt (siehe crypto.h).
+    if (!bulkHandlePacket(packet) && rxFilterAccept(packet) && dedupFilter(packet) == DEDUP_PASS) {
+      publishRxPacket(packet);
     }
-  } else {
-    logMessage("ERROR", "LoRa-Paket empfangen, ungültige Paketlänge: " + String(numBytes));
+
+  } else if (packet->state == RADIOLIB_ERR_CRC_MISMATCH) {
+    // Paket wurde empfangen, aber ist fehlerhaft (CRC-Fehler)
+    logEvent<LOG_LORA_RX_CRC>();
+    // Optional: setErrorMode() wenn CRC-Fehler als kritisch angesehen werden
+  } else if (packet->state < 0) {
+    // Einige andere Fehler sind aufgetreten
+    logEvent<LOG_LORA_RX_ERROR>(packet->state);
   }
 
-  // Wichtig: Nach der Bearbeitung des Pakets das Modul wieder in den Empfangsmodus versetzen,
-  // um auf das nächste Paket zu warten.
+  rxBufferRelease();
+}
 
-  receivedFlag = false; // Flag zurücksetzen
+void checkLoRaReceived() {
+  publishNextRxPacket();
+  // Weitere Pakete im Puffer: erneut nach der nächsten Aufgabe niedrigerer Priorität
+  if (rxBufferPeek() != nullptr) {
+    schedulerNotify(TASK_RX);
+  }
+}
 
-  int startRxState = radio.startReceive();
-  if (startRxState != RADIOLIB_ERR_NONE) {
-    logMessage("ERROR", "Fehler beim Neustarten des Empfangs nach Paketbearbeitung: " + String(startRxState));
-    setErrorMode(); // Fehler-LED aktivieren
+// Vorlauf von startTransmit() bis Sendebeginn: nachgeführter fester Anteil plus das Schreiben
+// der Nutzdaten über SPI
+static uint32_t txLeadMicros(uint8_t len) {
+  return scheduleStats.lead_us + (uint32_t)((uint64_t)len * 8000000UL / SX1262_SPI_CLOCK);
+}
+
+// Legt einen geprüften Auftrag am Ende der Warteschlange ab; die Felder des Auslösers sind gelöscht
+static LoRaTxRequest& enqueueRequest(const uint8_t* data, uint8_t len, uint32_t airtime_us) {
+  LoRaTxRequest& request = txQueue[txHead % LORA_TX_QUEUE_SIZE];
+  memcpy(request.payload, data, len);
+  request.len = len;
+  request.airtime_us = airtime_us;
+  request.cyclesCommand = 0;
+  request.report = false;
+  request.at_us = 0;
+  request.repeat = false;
+  request.rxDoneMicros = 0;
+  request.id  = nextTxId++;
+  if (nextTxId == 0) {
+    nextTxId = 1; // ID 0 ist reserviert
   }
+  txHead++;
+  queuedAirtime_us += airtime_us;
+  return request;
 }
 
-String sendLoRaPacket(const uint8_t* data, size_t len) {
-  //logMessage("INFO", "Sende LoRa-Paket..."); // Log-Ausgabe hier entfernt, wird als Rückgabewert behandelt
+String queueLoRaPacket(const uint8_t* data, size_t len, uint16_t& id, bool report, uint64_t at_us) {
+  if (len == 0 || len > sizeof(txQueue[0].payload)) {
+    return "Ungültige Paketlänge: " + String(len) + " Bytes";
+  }
+  if ((uint8_t)(txHead - txTail) >= LORA_TX_QUEUE_SIZE) {
+    return "Sendewarteschlange voll (" + String(LORA_TX_QUEUE_SIZE) + " Pakete)";
+  }
+  if (at_us != 0) {
+    // Der Zeitpunkt muss nach dem Vorlauf noch erreichbar und nicht beliebig weit entfernt sein
+    uint64_t now = timebaseMicros();
+    if (at_us < now + txLeadMicros(len) + LORA_TX_SCHEDULE_LATE_US) {
+      return "Sendezeitpunkt liegt zu knapp oder in der Vergangenheit (" + String((int32_t)(int64_t)(at_us - now)) + " us)";
+    }
+    if (at_us - now > (uint64_t)LORA_TX_SCHEDULE_MAX_AHEAD_MS * 1000) {
+      return "Sendezeitpunkt liegt mehr als " + String(LORA_TX_SCHEDULE_MAX_AHEAD_MS / 1000) + " s in der Zukunft";
+    }
+  }
 
-  // Sende die Daten blockierend
-  int state = radio.transmit(data, len);
-  
-  // WICHTIG: Den durch TxDone ausgelösten Interrupt sofort bereinigen,
-  // da er sonst checkLoRaReceived() fälschlicherweise triggern würde.
-  receivedFlag = false;
+  // Duty-Cycle: Pakete, die zu lange auf Budget warten müssten, gleich ablehnen
+  uint32_t airtime_us = getAirtimeMicros(len);
+  if (getDutyCycleCapacityMicros() != 0 && airtime_us > getDutyCycleCapacityMicros()) {
+    countDutyCycleRejected();
+    return "Sendedauer (" + String(airtime_us / 1000) + " ms) größer als das gesamte Duty-Cycle-Budget";
+  }
+  uint32_t wait_ms = getDutyCycleWaitMillis(airtime_us, queuedAirtime_us);
+  if (wait_ms > LORA_DUTY_CYCLE_MAX_DEFER_MS) {
+    countDutyCycleRejected();
+    return "Duty-Cycle-Budget erschöpft, nächster Sendeversuch in ca. " + String(wait_ms / 1000) + " s möglich";
+  }
+  if (wait_ms > 0) {
+    countDutyCycleDeferred();
+  }
+
+  LoRaTxRequest& request = enqueueRequest(data, len, airtime_us);
+  request.cyclesCommand = latencyCommandStart();
+  request.report = report;
+  request.at_us = at_us;
+
+  id = request.id;
+  return ""; // Erfolg
+}
+
+bool queueLoRaRepeat(const uint8_t* data, uint8_t len, uint32_t rxDoneMicros, uint32_t reserve_us) {
+  if (len == 0 || (uint8_t)(txHead - txTail) >= LORA_TX_QUEUE_SIZE) {
+    return false;
+  }
+  // Nicht auf Budget warten: Eine spät weitergesendete Kopie nützt niemandem mehr
+  uint32_t airtime_us = getAirtimeMicros(len);
+  if (getDutyCycleWaitMillis(airtime_us + reserve_us, queuedAirtime_us) > 0) {
+    return false;
+  }
+
+  LoRaTxRequest& request = enqueueRequest(data, len, airtime_us);
+  request.repeat = true;
+  request.rxDoneMicros = rxDoneMicros;
+  return true;
+}
 
-  triggerTxPulse(); // TX-Puls auslösen
+uint8_t getLoRaTxQueueCount() {
+  return (uint8_t)(txHead - txTail) + (txActive ? 1 : 0);
+}
+
+// Meldet den Abschluss des aktiven Auftrags an den Host (nur bei Aufträgen des Hosts) bzw.
+// an den Repeater. 'start_us' ist der gemessene Sendebeginn in Gerätezeit (0 = nicht gesendet).
+static void reportActiveTx(int state, uint32_t airtime_us, uint64_t start_us) {
+  if (activeRepeat) {
+    repeaterRecordTx(state == RADIOLIB_ERR_NONE ? start_us : 0, activeRxDoneMicros);
+  }
+  if (activeTxReport) {
+    publishLoRaTxDone(activeTxId, activeTxLen, state, airtime_us, activeCadBusy, activeBackoff_us, start_us, activeAt_us);
+  }
+}
+
+// Führt den Vorlauf nach und verbucht bei geplanten Aufträgen den Fehler des Sendebeginns
+static void recordTxStart(uint64_t start_us) {
+  static bool leadMeasured = false;
+  int64_t lead = (int64_t)(start_us - txCallMicros) - (int64_t)(txLeadMicros(activeTxLen) - scheduleStats.lead_us);
+  if (lead > 0 && lead < LORA_TX_SCHEDULE_GUARD_US) {
+    // Die erste Messung ersetzt den Startwert, danach gleitendes Mittel
+    int64_t base = leadMeasured ? (int64_t)scheduleStats.lead_us : lead;
+    scheduleStats.lead_us = (uint32_t)(base + (lead - base) / 4);
+    leadMeasured = true;
+  }
+  if (activeAt_us != 0) {
+    int32_t error_us = (int32_t)(int64_t)(start_us - activeAt_us);
+    uint32_t absError = error_us < 0 ? -error_us : error_us;
+    scheduleStats.sent++;
+    scheduleStats.absError_us += absError;
+    if (absError > (uint32_t)(scheduleStats.maxError_us < 0 ? -scheduleStats.maxError_us : scheduleStats.maxError_us)) {
+      scheduleStats.maxError_us = error_us;
+    }
+  }
+}
 
-  String resultMessage = ""; // Standardmäßig leer (Erfolg)
+// Schließt den laufenden Sendevorgang ab, wechselt zurück in den Empfang und meldet das Ergebnis.
+static void finishActiveTransmission(bool completed) {
+  uint32_t airtime_us = (completed ? txDoneMicros : micros()) - txStartMicros;
+  uint64_t start_us = 0;
+  if (completed) {
+    latencyRecordSpan(LAT_TX_AIRTIME, txStartCycles, txDoneCycles);
+    start_us = timebaseExtend(txDoneMicros) - activeAirtime_us;
+    recordTxStart(start_us);
+  }
+
+  // finishTransmit() löscht die IRQ-Flags und versetzt das Modul in Standby
+  int state = radio.finishTransmit();
+  if (!completed) {
+    state = RADIOLIB_ERR_TX_TIMEOUT;
+  }
+
+  txActive = false;
+  txDone = false;
+
+  // Nach dem Senden immer wieder in den Empfangsmodus wechseln
+  rxPending = false;
+  int startRxState = startListening(currentLoRaSettings);
+  unlockRadio();
 
   if (state == RADIOLIB_ERR_NONE) {
-    // Senden erfolgreich
-    // triggerTxPulse(); // TX-LED-Puls auslösen
-    // resultMessage bleibt leer
+    triggerTxPulse(); // TX-Puls auslösen
   } else {
-    // Senden fehlgeschlagen
-    resultMessage = "LoRa-Senden fehlgeschlagen, Code: " + String(state);
     setErrorMode(); // Fehler-LED aktivieren
   }
-  
-  // Nach dem Senden immer wieder in den Empfangsmodus wechseln
-  int startRxState = radio.startReceive();
   if (startRxState != RADIOLIB_ERR_NONE) {
-    String rxErrorMessage = "Fehler beim Neustarten des Empfangsmodus nach Senden: " + String(startRxState);
-    setErrorMode(); // Fehler-LED aktivieren
-    
-    // Wenn schon ein Sendefehler vorlag, beide Fehler kombinieren
-    if (resultMessage.length() > 0) { // <--- Hier geändert
-      resultMessage += "; " + rxErrorMessage;
-    } else {
-      resultMessage = rxErrorMessage; // Nur Neustart-Fehler
+    logEvent<LOG_LORA_TX_RX_FAILED>(startRxState);
+    setErrorMode();
+  }
+
+  reportActiveTx(state, airtime_us, start_us);
+}
+
+// Entfernt den vordersten Auftrag aus der Warteschlange und merkt sich seine Kenndaten
+// für das 'lora_tx_done'-Ereignis.
+static LoRaTxRequest& takeNextRequest() {
+  LoRaTxRequest& request = txQueue[txTail % LORA_TX_QUEUE_SIZE];
+  txTail++;
+  queuedAirtime_us -= request.airtime_us;
+
+  activeTxId       = request.id;
+  activeTxLen      = request.len;
+  activeTxReport   = request.report;
+  activeAirtime_us = getAirtimeMicros(request.len);
+  activeAt_us      = request.at_us;
+  activeRepeat     = request.repeat;
+  activeRxDoneMicros = request.rxDoneMicros;
+  // Kanalprüfungen gehören immer zum vordersten ungeplanten Auftrag (geplante senden ohne)
+  activeCadBusy    = 0;
+  activeBackoff_us = 0;
+  if (request.at_us == 0) {
+    activeCadBusy    = headCadBusy;
+    activeBackoff_us = headBackoff_us;
+    headCadBusy      = 0;
+    headBackoff_us   = 0;
+  }
+  return request;
+}
+
+static void swapRequests(uint8_t a, uint8_t b) {
+  uint8_t* x = (uint8_t*)&txQueue[a % LORA_TX_QUEUE_SIZE];
+  uint8_t* y = (uint8_t*)&txQueue[b % LORA_TX_QUEUE_SIZE];
+  for (size_t i = 0; i < sizeof(LoRaTxRequest); i++) {
+    uint8_t t = x[i];
+    x[i] = y[i];
+    y[i] = t;
+  }
+}
+
+// Holt den als Nächstes fälligen Auftrag nach vorn: den ersten ungeplanten, solange er samt
+// Kanalprüfung vor dem frühesten geplanten Zeitpunkt fertig wird, sonst den frühesten geplanten.
+// So hält ein weit vorausgeplanter Auftrag die übrigen nicht auf. Die Reihenfolge der übrigen
+// Aufträge bleibt erhalten (Verschieben per Tausch, ohne Kopie auf dem Stack).
+static void selectNextRequest() {
+  uint8_t plain = txHead;
+  uint8_t earliest = txHead;
+  for (uint8_t i = txTail; i != txHead; i++) {
+    const LoRaTxRequest& r = txQueue[i % LORA_TX_QUEUE_SIZE];
+    if (r.at_us == 0) {
+      if (plain == txHead) {
+        plain = i;
+      }
+    } else if (earliest == txHead || r.at_us < txQueue[earliest % LORA_TX_QUEUE_SIZE].at_us) {
+      earliest = i;
+    }
+  }
+
+  uint8_t chosen = plain != txHead ? plain : earliest;
+  if (plain != txHead && earliest != txHead) {
+    const LoRaTxRequest& p = txQueue[plain % LORA_TX_QUEUE_SIZE];
+    const LoRaTxRequest& e = txQueue[earliest % LORA_TX_QUEUE_SIZE];
+    uint64_t busy_us = getAirtimeMicros(p.len) + txLeadMicros(p.len) + LORA_TX_SCHEDULE_GUARD_US;
+    if (lbtEnabled) {
+      busy_us += 10 * getSymbolTimeMicros(); // Kanalprüfung mit bis zu 8 Symbolen
+    }
+    if (timebaseMicros() + busy_us > e.at_us - txLeadMicros(e.len)) {
+      chosen = earliest;
     }
   }
-  return resultMessage; // Gibt leeren String bei Erfolg oder eine Fehlermeldung zurück
+  for (uint8_t i = chosen; i != txTail; i--) {
+    swapRequests(i, i - 1);
+  }
 }
 
-// Diese Funktion ist jetzt 'static' und wird nur intern verwendet.
-// Sie wendet die berechneten Werte direkt auf das Modul an.
-static int applyLoRaRadioSettings(float frequency_MHz, float bandwidth_kHz, uint8_t spreadingFactor, 
-                                  uint8_t codingRate, uint8_t syncWord, int8_t outputPower_dBm, 
-                                  uint16_t preambleLength) {
-  int state;
-  // 1. Modul in den Standby-Modus versetzen
-  state = radio.standby();
-  if (state != RADIOLIB_ERR_NONE) {
-      logMessage("ERROR", "Fehler beim Wechsel in Standby-Modus: " + String(state));
-      setErrorMode(); // NEU: Fehler-LED aktivieren
-      return state;
+// Startet das nächste Paket aus der Warteschlange, ohne auf das Ende der Übertragung zu warten.
+// Nach einer freien Kanalprüfung ist das Modul bereits gesperrt und im Standby.
+static void startNextTransmission(bool afterChannelScan) {
+  LoRaTxRequest& request = takeNextRequest();
+
+  // Erst in Standby wechseln, damit ein gerade eintreffendes Paket nicht als TxDone gewertet wird
+  if (!afterChannelScan) {
+    lockRadio();
+    radio.standby();
+    rxPending = false;
   }
-  
-  // 2. Neue Parameter auf das Modul anwenden und Fehler prüfen
-  state = radio.setFrequency(frequency_MHz); 
-  if (state != RADIOLIB_ERR_NONE) {
-      logMessage("ERROR", "Fehler beim Setzen der Frequenz: " + String(frequency_MHz) + " MHz, Code: " + String(state));
-      setErrorMode(); // NEU: Fehler-LED aktivieren
-      return state;
+
+  // Geplanter Auftrag: den Rest bis zum Zeitpunkt abzüglich des gemessenen Vorlaufs (höchstens
+  // LORA_TX_SCHEDULE_SPIN_US) aktiv warten. delayMicroseconds() zählt Zyklen, kurze Interrupts wie
+  // SysTick und UART verlängern es nicht. Die ISR ist gesperrt und liest in dieser Zeit keine Pakete.
+  if (request.at_us != 0) {
+    int64_t wait_us = (int64_t)(request.at_us - txLeadMicros(request.len) - timebaseMicros());
+    if (wait_us > 0) {
+      delayMicroseconds((uint32_t)wait_us);
+    }
   }
-  state = radio.setBandwidth(bandwidth_kHz); 
-  if (state != RADIOLIB_ERR_NONE) {
-      logMessage("ERROR", "Fehler beim Setzen der Bandbreite: " + String(bandwidth_kHz) + " kHz, Code: " + String(state));
-      setErrorMode(); // NEU: Fehler-LED aktivieren
-      return state;
+
+  txDone = false;
+  txActive = true;
+  txStartMicros = micros();
+  txStartCycles = cycleCount();
+  txCallMicros = timebaseMicros();
+  int state = radio.startTransmit(request.payload, request.len);
+  if (request.cyclesCommand != 0) {
+    latencyRecord(LAT_CMD_TX_START, request.cyclesCommand);
   }
-  state = radio.setSpreadingFactor(spreadingFactor);
+
   if (state != RADIOLIB_ERR_NONE) {
-      logMessage("ERROR", "Fehler beim Setzen des Spreading Factors: " + String(spreadingFactor) + ", Code: " + String(state));
-      setErrorMode(); // NEU: Fehler-LED aktivieren
-      return state;
+    txActive = false;
+    rxPending = false;
+    startListening(currentLoRaSettings);
+    unlockRadio();
+    setErrorMode(); // Fehler-LED aktivieren
+    reportActiveTx(state, 0, 0);
+    return;
   }
-  state = radio.setCodingRate(codingRate);
-  if (state != RADIOLIB_ERR_NONE) {
-      logMessage("ERROR", "Fehler beim Setzen der Coding Rate: " + String(codingRate) + ", Code: " + String(state));
-      setErrorMode(); // NEU: Fehler-LED aktivieren
-      return state;
+
+  // Zeitlimit: doppelte berechnete Sendedauer plus Reserve
+  txTimeoutMicros = getAirtimeMicros(request.len) * 2 + LORA_TX_TIMEOUT_MARGIN_MS * 1000UL;
+}
+
+// CAD-Parameter nach Semtech AN1200.48: mehr Symbole und höhere Schwelle bei großem SF,
+// bei breiten Kanälen (ab 250 kHz) jeweils die doppelte Symbolanzahl.
+static void fillChannelScanConfig(const LoRaSettings& s, ChannelScanConfig_t& config, uint8_t& symbols) {
+  uint8_t sf = s.spreadingFactor;
+  bool wide = s.bandwidth_kHz >= 250.0f;
+  static const uint8_t DET_PEAK[13] = {0, 0, 0, 0, 0, 21, 21, 22, 22, 23, 24, 25, 28};
+
+  symbols = sf >= 9 ? 4 : 2;
+  if (wide) {
+    symbols *= 2;
   }
-  state = radio.setSyncWord(syncWord); 
+
+  config.cad.symNum   = symbols == 2 ? RADIOLIB_SX126X_CAD_ON_2_SYMB :
+                        symbols == 4 ? RADIOLIB_SX126X_CAD_ON_4_SYMB : RADIOLIB_SX126X_CAD_ON_8_SYMB;
+  config.cad.detPeak  = DET_PEAK[sf <= 12 ? sf : 12];
+  config.cad.detMin   = 10;
+  config.cad.exitMode = RADIOLIB_SX126X_CAD_GOTO_STDBY;
+  config.cad.timeout  = 0;
+  config.cad.irqFlags = RADIOLIB_IRQ_CAD_DEFAULT_FLAGS;
+  config.cad.irqMask  = RADIOLIB_IRQ_CAD_DEFAULT_MASK;
+}
+
+// Startet eine Kanalprüfung für den vordersten Auftrag. Das Ergebnis kommt per DIO1 (CadDone).
+static void startChannelScan() {
+  ChannelScanConfig_t config;
+  uint8_t symbols;
+  fillChannelScanConfig(currentLoRaSettings, config, symbols);
+
+  lockRadio();
+  radio.standby();
+  rxPending = false;
+
+  cadDone = false;
+  cadActive = true;
+  cadStartMicros = micros();
+  cadTimeoutMicros = (symbols + 2) * getSymbolTimeMicros() * 2 + LORA_TX_TIMEOUT_MARGIN_MS * 1000UL;
+  int state = radio.startChannelScan(config);
+
   if (state != RADIOLIB_ERR_NONE) {
-      logMessage("ERROR", "Fehler beim Setzen des Sync Word: " + String(syncWord, HEX) + ", Code: " + String(state));
-      setErrorMode(); // NEU: Fehler-LED aktivieren
-      return state;
+    cadActive = false;
+    rxPending = false;
+    startListening(currentLoRaSettings);
+    unlockRadio();
+    setErrorMode(); // Fehler-LED aktivieren
+    takeNextRequest();
+    reportActiveTx(state, 0, 0);
   }
-  state = radio.setOutputPower(outputPower_dBm); 
-  if (state != RADIOLIB_ERR_NONE) {
-      logMessage("ERROR", "Fehler beim Setzen der Sendeleistung: " + String(outputPower_dBm) + " dBm, Code: " + String(state));
-      setErrorMode(); // NEU: Fehler-LED aktivieren
-      return state;
+}
+
+// Wertet die Kanalprüfung aus. Bei freiem Kanal bleibt das Modul gesperrt im Standby
+// und es wird true zurückgegeben; sonst läuft wieder der Empfang und eine zufällige,
+// exponentiell wachsende Wartezeit beginnt (bzw. das Paket wird nach zu vielen Versuchen verworfen).
+static bool finishChannelScan(bool completed) {
+  cadActive = false;
+  cadDone = false;
+  lbtStats.cadRuns++;
+
+  // Zeitüberschreitung oder Lesefehler zählen wie ein belegter Kanal
+  int result = completed ? radio.getChannelScanResult() : RADIOLIB_ERR_RX_TIMEOUT;
+  if (result == RADIOLIB_CHANNEL_FREE) {
+    const LoRaTxRequest& next = txQueue[txTail % LORA_TX_QUEUE_SIZE];
+    if (consumeDutyCycleBudget(getAirtimeMicros(next.len))) {
+      return true;
+    }
   }
-  state = radio.setPreambleLength(preambleLength); 
+
+  rxPending = false;
+  startListening(currentLoRaSettings);
+  unlockRadio();
+
+  if (result == RADIOLIB_CHANNEL_FREE) {
+    return false; // Budget inzwischen verbraucht, später erneut prüfen
+  }
+
+  lbtStats.cadBusy++;
+  headCadBusy++;
+  if (headCadBusy > LORA_LBT_MAX_RETRIES) {
+    lbtStats.dropped++;
+    takeNextRequest();
+    reportActiveTx(RADIOLIB_LORA_DETECTED, 0, 0);
+    return false;
+  }
+
+  uint8_t exponent = headCadBusy < LORA_LBT_MAX_BACKOFF_EXP ? headCadBusy : LORA_LBT_MAX_BACKOFF_EXP;
+  uint32_t slot_us = LORA_LBT_SLOT_SYMBOLS * getSymbolTimeMicros();
+  backoffMicros = slot_us + random(slot_us << exponent);
+  backoffStartMicros = micros();
+  backoffActive = true;
+  headBackoff_us += backoffMicros;
+  lbtStats.backoff_ms += backoffMicros / 1000;
+  return false;
+}
+
+void handleLoRaTx() {
+  if (txActive) {
+    bool completed = txDone;
+    if (!completed && (micros() - txStartMicros) < txTimeoutMicros) {
+      return; // Übertragung läuft noch
+    }
+    finishActiveTransmission(completed);
+  }
+
+  if (cadActive && scanState != SCAN_CAD) {
+    bool completed = cadDone;
+    if (!completed && (micros() - cadStartMicros) < cadTimeoutMicros) {
+      return; // Kanalprüfung läuft noch
+    }
+    if (finishChannelScan(completed)) {
+      startNextTransmission(true);
+    }
+    return;
+  }
+
+  if (backoffActive) {
+    if ((micros() - backoffStartMicros) < backoffMicros) {
+      return; // Zufällige Wartezeit nach belegtem Kanal
+    }
+    backoffActive = false;
+  }
+
+  // Solange der Scan das Modul auf einem anderen Kanal hält, wartet der Auftrag;
+  // handleLoRaScan() gibt den Kanal nach dem laufenden Besuch frei.
+  if (txHead != txTail && !scanHoldsRadio()) {
+    selectNextRequest();
+    const LoRaTxRequest& next = txQueue[txTail % LORA_TX_QUEUE_SIZE];
+    uint32_t airtime_us = getAirtimeMicros(next.len);
+
+    if (next.at_us != 0) {
+      // Geplanter Auftrag: ohne Kanalprüfung, erst kurz vor dem Zeitpunkt übernehmen. Im letzten
+      // Abschnitt bleibt die Aufgabe benachrichtigt: Der Scheduler führt sie dann vor jeder weiteren
+      // Aufgabe erneut aus und powerIdle() schläft nicht, das Modul bleibt bis dahin frei.
+      int64_t remaining = (int64_t)(next.at_us - txLeadMicros(next.len) - timebaseMicros());
+      if (remaining > LORA_TX_SCHEDULE_SPIN_US) {
+        if (remaining <= LORA_TX_SCHEDULE_GUARD_US) {
+          schedulerNotify(TASK_TX);
+        }
+        return;
+      }
+      // Ohne Duty-Cycle-Budget ist der Zeitpunkt ebenso verpasst
+      if (remaining < -(int64_t)LORA_TX_SCHEDULE_LATE_US || !consumeDutyCycleBudget(airtime_us)) {
+        scheduleStats.late++;
+        takeNextRequest();
+        reportActiveTx(LORA_TX_ERR_LATE, 0, 0);
+        return;
+      }
+      startNextTransmission(false);
+      return;
+    }
+
+    if (lbtEnabled) {
+      // Erst prüfen, wenn das Budget reicht; abgebucht wird erst bei freiem Kanal
+      if (getDutyCycleWaitMillis(airtime_us, 0) == 0) {
+        startChannelScan();
+      }
+      return;
+    }
+
+    // Sendedauer mit den aktuellen Parametern abbuchen; ohne Budget bleibt der Auftrag stehen
+    if (!consumeDutyCycleBudget(airtime_us)) {
+      return;
+    }
+    startNextTransmission(false);
+  }
+}
+
+void setLoRaLbtEnabled(bool enabled) {
+  lbtEnabled = enabled;
+}
+
+bool isLoRaLbtEnabled() {
+  return lbtEnabled;
+}
+
+LoRaLbtStats getLoRaLbtStats() {
+  return lbtStats;
+}
+
+LoRaTxScheduleStats getLoRaTxScheduleStats() {
+  return scheduleStats;
+}
+
+void setLoRaRxFrequencyErrorEnabled(bool enabled) {
+  rxFrequencyErrorEnabled = enabled;
+}
+
+bool isLoRaRxFrequencyErrorEnabled() {
+  return rxFrequencyErrorEnabled;
+}
+
+void setLoRaRxDutyCycleEnabled(bool enabled) {
+  if (enabled == rxDutyCycleEnabled) {
+    return;
+  }
+  rxDutyCycleEnabled = enabled;
+  // Läuft gerade eine Übertragung, CAD oder ein Scan-Besuch, gilt die Einstellung beim
+  // nächsten Wechsel in den Empfang
+  if (!loraReady || txActive || cadActive || scanHoldsRadio()) {
+    return;
+  }
+  lockRadio();
+  radio.standby();
+  rxPending = false;
+  int state = startListening(currentLoRaSettings);
+  unlockRadio();
   if (state != RADIOLIB_ERR_NONE) {
-      logMessage("ERROR", "Fehler beim Setzen der Präambellänge: " + String(preambleLength) + ", Code: " + String(state));
+    logEvent<LOG_LORA_RX_START_FAILED>(state);
+    setErrorMode();
+  }
+}
+
+bool isLoRaRxDutyCycleEnabled() {
+  return rxDutyCycleEnabled;
+}
+
+bool getLoRaRxDutyCycle(uint32_t& rx_us, uint32_t& sleep_us) {
+  rx_us = dutyRx_us;
+  sleep_us = dutySleep_us;
+  return dutyListening;
+}
+
+// Einzelne Funkparameter, die jeweils mit einem eigenen Befehl auf das Modul geschrieben werden
+enum LoRaParam : uint8_t {
+  PARAM_FREQUENCY,
+  PARAM_BANDWIDTH,
+  PARAM_SPREADING_FACTOR,
+  PARAM_CODING_RATE,
+  PARAM_SYNC_WORD,
+  PARAM_OUTPUT_POWER,
+  PARAM_PREAMBLE,
+  PARAM_COUNT
+};
+
+// Parameter, die nur beim Senden wirken und ohne Unterbrechung des Empfangs gesetzt werden dürfen
+static const uint8_t TX_ONLY_PARAMS = (1 << PARAM_OUTPUT_POWER);
+
+// Dauer der letzten Empfangsunterbrechung durch eine Konfigurationsänderung
+static uint32_t lastRxBlind_us = 0;
+
+// Bitmaske der Parameter, in denen sich 'target' von 'current' unterscheidet
+static uint8_t changedParams(const LoRaSettings& target, const LoRaSettings& current) {
+  uint8_t changed = 0;
+  if (target.frequency_MHz   != current.frequency_MHz)   changed |= 1 << PARAM_FREQUENCY;
+  if (target.bandwidth_kHz   != current.bandwidth_kHz)   changed |= 1 << PARAM_BANDWIDTH;
+  if (target.spreadingFactor != current.spreadingFactor) changed |= 1 << PARAM_SPREADING_FACTOR;
+  if (target.codingRate      != current.codingRate)      changed |= 1 << PARAM_CODING_RATE;
+  if (target.syncWord        != current.syncWord)        changed |= 1 << PARAM_SYNC_WORD;
+  if (target.outputPower_dBm != current.outputPower_dBm) changed |= 1 << PARAM_OUTPUT_POWER;
+  if (target.preambleLength  != current.preambleLength)  changed |= 1 << PARAM_PREAMBLE;
+  return changed;
+}
+
+// Schreibt einen einzelnen Parameter aus 's' auf das Modul
+static int writeParam(uint8_t param, const LoRaSettings& s) {
+  switch (param) {
+    case PARAM_FREQUENCY:        return radio.setFrequency(s.frequency_MHz);
+    case PARAM_BANDWIDTH:        return radio.setBandwidth(s.bandwidth_kHz);
+    case PARAM_SPREADING_FACTOR: return radio.setSpreadingFactor(s.spreadingFactor);
+    case PARAM_CODING_RATE:      return radio.setCodingRate(s.codingRate);
+    case PARAM_SYNC_WORD:        return radio.setSyncWord(s.syncWord);
+    case PARAM_OUTPUT_POWER:     return radio.setOutputPower(s.outputPower_dBm);
+    case PARAM_PREAMBLE:         return radio.setPreambleLength(s.preambleLength);
+  }
+  return RADIOLIB_ERR_UNKNOWN;
+}
+
+// Bezeichnung und Wert eines Parameters für die Fehlermeldungen
+static const char* const PARAM_NAMES[PARAM_COUNT] = {
+  "Frequenz (MHz)", "Bandbreite (kHz)", "Spreading Factor", "Coding Rate",
+  "Sync Word", "Sendeleistung (dBm)", "Präambellänge"
+};
+
+static float paramValue(uint8_t param, const LoRaSettings& s) {
+  switch (param) {
+    case PARAM_FREQUENCY:        return s.frequency_MHz;
+    case PARAM_BANDWIDTH:        return s.bandwidth_kHz;
+    case PARAM_SPREADING_FACTOR: return s.spreadingFactor;
+    case PARAM_CODING_RATE:      return s.codingRate;
+    case PARAM_SYNC_WORD:        return s.syncWord;
+    case PARAM_OUTPUT_POWER:     return s.outputPower_dBm;
+    case PARAM_PREAMBLE:         return s.preambleLength;
+  }
+  return 0;
+}
+
+// Schreibt nur die Parameter, die sich gegenüber 'currentLoRaSettings' geändert haben.
+// Schlägt ein Parameter fehl, werden die bereits geschriebenen auf die alten Werte
+// zurückgesetzt, sodass Modul und 'currentLoRaSettings' übereinstimmen.
+// Der Empfang wird nur unterbrochen, wenn ein empfangsrelevanter Parameter dabei ist.
+static int applyLoRaRadioSettings(const LoRaSettings& target, uint8_t changed) {
+  int state;
+  bool interruptsRx = (changed & ~TX_ONLY_PARAMS) != 0;
+  uint32_t rxStopped_us = micros();
+  lastRxBlind_us = 0;
+
+  // 1. Nur für empfangsrelevante Parameter in den Standby-Modus wechseln
+  if (interruptsRx) {
+    state = radio.standby();
+    if (state != RADIOLIB_ERR_NONE) {
+      logEvent<LOG_LORA_STANDBY_FAILED>(state);
       setErrorMode(); // NEU: Fehler-LED aktivieren
       return state;
+    }
   }
 
-  // 3. Modul wieder in den Empfangsmodus versetzen
-  state = radio.startReceive();
+  // 2. Geänderte Parameter der Reihe nach schreiben
+  uint8_t applied = 0;
+  state = RADIOLIB_ERR_NONE;
+  for (uint8_t param = 0; param < PARAM_COUNT; param++) {
+    if ((changed & (1 << param)) == 0) {
+      continue;
+    }
+    state = writeParam(param, target);
+    if (state != RADIOLIB_ERR_NONE) {
+      logEvent<LOG_LORA_PARAM_FAILED>(PARAM_NAMES[param], paramValue(param, target), state);
+      break;
+    }
+    applied |= 1 << param;
+  }
+
+  // 3. Bei einem Fehler die bereits geschriebenen Parameter zurückrollen
   if (state != RADIOLIB_ERR_NONE) {
-      logMessage("ERROR", "Fehler beim Starten des Empfangs nach Parameteränderung: " + String(state));
+    for (uint8_t param = 0; param < PARAM_COUNT; param++) {
+      if ((applied & (1 << param)) == 0) {
+        continue;
+      }
+      int rollbackState = writeParam(param, currentLoRaSettings);
+      if (rollbackState != RADIOLIB_ERR_NONE) {
+        logEvent<LOG_LORA_ROLLBACK_FAILED>(PARAM_NAMES[param], paramValue(param, currentLoRaSettings), rollbackState);
+      }
+    }
+    setErrorMode(); // NEU: Fehler-LED aktivieren
+  }
+
+  // 4. Modul wieder in den Empfangsmodus versetzen. Ein vor dem Standby gemeldetes
+  //    Paket ist durch den Moduswechsel verloren und darf nicht mehr ausgelesen werden.
+  if (interruptsRx) {
+    rxPending = false;
+    int startRxState = startListening(state == RADIOLIB_ERR_NONE ? target : currentLoRaSettings);
+    lastRxBlind_us = micros() - rxStopped_us;
+    if (startRxState != RADIOLIB_ERR_NONE) {
+      logEvent<LOG_LORA_APPLY_RX_FAILED>(startRxState);
       setErrorMode(); // NEU: Fehler-LED aktivieren
+      if (state == RADIOLIB_ERR_NONE) {
+        state = startRxState;
+      }
+    }
+  }
+
+  return state;
+}
+
+//--------------------------------------------------------------------------------
+// Kanalscan
+//--------------------------------------------------------------------------------
+
+// Empfangsparameter eines Scan-Kanals (Profil mit Frequenzoffset und Sendeleistung des Geräts)
+static bool getScanChannelSettings(uint8_t index, LoRaSettings& settings) {
+  const LoRaSettings* preset = getLoRaPreset(scanChannels[index].preset);
+  if (preset == nullptr) {
+    return false; // Benutzerplatz inzwischen leer
+  }
+  settings = *preset;
+  settings.frequency_offset_kHz = currentLoRaSettings.frequency_offset_kHz;
+  settings.frequency_MHz        = settings.base_frequency_MHz + (settings.frequency_offset_kHz / 1000.0);
+  settings.outputPower_dBm      = currentLoRaSettings.outputPower_dBm;
+  return true;
+}
+
+// Stimmt das gesperrte Modul im Standby auf 'target' ab. Geschrieben werden nur die gegenüber
+// dem zuletzt abgestimmten Kanal geänderten Empfangsparameter (zwischen Profilen gleicher
+// Modulation also nur die Frequenz).
+static int tuneRadio(const LoRaSettings& target) {
+  uint8_t changed = tunedValid ? changedParams(target, tunedSettings) : 0xFF;
+  changed &= ((1 << PARAM_COUNT) - 1) & ~TX_ONLY_PARAMS;
+
+  for (uint8_t param = 0; param < PARAM_COUNT; param++) {
+    if ((changed & (1 << param)) == 0) {
+      continue;
+    }
+    int state = writeParam(param, target);
+    if (state != RADIOLIB_ERR_NONE) {
+      tunedValid = false; // Teilweise geschrieben: beim nächsten Mal alles schreiben
+      logEvent<LOG_SCAN_PARAM_FAILED>(PARAM_NAMES[param], paramValue(param, target), state);
       return state;
+    }
   }
+  tunedSettings = target;
+  tunedValid = true;
+  return RADIOLIB_ERR_NONE;
+}
 
-  //logMessage("INFO", "LoRa-Funkparameter erfolgreich auf Modul angewendet.");
-  return RADIOLIB_ERR_NONE; // Alles erfolgreich
+// Beendet das Einrasten: Modul sperren, Standby, Zähler des Kanals fortschreiben
+static void finishScanLock() {
+  lockRadio();
+  radio.standby();
+  rxPending = false;
+  rxChannelTag = LORA_SCAN_NO_CHANNEL;
+
+  LoRaScanChannelStats& stats = scanChannels[tunedChannel].stats;
+  stats.busy_ms += (micros() - lockStartMicros + 500) / 1000;
+  uint32_t received = scanRxGood - lockRxCount;
+  if (received > 0) {
+    stats.packets += received;
+  } else {
+    stats.missedDwells++;
+  }
+  scanState = SCAN_IDLE;
 }
 
-String setLoRaParameters(float base_frequency_MHz, float frequency_offset_kHz, float bandwidth_kHz, 
-                      uint8_t spreadingFactor, uint8_t codingRate, uint8_t syncWord, 
-                      int8_t outputPower_dBm, uint16_t preambleLength) {
+// Bricht einen laufenden Besuch ab und kehrt in den Empfang auf dem eingestellten Kanal zurück
+static void returnScanHome() {
+  if (!scanHoldsRadio()) {
+    return;
+  }
+  if (scanState == SCAN_LOCKED) {
+    finishScanLock();
+  } else if (scanState == SCAN_CAD) {
+    cadActive = false;
+    cadDone = false;
+    radio.standby();
+    scanState = SCAN_IDLE;
+  }
+
+  int state = tuneRadio(currentLoRaSettings);
+  tunedChannel = -1;
+  rxPending = false;
+  int startRxState = startListening(currentLoRaSettings);
+  unlockRadio();
+  if (state != RADIOLIB_ERR_NONE || startRxState != RADIOLIB_ERR_NONE) {
+    logEvent<LOG_SCAN_HOME_FAILED>(state != RADIOLIB_ERR_NONE ? state : startRxState);
+    setErrorMode();
+  }
+}
+
+// Startet eine Kanalprüfung auf dem abgestimmten Scan-Kanal (Modul gesperrt im Standby)
+static void startScanCad() {
+  ChannelScanConfig_t config;
+  uint8_t symbols;
+  fillChannelScanConfig(tunedSettings, config, symbols);
+  uint32_t symbol_us = (uint32_t)(((uint32_t)1 << tunedSettings.spreadingFactor) * 1000.0f / tunedSettings.bandwidth_kHz);
+
+  cadDone = false;
+  cadActive = true;
+  cadStartMicros = micros();
+  cadTimeoutMicros = (symbols + 2) * symbol_us * 2 + LORA_TX_TIMEOUT_MARGIN_MS * 1000UL;
+  scanState = SCAN_CAD;
+  scanChannels[tunedChannel].stats.cadRuns++;
+
+  if (radio.startChannelScan(config) != RADIOLIB_ERR_NONE) {
+    cadActive = false;
+    scanState = SCAN_IDLE; // Der nächste Aufruf schaltet weiter
+  }
+}
+
+// Wertet die Kanalprüfung aus: Bei erkannter Präambel auf dem Kanal einrasten, sonst bis zum
+// Ende der Mindestverweildauer erneut prüfen.
+static void finishScanCad(bool completed) {
+  cadActive = false;
+  cadDone = false;
+  scanState = SCAN_IDLE;
+
+  int result = completed ? radio.getChannelScanResult() : RADIOLIB_ERR_RX_TIMEOUT;
+  LoRaScanChannel& channel = scanChannels[tunedChannel];
+  if (result == RADIOLIB_LORA_DETECTED) {
+    channel.stats.detections++;
+    rxChannelTag = channel.preset;
+    lockRxCount = scanRxGood;
+    lockStartMicros = micros();
+    lockTimeoutMicros = computeAirtimeMicros(tunedSettings.bandwidth_kHz, tunedSettings.spreadingFactor,
+                                             tunedSettings.codingRate, tunedSettings.preambleLength, 255) +
+                        LORA_SCAN_LOCK_MARGIN_MS * 1000UL;
+    scanState = SCAN_LOCKED;
+
+    rxPending = false;
+    int state = radio.startReceive();
+    unlockRadio();
+    if (state != RADIOLIB_ERR_NONE) {
+      logEvent<LOG_SCAN_RX_FAILED>(state);
+      setErrorMode();
+    }
+    return;
+  }
+
+  if (micros() - visitStartMicros < scanDwell_ms * 1000UL) {
+    startScanCad();
+  }
+}
+
+// Gewichtete Reihenfolge (gleichmäßig verschränkt): Jeder Kanal erhält sein Gewicht als Guthaben,
+// der Kanal mit dem höchsten Guthaben ist dran und gibt die Summe aller Gewichte ab.
+static uint8_t pickNextScanChannel() {
+  uint8_t best = 0;
+  int16_t total = 0;
+  for (uint8_t i = 0; i < scanChannelCount; i++) {
+    scanChannels[i].credit += scanChannels[i].weight;
+    total += scanChannels[i].weight;
+    if (scanChannels[i].credit > scanChannels[best].credit) {
+      best = i;
+    }
+  }
+  scanChannels[best].credit -= total;
+
+  // Umlaufdauer: ein Umlauf umfasst so viele Besuche wie die Summe der Gewichte
+  if (cycleVisits == 0) {
+    cycleStartMicros = micros();
+  }
+  if (++cycleVisits >= total) {
+    lastCycle_us = micros() - cycleStartMicros;
+    cycleVisits = 0;
+  }
+  return best;
+}
+
+// Schaltet auf den nächsten Kanal der Scan-Liste und startet dort die erste Kanalprüfung
+static void startScanVisit() {
+  uint8_t next = pickNextScanChannel();
+  LoRaSettings target;
+  if (!getScanChannelSettings(next, target)) {
+    return;
+  }
+
+  if (tunedChannel < 0) {
+    // Vom eingestellten Kanal kommend: Empfang beenden
+    lockRadio();
+    radio.standby();
+    rxPending = false;
+    dutyListening = false; // Scan-Kanäle empfangen nach dem Einrasten dauerhaft
+    tunedSettings = currentLoRaSettings;
+    tunedValid = true;
+  }
+  tunedChannel = next;
+
+  if (tuneRadio(target) != RADIOLIB_ERR_NONE) {
+    scanEnabled = false;
+    returnScanHome();
+    setErrorMode();
+    return;
+  }
+  scanChannels[next].stats.visits++;
+  visitStartMicros = micros();
+  startScanCad();
+}
+
+void handleLoRaScan() {
+  if (!scanEnabled) {
+    return;
+  }
+
+  if (scanState == SCAN_CAD) {
+    bool completed = cadDone;
+    if (!completed && (micros() - cadStartMicros) < cadTimeoutMicros) {
+      return; // Kanalprüfung läuft noch
+    }
+    finishScanCad(completed);
+    return;
+  }
+
+  if (scanState == SCAN_LOCKED) {
+    if (scanRxGood == lockRxCount && (micros() - lockStartMicros) < lockTimeoutMicros) {
+      return; // Warten auf das Paket zur erkannten Präambel
+    }
+    finishScanLock();
+    return;
+  }
+
+  // Sendeaufträge haben Vorrang und laufen auf dem eingestellten Kanal
+  if (txActive || cadActive || backoffActive || txHead != txTail) {
+    returnScanHome();
+    return;
+  }
+  if (scanChannelCount > 0) {
+    startScanVisit();
+  }
+}
+
+String setLoRaScanChannels(const uint8_t* presets, const uint8_t* weights, uint8_t count) {
+  if (count > LORA_SCAN_MAX_CHANNELS) {
+    return "Zu viele Scan-Kanäle (max. " + String(LORA_SCAN_MAX_CHANNELS) + ")";
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    if (getLoRaPreset(presets[i]) == nullptr) {
+      return "Profil '" + String(getLoRaPresetName(presets[i])) + "' ist leer";
+    }
+    if (weights[i] == 0 || weights[i] > LORA_SCAN_MAX_WEIGHT) {
+      return "Ungültiges Gewicht " + String(weights[i]) + " (1-" + String(LORA_SCAN_MAX_WEIGHT) + ")";
+    }
+  }
+
+  returnScanHome();
+  for (uint8_t i = 0; i < count; i++) {
+    scanChannels[i].preset = presets[i];
+    scanChannels[i].weight = weights[i];
+    scanChannels[i].credit = 0;
+    scanChannels[i].stats  = {0, 0, 0, 0, 0, 0};
+  }
+  scanChannelCount = count;
+  cycleVisits = 0;
+  lastCycle_us = 0;
+  return "";
+}
+
+void setLoRaScanEnabled(bool enabled) {
+  scanEnabled = enabled;
+  if (!enabled) {
+    returnScanHome();
+  }
+}
+
+bool isLoRaScanEnabled() {
+  return scanEnabled;
+}
+
+void setLoRaScanDwellMillis(uint16_t dwell_ms) {
+  scanDwell_ms = dwell_ms;
+}
+
+uint16_t getLoRaScanDwellMillis() {
+  return scanDwell_ms;
+}
+
+uint8_t getLoRaScanChannelCount() {
+  return scanChannelCount;
+}
+
+uint8_t getLoRaScanChannelPreset(uint8_t index) {
+  return index < scanChannelCount ? scanChannels[index].preset : LORA_SCAN_NO_CHANNEL;
+}
+
+uint8_t getLoRaScanChannelWeight(uint8_t index) {
+  return index < scanChannelCount ? scanChannels[index].weight : 0;
+}
+
+LoRaScanChannelStats getLoRaScanChannelStats(uint8_t index) {
+  if (index >= scanChannelCount) {
+    return {0, 0, 0, 0, 0, 0};
+  }
+  return scanChannels[index].stats;
+}
+
+uint32_t getLoRaScanCycleMicros() {
+  return lastCycle_us;
+}
+
+void resetLoRaScanStats() {
+  for (uint8_t i = 0; i < scanChannelCount; i++) {
+    scanChannels[i].stats = {0, 0, 0, 0, 0, 0};
+  }
+}
+
+String applyLoRaSettings(const LoRaSettings& requested) {
+  // Ein laufender Scan-Besuch wird abgebrochen; das Modul steht danach auf dem eingestellten Kanal
+  returnScanHome();
+
+  // Eine laufende Übertragung darf nicht durch einen Moduswechsel abgebrochen werden
+  if (txActive || cadActive) {
+    return "ERROR: LoRa-Konfiguration während eines Sendevorgangs nicht möglich.";
+  }
 
   // Berechne die tatsächliche Arbeitsfrequenz
-  float frequency_MHz = base_frequency_MHz + (frequency_offset_kHz / 1000.0);
+  LoRaSettings target = requested;
+  target.frequency_MHz = target.base_frequency_MHz + (target.frequency_offset_kHz / 1000.0);
 
-  // Rufe die interne Funktion auf, um die Parameter auf die Hardware anzuwenden
-  int state = applyLoRaRadioSettings(frequency_MHz, bandwidth_kHz, spreadingFactor, codingRate, 
-                                     syncWord, outputPower_dBm, preambleLength);
+  uint8_t changed = changedParams(target, currentLoRaSettings);
+  if (changed == 0) {
+    // Nur Basis und Offset können sich bei gleicher Arbeitsfrequenz verschoben haben
+    currentLoRaSettings.base_frequency_MHz   = target.base_frequency_MHz;
+    currentLoRaSettings.frequency_offset_kHz = target.frequency_offset_kHz;
+    return "INFO: LoRa-Konfiguration unverändert, nichts an das Modul gesendet.";
+  }
 
-          
+  // Rufe die interne Funktion auf, um die Parameter auf die Hardware anzuwenden
+  lockRadio();
+  int state = applyLoRaRadioSettings(target, changed);
+  unlockRadio();
 
   // Nur wenn das Anwenden erfolgreich war, aktualisieren wir unsere globale Konfiguration
   if (state == RADIOLIB_ERR_NONE) {
-    currentLoRaSettings.base_frequency_MHz   = base_frequency_MHz;
-    currentLoRaSettings.frequency_offset_kHz = frequency_offset_kHz;
-    currentLoRaSettings.frequency_MHz        = frequency_MHz;
-    currentLoRaSettings.bandwidth_kHz        = bandwidth_kHz;
-    currentLoRaSettings.spreadingFactor      = spreadingFactor;
-    currentLoRaSettings.codingRate           = codingRate;
-    currentLoRaSettings.syncWord             = syncWord;
-    currentLoRaSettings.outputPower_dBm      = outputPower_dBm;
-    currentLoRaSettings.preambleLength       = preambleLength;
-    return "INFO: LoRa-Konfiguration erfolgreich angewendet."; // Erfolgsmeldung zurückgeben
+    currentLoRaSettings = target;
+    rebuildAirtimeTables(target.bandwidth_kHz, target.spreadingFactor, target.codingRate, target.preambleLength);
+    return "INFO: LoRa-Konfiguration erfolgreich angewendet (" + String(__builtin_popcount(changed)) +
+           " Parameter geändert, RX-Blindzeit " + String(lastRxBlind_us) + " us).";
   } else {
-    return "ERROR: LoRa-Konfiguration konnte nicht angewendet werden."; 
+    return "ERROR: LoRa-Konfiguration konnte nicht angewendet werden, vorherige Einstellungen bleiben aktiv."; 
   }
 }
 
-
-
+String setLoRaParameters(float base_frequency_MHz, float frequency_offset_kHz, float bandwidth_kHz, 
+                      uint8_t spreadingFactor, uint8_t codingRate, uint8_t syncWord, 
+                      int8_t outputPower_dBm, uint16_t preambleLength) {
+  LoRaSettings target;
+  target.base_frequency_MHz   = base_frequency_MHz;
+  target.frequency_offset_kHz = frequency_offset_kHz;
+  target.bandwidth_kHz        = bandwidth_kHz;
+  target.spreadingFactor      = spreadingFactor;
+  target.codingRate           = codingRate;
+  target.syncWord             = syncWord;
+  target.outputPower_dBm      = outputPower_dBm;
+  target.preambleLength       = preambleLength;
+  return applyLoRaSettings(target);
+}
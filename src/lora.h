@@ -20,17 +20,6 @@ struct LoRaSettings {
     uint16_t preambleLength;    // Länge der Präambel
 };
 
-//================================================================================
-// Globale Interrupt-Flags
-//================================================================================
-
-/**
- * @brief Globales, volatiles Flag, das von einer ISR auf 'true' gesetzt wird,
- *        sobald ein LoRa-Paket vollständig empfangen wurde (RxDone-Interrupt).
- *        Muss in der Hauptschleife manuell zurückgesetzt werden.
- */
-extern volatile bool receivedFlag;
-
 //================================================================================
 // Setup und Status
 //================================================================================
@@ -47,31 +36,202 @@ void setupLoRa();
  */
 bool isLoraReady();
 
+/**
+ * @brief Ob die Startkonfiguration aus dem Flash stammt (sonst aus 0_config.h).
+ */
+bool isLoRaConfigFromFlash();
+
+/**
+ * @brief Zeit vom Reset bis zum ersten startReceive() in Millisekunden.
+ */
+uint32_t getLoRaBootMillis();
+
 //================================================================================
 // Laufzeit-Handler (für die Hauptschleife)
 //================================================================================
 
 /**
- * @brief Prüft das 'receivedFlag'. Wenn es gesetzt ist, wird das empfangene
- *        Paket ausgelesen, verarbeitet und über die Schnittstelle publiziert.
- *        Muss regelmäßig in der Hauptschleife aufgerufen werden.
+ * @brief Publiziert das älteste Paket aus dem Empfangspuffer über die Schnittstelle.
+ *        Das Auslesen des Moduls erfolgt bereits im DIO1-Interrupt, sodass das Modul
+ *        sofort wieder empfängt; hier wird nur noch kodiert und ausgegeben.
+ *        Läuft als Aufgabe TASK_RX, die der Interrupt weckt; liegen danach noch Pakete im
+ *        Puffer, weckt sie sich selbst erneut (siehe scheduler.h).
  */
 void checkLoRaReceived();
 
+/**
+ * @brief Treibt den nicht-blockierenden Sendevorgang voran: schließt eine per TxDone
+ *        beendete (oder abgelaufene) Übertragung ab, kehrt in den Empfang zurück und
+ *        startet das nächste Paket der Warteschlange.
+ *        Muss regelmäßig in der Hauptschleife aufgerufen werden.
+ */
+void handleLoRaTx();
+
 
 //================================================================================
 // Konfiguration und Aktionen
 //================================================================================
 
 /**
- * @brief Sendet ein LoRa-Paket blockierend und wechselt danach wieder in den Empfangsmodus.
- *        Setzt das 'receivedFlag' zurück, um fälschliche Empfangs-Trigger durch TxDone zu vermeiden.
+ * @brief Reiht ein LoRa-Paket in die Sendewarteschlange ein und kehrt sofort zurück.
+ *        Die Übertragung startet in handleLoRaTx(); ihr Abschluss wird als eigenes
+ *        'lora_tx_done'-Ereignis mit gemessener Sendedauer publiziert.
  * 
  * @param data Zeiger auf den Puffer mit den zu sendenden Daten.
- * @param len  Anzahl der zu sendenden Bytes.
+ * @param len  Anzahl der zu sendenden Bytes (1-255).
+ * @param id   Erhält die fortlaufende Sende-ID, unter der das Ereignis gemeldet wird.
+ * @param report false für interne Pakete (z.B. Fragmente und Quittungen der Blockübertragung),
+ *               deren Abschluss nicht als 'lora_tx_done' gemeldet wird.
+ * @param at_us  Geplanter Sendebeginn in Gerätezeit (siehe timebase.h), 0 = sofort. Geplante
+ *               Aufträge senden ohne Kanalprüfung in der Reihenfolge ihrer Zeitpunkte; ungeplante
+ *               ziehen an ihnen vorbei, solange sie vor dem frühesten Zeitpunkt fertig werden.
+ *               Verpasst ein Auftrag seinen Zeitpunkt um mehr als LORA_TX_SCHEDULE_LATE_US, wird er
+ *               mit LORA_TX_ERR_LATE verworfen.
+ * @return Eine leere Zeichenkette bei Erfolg, andernfalls eine Fehlermeldung.
+ */
+String queueLoRaPacket(const uint8_t* data, size_t len, uint16_t& id, bool report = true, uint64_t at_us = 0);
+
+/**
+ * @brief Reiht ein vom Repeater weitergesendetes Paket ein (ohne 'lora_tx_done', siehe repeater.h).
+ *        Anders als queueLoRaPacket() wartet es nicht auf Budget: Nach dem Paket und den bereits
+ *        wartenden Aufträgen müssen noch 'reserve_us' an Duty-Cycle-Budget übrig sein.
+ * @param rxDoneMicros micros() beim RxDone des Originals; der Repeater erhält es mit dem
+ *                     Sendebeginn zurück (repeaterRecordTx()).
+ * @return false, wenn die Warteschlange voll ist oder das Budget nicht reicht.
+ */
+bool queueLoRaRepeat(const uint8_t* data, uint8_t len, uint32_t rxDoneMicros, uint32_t reserve_us);
+
+// Status im 'lora_tx_done'-Ereignis eines verworfenen, verspäteten geplanten Auftrags
+#define LORA_TX_ERR_LATE (-1001)
+
+/**
+ * @brief Anzahl der wartenden und des gerade laufenden Sendeauftrags.
+ */
+uint8_t getLoRaTxQueueCount();
+
+/**
+ * @brief Zähler der geplanten Aufträge. Der Fehler ist der gemessene Sendebeginn
+ *        (TxDone minus berechnete Sendedauer) gegenüber dem geplanten Zeitpunkt.
+ */
+struct LoRaTxScheduleStats {
+    uint32_t sent;         // Zum geplanten Zeitpunkt gestartete Aufträge
+    uint32_t late;         // Verworfene, verspätete Aufträge
+    uint64_t absError_us;  // Summe der Beträge der Fehler
+    int32_t maxError_us;   // Betragsmäßig größter Fehler (mit Vorzeichen)
+    uint32_t lead_us;      // Aktueller Vorlauf von startTransmit() bis Sendebeginn
+};
+
+LoRaTxScheduleStats getLoRaTxScheduleStats();
+
+/**
+ * @brief Zähler der Kanalprüfung vor dem Senden (Listen-before-talk).
+ */
+struct LoRaLbtStats {
+    uint32_t cadRuns;    // Durchgeführte Kanalprüfungen (CAD)
+    uint32_t cadBusy;    // ... davon mit belegtem Kanal oder ohne Ergebnis
+    uint32_t dropped;    // Pakete, die nach LORA_LBT_MAX_RETRIES belegten Prüfungen verworfen wurden
+    uint32_t backoff_ms; // Summe aller Wartezeiten
+};
+
+/**
+ * @brief Schaltet die Kanalprüfung (CAD) mit zufälliger exponentieller Wartezeit vor jedem
+ *        Senden ein oder aus. Die CAD-Parameter werden aus SF und Bandbreite abgeleitet.
+ */
+void setLoRaLbtEnabled(bool enabled);
+bool isLoRaLbtEnabled();
+LoRaLbtStats getLoRaLbtStats();
+
+/**
+ * @brief Schaltet das Auslesen des Frequenzfehlers je Paket ein oder aus. Ausgeschaltet
+ *        entfällt der Registerzugriff im Empfangspfad; Pakete tragen dann keinen Frequenzfehler.
+ */
+void setLoRaRxFrequencyErrorEnabled(bool enabled);
+bool isLoRaRxFrequencyErrorEnabled();
+
+/**
+ * @brief Schaltet den Empfang auf dem eingestellten Kanal zwischen dauerhaft und Duty-Cycle
+ *        (SX1262 SetRxDutyCycle) um. Die Fenster werden aus SF, Bandbreite und Präambellänge
+ *        berechnet (siehe computeLoRaRxDutyCycle()); die Gegenstellen müssen mindestens diese
+ *        Präambel senden. Ist die Präambel zu kurz, bleibt der Empfang dauerhaft.
+ */
+void setLoRaRxDutyCycleEnabled(bool enabled);
+bool isLoRaRxDutyCycleEnabled();
+
+/**
+ * @brief Berechnet Empfangsfenster und Schlafdauer für den Duty-Cycle.
+ * @return false, wenn die Präambel für den Duty-Cycle zu kurz ist.
+ */
+bool computeLoRaRxDutyCycle(const LoRaSettings& settings, uint32_t& rx_us, uint32_t& sleep_us);
+
+/**
+ * @brief Fenster des laufenden Duty-Cycles.
+ * @return true, wenn das Modul gerade im Duty-Cycle empfängt.
+ */
+bool getLoRaRxDutyCycle(uint32_t& rx_us, uint32_t& sleep_us);
+
+//================================================================================
+// Kanalscan
+//================================================================================
+//
+// Im Scan-Modus wechselt das Modul reihum zwischen den Kanälen der Scan-Liste (Profile aus
+// presets.h, mit dem Frequenzoffset des Geräts) und prüft jeden per CAD auf eine Präambel.
+// Wird eine erkannt, bleibt das Modul im Empfang auf diesem Kanal, bis ein Paket da ist oder
+// die längste mögliche Paketdauer verstrichen ist. Empfangene Pakete tragen den Kanal.
+// Die Reihenfolge folgt den Gewichten (gleichmäßig verschränkt, z.B. A B A C bei 2:1:1).
+// Gesendet wird immer auf dem eingestellten Kanal: Wartende Sendeaufträge unterbrechen
+// den Scan nach dem aktuellen Besuch, danach geht es weiter.
+
+/**
+ * @brief Zähler je Kanal der Scan-Liste.
+ */
+struct LoRaScanChannelStats {
+    uint32_t visits;       // Besuche (Umschaltungen auf den Kanal)
+    uint32_t cadRuns;      // Durchgeführte Kanalprüfungen
+    uint32_t detections;   // ... davon mit erkannter Präambel (Einrasten)
+    uint32_t packets;      // Während des Einrastens fehlerfrei empfangene Pakete
+    uint32_t missedDwells; // Eingerastet, aber bis zum Zeitlimit kein fehlerfreies Paket
+    uint32_t busy_ms;      // Eingerastete Zeit
+};
+
+/**
+ * @brief Ersetzt die Scan-Liste.
+ * @param presets Profil-Indizes (siehe findLoRaPreset()).
+ * @param weights Besuche je Umlauf (1 bis LORA_SCAN_MAX_WEIGHT).
  * @return Eine leere Zeichenkette bei Erfolg, andernfalls eine Fehlermeldung.
  */
-String sendLoRaPacket(const uint8_t* data, size_t len);
+String setLoRaScanChannels(const uint8_t* presets, const uint8_t* weights, uint8_t count);
+
+/**
+ * @brief Schaltet den Scan ein oder aus. Ausgeschaltet kehrt das Modul sofort auf den
+ *        eingestellten Kanal zurück.
+ */
+void setLoRaScanEnabled(bool enabled);
+bool isLoRaScanEnabled();
+
+/**
+ * @brief Mindestverweildauer je Besuch in ms; bis dahin wird die CAD wiederholt (0 = eine CAD).
+ */
+void setLoRaScanDwellMillis(uint16_t dwell_ms);
+uint16_t getLoRaScanDwellMillis();
+
+uint8_t getLoRaScanChannelCount();
+uint8_t getLoRaScanChannelPreset(uint8_t index);
+uint8_t getLoRaScanChannelWeight(uint8_t index);
+LoRaScanChannelStats getLoRaScanChannelStats(uint8_t index);
+
+/**
+ * @brief Dauer des letzten vollständigen Umlaufs über alle Besuche in Mikrosekunden.
+ *        Für lückenlose Erfassung muss sie kürzer als die kürzeste Präambel sein.
+ */
+uint32_t getLoRaScanCycleMicros();
+
+void resetLoRaScanStats();
+
+/**
+ * @brief Treibt den Kanalscan voran (CAD auswerten, einrasten, weiterschalten).
+ *        Muss regelmäßig in der Hauptschleife nach handleLoRaTx() aufgerufen werden.
+ */
+void handleLoRaScan();
 
 /**
  * @brief Gibt eine Kopie der aktuell aktiven LoRa-Einstellungen zurück.
@@ -79,9 +239,22 @@ String sendLoRaPacket(const uint8_t* data, size_t len);
  */
 LoRaSettings getCurrentLoRaSettings();
 
+/**
+ * @brief Wendet einen vollständigen Parametersatz an. Es werden nur die gegenüber den aktuellen
+ *        Einstellungen geänderten Parameter an das Modul gesendet; der Empfang wird nur
+ *        unterbrochen, wenn ein empfangsrelevanter Parameter dabei ist (nicht bei der Sendeleistung).
+ *        Schlägt ein Parameter fehl, werden die bereits geschriebenen zurückgenommen.
+ *        'frequency_MHz' wird aus Basisfrequenz und Offset neu berechnet.
+ *
+ * @param requested Der gewünschte Parametersatz.
+ * @return String Eine Erfolgs- ("INFO: ...", inkl. RX-Blindzeit) oder Fehlermeldung ("ERROR: ...").
+ */
+String applyLoRaSettings(const LoRaSettings& requested);
+
 /**
  * @brief Setzt neue LoRa-Parameter, wendet sie auf das Modul an und speichert sie bei Erfolg.
  *        Aktualisiert die internen Einstellungen nur bei erfolgreicher Anwendung auf der Hardware.
+ *        Kurzform von applyLoRaSettings() mit Einzelwerten.
  * 
  * @param base_frequency_MHz   Die neue Basisfrequenz in MHz.
  * @param frequency_offset_kHz Der neue Frequenzoffset in kHz.
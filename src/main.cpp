@@ -6,16 +6,42 @@
 #include "led.h"
 #include "lora.h" 
 #include "interface.h" 
+#include "serialout.h"
+#include "latency.h"
+#include "bulk.h"
+#include "afc.h"
+#include "scheduler.h"
+#include "power.h"
+#include "timebase.h"
+#include "repeater.h"
 
 
+// Aufgaben in Prioritätsreihenfolge (siehe scheduler.h); vor allen anderen Modulen eintragen,
+// damit deren Zeitgeber (z.B. LED) nicht wieder gelöscht werden
+static void setupTasks() {
+  schedulerAddTask(TASK_RX,      "rx",      checkLoRaReceived,  TASK_KIND_EVENT, SCHEDULER_RX_FALLBACK_MS);
+  schedulerAddTask(TASK_TX,      "tx",      handleLoRaTx,       TASK_KIND_POLL,  0);
+  schedulerAddTask(TASK_SCAN,    "scan",    handleLoRaScan,     TASK_KIND_POLL,  0);
+  schedulerAddTask(TASK_BULK,    "bulk",    handleBulkTransfer, TASK_KIND_POLL,  0);
+  schedulerAddTask(TASK_REPEATER, "repeater", handleRepeater,    TASK_KIND_TIMER, 0);
+  schedulerAddTask(TASK_COMMAND, "command", handleJsonInput,    TASK_KIND_POLL,  0);
+  schedulerAddTask(TASK_AFC,     "afc",     handleAfc,          TASK_KIND_TIMER, SCHEDULER_AFC_PERIOD_MS);
+  schedulerAddTask(TASK_LED,     "led",     handleLED,          TASK_KIND_TIMER, 0);
+  schedulerAddTask(TASK_TIME,    "time",    handleTimebase,     TASK_KIND_TIMER, SCHEDULER_TIME_PERIOD_MS);
+  schedulerAddTask(TASK_LOG,     "log",     handleLogOutput,    TASK_KIND_POLL,  0);
+  schedulerAddTask(TASK_SERIAL,  "serial",  handleSerialOutput, TASK_KIND_POLL,  0);
+}
+
 void setup() {
-  Serial.begin(115200);
+  setupLatencyStats();
+  setupTasks();
+  setupSerialOutput();
 
   // Initialisiere die SPI-Schnittstelle
   SPI.begin();
 
   // Der Start-Log sollte über den Logger erfolgen
-  Serial.println("{\"level\":\"INFO\",\"message\":\"LoRa Node starting...\"}");
+  serialOut.println("{\"level\":\"INFO\",\"message\":\"LoRa Node starting...\"}");
 
   setupLED();
   setupJsonSerial();
@@ -24,22 +50,25 @@ void setup() {
   // NEU: Setze den LED-Modus basierend auf dem LoRa-Initialisierungsstatus
   if (isLoraReady()) {
     setHeartbeatMode(); // LoRa ist bereit, normaler Betrieb
-    logMessage("INFO", "System ist bereit.");
+    logEvent<LOG_SYSTEM_READY>();
   } else {
     setErrorMode();     // LoRa konnte nicht initialisiert werden, Fehler anzeigen
-    logMessage("ERROR", "LoRa-Modul nicht bereit. System im Fehlermodus.");
+    logEvent<LOG_SYSTEM_NOT_READY>();
   }
+
+  // LoRa-Aufgaben nur ausführen, wenn das Modul bereit ist
+  bool ready = isLoraReady();
+  schedulerSetEnabled(TASK_RX, ready);
+  schedulerSetEnabled(TASK_TX, ready);
+  schedulerSetEnabled(TASK_SCAN, ready);
+  schedulerSetEnabled(TASK_BULK, ready);
+  schedulerSetEnabled(TASK_REPEATER, ready);
+  schedulerSetEnabled(TASK_AFC, ready);
+
+  setPowerProfile((PowerProfile)POWER_PROFILE_DEFAULT);
 }
 
 void loop() {
-  handleLED();
-  
-  // LoRa-Funktionen nur ausführen, wenn das Modul bereit ist
-  if (isLoraReady()) {
-    if (receivedFlag) {
-      checkLoRaReceived();
-    }
-  }
-  
-  handleJsonInput();
-}
\ No newline at end of file
+  schedulerRun();
+  powerIdle();
+}
@@ -0,0 +1,103 @@
+#include <Arduino.h>
+
+#include "power.h"
+#include "lora.h"
+#include "scheduler.h"
+#include "serialout.h"
+
+static PowerProfile profile = (PowerProfile)POWER_PROFILE_DEFAULT;
+static uint32_t sleeps = 0;
+static uint64_t slept_us = 0;
+static uint64_t elapsed_us = 0;
+static uint32_t lastMicros = 0;
+static bool started = false;
+
+static const char* const profileNames[POWER_PROFILE_COUNT] = {"continuous", "idle", "duty_cycle"};
+
+static void resetMeasurement() {
+  sleeps = 0;
+  slept_us = 0;
+  elapsed_us = 0;
+  lastMicros = micros();
+  started = true;
+}
+
+void setPowerProfile(PowerProfile newProfile) {
+  profile = newProfile;
+  setLoRaRxDutyCycleEnabled(profile == POWER_DUTY_CYCLE);
+  resetMeasurement();
+}
+
+PowerProfile getPowerProfile() {
+  return profile;
+}
+
+const char* powerProfileName(uint8_t id) {
+  return id < POWER_PROFILE_COUNT ? profileNames[id] : "-";
+}
+
+void powerIdle() {
+  uint32_t now = micros();
+  if (!started) {
+    resetMeasurement();
+    return;
+  }
+  elapsed_us += now - lastMicros;
+  lastMicros = now;
+  if (profile == POWER_CONTINUOUS) {
+    return;
+  }
+
+  // Eine Benachrichtigung zwischen Prüfung und WFI weckt trotzdem: Der Interrupt bleibt bei
+  // gesperrten Interrupts anhängig und beendet WFI, ausgeführt wird er nach interrupts().
+  noInterrupts();
+  if (schedulerHasPending() || Serial.available() > 0 || serialOut.pending() > 0) {
+    interrupts();
+    return;
+  }
+  __WFI();
+  interrupts();
+
+  uint32_t woke = micros();
+  sleeps++;
+  slept_us += woke - now;
+  elapsed_us += woke - now;
+  lastMicros = woke;
+}
+
+PowerEstimate estimatePower(uint8_t id) {
+  PowerEstimate e = {};
+  bool active = id == profile;
+
+  if (id == POWER_CONTINUOUS) {
+    e.awake = 1.0f;
+    e.measured = active;
+  } else if (profile != POWER_CONTINUOUS && elapsed_us > 0) {
+    // Beide schlafenden Profile legen den Prozessor gleich schlafen
+    e.awake = 1.0f - (float)slept_us / (float)elapsed_us;
+    e.measured = true;
+  } else {
+    e.awake = POWER_IDLE_AWAKE_DEFAULT;
+  }
+  e.mcu_mA = e.awake * POWER_MCU_RUN_MA + (1.0f - e.awake) * POWER_MCU_SLEEP_MA;
+  e.latency_us = id == POWER_CONTINUOUS ? 0 : POWER_MCU_WAKE_US;
+
+  e.radio_mA = POWER_RADIO_RX_MA;
+  if (id == POWER_DUTY_CYCLE && computeLoRaRxDutyCycle(getCurrentLoRaSettings(), e.rx_us, e.sleep_us)) {
+    // Je Periode: Fenster im Empfang, Wechsel im Standby, Rest im Schlaf
+    uint32_t wake_us = e.sleep_us < LORA_RX_DUTY_WAKE_US ? e.sleep_us : LORA_RX_DUTY_WAKE_US;
+    float period_us = (float)e.rx_us + (float)e.sleep_us;
+    e.radio_mA = (e.rx_us * POWER_RADIO_RX_MA + wake_us * POWER_RADIO_STANDBY_MA +
+                  (e.sleep_us - wake_us) * POWER_RADIO_SLEEP_MA) / period_us;
+    // Beginnt eine Präambel kurz nach einem Fenster, hört das Modul sie erst im nächsten
+    e.latency_us += e.sleep_us;
+  }
+  e.total_mA = e.mcu_mA + e.radio_mA;
+  return e;
+}
+
+void getPowerSleepStats(uint32_t& count, uint64_t& sleptTotal_us, uint64_t& elapsedTotal_us) {
+  count = sleeps;
+  sleptTotal_us = slept_us;
+  elapsedTotal_us = elapsed_us;
+}
@@ -0,0 +1,66 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+#include "0_config.h"
+
+//================================================================================
+// Energieprofile
+//================================================================================
+//
+// POWER_CONTINUOUS  - Hauptschleife läuft ununterbrochen, Funkmodul empfängt dauerhaft
+// POWER_IDLE        - Ist keine Aufgabe benachrichtigt und liegt nichts an der seriellen
+//                     Schnittstelle an, schläft der Prozessor mit WFI bis zum nächsten
+//                     Interrupt (DIO1, UART, SysTick spätestens nach POWER_TICK_US)
+// POWER_DUTY_CYCLE  - wie POWER_IDLE, zusätzlich empfängt das Funkmodul im Duty-Cycle
+//                     (siehe setLoRaRxDutyCycleEnabled())
+//
+// Der Stop-Modus wird nicht verwendet: Er hält SysTick und damit millis() an, und der UART
+// kann ihn ohne umkonfigurierten EXTI-Eingang nicht beenden.
+
+enum PowerProfile : uint8_t {
+    POWER_CONTINUOUS,
+    POWER_IDLE,
+    POWER_DUTY_CYCLE,
+    POWER_PROFILE_COUNT
+};
+
+/**
+ * @brief Geschätzter Verbrauch eines Profils.
+ */
+struct PowerEstimate {
+    float awake;          // Wachanteil des Prozessors (0..1)
+    bool measured;        // Wachanteil gemessen statt angenommen
+    float mcu_mA;
+    float radio_mA;
+    float total_mA;
+    uint32_t rx_us;       // Empfangsfenster im Duty-Cycle (0 = dauerhafter Empfang)
+    uint32_t sleep_us;    // Schlafphase des Funkmoduls
+    uint32_t latency_us;  // Schlechteste Verzögerung, bis Aktivität auf dem Kanal bemerkt wird
+};
+
+/**
+ * @brief Wählt ein Profil und startet die Messung des Wachanteils neu.
+ */
+void setPowerProfile(PowerProfile profile);
+PowerProfile getPowerProfile();
+const char* powerProfileName(uint8_t profile);
+
+/**
+ * @brief Legt den Prozessor schlafen, wenn das Profil es erlaubt und nichts ansteht.
+ *        Wird am Ende von loop() aufgerufen.
+ */
+void powerIdle();
+
+/**
+ * @brief Schätzt den mittleren Strom eines Profils mit den aktuellen Funkeinstellungen.
+ *        Für das aktive Profil wird der gemessene Wachanteil verwendet.
+ */
+PowerEstimate estimatePower(uint8_t profile);
+
+/**
+ * @brief Anzahl der Schlafphasen und die geschlafene Zeit seit der letzten Profilwahl.
+ */
+void getPowerSleepStats(uint32_t& sleeps, uint64_t& slept_us, uint64_t& elapsed_us);
+
+#endif // POWER_H
@@ -0,0 +1,85 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "presets.h"
+
+// Eingebaute Profile. Der Frequenzoffset gehört zum Gerät und wird beim Umschalten
+// beibehalten, 'frequency_MHz' wird beim Anwenden berechnet.
+struct BuiltinPreset {
+  const char* name;
+  LoRaSettings settings;
+};
+
+static const BuiltinPreset BUILTIN_PRESETS[] = {
+  //                      Basis     Offset Arbeit  BW     SF  CR  Sync  Power Präambel
+  {"meshtastic_longfast", {869.525f, 0.0f, 0.0f, 250.0f, 11, 5, 0x1B, 22, 16}},
+  {"meshcore",            {869.618f, 0.0f, 0.0f,  62.5f,  8, 8, 0x12, 22, 16}},
+};
+
+static const uint8_t BUILTIN_PRESET_COUNT = sizeof(BUILTIN_PRESETS) / sizeof(BUILTIN_PRESETS[0]);
+
+static const char* const USER_PRESET_NAMES[] = {"user1", "user2", "user3", "user4", "user5", "user6", "user7", "user8"};
+static_assert(LORA_USER_PRESET_SLOTS <= sizeof(USER_PRESET_NAMES) / sizeof(USER_PRESET_NAMES[0]),
+              "LORA_USER_PRESET_SLOTS ist größer als die Anzahl der Platznamen");
+
+static LoRaSettings userPresets[LORA_USER_PRESET_SLOTS];
+static bool userPresetUsed[LORA_USER_PRESET_SLOTS] = {false};
+
+uint8_t getLoRaPresetCount() {
+  return BUILTIN_PRESET_COUNT + LORA_USER_PRESET_SLOTS;
+}
+
+const char* getLoRaPresetName(uint8_t index) {
+  if (index < BUILTIN_PRESET_COUNT) {
+    return BUILTIN_PRESETS[index].name;
+  }
+  index -= BUILTIN_PRESET_COUNT;
+  return index < LORA_USER_PRESET_SLOTS ? USER_PRESET_NAMES[index] : "";
+}
+
+const LoRaSettings* getLoRaPreset(uint8_t index) {
+  if (index < BUILTIN_PRESET_COUNT) {
+    return &BUILTIN_PRESETS[index].settings;
+  }
+  index -= BUILTIN_PRESET_COUNT;
+  if (index < LORA_USER_PRESET_SLOTS && userPresetUsed[index]) {
+    return &userPresets[index];
+  }
+  return nullptr;
+}
+
+int findLoRaPreset(const char* name) {
+  for (uint8_t i = 0; i < getLoRaPresetCount(); i++) {
+    if (strcasecmp(name, getLoRaPresetName(i)) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool storeLoRaUserPreset(uint8_t slot, const LoRaSettings& settings) {
+  if (slot < 1 || slot > LORA_USER_PRESET_SLOTS) {
+    return false;
+  }
+  userPresets[slot - 1] = settings;
+  userPresetUsed[slot - 1] = true;
+  return true;
+}
+
+uint8_t exportLoRaUserPresets(LoRaSettings* slots) {
+  uint8_t usedMask = 0;
+  for (uint8_t i = 0; i < LORA_USER_PRESET_SLOTS; i++) {
+    slots[i] = userPresets[i];
+    if (userPresetUsed[i]) {
+      usedMask |= 1 << i;
+    }
+  }
+  return usedMask;
+}
+
+void importLoRaUserPresets(const LoRaSettings* slots, uint8_t usedMask) {
+  for (uint8_t i = 0; i < LORA_USER_PRESET_SLOTS; i++) {
+    userPresets[i] = slots[i];
+    userPresetUsed[i] = (usedMask & (1 << i)) != 0;
+  }
+}
@@ -0,0 +1,50 @@
+#ifndef PRESETS_H
+#define PRESETS_H
+
+#include <Arduino.h>
+#include "lora.h"
+
+//================================================================================
+// Benannte Parametersätze (eingebaute Profile und Benutzerplätze)
+//================================================================================
+
+/**
+ * @brief Anzahl aller Profile (eingebaute zuerst, danach die Benutzerplätze).
+ */
+uint8_t getLoRaPresetCount();
+
+/**
+ * @brief Name des Profils mit dem Index 'index' (z.B. "meshcore" oder "user1").
+ */
+const char* getLoRaPresetName(uint8_t index);
+
+/**
+ * @brief Parametersatz des Profils mit dem Index 'index'.
+ * @return nullptr, wenn der Benutzerplatz noch leer ist.
+ */
+const LoRaSettings* getLoRaPreset(uint8_t index);
+
+/**
+ * @brief Sucht ein Profil anhand seines Namens (Groß-/Kleinschreibung egal).
+ * @return Index des Profils oder -1, wenn es keinen solchen Namen gibt.
+ */
+int findLoRaPreset(const char* name);
+
+/**
+ * @brief Speichert einen Parametersatz in einem Benutzerplatz (1 bis LORA_USER_PRESET_SLOTS).
+ * @return false, wenn der Platz ungültig ist.
+ */
+bool storeLoRaUserPreset(uint8_t slot, const LoRaSettings& settings);
+
+/**
+ * @brief Kopiert alle Benutzerplätze nach 'slots' (LORA_USER_PRESET_SLOTS Einträge).
+ * @return Bitmaske der belegten Plätze (Bit 0 = "user1").
+ */
+uint8_t exportLoRaUserPresets(LoRaSettings* slots);
+
+/**
+ * @brief Übernimmt alle Benutzerplätze aus 'slots', z.B. aus dem Flash.
+ */
+void importLoRaUserPresets(const LoRaSettings* slots, uint8_t usedMask);
+
+#endif // PRESETS_H
@@ -0,0 +1,300 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "repeater.h"
+#include "lora.h"
+#include "airtime.h"
+#include "scheduler.h"
+#include "timebase.h"
+
+// Ein gemerktes Paket; hash == 0 kennzeichnet einen freien Platz
+struct RepeaterSeen {
+  uint32_t hash;
+  uint32_t seen_ms;
+};
+
+// Ein Paket, das auf seinen Sendezeitpunkt wartet (Hop-Feld bereits angepasst). Neben Länge und
+// Nutzdaten nur, was zum Abbrechen (Hash) und Terminieren (Empfangsende + Wartezeit) nötig ist.
+struct RepeaterSlot {
+  uint32_t hash;
+  uint32_t rxDoneMicros; // Sendezeitpunkt = rxDoneMicros + delay_ms, Latenz ab hier
+  uint16_t delay_ms;
+  uint8_t len;           // 0 = frei
+  uint8_t payload[255];
+};
+
+// Verbleibende Wartezeit eines belegten Platzes in Millisekunden (aufgerundet, 0 = fällig)
+static uint32_t slotRemainingMillis(const RepeaterSlot& slot, uint32_t now_us) {
+  uint32_t waited_us = now_us - slot.rxDoneMicros;
+  uint32_t delay_us = (uint32_t)slot.delay_ms * 1000UL;
+  return waited_us >= delay_us ? 0 : (delay_us - waited_us + 999) / 1000;
+}
+
+static RepeaterSeen seen[LORA_REPEATER_SEEN_SIZE];
+static RepeaterSlot slots[LORA_REPEATER_SLOTS];
+static RxFilterRule rules[LORA_RX_FILTER_RULES];
+static uint8_t ruleCount = 0;
+
+static RepeaterSettings settings = {
+  LORA_REPEATER_ENABLED_DEFAULT, LORA_REPEATER_DELAY_MIN_MS, LORA_REPEATER_DELAY_MAX_MS, LORA_REPEATER_WINDOW_MS,
+  REPEATER_HOP_OFF, 0, 0xFF, 3, LORA_REPEATER_RESERVE_PERCENT
+};
+static RepeaterStats stats = {};
+
+static inline bool hasHopField(const LoRaRxPacket* packet) {
+  return settings.hopMode != REPEATER_HOP_OFF && settings.hopOffset < packet->len;
+}
+
+// FNV-1a über die Nutzdaten ohne die Bits des Hop-Felds; die Länge fließt mit ein
+static uint32_t keyHash(const LoRaRxPacket* packet) {
+  bool masked = hasHopField(packet);
+  uint32_t hash = 2166136261UL;
+  for (uint16_t i = 0; i < packet->len; i++) {
+    uint8_t b = packet->payload[i];
+    if (masked && i == settings.hopOffset) {
+      b &= ~settings.hopMask;
+    }
+    hash = (hash ^ b) * 16777619UL;
+  }
+  hash = (hash ^ packet->len) * 16777619UL;
+  return hash != 0 ? hash : 1;
+}
+
+// Trägt den Hash ein; liefert true, wenn er im Zeitfenster schon bekannt war.
+// Verfallene Plätze werden wiederverwendet, sonst wird der älteste verdrängt.
+static bool rememberPacket(uint32_t hash, uint32_t now_ms) {
+  uint8_t target = 0;
+  uint32_t oldestAge = 0;
+  for (uint8_t i = 0; i < LORA_REPEATER_SEEN_SIZE; i++) {
+    RepeaterSeen& entry = seen[i];
+    uint32_t age = now_ms - entry.seen_ms;
+    bool expired = entry.hash == 0 || age >= settings.window_ms;
+    if (!expired && entry.hash == hash) {
+      return true;
+    }
+    if (expired) {
+      age = UINT32_MAX;
+    }
+    if (age >= oldestAge) {
+      oldestAge = age;
+      target = i;
+    }
+  }
+  seen[target].hash = hash;
+  seen[target].seen_ms = now_ms;
+  return false;
+}
+
+// Stellt den Zeitgeber auf das nächste fällige Paket
+static void armNextSlot() {
+  uint32_t now = micros();
+  bool pending = false;
+  uint32_t next_ms = 0;
+  for (uint8_t i = 0; i < LORA_REPEATER_SLOTS; i++) {
+    if (slots[i].len == 0) {
+      continue;
+    }
+    uint32_t delay_ms = slotRemainingMillis(slots[i], now);
+    if (!pending || delay_ms < next_ms) {
+      next_ms = delay_ms;
+      pending = true;
+    }
+  }
+  if (pending) {
+    schedulerArm(TASK_REPEATER, next_ms);
+  }
+}
+
+// Ein anderer Knoten hat das Paket schon weitergesendet: wartende Kopie verwerfen
+static bool cancelSlot(uint32_t hash) {
+  for (uint8_t i = 0; i < LORA_REPEATER_SLOTS; i++) {
+    if (slots[i].len != 0 && slots[i].hash == hash) {
+      slots[i].len = 0;
+      return true;
+    }
+  }
+  return false;
+}
+
+void repeaterHandlePacket(const LoRaRxPacket* packet) {
+  if (!settings.enabled || packet->len == 0) {
+    return;
+  }
+  if (!rxFilterRulesAccept(rules, ruleCount, packet)) {
+    stats.filtered++;
+    return;
+  }
+
+  uint32_t hash = keyHash(packet);
+  if (rememberPacket(hash, packet->timestamp_ms)) {
+    if (cancelSlot(hash)) {
+      stats.cancelled++;
+    } else {
+      stats.duplicates++;
+    }
+    return;
+  }
+
+  // Hop-Feld prüfen und für die Kopie fortschreiben
+  uint8_t hopByte = 0;
+  if (settings.hopMode != REPEATER_HOP_OFF) {
+    if (!hasHopField(packet)) {
+      stats.expired++;
+      return;
+    }
+    uint8_t shift = 0;
+    while (((settings.hopMask >> shift) & 1) == 0) {
+      shift++;
+    }
+    uint8_t field = (packet->payload[settings.hopOffset] & settings.hopMask) >> shift;
+    uint8_t fieldMax = settings.hopMask >> shift;
+    if (settings.hopMode == REPEATER_HOP_TTL) {
+      if (field == 0) {
+        stats.expired++;
+        return;
+      }
+      field--;
+    } else {
+      if (field >= settings.maxHops || field >= fieldMax) {
+        stats.expired++;
+        return;
+      }
+      field++;
+    }
+    hopByte = (packet->payload[settings.hopOffset] & ~settings.hopMask) | (uint8_t)(field << shift);
+  }
+
+  RepeaterSlot* slot = nullptr;
+  for (uint8_t i = 0; i < LORA_REPEATER_SLOTS; i++) {
+    if (slots[i].len == 0) {
+      slot = &slots[i];
+      break;
+    }
+  }
+  if (slot == nullptr) {
+    stats.overflow++;
+    return;
+  }
+
+  // Zufällige Wartezeit, damit benachbarte Repeater nicht gleichzeitig senden und der
+  // langsamere die Kopie des schnelleren noch hört
+  slot->hash = hash;
+  slot->delay_ms = random(settings.delayMin_ms, settings.delayMax_ms + 1);
+  slot->rxDoneMicros = packet->rxDoneMicros;
+  slot->len = packet->len;
+  memcpy(slot->payload, packet->payload, packet->len);
+  if (settings.hopMode != REPEATER_HOP_OFF) {
+    slot->payload[settings.hopOffset] = hopByte;
+  }
+  armNextSlot();
+}
+
+void handleRepeater() {
+  uint32_t now = micros();
+  uint32_t reserve_us = (uint32_t)((uint64_t)getDutyCycleCapacityMicros() * settings.reservePercent / 100);
+  for (uint8_t i = 0; i < LORA_REPEATER_SLOTS; i++) {
+    RepeaterSlot& slot = slots[i];
+    if (slot.len == 0 || slotRemainingMillis(slot, now) != 0) {
+      continue;
+    }
+    if (!queueLoRaRepeat(slot.payload, slot.len, slot.rxDoneMicros, reserve_us)) {
+      stats.budget++;
+    }
+    slot.len = 0;
+  }
+  armNextSlot();
+}
+
+void repeaterRecordTx(uint64_t start_us, uint32_t rxDoneMicros) {
+  if (start_us == 0) {
+    stats.failed++;
+    return;
+  }
+  uint32_t latency_us = (uint32_t)(start_us - timebaseExtend(rxDoneMicros));
+  if (stats.forwarded == 0 || latency_us < stats.minLatency_us) {
+    stats.minLatency_us = latency_us;
+  }
+  if (latency_us > stats.maxLatency_us) {
+    stats.maxLatency_us = latency_us;
+  }
+  stats.forwarded++;
+  stats.latency_us += latency_us;
+}
+
+void setRepeaterSettings(const RepeaterSettings& requested) {
+  RepeaterSettings next = requested;
+  if (next.hopMode > REPEATER_HOP_COUNT || next.hopMask == 0) {
+    next.hopMode = REPEATER_HOP_OFF;
+  }
+  if (next.delayMax_ms > LORA_REPEATER_DELAY_LIMIT_MS) {
+    next.delayMax_ms = LORA_REPEATER_DELAY_LIMIT_MS;
+  }
+  if (next.delayMin_ms > next.delayMax_ms) {
+    next.delayMin_ms = next.delayMax_ms;
+  }
+  if (next.window_ms < LORA_DEDUP_WINDOW_MIN_MS) {
+    next.window_ms = LORA_DEDUP_WINDOW_MIN_MS;
+  } else if (next.window_ms > LORA_DEDUP_WINDOW_MAX_MS) {
+    next.window_ms = LORA_DEDUP_WINDOW_MAX_MS;
+  }
+  if (next.reservePercent > 100) {
+    next.reservePercent = 100;
+  }
+
+  bool keyChanged = next.window_ms != settings.window_ms || next.hopMode != settings.hopMode ||
+                    next.hopOffset != settings.hopOffset || next.hopMask != settings.hopMask;
+  settings = next;
+  if (keyChanged) {
+    memset(seen, 0, sizeof(seen));
+  }
+  if (keyChanged || !settings.enabled) {
+    for (uint8_t i = 0; i < LORA_REPEATER_SLOTS; i++) {
+      slots[i].len = 0;
+    }
+  }
+}
+
+RepeaterSettings getRepeaterSettings() {
+  return settings;
+}
+
+bool setRepeaterRules(const RxFilterRule* newRules, uint8_t count) {
+  if (count > LORA_RX_FILTER_RULES) {
+    return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    rules[i] = newRules[i];
+    rules[i].hits = 0;
+  }
+  ruleCount = count;
+  return true;
+}
+
+uint8_t getRepeaterRuleCount() {
+  return ruleCount;
+}
+
+const RxFilterRule* getRepeaterRule(uint8_t index) {
+  return index < ruleCount ? &rules[index] : nullptr;
+}
+
+uint8_t getRepeaterPending() {
+  uint8_t pending = 0;
+  for (uint8_t i = 0; i < LORA_REPEATER_SLOTS; i++) {
+    if (slots[i].len != 0) {
+      pending++;
+    }
+  }
+  return pending;
+}
+
+RepeaterStats getRepeaterStats() {
+  return stats;
+}
+
+void resetRepeaterStats() {
+  stats = {};
+  for (uint8_t i = 0; i < ruleCount; i++) {
+    rules[i].hits = 0;
+  }
+}
@@ -0,0 +1,105 @@
+#ifndef REPEATER_H
+#define REPEATER_H
+
+#include <Arduino.h>
+#include "0_config.h"
+#include "rxbuffer.h"
+#include "rxfilter.h"
+
+//================================================================================
+// Repeater (Weitersenden empfangener Pakete ohne Umweg über den Host)
+//================================================================================
+//
+// Jedes fehlerfrei empfangene Paket durchläuft unabhängig von der Ausgabe an den Host:
+//   1. die eigene Regelkette des Repeaters (gleiche Regeln wie rxfilter.h),
+//   2. die Duplikatprüfung: Hash (FNV-1a) der Nutzdaten ohne die Bits des Hop-Felds, damit
+//      weitergesendete Kopien mit verändertem Feld als dasselbe Paket gelten,
+//   3. die Hop-Regel: REPEATER_HOP_TTL sendet nur mit Restlebensdauer > 0 und zählt sie
+//      herunter, REPEATER_HOP_COUNT nur unterhalb von 'maxHops' und zählt hoch.
+// Bestandene Pakete warten mit einer zufälligen Verzögerung in einem Platz des Repeaters.
+// Hört das Gerät in dieser Zeit eine Kopie (ein anderer Knoten war schneller), entfällt das
+// Weitersenden. Danach geht das Paket ohne 'lora_tx_done' in die Sendewarteschlange, sofern
+// nach ihm noch die Reserve des Duty-Cycle-Budgets für den Host übrig bleibt.
+// Gesendet wird mit den aktuellen Funkeinstellungen (im Scan-Modus also auf dem Heimatkanal).
+
+enum RepeaterHopMode : uint8_t {
+    REPEATER_HOP_OFF,   // Kein Hop-Feld, Begrenzung nur über das Zeitfenster
+    REPEATER_HOP_TTL,   // Feld enthält die verbleibenden Weiterleitungen
+    REPEATER_HOP_COUNT  // Feld enthält die bisherigen Weiterleitungen
+};
+
+/**
+ * @brief Einstellungen des Repeaters.
+ */
+struct RepeaterSettings {
+    bool enabled;
+    uint16_t delayMin_ms;   // Zufällige Wartezeit vor dem Weitersenden ...
+    uint16_t delayMax_ms;   // ... zwischen diesen Grenzen
+    uint32_t window_ms;     // Zeitfenster der Duplikatprüfung
+    RepeaterHopMode hopMode;
+    uint8_t hopOffset;      // Byte mit dem Hop-Feld
+    uint8_t hopMask;        // Bits des Hop-Felds in diesem Byte (zusammenhängend)
+    uint8_t maxHops;        // Obergrenze im Modus REPEATER_HOP_COUNT
+    uint8_t reservePercent; // Für den Host freizuhaltender Anteil des Duty-Cycle-Budgets
+};
+
+/**
+ * @brief Zähler des Repeaters. Alle Pakete außer 'forwarded' gelten als unterdrückt.
+ */
+struct RepeaterStats {
+    uint32_t forwarded;  // Weitergesendete Pakete (Übertragung abgeschlossen)
+    uint32_t filtered;   // Von der Regelkette verworfen
+    uint32_t duplicates; // Kopie eines bereits gehörten Pakets
+    uint32_t cancelled;  // Während der Wartezeit von einem anderen Knoten weitergesendet
+    uint32_t expired;    // Hop-Feld erschöpft oder Paket zu kurz dafür
+    uint32_t overflow;   // Alle Plätze belegt
+    uint32_t budget;     // Zu wenig Duty-Cycle-Budget oder Sendewarteschlange voll
+    uint32_t failed;     // Übertragung fehlgeschlagen
+    uint64_t latency_us; // Summe der Zeit von RxDone bis zum Sendebeginn der Kopie
+    uint32_t minLatency_us;
+    uint32_t maxLatency_us;
+};
+
+/**
+ * @brief Prüft ein fehlerfrei empfangenes Paket und merkt es gegebenenfalls zum
+ *        Weitersenden vor. Wird für jedes Paket aufgerufen, auch für gefilterte.
+ */
+void repeaterHandlePacket(const LoRaRxPacket* packet);
+
+/**
+ * @brief Läuft als Zeitgeber-Aufgabe und reiht fällige Pakete in die Sendewarteschlange ein.
+ */
+void handleRepeater();
+
+/**
+ * @brief Meldet das Ende der Übertragung eines weitergesendeten Pakets.
+ * @param start_us     Gemessener Sendebeginn in Gerätezeit (0 = fehlgeschlagen).
+ * @param rxDoneMicros micros() beim RxDone des Originals.
+ */
+void repeaterRecordTx(uint64_t start_us, uint32_t rxDoneMicros);
+
+/**
+ * @brief Übernimmt neue Einstellungen. Ändern sich Zeitfenster oder Hop-Feld, werden die
+ *        gemerkten Pakete vergessen; beim Abschalten entfallen wartende Pakete.
+ *        Ungültige Werte werden auf den zulässigen Bereich begrenzt.
+ */
+void setRepeaterSettings(const RepeaterSettings& settings);
+RepeaterSettings getRepeaterSettings();
+
+/**
+ * @brief Ersetzt die Regelkette des Repeaters (leer = alle Pakete).
+ * @return false, wenn 'count' größer als LORA_RX_FILTER_RULES ist (Kette bleibt unverändert).
+ */
+bool setRepeaterRules(const RxFilterRule* rules, uint8_t count);
+uint8_t getRepeaterRuleCount();
+const RxFilterRule* getRepeaterRule(uint8_t index);
+
+/**
+ * @brief Anzahl der Pakete, die auf ihren Sendezeitpunkt warten.
+ */
+uint8_t getRepeaterPending();
+
+RepeaterStats getRepeaterStats();
+void resetRepeaterStats();
+
+#endif // REPEATER_H
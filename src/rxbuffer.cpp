@@ -0,0 +1,79 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "rxbuffer.h"
+
+// Die Indizes laufen frei über; die Kapazität muss daher eine Zweierpotenz sein.
+static_assert((LORA_RX_RING_SIZE & (LORA_RX_RING_SIZE - 1)) == 0, "LORA_RX_RING_SIZE muss eine Zweierpotenz sein");
+static_assert(LORA_RX_RING_SIZE <= 128, "LORA_RX_RING_SIZE zu groß");
+
+static LoRaRxPacket rxRing[LORA_RX_RING_SIZE];
+
+// 'head' wird nur vom Produzenten (ISR), 'tail' nur vom Konsumenten (loop) geschrieben.
+static volatile uint8_t rxHead = 0;
+static volatile uint8_t rxTail = 0;
+
+static volatile LoRaRxStats rxStats = {0, 0, 0, 0};
+
+static inline uint8_t fillLevel() {
+  return (uint8_t)(rxHead - rxTail);
+}
+
+LoRaRxPacket* rxBufferReserve() {
+  if (fillLevel() >= LORA_RX_RING_SIZE) {
+    rxStats.overruns++;
+    return nullptr;
+  }
+  return &rxRing[rxHead & (LORA_RX_RING_SIZE - 1)];
+}
+
+void rxBufferCommit() {
+  rxHead = rxHead + 1;
+  rxStats.received++;
+
+  uint8_t level = fillLevel();
+  if (level > rxStats.highWater) {
+    rxStats.highWater = level;
+  }
+}
+
+void rxBufferCountDrop() {
+  rxStats.dropped++;
+}
+
+const LoRaRxPacket* rxBufferPeek() {
+  if (fillLevel() == 0) {
+    return nullptr;
+  }
+  return &rxRing[rxTail & (LORA_RX_RING_SIZE - 1)];
+}
+
+void rxBufferRelease() {
+  if (fillLevel() > 0) {
+    rxTail = rxTail + 1;
+  }
+}
+
+uint8_t rxBufferCount() {
+  return fillLevel();
+}
+
+LoRaRxStats getRxBufferStats() {
+  LoRaRxStats copy;
+  noInterrupts();
+  copy.received  = rxStats.received;
+  copy.overruns  = rxStats.overruns;
+  copy.dropped   = rxStats.dropped;
+  copy.highWater = rxStats.highWater;
+  interrupts();
+  return copy;
+}
+
+void resetRxBufferStats() {
+  noInterrupts();
+  rxStats.received  = 0;
+  rxStats.overruns  = 0;
+  rxStats.dropped   = 0;
+  rxStats.highWater = fillLevel();
+  interrupts();
+}
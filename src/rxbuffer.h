@@ -0,0 +1,88 @@
+#ifndef RXBUFFER_H
+#define RXBUFFER_H
+
+#include <Arduino.h>
+
+//================================================================================
+// Datenstruktur für empfangene Pakete
+//================================================================================
+
+/**
+ * @brief Ein vollständig ausgelesenes LoRa-Paket inklusive Empfangsqualität.
+ *        Wird im DIO1-Pfad befüllt und später von der Hauptschleife publiziert.
+ */
+struct LoRaRxPacket {
+    uint8_t payload[256];   // Nutzdaten
+    uint16_t len;           // Anzahl gültiger Bytes in 'payload'
+    int16_t state;          // RadioLib-Status von readData() (z.B. CRC-Fehler)
+    int16_t rssi;           // RSSI in dBm (Mittel über das Paket)
+    int16_t signalRssi;     // RSSI des Nutzsignals nach der Entspreizung in dBm
+    float snr;              // SNR in dB
+    float frequencyError;   // Frequenzfehler in Hz (NAN, wenn die Messung abgeschaltet ist)
+    uint8_t channel;        // Profil-Index des Scan-Kanals (LORA_SCAN_NO_CHANNEL außerhalb des Scans)
+    uint32_t timestamp_ms;  // millis() beim Auslesen
+    uint32_t rxDoneMicros;  // micros() beim Eintritt in die DIO1-ISR (RxDone = Paketende)
+    uint32_t cyclesIsr;     // Zykluszähler beim Eintritt in die DIO1-ISR
+    uint32_t cyclesRead;    // ... nach readData()
+    uint32_t cyclesStatus;  // ... nach dem Lesen von RSSI/SNR/Frequenzfehler
+    uint32_t cyclesRxReady; // ... Modul wieder empfangsbereit (IRQ gelöscht)
+};
+
+/**
+ * @brief Zähler des Empfangspuffers.
+ */
+struct LoRaRxStats {
+    uint32_t received;  // Erfolgreich in den Puffer geschriebene Pakete
+    uint32_t overruns;  // Verworfene Pakete, weil der Puffer voll war
+    uint32_t dropped;   // Verworfene Pakete wegen ungültiger Länge oder Lesefehler
+    uint8_t highWater;  // Höchster beobachteter Füllstand
+};
+
+//================================================================================
+// Ringpuffer (ein Produzent im Interrupt, ein Konsument in der Hauptschleife)
+//================================================================================
+
+/**
+ * @brief Reserviert den nächsten freien Platz im Ringpuffer (Produzentenseite).
+ * @return Zeiger auf den freien Eintrag oder nullptr, wenn der Puffer voll ist.
+ *         Ein voller Puffer wird als Overrun gezählt.
+ */
+LoRaRxPacket* rxBufferReserve();
+
+/**
+ * @brief Gibt den zuvor reservierten Eintrag für den Konsumenten frei.
+ */
+void rxBufferCommit();
+
+/**
+ * @brief Zählt ein verworfenes Paket (ungültige Länge oder Lesefehler).
+ */
+void rxBufferCountDrop();
+
+/**
+ * @brief Liefert das älteste Paket, ohne es zu entfernen (Konsumentenseite).
+ * @return Zeiger auf das Paket oder nullptr, wenn der Puffer leer ist.
+ */
+const LoRaRxPacket* rxBufferPeek();
+
+/**
+ * @brief Entfernt das mit rxBufferPeek() gelesene Paket aus dem Puffer.
+ */
+void rxBufferRelease();
+
+/**
+ * @brief Anzahl der aktuell gepufferten Pakete.
+ */
+uint8_t rxBufferCount();
+
+/**
+ * @brief Gibt eine Kopie der Pufferstatistik zurück.
+ */
+LoRaRxStats getRxBufferStats();
+
+/**
+ * @brief Setzt alle Zähler der Pufferstatistik zurück.
+ */
+void resetRxBufferStats();
+
+#endif // RXBUFFER_H
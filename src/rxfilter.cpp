@@ -0,0 +1,137 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "rxfilter.h"
+
+static RxFilterRule rules[LORA_RX_FILTER_RULES];
+static uint8_t ruleCount = 0;
+static bool filterEnabled = false;
+static RxFilterStats stats = {0, 0, 0};
+
+static bool bytesMatch(const RxFilterRule& rule, const LoRaRxPacket* packet) {
+  if ((uint16_t)rule.offset + rule.length > packet->len) {
+    return false;
+  }
+  const uint8_t* p = &packet->payload[rule.offset];
+  for (uint8_t i = 0; i < rule.length; i++) {
+    if ((p[i] & rule.mask[i]) != rule.value[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Liefert true, wenn die Regel das Paket verwirft
+static bool ruleRejects(const RxFilterRule& rule, const LoRaRxPacket* packet) {
+  switch (rule.kind) {
+    case RX_RULE_MIN_RSSI:
+      return packet->rssi < rule.min;
+    case RX_RULE_MIN_SNR:
+      return packet->snr * 4.0f < rule.min;
+    case RX_RULE_LENGTH:
+      return packet->len < rule.min || packet->len > rule.max;
+    case RX_RULE_DENY:
+      return bytesMatch(rule, packet);
+    default:
+      return false;
+  }
+}
+
+// Prüft eine Regelkette und schreibt die Trefferzähler ihrer Regeln fort. 'unmatched' wird
+// gesetzt, wenn das Paket nur an der Positivliste scheitert.
+static bool chainAccepts(RxFilterRule* chain, uint8_t count, const LoRaRxPacket* packet, bool& unmatched) {
+  bool haveMatchRules = false;
+  bool matched = false;
+  unmatched = false;
+  for (uint8_t i = 0; i < count; i++) {
+    RxFilterRule& rule = chain[i];
+    if (rule.kind == RX_RULE_MATCH) {
+      haveMatchRules = true;
+      if (!matched && bytesMatch(rule, packet)) {
+        matched = true;
+        rule.hits++;
+      }
+    } else if (ruleRejects(rule, packet)) {
+      rule.hits++;
+      return false;
+    }
+  }
+
+  if (haveMatchRules && !matched) {
+    unmatched = true;
+    return false;
+  }
+  return true;
+}
+
+bool rxFilterAccept(const LoRaRxPacket* packet) {
+  if (!filterEnabled || ruleCount == 0) {
+    return true;
+  }
+
+  bool unmatched;
+  if (!chainAccepts(rules, ruleCount, packet, unmatched)) {
+    stats.rejected++;
+    if (unmatched) {
+      stats.unmatched++;
+    }
+    return false;
+  }
+  stats.passed++;
+  return true;
+}
+
+bool rxFilterRulesAccept(RxFilterRule* chain, uint8_t count, const LoRaRxPacket* packet) {
+  bool unmatched;
+  return chainAccepts(chain, count, packet, unmatched);
+}
+
+bool setRxFilterRules(const RxFilterRule* newRules, uint8_t count, bool enabled) {
+  if (count > LORA_RX_FILTER_RULES) {
+    return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    rules[i] = newRules[i];
+    rules[i].hits = 0;
+  }
+  ruleCount = count;
+  filterEnabled = enabled;
+  return true;
+}
+
+bool addRxFilterRule(const RxFilterRule& rule) {
+  if (ruleCount >= LORA_RX_FILTER_RULES) {
+    return false;
+  }
+  rules[ruleCount] = rule;
+  rules[ruleCount].hits = 0;
+  ruleCount++;
+  return true;
+}
+
+void setRxFilterEnabled(bool enabled) {
+  filterEnabled = enabled;
+}
+
+bool isRxFilterEnabled() {
+  return filterEnabled;
+}
+
+uint8_t getRxFilterRuleCount() {
+  return ruleCount;
+}
+
+const RxFilterRule* getRxFilterRule(uint8_t index) {
+  return index < ruleCount ? &rules[index] : nullptr;
+}
+
+RxFilterStats getRxFilterStats() {
+  return stats;
+}
+
+void resetRxFilterStats() {
+  stats = {0, 0, 0};
+  for (uint8_t i = 0; i < ruleCount; i++) {
+    rules[i].hits = 0;
+  }
+}
@@ -0,0 +1,86 @@
+#ifndef RXFILTER_H
+#define RXFILTER_H
+
+#include <Arduino.h>
+#include "0_config.h"
+#include "rxbuffer.h"
+
+//================================================================================
+// Empfangsfilter (Regelkette vor der Kodierung)
+//================================================================================
+//
+// Die Regeln werden der Reihe nach geprüft; die erste verwerfende Regel beendet die
+// Prüfung. Gibt es MATCH-Regeln, muss mindestens eine davon zutreffen (Positivliste).
+// Byte-Vergleiche: (payload[offset + i] & mask[i]) == value[i] für alle i < length.
+
+enum RxFilterKind : uint8_t {
+    RX_RULE_MIN_RSSI, // Verwirft Pakete mit RSSI unter 'min' [dBm]
+    RX_RULE_MIN_SNR,  // Verwirft Pakete mit SNR unter 'min' [0.25 dB]
+    RX_RULE_LENGTH,   // Verwirft Pakete außerhalb 'min'..'max' Bytes
+    RX_RULE_MATCH,    // Lässt nur Pakete mit passenden Bytes durch
+    RX_RULE_DENY      // Verwirft Pakete mit passenden Bytes
+};
+
+/**
+ * @brief Eine Filterregel samt eigenem Trefferzähler.
+ */
+struct RxFilterRule {
+    RxFilterKind kind;
+    uint8_t offset;  // Erstes verglichenes Byte (MATCH/DENY)
+    uint8_t length;  // Anzahl verglichener Bytes (MATCH/DENY)
+    int16_t min;
+    int16_t max;
+    uint8_t value[LORA_RX_FILTER_MAX_BYTES]; // Bereits mit 'mask' verknüpft
+    uint8_t mask[LORA_RX_FILTER_MAX_BYTES];
+    uint32_t hits;   // Verworfene (bzw. bei MATCH: durchgelassene) Pakete
+};
+
+/**
+ * @brief Zähler der gesamten Filterkette.
+ */
+struct RxFilterStats {
+    uint32_t passed;    // Durchgelassene Pakete
+    uint32_t rejected;  // Verworfene Pakete (alle Regeln)
+    uint32_t unmatched; // ... davon ohne zutreffende MATCH-Regel
+};
+
+/**
+ * @brief Prüft ein fehlerfrei empfangenes Paket gegen die Regelkette.
+ * @return true, wenn das Paket publiziert werden soll (auch bei abgeschalteter Kette).
+ */
+bool rxFilterAccept(const LoRaRxPacket* packet);
+
+/**
+ * @brief Prüft ein Paket gegen eine eigene Regelkette (z.B. die des Repeaters). Die Trefferzähler
+ *        dieser Regeln werden fortgeschrieben, die Zähler der Empfangsfilterkette nicht.
+ * @return true, wenn keine Regel verwirft (auch bei leerer Kette).
+ */
+bool rxFilterRulesAccept(RxFilterRule* rules, uint8_t count, const LoRaRxPacket* packet);
+
+/**
+ * @brief Ersetzt die gesamte Regelkette und schaltet sie in einem Schritt ein oder aus.
+ *        Die Trefferzähler der neuen Regeln beginnen bei 0.
+ * @return false, wenn 'count' größer als LORA_RX_FILTER_RULES ist (Kette bleibt unverändert).
+ */
+bool setRxFilterRules(const RxFilterRule* rules, uint8_t count, bool enabled);
+
+/**
+ * @brief Hängt eine Regel an das Ende der Kette an.
+ * @return false, wenn die Kette bereits voll ist.
+ */
+bool addRxFilterRule(const RxFilterRule& rule);
+
+void setRxFilterEnabled(bool enabled);
+bool isRxFilterEnabled();
+
+uint8_t getRxFilterRuleCount();
+const RxFilterRule* getRxFilterRule(uint8_t index);
+
+RxFilterStats getRxFilterStats();
+
+/**
+ * @brief Setzt die Zähler der Kette und aller Regeln zurück.
+ */
+void resetRxFilterStats();
+
+#endif // RXFILTER_H
@@ -0,0 +1,151 @@
+#include <Arduino.h>
+
+#include "scheduler.h"
+#include "latency.h"
+
+struct SchedulerTask {
+  const char* name;
+  void (*run)();
+  SchedulerTaskKind kind;
+  bool enabled;
+  volatile bool pending; // Von schedulerNotify() gesetzt, vor der Ausführung gelöscht
+  bool armed;            // Zeitgeber läuft
+  uint32_t period_us;    // 0 = einmalig
+  uint32_t due_us;
+  SchedulerTaskStats stats;
+};
+
+static SchedulerTask tasks[SCHEDULER_TASK_COUNT];
+static SchedulerStats stats = {};
+static uint32_t lastRoundCycles = 0;
+
+void schedulerAddTask(SchedulerTaskId id, const char* name, void (*run)(), SchedulerTaskKind kind, uint32_t period_ms) {
+  SchedulerTask& task = tasks[id];
+  task.name = name;
+  task.run = run;
+  task.kind = kind;
+  task.enabled = true;
+  task.pending = false;
+  task.period_us = period_ms * 1000UL;
+  task.armed = kind != TASK_KIND_POLL && period_ms != 0;
+  task.due_us = micros() + task.period_us;
+  task.stats = {};
+}
+
+void schedulerSetEnabled(SchedulerTaskId id, bool enabled) {
+  tasks[id].enabled = enabled;
+}
+
+void schedulerNotify(SchedulerTaskId id) {
+  tasks[id].pending = true;
+}
+
+void schedulerArm(SchedulerTaskId id, uint32_t delay_ms) {
+  SchedulerTask& task = tasks[id];
+  task.due_us = micros() + delay_ms * 1000UL;
+  task.armed = true;
+}
+
+// Prüft den Zeitgeber und stellt ihn bei Fälligkeit nach
+static bool timerDue(SchedulerTask& task, uint32_t now_us) {
+  if (!task.armed || (int32_t)(now_us - task.due_us) < 0) {
+    return false;
+  }
+  uint32_t late_us = now_us - task.due_us;
+  task.stats.timerRuns++;
+  task.stats.lateness_us += late_us;
+  if (late_us > task.stats.maxLateness_us) {
+    task.stats.maxLateness_us = late_us;
+  }
+
+  if (task.period_us == 0) {
+    task.armed = false;
+  } else if (late_us >= task.period_us) {
+    task.due_us = now_us + task.period_us; // Ausgefallene Perioden nicht nachholen
+  } else {
+    task.due_us += task.period_us;
+  }
+  return true;
+}
+
+static void runTask(SchedulerTask& task) {
+  task.pending = false;
+  uint32_t start = cycleCount();
+  task.run();
+  uint32_t cycles = cycleCount() - start;
+
+  task.stats.runs++;
+  task.stats.cycles += cycles;
+  if (cycles > task.stats.maxCycles) {
+    task.stats.maxCycles = cycles;
+  }
+}
+
+// Führt benachrichtigte Aufgaben mit höherer Priorität als 'below' aus
+static void runPreempting(uint8_t below) {
+  for (uint8_t i = 0; i < below; i++) {
+    SchedulerTask& task = tasks[i];
+    if (task.enabled && task.pending) {
+      stats.preemptions++;
+      runTask(task);
+    }
+  }
+}
+
+void schedulerRun() {
+  uint32_t start = cycleCount();
+  if (stats.rounds != 0) {
+    uint32_t roundCycles = start - lastRoundCycles;
+    stats.roundCycles += roundCycles;
+    if (roundCycles > stats.maxRoundCycles) {
+      stats.maxRoundCycles = roundCycles;
+    }
+  }
+  lastRoundCycles = start;
+  stats.rounds++;
+
+  for (uint8_t i = 0; i < SCHEDULER_TASK_COUNT; i++) {
+    SchedulerTask& task = tasks[i];
+    if (task.run == nullptr || !task.enabled) {
+      continue;
+    }
+    // Der Zeitgeber wird auch bei gesetzter Benachrichtigung nachgestellt
+    bool due = timerDue(task, micros());
+    if (task.kind == TASK_KIND_POLL || task.pending || due) {
+      runPreempting(i);
+      runTask(task);
+    }
+  }
+}
+
+bool schedulerHasPending() {
+  for (uint8_t i = 0; i < SCHEDULER_TASK_COUNT; i++) {
+    if (tasks[i].enabled && tasks[i].pending) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* schedulerTaskName(uint8_t id) {
+  return tasks[id].name != nullptr ? tasks[id].name : "-";
+}
+
+bool isSchedulerTaskEnabled(uint8_t id) {
+  return tasks[id].enabled;
+}
+
+SchedulerTaskStats getSchedulerTaskStats(uint8_t id) {
+  return tasks[id].stats;
+}
+
+SchedulerStats getSchedulerStats() {
+  return stats;
+}
+
+void resetSchedulerStats() {
+  for (uint8_t i = 0; i < SCHEDULER_TASK_COUNT; i++) {
+    tasks[i].stats = {};
+  }
+  stats = {};
+}
@@ -0,0 +1,105 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+//================================================================================
+// Kooperativer Scheduler der Hauptschleife
+//================================================================================
+//
+// Alle Aufgaben stehen in einer festen Tabelle; die Reihenfolge von SchedulerTaskId ist
+// zugleich die Priorität (kleinster Wert zuerst). Ein Durchlauf von schedulerRun() geht die
+// Tabelle einmal durch und führt jede bereite Aufgabe höchstens einmal aus:
+//   TASK_KIND_POLL  - in jedem Durchlauf (fragt selbst Hardware oder Puffer ab)
+//   TASK_KIND_EVENT - nach schedulerNotify(), auch aus einem Interrupt; optional zusätzlich
+//                     periodisch als Rückfallebene
+//   TASK_KIND_TIMER - periodisch oder einmalig nach schedulerArm()
+// Vor jeder Aufgabe werden benachrichtigte Aufgaben höherer Priorität vorgezogen, auch wenn
+// sie in diesem Durchlauf schon liefen. Ein Empfangspaket wartet so höchstens auf das Ende
+// einer einzelnen niedrigeren Aufgabe statt auf den Rest der Schleife.
+//
+// Laufzeiten werden mit dem Zykluszähler gemessen (siehe latency.h), die Verspätung von
+// Zeitgebern gegenüber ihrem Fälligkeitszeitpunkt in Mikrosekunden.
+
+enum SchedulerTaskId : uint8_t {
+    TASK_RX,      // Empfangspuffer leeren (DIO1-Interrupt)
+    TASK_TX,      // Sendewarteschlange und Kanalprüfung
+    TASK_SCAN,    // Kanalscan
+    TASK_BULK,    // Blockübertragung
+    TASK_REPEATER, // Fällige Pakete des Repeaters einreihen
+    TASK_COMMAND, // Befehle von der seriellen Schnittstelle
+    TASK_AFC,     // Automatische Frequenzkorrektur
+    TASK_LED,     // LED-Zustandsmaschine
+    TASK_TIME,    // Zeitbasis über den Überlauf von micros() fortschreiben
+    TASK_LOG,     // Ereignisprotokoll (vor der seriellen Ausgabe)
+    TASK_SERIAL,  // Serielle Ausgabe
+    SCHEDULER_TASK_COUNT
+};
+
+enum SchedulerTaskKind : uint8_t {
+    TASK_KIND_POLL,
+    TASK_KIND_EVENT,
+    TASK_KIND_TIMER
+};
+
+/**
+ * @brief Laufzeitstatistik einer Aufgabe.
+ */
+struct SchedulerTaskStats {
+    uint32_t runs;
+    uint64_t cycles;      // Summe der Laufzeiten
+    uint32_t maxCycles;   // Längste Laufzeit
+    uint32_t timerRuns;   // Ausführungen durch den Zeitgeber
+    uint64_t lateness_us; // Summe der Verspätungen gegenüber der Fälligkeit
+    uint32_t maxLateness_us;
+};
+
+/**
+ * @brief Statistik der Durchläufe.
+ */
+struct SchedulerStats {
+    uint32_t rounds;          // Durchläufe von schedulerRun()
+    uint64_t roundCycles;     // Summe der Abstände zwischen zwei Durchläufen
+    uint32_t maxRoundCycles;  // Längster Abstand (schlechteste Reaktionszeit einer Abfrage)
+    uint32_t preemptions;     // Vorgezogene Ausführungen benachrichtigter Aufgaben
+};
+
+/**
+ * @brief Trägt eine Aufgabe in die Tabelle ein. Sie ist danach aktiv; Zeitgeber laufen ab jetzt.
+ * @param period_ms Periode für TASK_KIND_TIMER und die Rückfallebene von TASK_KIND_EVENT
+ *                  (0 = keine; Zeitgeber dann nur per schedulerArm()).
+ */
+void schedulerAddTask(SchedulerTaskId id, const char* name, void (*run)(), SchedulerTaskKind kind, uint32_t period_ms);
+
+/**
+ * @brief Schaltet eine Aufgabe ein oder aus (z.B. alle Funkaufgaben ohne bereites Modul).
+ */
+void schedulerSetEnabled(SchedulerTaskId id, bool enabled);
+
+/**
+ * @brief Markiert eine Aufgabe als bereit. Darf aus Interrupts aufgerufen werden.
+ */
+void schedulerNotify(SchedulerTaskId id);
+
+/**
+ * @brief Lässt eine Aufgabe einmalig nach 'delay_ms' laufen (ersetzt eine laufende Frist).
+ */
+void schedulerArm(SchedulerTaskId id, uint32_t delay_ms);
+
+/**
+ * @brief Ein Durchlauf über alle Aufgaben. Wird aus loop() aufgerufen.
+ */
+void schedulerRun();
+
+/**
+ * @brief Ob eine aktive Aufgabe benachrichtigt ist und auf ihren Lauf wartet.
+ */
+bool schedulerHasPending();
+
+const char* schedulerTaskName(uint8_t id);
+bool isSchedulerTaskEnabled(uint8_t id);
+SchedulerTaskStats getSchedulerTaskStats(uint8_t id);
+SchedulerStats getSchedulerStats();
+void resetSchedulerStats();
+
+#endif // SCHEDULER_H
@@ -0,0 +1,5 @@
+#include <Arduino.h>
+
+#include "scratch.h"
+
+uint8_t packetScratch[PACKET_SCRATCH_SIZE];
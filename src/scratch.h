@@ -0,0 +1,21 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include <Arduino.h>
+
+//================================================================================
+// Gemeinsamer Arbeitspuffer für die Aufbereitung eines Pakets
+//================================================================================
+//
+// Dekodieren, Komprimieren und Verschlüsseln eines Sendeauftrags sowie Entschlüsseln und Entpacken
+// eines Empfangspakets laufen nacheinander in der Hauptschleife ab. Statt je Schritt einen Puffer von 255 Bytes auf dem Stack anzulegen, wechseln
+// sich die Schritte in den beiden Hälften dieses Puffers ab: Eingabe in der einen, Ausgabe in der
+// anderen Hälfte. Wer den Puffer nutzt, darf bis zum Ende der Aufbereitung nichts aufrufen, das ihn
+// ebenfalls nutzt; aus Interrupts wird er nie verwendet.
+
+#define PACKET_SCRATCH_HALF 255
+#define PACKET_SCRATCH_SIZE (2 * PACKET_SCRATCH_HALF)
+
+extern uint8_t packetScratch[PACKET_SCRATCH_SIZE];
+
+#endif // SCRATCH_H
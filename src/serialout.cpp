@@ -0,0 +1,146 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "serialout.h"
+#include "latency.h"
+
+static_assert((SERIAL_OUT_BUFFER_SIZE & (SERIAL_OUT_BUFFER_SIZE - 1)) == 0, "SERIAL_OUT_BUFFER_SIZE muss eine Zweierpotenz sein");
+
+SerialOutput serialOut;
+
+static uint8_t outBuffer[SERIAL_OUT_BUFFER_SIZE];
+
+// 'outTail' = nächstes zu sendendes Byte, 'outCommitted' = Ende des letzten vollständigen
+// Datensatzes, 'outHead' = Schreibposition des aktuellen Datensatzes. Alle Indizes laufen frei.
+static uint16_t outTail = 0;
+static uint16_t outCommitted = 0;
+static uint16_t outHead = 0;
+
+static bool recordOpen = false;
+static bool recordOverflow = false;
+
+static uint32_t currentBaudRate = SERIAL_BAUD_DEFAULT;
+static SerialOutputStats outStats = {0, 0, 0, 0};
+
+static const uint32_t SUPPORTED_BAUD_RATES[] = {9600, 57600, 115200, 230400, 460800, 921600};
+
+void SerialOutput::beginRecord() {
+  outHead = outCommitted;
+  recordOpen = true;
+  recordOverflow = false;
+}
+
+void SerialOutput::endRecord() {
+  if (recordOverflow) {
+    outHead = outCommitted; // Unvollständigen Datensatz zurücknehmen
+    outStats.droppedRecords++;
+  } else {
+    outCommitted = outHead;
+    outStats.records++;
+
+    uint16_t level = outCommitted - outTail;
+    if (level > outStats.highWater) {
+      outStats.highWater = level;
+    }
+  }
+  recordOpen = false;
+}
+
+size_t SerialOutput::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t SerialOutput::write(const uint8_t* buffer, size_t size) {
+  // Schreiben außerhalb eines Datensatzes (z.B. Echo) bildet einen eigenen Datensatz
+  bool implicitRecord = !recordOpen;
+  if (implicitRecord) {
+    beginRecord();
+  }
+
+  if (!recordOverflow) {
+    if ((uint16_t)(outHead - outTail) + size > SERIAL_OUT_BUFFER_SIZE) {
+      recordOverflow = true;
+    } else {
+      for (size_t i = 0; i < size; i++) {
+        outBuffer[outHead & (SERIAL_OUT_BUFFER_SIZE - 1)] = buffer[i];
+        outHead++;
+      }
+    }
+  }
+
+  if (implicitRecord) {
+    endRecord();
+  }
+  return size;
+}
+
+size_t SerialOutput::freeSpace() const {
+  return SERIAL_OUT_BUFFER_SIZE - (uint16_t)(outHead - outTail);
+}
+
+size_t SerialOutput::pending() const {
+  return (uint16_t)(outCommitted - outTail);
+}
+
+uint16_t SerialOutput::committedPosition() const {
+  return outCommitted;
+}
+
+void setupSerialOutput() {
+  Serial.begin(currentBaudRate);
+}
+
+void handleSerialOutput() {
+  while (outCommitted != outTail) {
+    int space = Serial.availableForWrite();
+    if (space <= 0) {
+      return; // UART-Sendepuffer voll, der TX-Interrupt leert ihn im Hintergrund
+    }
+
+    // Nur den zusammenhängenden Teil bis zum Pufferende auf einmal übergeben
+    uint16_t start = outTail & (SERIAL_OUT_BUFFER_SIZE - 1);
+    uint16_t count = outCommitted - outTail;
+    if (count > SERIAL_OUT_BUFFER_SIZE - start) {
+      count = SERIAL_OUT_BUFFER_SIZE - start;
+    }
+    if (count > (uint16_t)space) {
+      count = space;
+    }
+
+    Serial.write(&outBuffer[start], count);
+    outTail += count;
+    outStats.bytesWritten += count;
+    latencyOnSerialDrained(outTail);
+  }
+}
+
+void flushSerialOutput() {
+  while (outCommitted != outTail) {
+    handleSerialOutput();
+  }
+  Serial.flush();
+}
+
+bool isSupportedBaudRate(uint32_t baud) {
+  for (uint32_t supported : SUPPORTED_BAUD_RATES) {
+    if (supported == baud) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void setSerialBaudRate(uint32_t baud) {
+  flushSerialOutput();
+  Serial.end();
+  currentBaudRate = baud;
+  Serial.begin(currentBaudRate);
+}
+
+uint32_t getSerialBaudRate() {
+  return currentBaudRate;
+}
+
+SerialOutputStats getSerialOutputStats() {
+  return outStats;
+}
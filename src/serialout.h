@@ -0,0 +1,92 @@
+#ifndef SERIALOUT_H
+#define SERIALOUT_H
+
+#include <Arduino.h>
+
+//================================================================================
+// Gepufferte serielle Ausgabe
+//================================================================================
+
+/**
+ * @brief Zähler der gepufferten Ausgabe.
+ */
+struct SerialOutputStats {
+    uint32_t records;        // Vollständig eingereihte Datensätze
+    uint32_t droppedRecords; // Verworfene Datensätze, weil der Puffer voll war
+    uint32_t bytesWritten;   // An den UART übergebene Bytes
+    uint16_t highWater;      // Höchster beobachteter Füllstand in Bytes
+};
+
+/**
+ * @brief Ausgabeziel für alle Datensätze an den Host. Schreibt in einen Ringpuffer,
+ *        der in handleSerialOutput() nur so weit geleert wird, wie der UART-Sendepuffer
+ *        Platz hat. Die Hauptschleife blockiert dadurch nie auf der seriellen Schnittstelle.
+ *
+ *        Jeder Datensatz (eine JSON-Zeile oder ein Binärrahmen) wird zwischen beginRecord()
+ *        und endRecord() geschrieben. Passt er nicht vollständig in den Puffer, wird er
+ *        komplett verworfen, sodass der Host nie halbe Zeilen sieht.
+ */
+class SerialOutput : public Print {
+public:
+    void beginRecord();
+    void endRecord();
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    /**
+     * @brief Freier Platz im Puffer in Bytes (für Gegendruck in den Erzeugern).
+     */
+    size_t freeSpace() const;
+
+    /**
+     * @brief Anzahl der noch nicht an den UART übergebenen Bytes.
+     */
+    size_t pending() const;
+
+    /**
+     * @brief Freilaufende Pufferposition hinter dem zuletzt abgeschlossenen Datensatz.
+     */
+    uint16_t committedPosition() const;
+};
+
+extern SerialOutput serialOut;
+
+/**
+ * @brief Initialisiert den UART mit der Standard-Baudrate.
+ */
+void setupSerialOutput();
+
+/**
+ * @brief Übergibt so viele gepufferte Bytes an den UART, wie dessen Sendepuffer aufnehmen kann.
+ *        Muss regelmäßig in der Hauptschleife aufgerufen werden.
+ */
+void handleSerialOutput();
+
+/**
+ * @brief Leert den Ausgabepuffer und den UART blockierend (z.B. vor Reset oder Baudratenwechsel).
+ */
+void flushSerialOutput();
+
+/**
+ * @brief Prüft, ob eine Baudrate unterstützt wird.
+ */
+bool isSupportedBaudRate(uint32_t baud);
+
+/**
+ * @brief Leert alle Puffer und stellt den UART auf die neue Baudrate um.
+ */
+void setSerialBaudRate(uint32_t baud);
+
+/**
+ * @brief Aktuell eingestellte Baudrate.
+ */
+uint32_t getSerialBaudRate();
+
+/**
+ * @brief Gibt eine Kopie der Ausgabestatistik zurück.
+ */
+SerialOutputStats getSerialOutputStats();
+
+#endif // SERIALOUT_H
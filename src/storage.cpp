@@ -0,0 +1,186 @@
+#include <Arduino.h>
+
+#include "0_config.h"
+#include "storage.h"
+#include "presets.h"
+#include "codec.h"
+#include "crypto.h"
+#include "afc.h"
+
+static const uint16_t RECORD_MAGIC = 0x4C43;   // "CL"
+static const uint16_t ERASED_HALFWORD = 0xFFFF;
+static const uint8_t STORED_CONFIG_VERSION = 2;
+
+// Erste Adresse des reservierten Bereichs am Ende des Flashs
+static const uint32_t STORE_START = FLASH_BANK1_END + 1 - CONFIG_STORE_PAGES * FLASH_PAGE_SIZE;
+
+struct RecordHeader {
+  uint16_t magic;
+  uint16_t sequence;
+  uint16_t length;   // Nutzdatenlänge ohne Kopf
+  uint16_t crc;      // CRC16 über Folgenummer und Nutzdaten
+};
+
+// Inhalt eines Datensatzes
+struct StoredConfig {
+  uint8_t version;
+  uint8_t userPresetMask;
+  LoRaSettings lora;
+  LoRaSettings userPresets[LORA_USER_PRESET_SLOTS];
+  CryptoConfig crypto;  // Ab Version 2
+};
+
+// Datensätze der Version 1 enden vor dem Abschnitt der Verschlüsselung
+static const uint16_t STORED_CONFIG_V1_SIZE = offsetof(StoredConfig, crypto);
+
+static const uint16_t RECORD_SIZE = (sizeof(RecordHeader) + sizeof(StoredConfig) + 1) & ~1U;
+static_assert(RECORD_SIZE <= FLASH_PAGE_SIZE, "Konfigurationsdatensatz passt nicht in eine Flash-Seite");
+
+// Ergebnis eines Durchlaufs über alle Seiten
+struct StoreScan {
+  bool found;            // Gültiger Datensatz vorhanden
+  uint8_t newestPage;    // Seite des neuesten Datensatzes
+  uint32_t newestAddress;
+  uint16_t newestSequence;
+  uint16_t newestLength;   // Nutzdatenlänge (ältere Versionen sind kürzer)
+  uint32_t freeOffset[CONFIG_STORE_PAGES]; // Erste freie Position je Seite (Seitengröße = voll)
+};
+
+static inline const uint8_t* flashPointer(uint32_t address) {
+#ifdef NATIVE_BUILD
+  return simFlashPointer(address);
+#else
+  return (const uint8_t*)(uintptr_t)address;
+#endif
+}
+
+static uint32_t pageAddress(uint8_t page) {
+  return STORE_START + (uint32_t)page * FLASH_PAGE_SIZE;
+}
+
+static uint16_t recordCrc(uint16_t sequence, const uint8_t* payload, uint16_t length) {
+  uint8_t seq[2] = {(uint8_t)sequence, (uint8_t)(sequence >> 8)};
+  return crc16_ccitt(payload, length, crc16_ccitt(seq, sizeof(seq)));
+}
+
+static void scanStore(StoreScan& scan) {
+  scan.found = false;
+
+  for (uint8_t page = 0; page < CONFIG_STORE_PAGES; page++) {
+    uint32_t offset = 0;
+    scan.freeOffset[page] = FLASH_PAGE_SIZE;
+
+    while (offset + sizeof(RecordHeader) <= FLASH_PAGE_SIZE) {
+      uint32_t address = pageAddress(page) + offset;
+      RecordHeader header;
+      memcpy(&header, flashPointer(address), sizeof(header));
+
+      if (header.magic == ERASED_HALFWORD) {
+        scan.freeOffset[page] = offset; // Rest der Seite ist gelöscht
+        break;
+      }
+      uint32_t recordLen = (sizeof(RecordHeader) + header.length + 1) & ~1U;
+      if (header.magic != RECORD_MAGIC || offset + recordLen > FLASH_PAGE_SIZE) {
+        break; // Unlesbarer Rest, Seite gilt als voll
+      }
+
+      const uint8_t* payload = flashPointer(address + sizeof(RecordHeader));
+      bool valid = ((header.length == sizeof(StoredConfig) && payload[0] == STORED_CONFIG_VERSION) ||
+                    (header.length == STORED_CONFIG_V1_SIZE && payload[0] == 1)) &&
+                   recordCrc(header.sequence, payload, header.length) == header.crc;
+      if (valid && (!scan.found || (int16_t)(header.sequence - scan.newestSequence) > 0)) {
+        scan.found = true;
+        scan.newestPage = page;
+        scan.newestAddress = address;
+        scan.newestSequence = header.sequence;
+        scan.newestLength = header.length;
+      }
+      offset += recordLen;
+    }
+  }
+}
+
+static bool erasePage(uint8_t page) {
+  FLASH_EraseInitTypeDef erase = {};
+  erase.TypeErase   = FLASH_TYPEERASE_PAGES;
+  erase.PageAddress = pageAddress(page);
+  erase.NbPages     = 1;
+  uint32_t pageError = 0;
+  return HAL_FLASHEx_Erase(&erase, &pageError) == HAL_OK;
+}
+
+// Schreibt einen Datensatz halbwortweise; der Kopf mit der Kennung kommt zuerst
+static bool writeRecord(uint32_t address, uint16_t sequence, const StoredConfig& config) {
+  uint8_t record[RECORD_SIZE];
+  memset(record, 0xFF, sizeof(record));
+
+  RecordHeader header;
+  header.magic    = RECORD_MAGIC;
+  header.sequence = sequence;
+  header.length   = sizeof(StoredConfig);
+  header.crc      = recordCrc(sequence, (const uint8_t*)&config, sizeof(StoredConfig));
+  memcpy(record, &header, sizeof(header));
+  memcpy(record + sizeof(header), &config, sizeof(config));
+
+  for (uint16_t i = 0; i < RECORD_SIZE; i += 2) {
+    uint16_t halfword = record[i] | (uint16_t)record[i + 1] << 8;
+    if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, address + i, halfword) != HAL_OK) {
+      return false;
+    }
+  }
+  return memcmp(flashPointer(address), record, RECORD_SIZE) == 0;
+}
+
+bool loadStoredConfig(LoRaSettings& settings) {
+  StoreScan scan;
+  scanStore(scan);
+  if (!scan.found) {
+    return false;
+  }
+
+  // Ältere Datensätze sind kürzer, fehlende Abschnitte bleiben 0
+  StoredConfig config;
+  memset(&config, 0, sizeof(config));
+  memcpy(&config, flashPointer(scan.newestAddress + sizeof(RecordHeader)), scan.newestLength);
+  settings = config.lora;
+  importLoRaUserPresets(config.userPresets, config.userPresetMask);
+  importCryptoConfig(config.crypto);
+  return true;
+}
+
+bool saveStoredConfig() {
+  StoredConfig config;
+  memset(&config, 0, sizeof(config)); // Füllbytes festlegen, damit der Vergleich stabil ist
+  config.version = STORED_CONFIG_VERSION;
+  config.lora = getCurrentLoRaSettings();
+  config.lora.frequency_offset_kHz = getAfcReferenceOffset(); // Ohne die laufende AFC-Korrektur
+  config.userPresetMask = exportLoRaUserPresets(config.userPresets);
+  exportCryptoConfig(config.crypto);
+
+  StoreScan scan;
+  scanStore(scan);
+
+  // Unveränderten Stand nicht erneut schreiben (schont den Flash)
+  if (scan.found && scan.newestLength == sizeof(config) && memcmp(flashPointer(scan.newestAddress + sizeof(RecordHeader)), &config, sizeof(config)) == 0) {
+    return true;
+  }
+
+  uint16_t sequence = scan.found ? scan.newestSequence + 1 : 0;
+  uint8_t page = scan.found ? scan.newestPage : 0;
+
+  HAL_FLASH_Unlock();
+  bool written = false;
+  if (scan.freeOffset[page] + RECORD_SIZE <= FLASH_PAGE_SIZE) {
+    written = writeRecord(pageAddress(page) + scan.freeOffset[page], sequence, config);
+  }
+  if (!written) {
+    // Seite voll oder Schreibfehler: die nächste (älteste) Seite löschen und dort neu
+    // beginnen. Der bisher neueste Datensatz bleibt in seiner Seite erhalten.
+    page = (page + 1) % CONFIG_STORE_PAGES;
+    if (erasePage(page)) {
+      written = writeRecord(pageAddress(page), sequence, config);
+    }
+  }
+  HAL_FLASH_Lock();
+  return written;
+}
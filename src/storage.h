@@ -0,0 +1,31 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <Arduino.h>
+#include "lora.h"
+
+//================================================================================
+// Dauerhafte Konfiguration im Flash
+//================================================================================
+// Die letzten CONFIG_STORE_PAGES Flash-Seiten bilden ein Protokoll aus Datensätzen mit
+// Folgenummer und CRC16. Neue Stände werden angehängt statt überschrieben; erst wenn
+// eine Seite voll ist, wird die jeweils andere gelöscht (Verschleißausgleich). Ein beim
+// Schreiben unterbrochener Datensatz fällt durch die CRC-Prüfung, der vorherige bleibt gültig.
+
+/**
+ * @brief Sucht den neuesten gültigen Datensatz und stellt daraus die Funkparameter, die
+ *        Benutzerprofile und den gespeicherten Teil der Verschlüsselung wieder her.
+ * @param settings Erhält die gespeicherten Funkparameter (nur bei Erfolg verändert).
+ * @return true, wenn ein gültiger Datensatz gefunden wurde.
+ */
+bool loadStoredConfig(LoRaSettings& settings);
+
+/**
+ * @brief Speichert die aktuellen Funkparameter, Benutzerprofile und Verschlüsselungsdaten
+ *        (Knotennummer, Zählervorrat, Schlüssel nur auf Wunsch). Entspricht der Stand
+ *        bereits dem neuesten Datensatz, wird nichts geschrieben.
+ * @return true, wenn der Stand danach im Flash liegt (geschrieben oder unverändert).
+ */
+bool saveStoredConfig();
+
+#endif // STORAGE_H
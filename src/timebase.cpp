@@ -0,0 +1,52 @@
+#include <Arduino.h>
+
+#include "timebase.h"
+#include "latency.h"
+
+static uint32_t lastLow = 0;
+static uint32_t high = 0;
+static TimebaseSync sync = {};
+
+uint64_t timebaseMicros() {
+  uint32_t now = micros();
+  if (now < lastLow) {
+    high++;
+  }
+  lastLow = now;
+  return ((uint64_t)high << 32) | now;
+}
+
+uint64_t timebaseExtend(uint32_t micros32) {
+  uint64_t now = timebaseMicros();
+  return now - (uint32_t)((uint32_t)now - micros32);
+}
+
+uint64_t timebaseCommandMicros() {
+  uint64_t now = timebaseMicros();
+  uint32_t start = latencyCommandStart();
+  if (start == 0) {
+    return now;
+  }
+  // Der Zykluszähler läuft schneller über als micros(), reicht aber für die Dauer eines Befehls
+  return now - (cycleCount() - start) / (SystemCoreClock / 1000000UL);
+}
+
+void timebaseSync(uint64_t host_us, uint64_t device_us) {
+  if (sync.count > 0 && device_us > sync.device_us && host_us > sync.host_us) {
+    int64_t hostElapsed = (int64_t)(host_us - sync.host_us);
+    int64_t deviceElapsed = (int64_t)(device_us - sync.device_us);
+    sync.drift_ppm = (float)(deviceElapsed - hostElapsed) * 1e6f / (float)hostElapsed;
+    sync.driftValid = true;
+  }
+  sync.count++;
+  sync.device_us = device_us;
+  sync.host_us = host_us;
+}
+
+TimebaseSync getTimebaseSync() {
+  return sync;
+}
+
+void handleTimebase() {
+  timebaseMicros();
+}
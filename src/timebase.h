@@ -0,0 +1,57 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <Arduino.h>
+
+//================================================================================
+// Freilaufende Zeitbasis in Mikrosekunden
+//================================================================================
+//
+// micros() läuft nach gut 71 Minuten über. Die Zeitbasis erweitert es auf 64 Bit und ist damit
+// ab dem Reset eindeutig; sie ist die Gerätezeit in 'lora_rx', 'lora_tx_done', 'sync' und im
+// Sendezeitpunkt 'at_us' von 'sendlora'. Interrupts erfassen nur micros() (32 Bit); die
+// Hauptschleife rechnet den Wert mit timebaseExtend() um, solange er jünger als ein Überlauf ist.
+// Der Host bildet die Gerätezeit mit dem 'sync'-Befehl auf seine Uhr ab.
+
+/**
+ * @brief Abgleich zwischen Gerätezeit und Host-Uhr.
+ */
+struct TimebaseSync {
+    uint32_t count;      // Bisherige Abgleiche
+    uint64_t device_us;  // Gerätezeit beim letzten Abgleich (Ende der Befehlszeile)
+    uint64_t host_us;    // Vom Host übergebene Zeit dazu
+    float drift_ppm;     // Gang der Geräteuhr gegenüber dem Host zwischen den letzten beiden Abgleichen
+    bool driftValid;     // Mindestens zwei Abgleiche
+};
+
+/**
+ * @brief Aktuelle Gerätezeit. Nur aus der Hauptschleife aufrufen, mindestens einmal je
+ *        Überlauf von micros() (siehe TASK_TIME).
+ */
+uint64_t timebaseMicros();
+
+/**
+ * @brief Rechnet einen in einem Interrupt erfassten micros()-Wert in die Gerätezeit um.
+ */
+uint64_t timebaseExtend(uint32_t micros32);
+
+/**
+ * @brief Gerätezeit am Ende der gerade verarbeiteten Befehlszeile (siehe latencyMarkCommandStart()),
+ *        ohne markierten Befehl die aktuelle Zeit.
+ */
+uint64_t timebaseCommandMicros();
+
+/**
+ * @brief Merkt sich einen Abgleich und schätzt den Gang gegenüber dem vorherigen.
+ * @param host_us   Host-Uhr beim Absenden des Befehls.
+ * @param device_us Gerätezeit beim Empfang (timebaseCommandMicros()).
+ */
+void timebaseSync(uint64_t host_us, uint64_t device_us);
+TimebaseSync getTimebaseSync();
+
+/**
+ * @brief Läuft als Zeitgeber-Aufgabe und schreibt die Zeitbasis fort.
+ */
+void handleTimebase();
+
+#endif // TIMEBASE_H
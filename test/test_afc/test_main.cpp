@@ -0,0 +1,136 @@
+// Frequenzkorrektur: Ausreißer gehen nicht in die Schätzung ein, eine Folge von Ausreißern
+// startet sie neu, und die Korrektur bleibt je Schritt und insgesamt begrenzt (siehe afc.h).
+// Gespeichert wird der Ausgangswert, nicht der korrigierte Offset.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <string.h>
+
+#include "SimCore.h"
+#include "0_config.h"
+#include "afc.h"
+#include "lora.h"
+#include "storage.h"
+
+void setup();
+void loop();
+
+static void feed(float frequencyError_Hz) {
+  LoRaRxPacket packet;
+  memset(&packet, 0, sizeof(packet));
+  packet.len = 8;
+  packet.rssi = -90;
+  packet.snr = 5.0f;
+  packet.frequencyError = frequencyError_Hz;
+  packet.timestamp_ms = millis();
+  afcHandlePacket(&packet);
+  simAdvance(1000);
+}
+
+static void enableAfc() {
+  AfcSettings s = getAfcSettings();
+  s.enabled = true;
+  s.perSender = false;
+  setAfcSettings(s);
+  resetAfc();
+  simAdvance(1000);
+}
+
+void setUp() {
+  enableAfc();
+}
+
+void tearDown() {
+  AfcSettings s = getAfcSettings();
+  s.enabled = false;
+  setAfcSettings(s);
+}
+
+void test_outliers_are_rejected_and_a_run_restarts() {
+  const float samples[] = {1000, 1060, 950, 1020, 980, 1010, 990};
+  for (float x : samples) {
+    feed(x);
+  }
+  feed(20000); // Einzelner Ausreißer
+  feed(1005);
+
+  AfcStats stats = getAfcStats();
+  TEST_ASSERT_TRUE(stats.valid);
+  TEST_ASSERT_EQUAL(1, stats.outliers);
+  TEST_ASSERT_EQUAL(0, stats.restarts);
+  TEST_ASSERT_INT_WITHIN(50, 1000, stats.estimate_Hz);
+
+  // Bleibt der Fehler dauerhaft woanders, ist er wirklich gesprungen
+  for (uint8_t i = 0; i < LORA_AFC_OUTLIER_RUN; i++) {
+    feed(6000);
+  }
+  stats = getAfcStats();
+  TEST_ASSERT_EQUAL(1 + LORA_AFC_OUTLIER_RUN, stats.outliers);
+  TEST_ASSERT_EQUAL(1, stats.restarts);
+  TEST_ASSERT_FALSE(stats.valid); // Neue Schätzung noch in der Anlaufphase
+  for (uint8_t i = 0; i < LORA_AFC_MIN_SAMPLES; i++) {
+    feed(6000);
+  }
+  TEST_ASSERT_INT_WITHIN(1, 6000, getAfcStats().estimate_Hz);
+}
+
+void test_correction_is_limited_per_step_and_in_total() {
+  // Der Sender liegt weit außerhalb der erlaubten Gesamtkorrektur
+  const float trueError_Hz = LORA_AFC_MAX_CORRECTION_KHZ * 1000.0f + 8000.0f;
+  float reference_kHz = getCurrentLoRaSettings().frequency_offset_kHz;
+  TEST_ASSERT_EQUAL_FLOAT(reference_kHz, getAfcStats().reference_kHz);
+
+  for (uint8_t round = 0; round < 20; round++) {
+    float before_kHz = getCurrentLoRaSettings().frequency_offset_kHz;
+    // Gemessen wird der Restfehler nach der bisherigen Korrektur
+    float residual_Hz = trueError_Hz - LORA_AFC_ERROR_SIGN * (before_kHz - reference_kHz) * 1000.0f;
+    for (uint8_t i = 0; i < LORA_AFC_MIN_SAMPLES; i++) {
+      feed(residual_Hz);
+    }
+    handleAfc();
+    float step_Hz = (getCurrentLoRaSettings().frequency_offset_kHz - before_kHz) * 1000.0f;
+    TEST_ASSERT_LESS_OR_EQUAL(LORA_AFC_MAX_STEP_HZ + 1, (int32_t)fabsf(step_Hz));
+    simAdvance((uint64_t)LORA_AFC_MIN_INTERVAL_MS * 1000);
+  }
+
+  AfcStats stats = getAfcStats();
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, reference_kHz + LORA_AFC_ERROR_SIGN * LORA_AFC_MAX_CORRECTION_KHZ,
+                           getCurrentLoRaSettings().frequency_offset_kHz);
+  TEST_ASSERT_EQUAL(LORA_AFC_MAX_CORRECTION_KHZ * 1000 / LORA_AFC_MAX_STEP_HZ, stats.adjustments);
+  TEST_ASSERT_GREATER_THAN(0, stats.limited);
+  TEST_ASSERT_EQUAL(LORA_AFC_MAX_STEP_HZ, getAfcHistory(1).step_Hz);
+}
+
+void test_saved_offset_excludes_correction() {
+  float reference_kHz = getCurrentLoRaSettings().frequency_offset_kHz;
+  for (uint8_t i = 0; i < LORA_AFC_MIN_SAMPLES; i++) {
+    feed(5000);
+  }
+  handleAfc();
+  TEST_ASSERT_EQUAL(1, getAfcStats().adjustments);
+  TEST_ASSERT_NOT_EQUAL(reference_kHz, getCurrentLoRaSettings().frequency_offset_kHz);
+
+  TEST_ASSERT_TRUE(saveStoredConfig());
+  LoRaSettings stored;
+  TEST_ASSERT_TRUE(loadStoredConfig(stored));
+  TEST_ASSERT_EQUAL_FLOAT(reference_kHz, stored.frequency_offset_kHz);
+
+  // Von Hand geänderter Offset wird so gespeichert, wie er eingestellt ist
+  LoRaSettings manual = getCurrentLoRaSettings();
+  manual.frequency_offset_kHz = reference_kHz + 1.5f;
+  TEST_ASSERT_FALSE(applyLoRaSettings(manual).startsWith("ERROR"));
+  TEST_ASSERT_TRUE(saveStoredConfig());
+  TEST_ASSERT_TRUE(loadStoredConfig(stored));
+  TEST_ASSERT_EQUAL_FLOAT(reference_kHz + 1.5f, stored.frequency_offset_kHz);
+}
+
+int main(int argc, char** argv) {
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_outliers_are_rejected_and_a_run_restarts);
+  RUN_TEST(test_correction_is_limited_per_step_and_in_total);
+  RUN_TEST(test_saved_offset_excludes_correction);
+  return UNITY_END();
+}
@@ -0,0 +1,296 @@
+// Base64: Durchsatz und Heap-Nutzung des tabellengesteuerten Codecs (codec.cpp)
+// gegen den früheren Wrapper um agdl/Base64 (VLA auf dem Stack, Ergebnis als String).
+
+#include <Arduino.h>
+#include <unity.h>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "codec.h"
+
+static const int BENCH_ROUNDS = 20000;
+static const size_t PAYLOAD_SIZE = 255; // Größtes LoRa-Paket
+
+// Zählt alle Allokationen, solange 'countAllocations' gesetzt ist
+static bool countAllocations = false;
+static uint32_t allocations = 0;
+
+void* operator new(size_t size) {
+  if (countAllocations) {
+    allocations++;
+  }
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// Ausgabesenke, die wie die serielle Ausgabe nur Bytes entgegennimmt
+class BufferSink : public Print {
+public:
+  size_t write(uint8_t c) override {
+    if (len < sizeof(data)) {
+      data[len++] = c;
+    }
+    return 1;
+  }
+  size_t write(const uint8_t* buffer, size_t size) override {
+    size_t n = (size <= sizeof(data) - len) ? size : sizeof(data) - len;
+    memcpy(data + len, buffer, n);
+    len += n;
+    return size;
+  }
+  char data[512];
+  size_t len = 0;
+};
+
+// --- Nachbildung von agdl/Base64 und des früheren Wrappers in codec.cpp ---
+
+static const char legacyAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static unsigned char legacyLookup(char c) {
+  if (c >= 'A' && c <= 'Z') return c - 'A';
+  if (c >= 'a' && c <= 'z') return c - 71;
+  if (c >= '0' && c <= '9') return c + 4;
+  if (c == '+') return 62;
+  if (c == '/') return 63;
+  return -1;
+}
+
+static int legacyEncodedLength(int plainLen) {
+  return (plainLen + 2 - ((plainLen + 2) % 3)) / 3 * 4;
+}
+
+static int legacyDecodedLength(const char* input, int inputLen) {
+  int numEq = 0;
+  for (int i = inputLen - 1; i >= 0 && input[i] == '='; i--) {
+    numEq++;
+  }
+  return ((6 * inputLen) / 8) - numEq;
+}
+
+static int legacyEncode(char* output, const char* input, int inputLen) {
+  int i = 0, j = 0, encLen = 0;
+  unsigned char a3[3];
+  unsigned char a4[4];
+
+  while (inputLen--) {
+    a3[i++] = *(input++);
+    if (i == 3) {
+      a4[0] = (a3[0] & 0xfc) >> 2;
+      a4[1] = ((a3[0] & 0x03) << 4) + ((a3[1] & 0xf0) >> 4);
+      a4[2] = ((a3[1] & 0x0f) << 2) + ((a3[2] & 0xc0) >> 6);
+      a4[3] = (a3[2] & 0x3f);
+      for (i = 0; i < 4; i++) {
+        output[encLen++] = legacyAlphabet[a4[i]];
+      }
+      i = 0;
+    }
+  }
+  if (i) {
+    for (j = i; j < 3; j++) {
+      a3[j] = '\0';
+    }
+    a4[0] = (a3[0] & 0xfc) >> 2;
+    a4[1] = ((a3[0] & 0x03) << 4) + ((a3[1] & 0xf0) >> 4);
+    a4[2] = ((a3[1] & 0x0f) << 2) + ((a3[2] & 0xc0) >> 6);
+    for (j = 0; j < i + 1; j++) {
+      output[encLen++] = legacyAlphabet[a4[j]];
+    }
+    while (i++ < 3) {
+      output[encLen++] = '=';
+    }
+  }
+  output[encLen] = '\0';
+  return encLen;
+}
+
+static int legacyDecode(char* output, char* input, int inputLen) {
+  int i = 0, j = 0, decLen = 0;
+  unsigned char a3[3];
+  unsigned char a4[4];
+
+  while (inputLen--) {
+    if (*input == '=') {
+      break;
+    }
+    a4[i++] = *(input++);
+    if (i == 4) {
+      for (i = 0; i < 4; i++) {
+        a4[i] = legacyLookup(a4[i]);
+      }
+      a3[0] = (a4[0] << 2) + ((a4[1] & 0x30) >> 4);
+      a3[1] = ((a4[1] & 0xf) << 4) + ((a4[2] & 0x3c) >> 2);
+      a3[2] = ((a4[2] & 0x3) << 6) + a4[3];
+      for (i = 0; i < 3; i++) {
+        output[decLen++] = a3[i];
+      }
+      i = 0;
+    }
+  }
+  if (i) {
+    for (j = i; j < 4; j++) {
+      a4[j] = '\0';
+    }
+    for (j = 0; j < 4; j++) {
+      a4[j] = legacyLookup(a4[j]);
+    }
+    a3[0] = (a4[0] << 2) + ((a4[1] & 0x30) >> 4);
+    a3[1] = ((a4[1] & 0xf) << 4) + ((a4[2] & 0x3c) >> 2);
+    for (j = 0; j < i - 1; j++) {
+      output[decLen++] = a3[j];
+    }
+  }
+  output[decLen] = '\0';
+  return decLen;
+}
+
+static void legacyBase64Encode(const uint8_t* data, size_t len, String& output) {
+  int encodedLen = legacyEncodedLength(len);
+  char encodedChars[encodedLen + 1];
+  legacyEncode(encodedChars, (const char*)data, len);
+  encodedChars[encodedLen] = '\0';
+  output = String(encodedChars);
+}
+
+static void legacyBase64Decode(const String& input, uint8_t* output, size_t& outputLen) {
+  size_t inputLength = input.length();
+  char mutableInputChars[inputLength + 1];
+  memcpy(mutableInputChars, input.c_str(), inputLength + 1);
+  int decodedLen = legacyDecodedLength(mutableInputChars, inputLength);
+  // Der alte Dekoder schreibt ein abschließendes Null-Byte hinter die Daten
+  char decoded[PAYLOAD_SIZE + 1];
+  legacyDecode(decoded, mutableInputChars, inputLength);
+  memcpy(output, decoded, decodedLen);
+  outputLen = decodedLen;
+}
+
+// --- Messungen ---
+
+static uint8_t payload[PAYLOAD_SIZE];
+
+static double megabytesPerSecond(size_t bytes, uint64_t ns) {
+  return ns ? (double)bytes * 1000.0 / (double)ns : 0.0;
+}
+
+static void report(const char* what, uint64_t ns, uint32_t allocs) {
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%s: %.1f MB/s, %u Allokationen pro Aufruf", what,
+           megabytesPerSecond((size_t)BENCH_ROUNDS * PAYLOAD_SIZE, ns), (unsigned)(allocs / BENCH_ROUNDS));
+  TEST_MESSAGE(msg);
+}
+
+void setUp() {
+  for (size_t i = 0; i < PAYLOAD_SIZE; i++) {
+    payload[i] = (uint8_t)(i * 167 + 13);
+  }
+}
+
+void tearDown() {}
+
+void test_encoder_matches_legacy_and_does_not_allocate() {
+  BufferSink sink;
+  String legacy;
+  uint64_t ns = 0;
+  uint64_t legacyNs = 0;
+  uint32_t allocs = 0;
+  uint32_t legacyAllocs = 0;
+
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    sink.len = 0;
+    allocations = 0;
+    countAllocations = true;
+    auto start = std::chrono::steady_clock::now();
+    base64_encode(payload, PAYLOAD_SIZE, sink);
+    ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    allocs += allocations;
+
+    allocations = 0;
+    start = std::chrono::steady_clock::now();
+    legacyBase64Encode(payload, PAYLOAD_SIZE, legacy);
+    legacyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    countAllocations = false;
+    legacyAllocs += allocations;
+  }
+
+  report("Kodieren, Tabelle + Senke", ns, allocs);
+  report("Kodieren, agdl-Wrapper", legacyNs, legacyAllocs);
+  TEST_ASSERT_EQUAL(legacy.length(), sink.len);
+  TEST_ASSERT_EQUAL_MEMORY(legacy.c_str(), sink.data, sink.len);
+  TEST_ASSERT_EQUAL(0, allocs);
+  TEST_ASSERT_GREATER_THAN(0, legacyAllocs);
+}
+
+void test_decoder_matches_legacy_and_does_not_allocate() {
+  BufferSink sink;
+  base64_encode(payload, PAYLOAD_SIZE, sink);
+  String encoded(std::string(sink.data, sink.len).c_str());
+
+  uint8_t decoded[PAYLOAD_SIZE];
+  uint8_t legacyDecoded[PAYLOAD_SIZE];
+  size_t decodedLen = 0;
+  size_t legacyLen = 0;
+  uint64_t ns = 0;
+  uint64_t legacyNs = 0;
+  uint32_t allocs = 0;
+  uint32_t legacyAllocs = 0;
+
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    allocations = 0;
+    countAllocations = true;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = base64_decode(sink.data, sink.len, decoded, sizeof(decoded), decodedLen);
+    ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    allocs += allocations;
+    TEST_ASSERT_TRUE(ok);
+
+    allocations = 0;
+    start = std::chrono::steady_clock::now();
+    legacyBase64Decode(encoded, legacyDecoded, legacyLen);
+    legacyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    countAllocations = false;
+    legacyAllocs += allocations;
+  }
+
+  report("Dekodieren, Tabelle", ns, allocs);
+  report("Dekodieren, agdl-Wrapper", legacyNs, legacyAllocs);
+  TEST_ASSERT_EQUAL(PAYLOAD_SIZE, decodedLen);
+  TEST_ASSERT_EQUAL(PAYLOAD_SIZE, legacyLen);
+  TEST_ASSERT_EQUAL_MEMORY(payload, decoded, PAYLOAD_SIZE);
+  TEST_ASSERT_EQUAL_MEMORY(legacyDecoded, decoded, PAYLOAD_SIZE);
+  TEST_ASSERT_EQUAL(0, allocs);
+}
+
+void test_decoder_rejects_overflow_and_invalid_input() {
+  BufferSink sink;
+  base64_encode(payload, PAYLOAD_SIZE, sink);
+
+  uint8_t small[PAYLOAD_SIZE - 1];
+  size_t len = 0;
+  TEST_ASSERT_FALSE(base64_decode(sink.data, sink.len, small, sizeof(small), len));
+  TEST_ASSERT_EQUAL(0, len);
+
+  uint8_t out[8];
+  TEST_ASSERT_FALSE(base64_decode("QU$D", 4, out, sizeof(out), len));
+  TEST_ASSERT_FALSE(base64_decode("QUJDR", 5, out, sizeof(out), len));
+  TEST_ASSERT_FALSE(base64_decode("QQ=", 3, out, sizeof(out), len));
+  TEST_ASSERT_TRUE(base64_decode("QQ==", 4, out, sizeof(out), len));
+  TEST_ASSERT_EQUAL(1, len);
+  TEST_ASSERT_EQUAL_HEX8('A', out[0]);
+}
+
+int main(int argc, char** argv) {
+  UNITY_BEGIN();
+  RUN_TEST(test_encoder_matches_legacy_and_does_not_allocate);
+  RUN_TEST(test_decoder_matches_legacy_and_does_not_allocate);
+  RUN_TEST(test_decoder_rejects_overflow_and_invalid_input);
+  return UNITY_END();
+}
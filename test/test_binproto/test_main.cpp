@@ -0,0 +1,178 @@
+// Binäres Rahmenprotokoll: COBS/CRC16 in beiden Richtungen und Bytes je Empfangspaket
+// gegenüber der JSON-Zeile (siehe binproto.h).
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <stdio.h>
+#include <vector>
+
+#include "SimCore.h"
+#include "codec.h"
+#include "binproto.h"
+#include "interface.h"
+#include "serialout.h"
+#include "crypto.h"
+
+void setup();
+void loop();
+
+static std::vector<uint8_t> lastTx;
+static uint32_t txCount = 0;
+
+static void onTxStart(uint64_t, const uint8_t* payload, size_t len) {
+  lastTx.assign(payload, payload + len);
+  txCount++;
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+// Host-Seite: Rahmen mit CRC16 und COBS kodieren und Byte für Byte einspeisen
+static void sendFrame(uint8_t type, const uint8_t* data, size_t len, bool corruptCrc = false) {
+  std::vector<uint8_t> raw(1, type);
+  raw.insert(raw.end(), data, data + len);
+  uint16_t crc = crc16_ccitt(raw.data(), raw.size()) ^ (corruptCrc ? 1 : 0);
+  raw.push_back(crc & 0xFF);
+  raw.push_back(crc >> 8);
+  std::vector<uint8_t> encoded(raw.size() + raw.size() / 254 + 2);
+  size_t encodedLen = cobs_encode(raw.data(), raw.size(), encoded.data());
+  for (size_t i = 0; i < encodedLen; i++) {
+    TEST_ASSERT_TRUE(handleBinaryInputByte(encoded[i]));
+  }
+  TEST_ASSERT_TRUE(handleBinaryInputByte(0x00));
+}
+
+void setUp() {
+  runLoop(100000);
+}
+
+// Binärrahmen enden ohne Zeilenumbruch; die Ausgabe von Unity beginnt wieder am Zeilenanfang
+static void flushBinaryOutput() {
+  flushSerialOutput();
+  printf("\n");
+}
+
+void tearDown() {
+  flushBinaryOutput();
+}
+
+void test_crc16_check_value() {
+  const char* check = "123456789";
+  TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16_ccitt((const uint8_t*)check, 9));
+}
+
+void test_cobs_round_trip() {
+  for (size_t len = 0; len <= 600; len += (len < 260 ? 1 : 37)) {
+    std::vector<uint8_t> input(len);
+    for (size_t i = 0; i < len; i++) {
+      input[i] = (i % 7 == 3) ? 0 : (uint8_t)(i * 13 + 1); // Nullen und lange Läufe ohne Null
+    }
+    if (len > 300) {
+      std::fill(input.begin(), input.end(), 0xAA);
+    }
+    std::vector<uint8_t> encoded(len + len / 254 + 1);
+    size_t encodedLen = cobs_encode(input.data(), len, encoded.data());
+    TEST_ASSERT_LESS_OR_EQUAL(len + len / 254 + 1, encodedLen);
+    for (size_t i = 0; i < encodedLen; i++) {
+      TEST_ASSERT_NOT_EQUAL(0, encoded[i]);
+    }
+    std::vector<uint8_t> decoded(len + 1);
+    TEST_ASSERT_EQUAL(len, cobs_decode(encoded.data(), encodedLen, decoded.data(), decoded.size()));
+    TEST_ASSERT_TRUE(len == 0 || memcmp(input.data(), decoded.data(), len) == 0);
+  }
+}
+
+void test_tx_request_frame_reaches_air_unchanged() {
+  uint8_t payload[40];
+  for (uint8_t i = 0; i < sizeof(payload); i++) {
+    payload[i] = i % 3 == 0 ? 0 : 0x80 + i;
+  }
+  uint32_t before = txCount;
+  sendFrame(BIN_FRAME_TX_REQUEST, payload, sizeof(payload));
+  runLoop(1500000);
+  TEST_ASSERT_EQUAL(before + 1, txCount);
+  TEST_ASSERT_EQUAL(sizeof(payload), lastTx.size());
+  TEST_ASSERT_EQUAL_MEMORY(payload, lastTx.data(), sizeof(payload));
+
+  // Rahmen mit falschem CRC wird verworfen
+  sendFrame(BIN_FRAME_TX_REQUEST, payload, sizeof(payload), true);
+  runLoop(1500000);
+  TEST_ASSERT_EQUAL(before + 1, txCount);
+}
+
+void test_tx_request_is_encrypted_when_enabled() {
+  const uint8_t key[16] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+  uint8_t payload[40];
+  for (uint8_t i = 0; i < sizeof(payload); i++) {
+    payload[i] = 0x80 + i;
+  }
+  setCryptoKey(key, false);
+  setCryptoTxEnabled(true);
+  uint32_t before = txCount;
+  uint32_t encrypted = getCryptoStats().txPackets;
+  sendFrame(BIN_FRAME_TX_REQUEST, payload, sizeof(payload));
+  runLoop(1500000);
+  TEST_ASSERT_EQUAL(before + 1, txCount);
+  TEST_ASSERT_EQUAL(encrypted + 1, getCryptoStats().txPackets);
+  TEST_ASSERT_EQUAL(sizeof(payload) + LORA_CRYPTO_OVERHEAD, lastTx.size());
+  TEST_ASSERT_EQUAL_HEX8(0xC7, lastTx[0]);
+
+  // Ohne Schlüssel wird nichts gesendet
+  clearCryptoKey();
+  sendFrame(BIN_FRAME_TX_REQUEST, payload, sizeof(payload));
+  runLoop(1500000);
+  TEST_ASSERT_EQUAL(before + 1, txCount);
+  setCryptoTxEnabled(false);
+}
+
+// Bytes eines Datensatzes in der seriellen Ausgabe
+static size_t recordBytes(bool binary, const uint8_t* payload, size_t len) {
+  flushSerialOutput();
+  if (binary) {
+    publishBinaryRx(payload, len, -97, 6.25f, -1234.0f, 0xFF);
+  } else {
+    publishReceivedLoRaPacket(payload, len, -97, -99, 6.25f, -1234.0f, 0xFF, 123456789, -1);
+  }
+  size_t bytes = serialOut.pending();
+  flushBinaryOutput();
+  return bytes;
+}
+
+void test_binary_rx_event_is_smaller_than_json() {
+  const size_t lengths[] = {16, 64, 255};
+  for (size_t len : lengths) {
+    uint8_t payload[255];
+    for (size_t i = 0; i < len; i++) {
+      payload[i] = (uint8_t)(i * 37 + 11);
+    }
+    size_t json = recordBytes(false, payload, len);
+    size_t binary = recordBytes(true, payload, len);
+    char text[120];
+    snprintf(text, sizeof(text), "%u Bytes Payload: JSON %u Bytes, binär %u Bytes (%u %%)", (unsigned)len,
+             (unsigned)json, (unsigned)binary, (unsigned)(binary * 100 / json));
+    TEST_MESSAGE(text);
+    TEST_ASSERT_GREATER_THAN(len, json);
+    // Binär: Payload + 11 Bytes Kopf/CRC + COBS-Overhead + Rahmenende
+    TEST_ASSERT_LESS_OR_EQUAL(len + 11 + len / 254 + 2, binary);
+    TEST_ASSERT_LESS_THAN(json * 3 / 4, binary);
+  }
+}
+
+int main(int argc, char** argv) {
+  simRadioSetTxStartHandler(onTxStart);
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_crc16_check_value);
+  RUN_TEST(test_cobs_round_trip);
+  RUN_TEST(test_tx_request_frame_reaches_air_unchanged);
+  RUN_TEST(test_tx_request_is_encrypted_when_enabled);
+  RUN_TEST(test_binary_rx_event_is_smaller_than_json);
+  return UNITY_END();
+}
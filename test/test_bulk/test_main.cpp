@@ -0,0 +1,253 @@
+// Blockübertragung: Die Testseite spielt über den TX-Start-Haken der Simulation die
+// Gegenstelle, verliert gezielt Fragmente und quittiert mit Bitmaske (siehe bulk.h).
+// Als Empfänger werden Lücken quittiert und die Daten vollständig an den Host gegeben;
+// Übertragungen, die nicht in den Puffer passen, werden auf beiden Seiten abgelehnt.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "0_config.h"
+#include "airtime.h"
+#include "bulk.h"
+#include "codec.h"
+
+void setup();
+void loop();
+
+static const uint8_t MAGIC = 0xB5;
+static const uint8_t TYPE_DATA = 0x01;
+static const uint8_t TYPE_ACK = 0x02;
+static const uint8_t FLAG_ACK_REQ = 0x80;
+static const uint8_t FLAG_NAK = 0x40;
+static const uint8_t DATA_HEADER = 5;
+
+// Gegenstelle: empfangene Fragmente, Verluste und gesendete Quittungen des Geräts
+static uint32_t peerMask = 0;
+static uint32_t dropOnce = 0;
+static bool peerRejects = false;
+static std::vector<uint8_t> peerData;
+static std::vector<uint32_t> deviceAcks;
+static std::vector<uint8_t> deviceAckTypes;
+static std::vector<std::string> lines;
+
+static void onTxStart(uint64_t at_us, const uint8_t* payload, size_t len) {
+  if (len < 4 || payload[0] != MAGIC) {
+    return;
+  }
+  if ((payload[1] & 0x0F) == TYPE_ACK) {
+    deviceAckTypes.push_back(payload[1]);
+    deviceAcks.push_back((uint32_t)payload[4] | ((uint32_t)payload[5] << 8) | ((uint32_t)payload[6] << 16) |
+                         ((uint32_t)payload[7] << 24));
+    return;
+  }
+
+  uint8_t seq = payload[3];
+  if (dropOnce & (1UL << seq)) {
+    dropOnce &= ~(1UL << seq); // Verloren, die Quittung bleibt ebenfalls aus
+    return;
+  }
+  peerMask |= 1UL << seq;
+  memcpy(&peerData[(size_t)seq * LORA_BULK_FRAGMENT_SIZE], &payload[DATA_HEADER], len - DATA_HEADER);
+  if (payload[1] & FLAG_ACK_REQ) {
+    uint32_t mask = peerRejects ? 0 : peerMask;
+    uint8_t ack[8] = {MAGIC, (uint8_t)(TYPE_ACK | (peerRejects ? FLAG_NAK : 0)), payload[2], payload[4], (uint8_t)mask,
+                      (uint8_t)(mask >> 8), (uint8_t)(mask >> 16), (uint8_t)(mask >> 24)};
+    simRadioInjectPacket(at_us + getAirtimeMicros(len) + getAirtimeMicros(sizeof(ack)) + 20000, ack, sizeof(ack),
+                         -80, 8.0f, 0.0f);
+  }
+}
+
+static void onLine(const std::string& line, uint64_t) {
+  if (line.find("\"type\":\"lora_bulk") != std::string::npos) {
+    lines.push_back(line);
+  }
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+static std::vector<uint8_t> pattern(size_t len) {
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; i++) {
+    data[i] = (uint8_t)(i * 7 + i / 251);
+  }
+  return data;
+}
+
+// Sendet 'data' und läuft, bis die Übertragung abgeschlossen ist
+static void transfer(const std::vector<uint8_t>& data) {
+  peerData.assign(LORA_BULK_BUFFER_SIZE, 0);
+  TEST_ASSERT_EQUAL_STRING("", bulkAppend(data.data(), data.size()).c_str());
+  uint8_t id = 0;
+  TEST_ASSERT_EQUAL_STRING("", bulkStartSend(id).c_str());
+  for (uint8_t i = 0; i < 60 && strcmp(getBulkStateName(), "idle") != 0; i++) {
+    runLoop(1000000);
+  }
+  TEST_ASSERT_EQUAL_STRING("idle", getBulkStateName());
+}
+
+static void injectFragment(uint8_t id, uint8_t seq, uint8_t count, const std::vector<uint8_t>& data, bool ackReq) {
+  size_t offset = (size_t)seq * LORA_BULK_FRAGMENT_SIZE;
+  size_t fragLen = data.size() - offset < LORA_BULK_FRAGMENT_SIZE ? data.size() - offset : LORA_BULK_FRAGMENT_SIZE;
+  std::vector<uint8_t> frame = {MAGIC, (uint8_t)(TYPE_DATA | (ackReq ? FLAG_ACK_REQ : 0)), id, seq, count};
+  frame.insert(frame.end(), data.begin() + offset, data.begin() + offset + fragLen);
+  simRadioInjectPacket(simNow() + getAirtimeMicros(frame.size()), frame.data(), frame.size(), -80, 8.0f, 0.0f);
+  runLoop(getAirtimeMicros(frame.size()) + 50000);
+}
+
+void setUp() {
+  setBulkEnabled(true);
+  resetBulkStats();
+  peerMask = 0;
+  dropOnce = 0;
+  peerRejects = false;
+  deviceAcks.clear();
+  deviceAckTypes.clear();
+  lines.clear();
+}
+
+void tearDown() {
+  setBulkEnabled(LORA_BULK_ENABLED_DEFAULT);
+  runLoop(100000);
+}
+
+void test_lost_fragment_is_repeated_selectively() {
+  // 5 Fragmente, das zweite geht im ersten Fenster verloren
+  std::vector<uint8_t> data = pattern(4 * LORA_BULK_FRAGMENT_SIZE + 37);
+  dropOnce = 1UL << 1;
+  transfer(data);
+
+  BulkStats stats = getBulkStats();
+  TEST_ASSERT_EQUAL(1, stats.txTransfers);
+  TEST_ASSERT_EQUAL(6, stats.fragmentsSent);
+  TEST_ASSERT_EQUAL(1, stats.retransmissions);
+  TEST_ASSERT_EQUAL(0, stats.ackTimeouts);
+  TEST_ASSERT_EQUAL_HEX32(0x1F, peerMask);
+  TEST_ASSERT_EQUAL_MEMORY(data.data(), peerData.data(), data.size());
+  TEST_ASSERT_EQUAL(1, lines.size());
+  TEST_ASSERT_TRUE(lines[0].find("\"ok\":true") != std::string::npos);
+}
+
+void test_lost_ack_request_times_out_and_resends_window() {
+  // Das anfordernde letzte Fragment des ersten Fensters fehlt: keine Quittung, ganzes Fenster erneut
+  std::vector<uint8_t> data = pattern(4 * LORA_BULK_FRAGMENT_SIZE + 1);
+  dropOnce = 1UL << (LORA_BULK_WINDOW - 1);
+  transfer(data);
+
+  BulkStats stats = getBulkStats();
+  TEST_ASSERT_EQUAL(1, stats.txTransfers);
+  TEST_ASSERT_EQUAL(1, stats.ackTimeouts);
+  TEST_ASSERT_EQUAL(LORA_BULK_WINDOW, stats.retransmissions);
+  TEST_ASSERT_EQUAL_MEMORY(data.data(), peerData.data(), data.size());
+}
+
+void test_receiver_acks_gaps_and_delivers_data() {
+  std::vector<uint8_t> data = pattern(2 * LORA_BULK_FRAGMENT_SIZE + 90);
+  injectFragment(9, 0, 3, data, false);
+  injectFragment(9, 2, 3, data, true);
+  TEST_ASSERT_EQUAL(1, deviceAcks.size());
+  TEST_ASSERT_EQUAL_HEX32(0x5, deviceAcks[0]);
+  TEST_ASSERT_EQUAL_STRING("rx", getBulkStateName());
+
+  injectFragment(9, 1, 3, data, true);
+  runLoop(500000);
+  TEST_ASSERT_EQUAL(2, deviceAcks.size());
+  TEST_ASSERT_EQUAL_HEX32(0x7, deviceAcks[1]);
+  TEST_ASSERT_EQUAL(1, getBulkStats().rxTransfers);
+
+  // Ereignis mit Länge, dann die Daten in Abschnitten mit aufsteigendem Offset
+  TEST_ASSERT_GREATER_THAN(1, lines.size());
+  TEST_ASSERT_TRUE(lines[0].find("\"type\":\"lora_bulk_rx\"") != std::string::npos);
+  TEST_ASSERT_TRUE(lines[0].find("\"len\":" + std::to_string(data.size())) != std::string::npos);
+  std::vector<uint8_t> received;
+  for (size_t i = 1; i < lines.size(); i++) {
+    TEST_ASSERT_TRUE(lines[i].find("\"offset\":" + std::to_string(received.size())) != std::string::npos);
+    size_t start = lines[i].find("\"payload\":\"") + 11;
+    size_t end = lines[i].find('"', start);
+    uint8_t chunk[LORA_BULK_EVENT_CHUNK];
+    size_t chunkLen = 0;
+    TEST_ASSERT_TRUE(base64_decode(&lines[i][start], end - start, chunk, sizeof(chunk), chunkLen));
+    received.insert(received.end(), chunk, chunk + chunkLen);
+  }
+  TEST_ASSERT_EQUAL(data.size(), received.size());
+  TEST_ASSERT_EQUAL_MEMORY(data.data(), received.data(), data.size());
+
+  // Wiederholtes letztes Fragment (Quittung verloren): erneut vollständig quittiert
+  injectFragment(9, 2, 3, data, true);
+  TEST_ASSERT_EQUAL(3, deviceAcks.size());
+  TEST_ASSERT_EQUAL_HEX32(0x7, deviceAcks[2]);
+  TEST_ASSERT_EQUAL(1, getBulkStats().rxTransfers);
+}
+
+void test_oversized_transfer_is_rejected_with_nak() {
+  // Gegenstelle mit größerem Puffer: erst das Fenster mit Anforderung, dann das lange letzte Fragment
+  uint8_t count = LORA_BULK_BUFFER_SIZE / LORA_BULK_FRAGMENT_SIZE + 1;
+  std::vector<uint8_t> data = pattern((size_t)count * LORA_BULK_FRAGMENT_SIZE);
+  injectFragment(21, 0, count, data, false);
+  injectFragment(21, 1, count, data, true);
+  TEST_ASSERT_EQUAL(1, deviceAcks.size());
+  TEST_ASSERT_EQUAL_HEX8(TYPE_ACK, deviceAckTypes[0]);
+  TEST_ASSERT_EQUAL_STRING("rx", getBulkStateName());
+
+  injectFragment(21, count - 1, count, data, true);
+  TEST_ASSERT_EQUAL(2, deviceAcks.size());
+  TEST_ASSERT_EQUAL_HEX8(TYPE_ACK | FLAG_NAK, deviceAckTypes[1]);
+  TEST_ASSERT_EQUAL_HEX32(0, deviceAcks[1]);
+  TEST_ASSERT_EQUAL_STRING("idle", getBulkStateName());
+
+  // Mehr Fragmente, als die Bitmaske erlaubt: sofort abgelehnt, aber nur einmal gezählt
+  injectFragment(22, 0, 40, data, true);
+  injectFragment(22, 1, 40, data, true);
+  TEST_ASSERT_EQUAL(4, deviceAcks.size());
+  TEST_ASSERT_EQUAL_HEX8(TYPE_ACK | FLAG_NAK, deviceAckTypes[3]);
+  BulkStats stats = getBulkStats();
+  TEST_ASSERT_EQUAL(2, stats.rxTooLarge);
+  TEST_ASSERT_EQUAL(0, stats.rxTransfers);
+}
+
+void test_sender_aborts_on_nak() {
+  peerRejects = true;
+  std::vector<uint8_t> data = pattern(6 * LORA_BULK_FRAGMENT_SIZE);
+  peerData.assign(LORA_BULK_BUFFER_SIZE, 0);
+  TEST_ASSERT_EQUAL_STRING("", bulkAppend(data.data(), data.size()).c_str());
+  uint8_t id = 0;
+  TEST_ASSERT_EQUAL_STRING("", bulkStartSend(id).c_str());
+  for (uint8_t i = 0; i < 10 && strcmp(getBulkStateName(), "idle") != 0; i++) {
+    runLoop(1000000);
+  }
+  TEST_ASSERT_EQUAL_STRING("idle", getBulkStateName());
+
+  // Nur das erste Fenster, keine Wiederholungen bis zum Zeitlimit
+  BulkStats stats = getBulkStats();
+  TEST_ASSERT_EQUAL(1, stats.txFailed);
+  TEST_ASSERT_LESS_OR_EQUAL(LORA_BULK_WINDOW, stats.fragmentsSent);
+  TEST_ASSERT_EQUAL(0, stats.retransmissions);
+  TEST_ASSERT_EQUAL(0, stats.ackTimeouts);
+  TEST_ASSERT_EQUAL(1, lines.size());
+  TEST_ASSERT_TRUE(lines[0].find("\"ok\":false") != std::string::npos);
+}
+
+int main(int argc, char** argv) {
+  simRadioSetTxStartHandler(onTxStart);
+  simSerialSetLineHandler(onLine);
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_lost_fragment_is_repeated_selectively);
+  RUN_TEST(test_lost_ack_request_times_out_and_resends_window);
+  RUN_TEST(test_receiver_acks_gaps_and_delivers_data);
+  RUN_TEST(test_oversized_transfer_is_rejected_with_nak);
+  RUN_TEST(test_sender_aborts_on_nak);
+  return UNITY_END();
+}
@@ -0,0 +1,158 @@
+// Kompression: Rohpakete, die selbst mit einem Kennbyte (0xC5/0xC6, auf Knoten mit Verschlüsselung
+// auch 0xC7) beginnen, werden bei eingeschalteter Kompression eingepackt gesendet und unverändert
+// entpackt; ist sie abgeschaltet, geht jedes Paket unverändert hinaus.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+
+#include "SimCore.h"
+#include "0_config.h"
+#include "compress.h"
+#include "crypto.h"
+
+void setup();
+void loop();
+
+static const uint8_t MARKERS[] = {0xC5, 0xC6};
+
+// Nicht komprimierbare Daten (lineare Kongruenz), erstes Byte = 'first'
+static void fillRandom(uint8_t* data, size_t len, uint8_t first, uint32_t seed) {
+  for (size_t i = 0; i < len; i++) {
+    seed = seed * 1103515245UL + 12345UL;
+    data[i] = seed >> 24;
+  }
+  data[0] = first;
+}
+
+// Sendet 'data' durch compressForTx() und prüft, dass die Gegenseite genau 'data' erhält
+static void assertRoundTrip(const uint8_t* data, size_t len) {
+  uint8_t packed[255];
+  uint8_t unpacked[255];
+  uint32_t saved = 0;
+
+  size_t packedLen = compressForTx(data, len, packed, saved);
+  TEST_ASSERT_GREATER_THAN(0, packedLen);
+  TEST_ASSERT_LESS_OR_EQUAL(255, packedLen);
+  TEST_ASSERT_TRUE(packed[0] == 0xC5 || packed[0] == 0xC6);
+
+  size_t unpackedLen = decompressRx(packed, packedLen, unpacked);
+  TEST_ASSERT_EQUAL(len, unpackedLen);
+  TEST_ASSERT_EQUAL_MEMORY(data, unpacked, len);
+}
+
+void setUp() {
+  setCompressRxEnabled(true);
+  setCompressDictEnabled(false);
+}
+
+void tearDown() {
+  setCompressTxEnabled(LORA_COMPRESS_TX_DEFAULT);
+  setCompressRxEnabled(LORA_COMPRESS_RX_DEFAULT);
+  setCompressDictEnabled(LORA_COMPRESS_DICT_DEFAULT);
+}
+
+void test_marker_payload_is_wrapped_with_tx_compression_on() {
+  setCompressTxEnabled(true);
+  uint8_t data[200];
+  for (uint8_t marker : MARKERS) {
+    for (size_t len : {(size_t)1, (size_t)2, (size_t)33, sizeof(data)}) {
+      fillRandom(data, len, marker, len);
+      assertRoundTrip(data, len);
+    }
+  }
+}
+
+void test_incompressible_marker_payload_is_wrapped_with_tx_compression_on() {
+  setCompressTxEnabled(true);
+  uint8_t data[240];
+  for (uint8_t marker : MARKERS) {
+    for (bool dict : {false, true}) {
+      setCompressDictEnabled(dict);
+      fillRandom(data, sizeof(data), marker, marker + dict);
+      assertRoundTrip(data, sizeof(data));
+    }
+  }
+}
+
+void test_compressible_marker_payload_round_trips() {
+  setCompressTxEnabled(true);
+  uint8_t data[120];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = "temp=21.5;hum=40;"[i % 17];
+  }
+  data[0] = 0xC6;
+  assertRoundTrip(data, sizeof(data));
+}
+
+void test_payload_unchanged_with_tx_compression_off() {
+  setCompressTxEnabled(false);
+  uint8_t data[64];
+  uint8_t out[255];
+  uint32_t saved = 0;
+  for (uint8_t first : {(uint8_t)0x42, (uint8_t)0xC5, (uint8_t)0xC6, (uint8_t)0xC7}) {
+    fillRandom(data, sizeof(data), first, 7);
+    TEST_ASSERT_EQUAL(sizeof(data), compressForTx(data, sizeof(data), out, saved));
+    TEST_ASSERT_EQUAL_MEMORY(data, out, sizeof(data));
+  }
+  TEST_ASSERT_EQUAL(0, saved);
+}
+
+void test_marker_payload_too_long_to_wrap_is_rejected() {
+  uint8_t data[255];
+  uint8_t out[255];
+  uint32_t saved = 0;
+  fillRandom(data, sizeof(data), 0xC5, 99);
+  setCompressTxEnabled(true);
+  TEST_ASSERT_EQUAL(0, compressForTx(data, sizeof(data), out, saved));
+}
+
+void test_plaintext_with_crypto_marker_is_not_rejected() {
+  const uint8_t key[16] = {0x2B, 0x7E, 0x15, 0x16, 0x28, 0xAE, 0xD2, 0xA6, 0xAB, 0xF7, 0x15, 0x88, 0x09, 0xCF, 0x4F, 0x3C};
+  setCryptoKey(key, false);
+  setCryptoRxEnabled(true);
+  setCompressTxEnabled(true);
+  uint8_t data[48];
+  uint8_t packed[255];
+  uint8_t decrypted[255];
+  uint32_t saved = 0;
+  fillRandom(data, sizeof(data), 0xC7, 3);
+  uint32_t rejected = getCryptoStats().rxRejected;
+
+  size_t packedLen = compressForTx(data, sizeof(data), packed, saved);
+  size_t decryptedLen = 0;
+  uint16_t node = 0;
+  TEST_ASSERT_EQUAL(CRYPTO_PLAIN, decryptRx(packed, packedLen, decrypted, decryptedLen, node));
+  TEST_ASSERT_EQUAL(rejected, getCryptoStats().rxRejected);
+  assertRoundTrip(data, sizeof(data));
+
+  setCryptoRxEnabled(LORA_CRYPTO_RX_DEFAULT);
+  clearCryptoKey();
+}
+
+void test_crypto_marker_unchanged_without_crypto() {
+  setCompressTxEnabled(true);
+  TEST_ASSERT_FALSE(isCryptoTxEnabled());
+  TEST_ASSERT_FALSE(isCryptoRxEnabled());
+  uint8_t data[48];
+  uint8_t out[255];
+  uint32_t saved = 0;
+  fillRandom(data, sizeof(data), 0xC7, 5);
+  uint32_t skipped = getCompressStats().txSkipped;
+  TEST_ASSERT_EQUAL(sizeof(data), compressForTx(data, sizeof(data), out, saved));
+  TEST_ASSERT_EQUAL_MEMORY(data, out, sizeof(data));
+  TEST_ASSERT_EQUAL(skipped + 1, getCompressStats().txSkipped);
+}
+
+int main(int argc, char** argv) {
+  setup();
+  UNITY_BEGIN();
+  RUN_TEST(test_marker_payload_is_wrapped_with_tx_compression_on);
+  RUN_TEST(test_incompressible_marker_payload_is_wrapped_with_tx_compression_on);
+  RUN_TEST(test_compressible_marker_payload_round_trips);
+  RUN_TEST(test_payload_unchanged_with_tx_compression_off);
+  RUN_TEST(test_marker_payload_too_long_to_wrap_is_rejected);
+  RUN_TEST(test_plaintext_with_crypto_marker_is_not_rejected);
+  RUN_TEST(test_crypto_marker_unchanged_without_crypto);
+  return UNITY_END();
+}
@@ -0,0 +1,165 @@
+// Verschlüsselung: AES-128 und CCM gegen die Testvektoren aus FIPS-197 Anhang C.1 und
+// NIST SP 800-38C Anhang C, Ablehnung verfälschter Pakete und Fortsetzen des Zählers
+// nach einem Neustart oberhalb des gespeicherten Vorrats (siehe aes.h und crypto.h).
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string.h>
+#include <vector>
+
+#include "0_config.h"
+#include "aes.h"
+#include "crypto.h"
+#include "lora.h"
+#include "storage.h"
+
+void setup();
+void loop();
+
+static std::vector<uint8_t> hexBytes(const char* hex) {
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; hex[i] != 0 && hex[i + 1] != 0; i += 2) {
+    char pair[3] = {hex[i], hex[i + 1], 0};
+    bytes.push_back((uint8_t)strtoul(pair, nullptr, 16));
+  }
+  return bytes;
+}
+
+// Schlüssel 40..4f aus SP 800-38C Anhang C
+static AesKey ccmKey() {
+  AesKey key;
+  aesSetKey(key, hexBytes("404142434445464748494a4b4c4d4e4f").data());
+  return key;
+}
+
+// Verschlüsselt ein Paket des Geräts und liefert seinen Zählerstand aus der Nonce
+static uint32_t encryptPacket(std::vector<uint8_t>& packet) {
+  const uint8_t plain[12] = {'t', 'e', 'l', 'e', 'm', 'e', 't', 'r', 'y', 0, 1, 2};
+  uint8_t out[255];
+  size_t outLen = 0;
+  TEST_ASSERT_EQUAL_STRING("", encryptForTx(plain, sizeof(plain), out, outLen).c_str());
+  TEST_ASSERT_EQUAL(sizeof(plain) + LORA_CRYPTO_OVERHEAD, outLen);
+  packet.assign(out, out + outLen);
+  return (uint32_t)out[3] | (uint32_t)out[4] << 8 | (uint32_t)out[5] << 16 | (uint32_t)out[6] << 24;
+}
+
+void setUp() {
+  const uint8_t key[16] = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                           0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  setCryptoKey(key, true);
+  setCryptoTxEnabled(true);
+  setCryptoRxEnabled(true);
+}
+
+void tearDown() {
+  clearCryptoKey();
+  setCryptoTxEnabled(LORA_CRYPTO_TX_DEFAULT);
+  setCryptoRxEnabled(LORA_CRYPTO_RX_DEFAULT);
+}
+
+void test_fips197_c1_block() {
+  AesKey key;
+  uint8_t out[16];
+  aesSetKey(key, hexBytes("000102030405060708090a0b0c0d0e0f").data());
+  aesEncryptBlock(key, hexBytes("00112233445566778899aabbccddeeff").data(), out);
+  TEST_ASSERT_EQUAL_MEMORY(hexBytes("69c4e0d86a7b0430d8cdb78070b4c55a").data(), out, 16);
+}
+
+void test_sp800_38c_examples() {
+  struct {
+    const char* nonce;
+    const char* aad;
+    const char* plain;
+    const char* expected; // Geheimtext samt Prüfwert
+    uint8_t tagLen;
+  } vectors[] = {
+    {"10111213141516", "0001020304050607", "20212223", "7162015b4dac255d", 4},
+    {"1011121314151617", "000102030405060708090a0b0c0d0e0f", "202122232425262728292a2b2c2d2e2f",
+     "d2a1f0e051ea5f62081a7792073d593d1fc64fbfaccd", 6},
+    {"101112131415161718191a1b", "000102030405060708090a0b0c0d0e0f10111213",
+     "202122232425262728292a2b2c2d2e2f3031323334353637", "e3b201a9f5b71a7a9b1ceaeccd97e70b6176aad9a4428aa5484392fbc1b09951", 8},
+  };
+  AesKey key = ccmKey();
+  for (auto& v : vectors) {
+    std::vector<uint8_t> nonce = hexBytes(v.nonce), aad = hexBytes(v.aad), plain = hexBytes(v.plain);
+    std::vector<uint8_t> expected = hexBytes(v.expected);
+    std::vector<uint8_t> out(plain.size() + v.tagLen), back(plain.size());
+    aesCcmEncrypt(key, nonce.data(), nonce.size(), aad.data(), aad.size(), plain.data(), plain.size(), out.data(),
+                  out.data() + plain.size(), v.tagLen);
+    TEST_ASSERT_EQUAL(expected.size(), out.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), out.data(), out.size());
+    TEST_ASSERT_TRUE(aesCcmDecrypt(key, nonce.data(), nonce.size(), aad.data(), aad.size(), out.data(), plain.size(),
+                                   back.data(), out.data() + plain.size(), v.tagLen));
+    TEST_ASSERT_EQUAL_MEMORY(plain.data(), back.data(), plain.size());
+  }
+}
+
+void test_flipped_bit_is_rejected() {
+  std::vector<uint8_t> packet;
+  encryptPacket(packet);
+  uint8_t plain[255];
+  size_t plainLen = 0;
+  uint16_t node = 0;
+  TEST_ASSERT_EQUAL(CRYPTO_DECRYPTED, decryptRx(packet.data(), packet.size(), plain, plainLen, node));
+  TEST_ASSERT_EQUAL(getCryptoNodeId(), node);
+
+  // Jedes einzelne Bit in Nonce, Geheimtext und Prüfwert muss auffallen (außer dem Kennbyte)
+  uint32_t rejectedBefore = getCryptoStats().rxRejected;
+  uint32_t flips = 0;
+  for (size_t i = 1; i < packet.size(); i++) {
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      std::vector<uint8_t> forged = packet;
+      forged[i] ^= 1 << bit;
+      TEST_ASSERT_EQUAL(CRYPTO_REJECTED, decryptRx(forged.data(), forged.size(), plain, plainLen, node));
+      flips++;
+    }
+  }
+  TEST_ASSERT_EQUAL(rejectedBefore + flips, getCryptoStats().rxRejected);
+
+  // Zu kurz für Kopf und Prüfwert
+  TEST_ASSERT_EQUAL(CRYPTO_REJECTED, decryptRx(packet.data(), LORA_CRYPTO_OVERHEAD - 1, plain, plainLen, node));
+}
+
+void test_counter_lease_resumes_after_restart() {
+  std::vector<uint8_t> packet;
+  uint32_t first = encryptPacket(packet);
+  uint32_t lease = getCryptoCounterLease();
+  TEST_ASSERT_GREATER_THAN(first, lease);
+  uint32_t last = first;
+  for (uint8_t i = 0; i < 5; i++) {
+    last = encryptPacket(packet);
+  }
+  TEST_ASSERT_EQUAL(first + 5, last);
+
+  // Neustart: Zähler und Schlüssel kommen aus dem Flash zurück
+  clearCryptoKey();
+  setCryptoTxEnabled(false);
+  LoRaSettings stored;
+  TEST_ASSERT_TRUE(loadStoredConfig(stored));
+  TEST_ASSERT_TRUE(hasCryptoKey());
+  TEST_ASSERT_TRUE(isCryptoTxEnabled());
+  TEST_ASSERT_EQUAL(lease, getCryptoCounter());
+
+  // Das erste Paket danach liegt oberhalb aller vor dem Neustart verwendeten Zählerstände
+  uint32_t writesBefore = getCryptoStats().leaseWrites;
+  uint32_t resumed = encryptPacket(packet);
+  TEST_ASSERT_EQUAL(lease, resumed);
+  TEST_ASSERT_GREATER_THAN(last, resumed);
+  TEST_ASSERT_EQUAL(writesBefore + 1, getCryptoStats().leaseWrites);
+  TEST_ASSERT_EQUAL(lease + LORA_CRYPTO_COUNTER_LEASE, getCryptoCounterLease());
+
+  // Innerhalb des neuen Vorrats wird nicht erneut geschrieben
+  encryptPacket(packet);
+  TEST_ASSERT_EQUAL(writesBefore + 1, getCryptoStats().leaseWrites);
+}
+
+int main(int argc, char** argv) {
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_fips197_c1_block);
+  RUN_TEST(test_sp800_38c_examples);
+  RUN_TEST(test_flipped_bit_is_rejected);
+  RUN_TEST(test_counter_lease_resumes_after_restart);
+  return UNITY_END();
+}
@@ -0,0 +1,199 @@
+// Duplikatunterdrückung: Verfall im Zeitfenster ohne Bruch der Sondierkette, Verdrängen
+// des ältesten Eintrags bei voller Kette und Zurückhalten der Kopie mit dem besten RSSI
+// (siehe dedup.h). Zum Schluss ein Durchlauf über die Simulation.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "0_config.h"
+#include "dedup.h"
+
+void setup();
+void loop();
+
+static const uint32_t WINDOW_MS = 1000;
+static const uint16_t HOLD_MS = 200;
+
+static std::vector<std::string> rxLines;
+
+static void onLine(const std::string& line, uint64_t) {
+  if (line.find("\"type\":\"lora_rx\"") != std::string::npos) {
+    rxLines.push_back(line);
+  }
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+static void configure(DedupMode mode) {
+  DedupSettings s = {mode, WINDOW_MS, HOLD_MS, 0, 0};
+  // Anderes Zeitfenster leert die Tabelle
+  s.window_ms = WINDOW_MS + 1;
+  setDedupSettings(s);
+  s.window_ms = WINDOW_MS;
+  setDedupSettings(s);
+  resetDedupStats();
+}
+
+static LoRaRxPacket makePacket(uint32_t id, uint32_t at_ms, int16_t rssi = -100) {
+  LoRaRxPacket packet;
+  memset(&packet, 0, sizeof(packet));
+  memcpy(packet.payload, &id, sizeof(id));
+  packet.len = 12;
+  packet.rssi = rssi;
+  packet.snr = 5.0f;
+  packet.timestamp_ms = at_ms;
+  return packet;
+}
+
+// Heimplatz eines Pakets in der Tabelle, wie in dedup.cpp berechnet (FNV-1a über die ganzen Nutzdaten)
+static uint8_t homeSlot(const LoRaRxPacket& packet) {
+  uint32_t hash = 2166136261UL;
+  for (uint16_t i = 0; i < packet.len; i++) {
+    hash = (hash ^ packet.payload[i]) * 16777619UL;
+  }
+  hash = (hash ^ packet.len) * 16777619UL;
+  return (hash != 0 ? hash : 1) & (LORA_DEDUP_TABLE_SIZE - 1);
+}
+
+// Liefert 'count' Paket-IDs, die alle auf denselben Heimplatz fallen
+static std::vector<uint32_t> collidingIds(uint8_t count) {
+  std::vector<uint32_t> ids;
+  uint8_t home = homeSlot(makePacket(1, 0));
+  for (uint32_t id = 1; ids.size() < count; id++) {
+    if (homeSlot(makePacket(id, 0)) == home) {
+      ids.push_back(id);
+    }
+  }
+  return ids;
+}
+
+static DedupVerdict filter(uint32_t id, uint32_t at_ms, int16_t rssi = -100) {
+  LoRaRxPacket packet = makePacket(id, at_ms, rssi);
+  return dedupFilter(&packet);
+}
+
+void setUp() {
+  rxLines.clear();
+}
+
+void tearDown() {
+  configure((DedupMode)LORA_DEDUP_MODE_DEFAULT);
+}
+
+void test_copies_inside_window_are_dropped() {
+  configure(DEDUP_DROP);
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(7, 1000));
+  TEST_ASSERT_EQUAL(DEDUP_DUPLICATE, filter(7, 1000 + WINDOW_MS - 1));
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(8, 1000 + WINDOW_MS - 1));
+
+  // Nach Ablauf des Fensters gilt dasselbe Paket wieder als neu
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(7, 1000 + WINDOW_MS));
+  DedupStats stats = getDedupStats();
+  TEST_ASSERT_EQUAL(1, stats.hits);
+  TEST_ASSERT_EQUAL(3, stats.misses);
+  TEST_ASSERT_EQUAL(0, stats.evictions);
+}
+
+void test_expired_entry_does_not_break_probe_chain() {
+  configure(DEDUP_DROP);
+  std::vector<uint32_t> ids = collidingIds(4);
+
+  // A belegt den Heimplatz, B und C liegen dahinter in derselben Kette
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(ids[0], 0));
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(ids[1], WINDOW_MS / 2));
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(ids[2], WINDOW_MS / 2));
+
+  // A ist verfallen, C muss trotzdem noch gefunden werden
+  uint32_t now = WINDOW_MS + 1;
+  TEST_ASSERT_EQUAL(DEDUP_DUPLICATE, filter(ids[2], now));
+  // D übernimmt den verfallenen Platz von A, ohne etwas zu verdrängen
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(ids[3], now));
+  TEST_ASSERT_EQUAL(DEDUP_DUPLICATE, filter(ids[1], now));
+  TEST_ASSERT_EQUAL(0, getDedupStats().evictions);
+}
+
+void test_full_probe_range_evicts_oldest() {
+  configure(DEDUP_DROP);
+  std::vector<uint32_t> ids = collidingIds(LORA_DEDUP_MAX_PROBE + 1);
+
+  for (uint8_t i = 0; i < LORA_DEDUP_MAX_PROBE; i++) {
+    TEST_ASSERT_EQUAL(DEDUP_PASS, filter(ids[i], 10 + i));
+  }
+  TEST_ASSERT_EQUAL(0, getDedupStats().evictions);
+
+  // Die Kette ist voll: der älteste Eintrag (ids[0]) weicht
+  uint32_t now = 10 + LORA_DEDUP_MAX_PROBE;
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(ids[LORA_DEDUP_MAX_PROBE], now));
+  TEST_ASSERT_EQUAL(1, getDedupStats().evictions);
+  TEST_ASSERT_EQUAL(DEDUP_DUPLICATE, filter(ids[1], now));
+  TEST_ASSERT_EQUAL(DEDUP_DUPLICATE, filter(ids[LORA_DEDUP_MAX_PROBE], now));
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(ids[0], now));
+}
+
+void test_best_mode_holds_copy_with_best_rssi() {
+  configure(DEDUP_BEST);
+  uint32_t start = millis();
+
+  TEST_ASSERT_EQUAL(DEDUP_HELD, filter(21, start, -100));
+  TEST_ASSERT_EQUAL(DEDUP_DUPLICATE, filter(21, start + 10, -80));
+  TEST_ASSERT_EQUAL(DEDUP_DUPLICATE, filter(21, start + 20, -90));
+  TEST_ASSERT_EQUAL(1, getDedupStats().replaced);
+
+  // Erst nach der Haltezeit fällig, dann mit dem besten RSSI
+  TEST_ASSERT_NULL(dedupPeekDue(start + HOLD_MS - 1));
+  const LoRaRxPacket* due = dedupPeekDue(start + HOLD_MS);
+  TEST_ASSERT_NOT_NULL(due);
+  TEST_ASSERT_EQUAL(-80, due->rssi);
+  dedupReleaseDue();
+  TEST_ASSERT_NULL(dedupPeekDue(start + HOLD_MS));
+
+  // Sind alle Halteplätze belegt, wird ein neues Paket sofort publiziert
+  for (uint8_t i = 0; i < LORA_DEDUP_HOLD_SLOTS; i++) {
+    TEST_ASSERT_EQUAL(DEDUP_HELD, filter(30 + i, start + HOLD_MS));
+  }
+  TEST_ASSERT_EQUAL(DEDUP_PASS, filter(40, start + HOLD_MS));
+  for (uint8_t i = 0; i < LORA_DEDUP_HOLD_SLOTS; i++) {
+    TEST_ASSERT_NOT_NULL(dedupPeekDue(start + 2 * HOLD_MS));
+    dedupReleaseDue();
+  }
+}
+
+void test_flooded_copies_publish_once_with_best_rssi() {
+  configure(DEDUP_BEST);
+  const uint8_t payload[20] = {0xA5, 1, 2, 3};
+  uint64_t start = simNow() + 1000;
+  const int16_t rssi[] = {-110, -75, -95};
+  for (uint8_t i = 0; i < 3; i++) {
+    simRadioInjectPacket(start + i * 60000, payload, sizeof(payload), rssi[i], 5.0f, 0.0f);
+  }
+  runLoop(1000000);
+
+  TEST_ASSERT_EQUAL(1, rxLines.size());
+  TEST_ASSERT_TRUE(rxLines[0].find("\"rssi\":-75") != std::string::npos);
+  TEST_ASSERT_EQUAL(2, getDedupStats().hits);
+}
+
+int main(int argc, char** argv) {
+  simSerialSetLineHandler(onLine);
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_copies_inside_window_are_dropped);
+  RUN_TEST(test_expired_entry_does_not_break_probe_chain);
+  RUN_TEST(test_full_probe_range_evicts_oldest);
+  RUN_TEST(test_best_mode_holds_copy_with_best_rssi);
+  RUN_TEST(test_flooded_copies_publish_once_with_best_rssi);
+  return UNITY_END();
+}
@@ -0,0 +1,126 @@
+// Sendedauer-Tabellen und Duty-Cycle-Begrenzung: Tabellenwerte gegen die Semtech-Formel,
+// Auffüllen des Budgets in virtueller Zeit, Zurückstellen und Ablehnen in der Sendewarteschlange.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+
+#include "SimCore.h"
+#include "0_config.h"
+#include "airtime.h"
+#include "lora.h"
+
+void setup();
+void loop();
+
+extern SX1262 radio;
+
+// Budgetzuwachs je Millisekunde in µs
+static const uint32_t REFILL_US_PER_MS = LORA_DUTY_CYCLE_PERCENT * 10UL;
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+// Leert das Budget bis auf 'left_us'
+static void drainBudgetTo(uint32_t left_us) {
+  uint32_t budget = getDutyCycleBudgetMicros();
+  TEST_ASSERT_GREATER_OR_EQUAL(left_us, budget);
+  TEST_ASSERT_TRUE(consumeDutyCycleBudget(budget - left_us));
+}
+
+void setUp() {
+  runLoop(100000);
+}
+
+void tearDown() {
+  // Volles Budget für den nächsten Test
+  simAdvance((uint64_t)getDutyCycleCapacityMicros() / REFILL_US_PER_MS * 1000);
+}
+
+void test_airtime_table_matches_formula() {
+  // Aktuelle Parameter: Tabelle gegen die Fließkommaformel des simulierten Moduls
+  for (uint16_t len = 1; len < 256; len++) {
+    uint32_t expected = radio.getTimeOnAir(len);
+    uint32_t actual = getAirtimeMicros((uint8_t)len);
+    TEST_ASSERT_TRUE_MESSAGE(actual + 1 >= expected && actual <= expected + 1, "Sendedauer weicht ab");
+  }
+}
+
+void test_budget_refills_over_time() {
+  TEST_ASSERT_EQUAL((uint32_t)LORA_DUTY_CYCLE_PERCENT * LORA_DUTY_CYCLE_WINDOW_S * 10000UL,
+                    getDutyCycleCapacityMicros());
+  drainBudgetTo(1000);
+
+  // 5000 µs benötigt, 1000 µs vorhanden: bei 10 % sind das 40 ms Wartezeit (4000 µs / 100 µs je ms)
+  TEST_ASSERT_EQUAL(0, getDutyCycleWaitMillis(1000, 0));
+  TEST_ASSERT_EQUAL((5000 - 1000 + REFILL_US_PER_MS - 1) / REFILL_US_PER_MS, getDutyCycleWaitMillis(5000, 0));
+  // Bereits eingereihte Sendedauer zählt mit
+  TEST_ASSERT_EQUAL((5000 + 2000 - 1000) / REFILL_US_PER_MS, getDutyCycleWaitMillis(5000, 2000));
+
+  TEST_ASSERT_FALSE(consumeDutyCycleBudget(5000));
+  simAdvance(((5000 - 1000) / REFILL_US_PER_MS) * 1000);
+  TEST_ASSERT_TRUE(consumeDutyCycleBudget(5000));
+  TEST_ASSERT_EQUAL(0, getDutyCycleBudgetMicros());
+
+  // Das Budget wächst nie über die Kapazität
+  simAdvance((uint64_t)LORA_DUTY_CYCLE_WINDOW_S * 2 * 1000000ULL);
+  TEST_ASSERT_EQUAL(getDutyCycleCapacityMicros(), getDutyCycleBudgetMicros());
+}
+
+void test_queue_defers_then_transmits() {
+  const uint8_t payload[32] = {0};
+  uint32_t airtime = getAirtimeMicros(sizeof(payload));
+  uint32_t sentBefore = simRadioGetStats().transmitted;
+  DutyCycleStats before = getDutyCycleStats();
+
+  // Halbe Sendedauer vorhanden: Auftrag wird angenommen, aber zurückgestellt
+  drainBudgetTo(airtime / 2);
+  uint16_t id = 0;
+  TEST_ASSERT_EQUAL_STRING("", queueLoRaPacket(payload, sizeof(payload), id).c_str());
+  TEST_ASSERT_EQUAL(before.deferred + 1, getDutyCycleStats().deferred);
+  runLoop(10000);
+  TEST_ASSERT_EQUAL(sentBefore, simRadioGetStats().transmitted);
+
+  // Nach der Wartezeit geht er hinaus
+  uint32_t wait_ms = (airtime - airtime / 2 + REFILL_US_PER_MS - 1) / REFILL_US_PER_MS;
+  runLoop((uint64_t)wait_ms * 1000 + airtime + 50000);
+  TEST_ASSERT_EQUAL(sentBefore + 1, simRadioGetStats().transmitted);
+}
+
+// Ändert die Tabellen, deshalb als letzter Test
+void test_known_airtimes_and_rejection() {
+  // SF7/125 kHz/CR 4/5, 8 Präambelsymbole, 10 Bytes: 41.216 ms (Semtech-Rechner)
+  rebuildAirtimeTables(125.0f, 7, 5, 8);
+  TEST_ASSERT_EQUAL(41216, getAirtimeMicros(10));
+
+  // SF12/125 kHz mit Low-Data-Rate-Optimierung: 1318.912 ms für 20 Bytes
+  rebuildAirtimeTables(125.0f, 12, 5, 8);
+  TEST_ASSERT_EQUAL(1318912, getAirtimeMicros(20));
+
+  // 255 Bytes bei SF12 brauchen mehr als LORA_DUTY_CYCLE_MAX_DEFER_MS Budgetzuwachs: abgelehnt
+  const uint8_t payload[255] = {0};
+  uint32_t airtime = getAirtimeMicros(sizeof(payload));
+  TEST_ASSERT_GREATER_THAN(LORA_DUTY_CYCLE_MAX_DEFER_MS * REFILL_US_PER_MS, airtime);
+  drainBudgetTo(0);
+  DutyCycleStats before = getDutyCycleStats();
+  uint16_t id = 0;
+  TEST_ASSERT_TRUE(queueLoRaPacket(payload, sizeof(payload), id).length() > 0);
+  TEST_ASSERT_EQUAL(before.rejected + 1, getDutyCycleStats().rejected);
+  TEST_ASSERT_EQUAL(0, getLoRaTxQueueCount());
+}
+
+int main(int argc, char** argv) {
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_airtime_table_matches_formula);
+  RUN_TEST(test_budget_refills_over_time);
+  RUN_TEST(test_queue_defers_then_transmits);
+  RUN_TEST(test_known_airtimes_and_rejection);
+  return UNITY_END();
+}
@@ -0,0 +1,87 @@
+// Hilfe: Jeder Befehl kommt als eigener Datensatz, keiner wird wegen der Größe der
+// seriellen Ausgabe (SERIAL_OUT_BUFFER_SIZE) verworfen.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <string>
+#include <vector>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "0_config.h"
+#include "serialout.h"
+
+void setup();
+void loop();
+
+static std::vector<std::string> logLines;
+
+static void onLine(const std::string& line, uint64_t) {
+  if (line.find("\"type\":\"log\"") != std::string::npos) {
+    logLines.push_back(line);
+  }
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+static bool anyLineContains(const char* text) {
+  for (const std::string& line : logLines) {
+    if (line.find(text) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void setUp() {
+  runLoop(200000); // Startmeldungen vollständig ausgeben
+  logLines.clear();
+}
+
+void tearDown() {}
+
+void test_help_is_published_one_record_per_command() {
+  uint32_t droppedBefore = getSerialOutputStats().droppedRecords;
+
+  simSerialInject(simNow(), "help");
+  runLoop(2000000);
+
+  // Einleitung plus mindestens eine Zeile je Befehl
+  TEST_ASSERT_GREATER_THAN(20, logLines.size());
+  TEST_ASSERT_TRUE(logLines[0].find("Hilfe") != std::string::npos);
+  TEST_ASSERT_TRUE(anyLineContains("'sendLora'"));
+  TEST_ASSERT_TRUE(anyLineContains("'setLoraConfig'"));
+  TEST_ASSERT_TRUE(anyLineContains(("Blockübertragung bis " + std::to_string(LORA_BULK_BUFFER_SIZE) + " Bytes").c_str()));
+  for (const std::string& line : logLines) {
+    TEST_ASSERT_LESS_THAN(SERIAL_OUT_BUFFER_SIZE / 2, line.size());
+  }
+  TEST_ASSERT_EQUAL(droppedBefore, getSerialOutputStats().droppedRecords);
+}
+
+void test_help_can_be_repeated() {
+  simSerialInject(simNow(), "HELP");
+  runLoop(2000000);
+  size_t first = logLines.size();
+  TEST_ASSERT_GREATER_THAN(20, first);
+
+  logLines.clear();
+  simSerialInject(simNow(), "help");
+  runLoop(2000000);
+  TEST_ASSERT_EQUAL(first, logLines.size());
+}
+
+int main(int argc, char** argv) {
+  simSerialSetLineHandler(onLine);
+  setup();
+  UNITY_BEGIN();
+  RUN_TEST(test_help_is_published_one_record_per_command);
+  RUN_TEST(test_help_can_be_repeated);
+  return UNITY_END();
+}
@@ -0,0 +1,178 @@
+// Befehlseingabe: Heap-Allokationen und Zyklen pro Befehl beim Zusammensetzen der Zeile,
+// fester Zeilenpuffer (handleJsonInput) gegen den früheren Weg mit 'String += c'.
+// Gemessen wird jeweils bis vor die Deserialisierung, die bei beiden Wegen gleich ist.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <chrono>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <x86intrin.h>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "0_config.h"
+#include "interface.h"
+
+void setup();
+void loop();
+
+static const int BENCH_COMMANDS = 200;
+
+// Zählt alle Allokationen, solange 'countAllocations' gesetzt ist
+static bool countAllocations = false;
+static uint32_t allocations = 0;
+
+void* operator new(size_t size) {
+  if (countAllocations) {
+    allocations++;
+  }
+  void* p = malloc(size ? size : 1);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static uint64_t hostCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// Ein typischer sendlora-Befehl mit gemischter Groß-/Kleinschreibung und Base64-Payload
+static std::string commandLine() {
+  std::string payload;
+  for (int i = 0; i < 160; i++) {
+    payload += "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[(i * 37) % 64];
+  }
+  return "{\"Command\":{\"Type\":\"sendLora\",\"sendLora\":{\"payload\":\"" + payload + "\"}}}";
+}
+
+// Nachbildung des früheren handleJsonInput() bis vor deserializeJson()
+static String legacyInputBuffer;
+
+static bool legacyHandleJsonInput() {
+  while (Serial.available()) {
+    char c = Serial.read();
+    Serial.write(c);
+    if (c == '\n' || c == '\r') {
+      if (legacyInputBuffer.length() > 0) {
+        Serial.println();
+        legacyInputBuffer.toLowerCase();
+        return true;
+      }
+    } else {
+      legacyInputBuffer += c;
+    }
+  }
+  return false;
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+// Lässt die Bytes vollständig im UART-Empfangspuffer ankommen
+static void deliver(const std::string& bytes) {
+  simSerialInjectRaw(simNow(), bytes);
+  simAdvance((bytes.size() + 2) * 100);
+}
+
+void setUp() {
+  runLoop(100000);
+}
+
+void tearDown() {}
+
+void test_fixed_line_buffer_does_not_allocate() {
+  std::string line = commandLine();
+  uint32_t totalAllocations = 0;
+  uint64_t cycles = 0;
+  uint64_t ns = 0;
+
+  for (int i = 0; i < BENCH_COMMANDS; i++) {
+    deliver(line);
+    allocations = 0;
+    countAllocations = true;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t c0 = hostCycles();
+    handleJsonInput();
+    uint64_t c1 = hostCycles();
+    ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    countAllocations = false;
+    cycles += c1 - c0;
+    totalAllocations += allocations;
+
+    // Zeilenende nachreichen und den Befehl ungemessen abarbeiten lassen
+    deliver("\n");
+    runLoop(20000);
+  }
+
+  char msg[160];
+  snprintf(msg, sizeof(msg), "Zeilenpuffer: %u Allokationen, %llu Zyklen, %llu ns pro Befehl (%u Bytes)",
+           (unsigned)(totalAllocations / BENCH_COMMANDS), (unsigned long long)(cycles / BENCH_COMMANDS),
+           (unsigned long long)(ns / BENCH_COMMANDS), (unsigned)line.size());
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL(0, totalAllocations);
+}
+
+void test_legacy_string_path_allocates_and_lowercases_payload() {
+  std::string line = commandLine();
+  uint32_t firstAllocations = 0;
+  uint64_t cycles = 0;
+  uint64_t ns = 0;
+
+  for (int i = 0; i < BENCH_COMMANDS; i++) {
+    // Jeder Befehl beginnt mit leerem Puffer wie direkt nach dem Start; danach
+    // behielte der String seine Kapazität bis zur nächsten längeren Zeile
+    legacyInputBuffer = String();
+    deliver(line + "\n");
+    allocations = 0;
+    countAllocations = true;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t c0 = hostCycles();
+    bool complete = legacyHandleJsonInput();
+    uint64_t c1 = hostCycles();
+    ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    countAllocations = false;
+    TEST_ASSERT_TRUE(complete);
+    cycles += c1 - c0;
+    if (i == 0) {
+      firstAllocations = allocations;
+    }
+    runLoop(100000); // Echo aus dem UART-Sendepuffer abfließen lassen
+  }
+
+  char msg[160];
+  snprintf(msg, sizeof(msg), "String-Pfad: %u Allokationen, %llu Zyklen, %llu ns pro Befehl (%u Bytes)",
+           (unsigned)firstAllocations, (unsigned long long)(cycles / BENCH_COMMANDS),
+           (unsigned long long)(ns / BENCH_COMMANDS), (unsigned)line.size());
+  TEST_MESSAGE(msg);
+  // Der Host-String wächst geometrisch; der Arduino-String reserviert bei jedem
+  // Überschreiten der Kapazität neu, auf dem Gerät sind es also eher mehr
+  TEST_ASSERT_GREATER_THAN(0, firstAllocations);
+
+  // toLowerCase() verfälscht den Base64-Payload
+  TEST_ASSERT_TRUE(std::string(legacyInputBuffer.c_str()) != line);
+}
+
+int main(int argc, char** argv) {
+  setup();
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_line_buffer_does_not_allocate);
+  RUN_TEST(test_legacy_string_path_allocates_and_lowercases_payload);
+  return UNITY_END();
+}
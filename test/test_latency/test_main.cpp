@@ -0,0 +1,93 @@
+// Latenzmessung: Verbuchung je Abschnitt (min/avg/max, log2-Histogramm, Zählerüberlauf)
+// und die Messpunkte auf Empfangs- und Sendepfad in der Simulation (siehe latency.h).
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "latency.h"
+
+void setup();
+void loop();
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+void setUp() {
+  runLoop(100000);
+  resetLatencyStats();
+}
+
+void tearDown() {}
+
+void test_span_bookkeeping() {
+  latencyRecordSpan(LAT_RX_ENCODE, 1000, 1100);   // 100 Zyklen -> Klasse 7
+  latencyRecordSpan(LAT_RX_ENCODE, 5000, 5300);   // 300 Zyklen -> Klasse 9
+  latencyRecordSpan(LAT_RX_ENCODE, 0xFFFFFF00, 0x40); // Überlauf: 320 Zyklen -> Klasse 9
+
+  const LatencyStageStats& s = getLatencyStageStats(LAT_RX_ENCODE);
+  TEST_ASSERT_EQUAL(3, s.count);
+  TEST_ASSERT_EQUAL(100, s.min);
+  TEST_ASSERT_EQUAL(320, s.max);
+  TEST_ASSERT_EQUAL(720, (uint32_t)s.sum);
+  TEST_ASSERT_EQUAL(1, s.histogram[7]);
+  TEST_ASSERT_EQUAL(2, s.histogram[9]);
+
+  resetLatencyStats();
+  TEST_ASSERT_EQUAL(0, getLatencyStageStats(LAT_RX_ENCODE).count);
+  TEST_ASSERT_EQUAL(0, getLatencyStageStats(LAT_RX_ENCODE).histogram[9]);
+}
+
+void test_rx_path_stages_are_recorded() {
+  const uint8_t payload[24] = {1, 2, 3};
+  simRadioInjectPacket(simNow() + 1000, payload, sizeof(payload), -90, 5.0f, 0.0f);
+  runLoop(200000);
+
+  for (uint8_t stage = LAT_RX_READ; stage <= LAT_RX_TOTAL; stage++) {
+    TEST_ASSERT_EQUAL_MESSAGE(1, getLatencyStageStats(stage).count, latencyStageName(stage));
+  }
+  // Die Gesamtspanne umfasst alle Teilabschnitte; die Umschaltzeit überlappt mit ihnen
+  uint64_t parts = 0;
+  for (uint8_t stage = LAT_RX_READ; stage <= LAT_RX_SERIAL; stage++) {
+    if (stage != LAT_RX_TURNAROUND) {
+      parts += getLatencyStageStats(stage).sum;
+    }
+  }
+  TEST_ASSERT_EQUAL((uint32_t)parts, (uint32_t)getLatencyStageStats(LAT_RX_TOTAL).sum);
+  // Das Auslesen kostet simulierte SPI-Zeit
+  TEST_ASSERT_GREATER_THAN(0, getLatencyStageStats(LAT_RX_READ).min);
+  TEST_ASSERT_GREATER_OR_EQUAL(getLatencyStageStats(LAT_RX_READ).min, getLatencyStageStats(LAT_RX_TURNAROUND).min);
+}
+
+void test_tx_path_stages_are_recorded() {
+  SimRadioStats before = simRadioGetStats();
+  simSerialInject(simNow(), "{\"command\":{\"type\":\"sendlora\",\"sendlora\":{\"payload\":\"AAECAwQFBgc=\"}}}");
+  runLoop(1000000);
+
+  TEST_ASSERT_EQUAL(1, getLatencyStageStats(LAT_CMD_PARSE).count);
+  TEST_ASSERT_EQUAL(1, getLatencyStageStats(LAT_CMD_TX_START).count);
+  TEST_ASSERT_EQUAL(1, getLatencyStageStats(LAT_TX_AIRTIME).count);
+  TEST_ASSERT_LESS_OR_EQUAL(getLatencyStageStats(LAT_CMD_TX_START).min, getLatencyStageStats(LAT_CMD_PARSE).max);
+
+  // Sendedauer im Rahmen der simulierten Time-on-Air (auf 1 ms genau)
+  uint32_t airtime_us = getLatencyStageStats(LAT_TX_AIRTIME).max / (SystemCoreClock / 1000000UL);
+  uint32_t expected_us = (uint32_t)(simRadioGetStats().txAirtime_us - before.txAirtime_us);
+  TEST_ASSERT_UINT32_WITHIN(1000, expected_us, airtime_us);
+}
+
+int main(int argc, char** argv) {
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_span_bookkeeping);
+  RUN_TEST(test_rx_path_stages_are_recorded);
+  RUN_TEST(test_tx_path_stages_are_recorded);
+  return UNITY_END();
+}
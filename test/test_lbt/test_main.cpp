@@ -0,0 +1,108 @@
+// Listen-before-talk: Bei belegtem Kanal wird das Senden bis zum Freiwerden verschoben,
+// bei dauerhaft belegtem Kanal nach LORA_LBT_MAX_RETRIES Prüfungen verworfen.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+
+#include "SimCore.h"
+#include "0_config.h"
+#include "lora.h"
+
+void setup();
+void loop();
+
+static uint32_t txStarts = 0;
+static uint64_t lastTxStart_us = 0;
+
+static void onTxStart(uint64_t at_us, const uint8_t*, size_t) {
+  txStarts++;
+  lastTxStart_us = at_us;
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+static void queuePacket() {
+  const uint8_t payload[16] = {0x42};
+  uint16_t id = 0;
+  TEST_ASSERT_EQUAL_STRING("", queueLoRaPacket(payload, sizeof(payload), id).c_str());
+}
+
+void setUp() {
+  runLoop(100000);
+  txStarts = 0;
+  setLoRaLbtEnabled(true);
+}
+
+void tearDown() {
+  setLoRaLbtEnabled(LORA_LBT_ENABLED_DEFAULT);
+  runLoop(2000000);
+}
+
+void test_free_channel_transmits_after_one_cad() {
+  LoRaLbtStats before = getLoRaLbtStats();
+  queuePacket();
+  runLoop(1000000);
+  TEST_ASSERT_EQUAL(1, txStarts);
+  TEST_ASSERT_EQUAL(before.cadRuns + 1, getLoRaLbtStats().cadRuns);
+  TEST_ASSERT_EQUAL(before.cadBusy, getLoRaLbtStats().cadBusy);
+}
+
+void test_busy_channel_defers_until_free() {
+  LoRaLbtStats before = getLoRaLbtStats();
+  uint64_t busyEnd = simNow() + 300000;
+  simRadioAddBusy(simNow(), busyEnd);
+  queuePacket();
+  runLoop(3000000);
+
+  TEST_ASSERT_EQUAL(1, txStarts);
+  TEST_ASSERT_GREATER_OR_EQUAL(busyEnd, lastTxStart_us);
+  LoRaLbtStats after = getLoRaLbtStats();
+  TEST_ASSERT_GREATER_THAN(before.cadBusy, after.cadBusy);
+  TEST_ASSERT_GREATER_THAN(before.backoff_ms, after.backoff_ms);
+  TEST_ASSERT_EQUAL(before.dropped, after.dropped);
+}
+
+void test_permanently_busy_channel_drops_after_retry_cap() {
+  LoRaLbtStats before = getLoRaLbtStats();
+  simRadioAddBusy(simNow(), simNow() + 120000000ULL);
+  queuePacket();
+  runLoop(30000000);
+
+  TEST_ASSERT_EQUAL(0, txStarts);
+  LoRaLbtStats after = getLoRaLbtStats();
+  TEST_ASSERT_EQUAL(before.dropped + 1, after.dropped);
+  // Erste Prüfung plus LORA_LBT_MAX_RETRIES Wiederholungen
+  TEST_ASSERT_EQUAL(before.cadBusy + LORA_LBT_MAX_RETRIES + 1, after.cadBusy);
+  TEST_ASSERT_EQUAL(0, getLoRaTxQueueCount());
+}
+
+void test_disabled_lbt_ignores_busy_channel() {
+  setLoRaLbtEnabled(false);
+  LoRaLbtStats before = getLoRaLbtStats();
+  simRadioAddBusy(simNow(), simNow() + 1000000);
+  uint64_t queued = simNow();
+  queuePacket();
+  runLoop(100000);
+  TEST_ASSERT_EQUAL(1, txStarts);
+  TEST_ASSERT_LESS_THAN(queued + 100000, lastTxStart_us);
+  TEST_ASSERT_EQUAL(before.cadRuns, getLoRaLbtStats().cadRuns);
+}
+
+int main(int argc, char** argv) {
+  simRadioSetTxStartHandler(onTxStart);
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_free_channel_transmits_after_one_cad);
+  RUN_TEST(test_busy_channel_defers_until_free);
+  RUN_TEST(test_permanently_busy_channel_drops_after_retry_cap);
+  RUN_TEST(test_disabled_lbt_ignores_busy_channel);
+  return UNITY_END();
+}
@@ -0,0 +1,101 @@
+// Rauchtest der nativen Umgebung: ein Paket aus dem simulierten SX1262 erscheint als
+// lora_rx-Zeile am simulierten UART, ein sendlora-Befehl des Hosts startet eine Übertragung.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <string>
+#include <vector>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+
+void setup();
+void loop();
+
+static std::vector<std::string> rxLines;
+static uint64_t lastRxLineDone_us = 0;
+
+static uint32_t txStarts = 0;
+static size_t lastTxLen = 0;
+static uint64_t lastTxStart_us = 0;
+
+static void onLine(const std::string& line, uint64_t done_us) {
+  if (line.find("\"type\":\"lora_rx\"") != std::string::npos) {
+    rxLines.push_back(line);
+    lastRxLineDone_us = done_us;
+  }
+}
+
+static void onTxStart(uint64_t at_us, const uint8_t*, size_t len) {
+  txStarts++;
+  lastTxLen = len;
+  lastTxStart_us = at_us;
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+void setUp() {
+  runLoop(100000);
+  rxLines.clear();
+  txStarts = 0;
+}
+
+void tearDown() {}
+
+void test_received_packet_reaches_host() {
+  const uint8_t payload[] = {'h', 'e', 'l', 'l', 'o'};
+  SimRadioStats before = simRadioGetStats();
+  uint64_t rxDone = simNow() + 1000;
+  simRadioInjectPacket(rxDone, payload, sizeof(payload), -80, 7.5f, 0.0f);
+  runLoop(100000);
+
+  SimRadioStats after = simRadioGetStats();
+  TEST_ASSERT_EQUAL(before.delivered + 1, after.delivered);
+  TEST_ASSERT_EQUAL(before.readOut + 1, after.readOut);
+  TEST_ASSERT_EQUAL(1, rxLines.size());
+  TEST_ASSERT_TRUE(rxLines[0].find("aGVsbG8=") != std::string::npos);
+  // Die Zeile ist frühestens nach ihrer Übertragungszeit bei 115200 Baud (8N1) beim Host
+  uint64_t lineTime_us = (rxLines[0].size() + 1) * (10000000ULL / 115200);
+  TEST_ASSERT_GREATER_OR_EQUAL(rxDone + lineTime_us, lastRxLineDone_us);
+}
+
+void test_packet_with_crc_error_is_not_published() {
+  const uint8_t payload[8] = {0};
+  simRadioInjectPacket(simNow() + 1000, payload, sizeof(payload), -80, 7.5f, 0.0f, false);
+  runLoop(100000);
+  TEST_ASSERT_EQUAL(0, rxLines.size());
+}
+
+void test_sendlora_command_starts_transmission() {
+  SimRadioStats before = simRadioGetStats();
+  uint64_t sent = simNow();
+  simSerialInject(sent, "{\"command\":{\"type\":\"sendlora\",\"sendlora\":{\"payload\":\"aGVsbG8=\"}}}");
+  runLoop(1000000);
+
+  TEST_ASSERT_EQUAL(1, txStarts);
+  TEST_ASSERT_EQUAL(5, lastTxLen);
+  TEST_ASSERT_GREATER_THAN(sent, lastTxStart_us);
+  TEST_ASSERT_EQUAL(before.transmitted + 1, simRadioGetStats().transmitted);
+
+  // Während der Übertragung empfängt das Modul nicht
+  TEST_ASSERT_GREATER_THAN(before.rxBlind_us, simRadioGetStats().rxBlind_us);
+}
+
+int main(int argc, char** argv) {
+  simSerialSetLineHandler(onLine);
+  simRadioSetTxStartHandler(onTxStart);
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_received_packet_reaches_host);
+  RUN_TEST(test_packet_with_crc_error_is_not_published);
+  RUN_TEST(test_sendlora_command_starts_transmission);
+  return UNITY_END();
+}
@@ -0,0 +1,108 @@
+// Repeater: Wenige Warteplätze (LORA_REPEATER_SLOTS); weitere Pakete zählen als Überlauf,
+// eine während der Wartezeit gehörte Kopie bricht das Weitersenden ab.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+
+#include "SimCore.h"
+#include "0_config.h"
+#include "repeater.h"
+
+void setup();
+void loop();
+
+static uint32_t txStarts = 0;
+
+static void onTxStart(uint64_t, const uint8_t*, size_t) {
+  txStarts++;
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+// Paket mit Kennung 'tag' und TTL im unteren Nibble von Byte 1
+static void inject(uint64_t end_us, uint8_t ttl, uint8_t tag) {
+  uint8_t payload[8] = {0xA5, ttl, tag, 0, 0, 0, 0, 0};
+  simRadioInjectPacket(end_us, payload, sizeof(payload), -90, 5.0f, 0.0f);
+}
+
+static void configure(uint16_t delay_ms) {
+  RepeaterSettings s = getRepeaterSettings();
+  s.enabled = true;
+  s.delayMin_ms = delay_ms;
+  s.delayMax_ms = delay_ms;
+  s.hopMode = REPEATER_HOP_TTL;
+  s.hopOffset = 1;
+  s.hopMask = 0x07;
+  setRepeaterSettings(s);
+}
+
+void setUp() {
+  runLoop(3000000);
+  resetRepeaterStats();
+  txStarts = 0;
+}
+
+void tearDown() {
+  RepeaterSettings s = getRepeaterSettings();
+  s.enabled = false;
+  setRepeaterSettings(s);
+}
+
+void test_burst_beyond_slots_counts_overflow() {
+  configure(1000);
+  uint64_t start = simNow() + 100000;
+  for (uint8_t i = 0; i < LORA_REPEATER_SLOTS + 2; i++) {
+    inject(start + i * 60000, 3, 10 + i);
+  }
+  runLoop(400000);
+  TEST_ASSERT_EQUAL(LORA_REPEATER_SLOTS, getRepeaterPending());
+
+  runLoop(5000000);
+  RepeaterStats stats = getRepeaterStats();
+  TEST_ASSERT_EQUAL(LORA_REPEATER_SLOTS, stats.forwarded);
+  TEST_ASSERT_EQUAL(2, stats.overflow);
+  TEST_ASSERT_EQUAL(LORA_REPEATER_SLOTS, txStarts);
+  TEST_ASSERT_EQUAL(0, getRepeaterPending());
+}
+
+void test_copy_during_wait_cancels_forwarding() {
+  configure(300);
+  uint64_t start = simNow() + 100000;
+  inject(start, 3, 40);
+  inject(start + 100000, 2, 40); // Kopie eines anderen Repeaters mit verringerter TTL
+  runLoop(3000000);
+
+  RepeaterStats stats = getRepeaterStats();
+  TEST_ASSERT_EQUAL(1, stats.cancelled);
+  TEST_ASSERT_EQUAL(0, stats.forwarded);
+  TEST_ASSERT_EQUAL(0, txStarts);
+}
+
+void test_forwarding_latency_counts_from_rx_done() {
+  configure(200);
+  inject(simNow() + 100000, 3, 50);
+  runLoop(3000000);
+
+  RepeaterStats stats = getRepeaterStats();
+  TEST_ASSERT_EQUAL(1, stats.forwarded);
+  // Wartezeit plus Vorlauf des Sendebeginns, keine Auslese-Verzögerung obendrauf
+  TEST_ASSERT_GREATER_OR_EQUAL(200000, stats.minLatency_us);
+  TEST_ASSERT_LESS_THAN(205000, stats.maxLatency_us);
+}
+
+int main(int argc, char** argv) {
+  simRadioSetTxStartHandler(onTxStart);
+  setup();
+  UNITY_BEGIN();
+  RUN_TEST(test_burst_beyond_slots_counts_overflow);
+  RUN_TEST(test_copy_during_wait_cancels_forwarding);
+  RUN_TEST(test_forwarding_latency_counts_from_rx_done);
+  return UNITY_END();
+}
@@ -0,0 +1,77 @@
+// Empfangspegel: Das SX1262 meldet RSSI in halben dB; 'rssi'/'signalRssi' in lora_rx
+// werden auf ganze dB gerundet statt abgeschnitten.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <stdlib.h>
+#include <string>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+
+void setup();
+void loop();
+
+static std::string lastRx;
+
+static void onLine(const std::string& line, uint64_t) {
+  if (line.find("\"type\":\"lora_rx\"") != std::string::npos) {
+    lastRx = line;
+  }
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+// Liest ein ganzzahliges Feld aus der letzten lora_rx-Zeile; fehlt es, gilt 'fallback'
+static long field(const char* name, long fallback) {
+  std::string key = std::string("\"") + name + "\":";
+  size_t pos = lastRx.find(key);
+  return pos == std::string::npos ? fallback : strtol(lastRx.c_str() + pos + key.size(), nullptr, 10);
+}
+
+static void receive(int16_t rssi, float snr) {
+  static const uint8_t payload[] = {0x01, 0x02, 0x03, 0x04};
+  lastRx.clear();
+  simRadioInjectPacket(simNow() + 1000, payload, sizeof(payload), rssi, snr, 0.0f);
+  runLoop(200000);
+  TEST_ASSERT_FALSE(lastRx.empty());
+}
+
+void setUp() {
+  runLoop(100000);
+}
+
+void tearDown() {}
+
+void test_whole_db_rssi_is_exact() {
+  receive(-90, 5.0f);
+  TEST_ASSERT_EQUAL(-90, field("rssi", 0));
+  TEST_ASSERT_EQUAL(-90, field("signalRssi", -90));
+}
+
+void test_half_db_signal_rssi_is_rounded() {
+  // Signal-RSSI = RSSI + SNR = -115.5 dBm, abgeschnitten wären es -115
+  receive(-110, -5.5f);
+  TEST_ASSERT_EQUAL(-110, field("rssi", 0));
+  TEST_ASSERT_EQUAL(-116, field("signalRssi", 0));
+
+  // -112.5 dBm
+  receive(-108, -4.5f);
+  TEST_ASSERT_EQUAL(-113, field("signalRssi", 0));
+}
+
+int main(int argc, char** argv) {
+  simSerialSetLineHandler(onLine);
+  setup();
+  UNITY_BEGIN();
+  RUN_TEST(test_whole_db_rssi_is_exact);
+  RUN_TEST(test_half_db_signal_rssi_is_rounded);
+  return UNITY_END();
+}
@@ -0,0 +1,104 @@
+// Empfangspfad: Bursts direkt hintereinander, während die Hauptschleife nicht läuft.
+// Bis zur Tiefe des Ringpuffers darf kein Paket verloren gehen (siehe rxbuffer.h).
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <string>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "0_config.h"
+#include "rxbuffer.h"
+
+void setup();
+void loop();
+
+static uint32_t rxLines = 0;
+
+static void onLine(const std::string& line, uint64_t) {
+  if (line.find("\"type\":\"lora_rx\"") != std::string::npos) {
+    rxLines++;
+  }
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+// Spielt 'count' unterschiedliche Pakete im Abstand von 'gap_us' ein und lässt nur die
+// Simulation (DIO1-Interrupt) laufen, nicht die Hauptschleife
+static void injectBurst(uint8_t count, uint64_t gap_us) {
+  uint64_t start = simNow() + 1000;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t payload[32];
+    for (uint8_t j = 0; j < sizeof(payload); j++) {
+      payload[j] = i * 31 + j;
+    }
+    simRadioInjectPacket(start + i * gap_us, payload, sizeof(payload), -90, 5.0f, 0.0f);
+  }
+  simAdvance(1000 + count * gap_us + 1000);
+}
+
+void setUp() {
+  runLoop(200000); // Vorherige Pakete vollständig ausgeben
+  resetRxBufferStats();
+  rxLines = 0;
+}
+
+void tearDown() {}
+
+void test_burst_up_to_ring_depth_is_lossless() {
+  injectBurst(LORA_RX_RING_SIZE, 2000);
+  TEST_ASSERT_EQUAL(LORA_RX_RING_SIZE, rxBufferCount());
+
+  runLoop(2000000);
+  LoRaRxStats stats = getRxBufferStats();
+  TEST_ASSERT_EQUAL(LORA_RX_RING_SIZE, stats.received);
+  TEST_ASSERT_EQUAL(0, stats.overruns);
+  TEST_ASSERT_EQUAL(0, stats.dropped);
+  TEST_ASSERT_EQUAL(LORA_RX_RING_SIZE, stats.highWater);
+  TEST_ASSERT_EQUAL(LORA_RX_RING_SIZE, rxLines);
+  TEST_ASSERT_EQUAL(0, simRadioGetStats().overwritten);
+}
+
+void test_burst_beyond_ring_depth_counts_overruns() {
+  injectBurst(LORA_RX_RING_SIZE + 3, 2000);
+
+  runLoop(2000000);
+  LoRaRxStats stats = getRxBufferStats();
+  TEST_ASSERT_EQUAL(LORA_RX_RING_SIZE, stats.received);
+  TEST_ASSERT_EQUAL(3, stats.overruns);
+  TEST_ASSERT_EQUAL(LORA_RX_RING_SIZE, rxLines);
+}
+
+void test_continuous_traffic_with_running_loop_is_lossless() {
+  // Die Hauptschleife leert den Ring, während weiter Pakete eintreffen
+  const uint8_t count = 4 * LORA_RX_RING_SIZE;
+  uint64_t start = simNow() + 1000;
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t payload[16] = {i};
+    simRadioInjectPacket(start + i * 20000ULL, payload, sizeof(payload), -100, 2.0f, 0.0f);
+  }
+  runLoop(count * 20000ULL + 2000000);
+
+  LoRaRxStats stats = getRxBufferStats();
+  TEST_ASSERT_EQUAL(count, stats.received);
+  TEST_ASSERT_EQUAL(0, stats.overruns);
+  TEST_ASSERT_EQUAL(count, rxLines);
+}
+
+int main(int argc, char** argv) {
+  simSerialSetLineHandler(onLine);
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_burst_up_to_ring_depth_is_lossless);
+  RUN_TEST(test_burst_beyond_ring_depth_counts_overruns);
+  RUN_TEST(test_continuous_traffic_with_running_loop_is_lossless);
+  return UNITY_END();
+}
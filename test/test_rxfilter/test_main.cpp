@@ -0,0 +1,161 @@
+// Empfangsfilter: maskierte MATCH-/DENY-Vergleiche, Positivliste aus MATCH-Regeln,
+// Schwellwerte und Trefferzähler je Regel (siehe rxfilter.h). Zum Schluss der Befehl
+// 'rxFilter' über den simulierten UART mit eingespielten Paketen.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <optional>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "command.h"
+#include "rxfilter.h"
+
+void setup();
+void loop();
+
+static std::vector<std::string> rxLines;
+
+static void onLine(const std::string& line, uint64_t) {
+  if (line.find("\"type\":\"lora_rx\"") != std::string::npos) {
+    rxLines.push_back(line);
+  }
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+static RxFilterRule rule(const char* type, std::optional<float> min, std::optional<float> max, uint8_t offset = 0,
+                         const char* value = "", const char* mask = "") {
+  RxFilterRule r;
+  TEST_ASSERT_EQUAL_STRING("", makeRxFilterRule(type, min, max, offset, value, mask, r).c_str());
+  return r;
+}
+
+static bool accept(std::initializer_list<uint8_t> bytes, int16_t rssi = -90, float snr = 5.0f) {
+  LoRaRxPacket packet;
+  memset(&packet, 0, sizeof(packet));
+  uint16_t len = 0;
+  for (uint8_t b : bytes) {
+    packet.payload[len++] = b;
+  }
+  packet.len = len;
+  packet.rssi = rssi;
+  packet.snr = snr;
+  return rxFilterAccept(&packet);
+}
+
+void setUp() {
+  rxLines.clear();
+}
+
+void tearDown() {
+  setRxFilterRules(nullptr, 0, false);
+  resetRxFilterStats();
+}
+
+void test_masked_match_is_an_allow_list() {
+  // Byte 1 muss 0x4X sein oder Byte 2 genau 0x99
+  RxFilterRule rules[] = {rule("match", {}, {}, 1, "40", "f0"), rule("match", {}, {}, 2, "99")};
+  TEST_ASSERT_TRUE(setRxFilterRules(rules, 2, true));
+
+  TEST_ASSERT_TRUE(accept({0x00, 0x4F, 0x00}));
+  TEST_ASSERT_TRUE(accept({0x00, 0x41, 0x99}));  // Beide treffen, nur die erste zählt
+  TEST_ASSERT_TRUE(accept({0x00, 0x00, 0x99}));
+  TEST_ASSERT_FALSE(accept({0x00, 0x5F, 0x98}));
+  TEST_ASSERT_FALSE(accept({0x00}));             // Zu kurz für beide Vergleiche
+
+  TEST_ASSERT_EQUAL(2, getRxFilterRule(0)->hits);
+  TEST_ASSERT_EQUAL(1, getRxFilterRule(1)->hits);
+  RxFilterStats stats = getRxFilterStats();
+  TEST_ASSERT_EQUAL(3, stats.passed);
+  TEST_ASSERT_EQUAL(2, stats.rejected);
+  TEST_ASSERT_EQUAL(2, stats.unmatched);
+}
+
+void test_deny_and_thresholds_stop_at_first_rejecting_rule() {
+  RxFilterRule rules[] = {
+    rule("rssi", -100.0f, {}),
+    rule("snr", -2.5f, {}),
+    rule("len", 2.0f, 4.0f),
+    rule("deny", {}, {}, 0, "a0b0", "f0f0"),
+  };
+  TEST_ASSERT_TRUE(setRxFilterRules(rules, 4, true));
+
+  TEST_ASSERT_TRUE(accept({0x01, 0x02}, -100, -2.5f));
+  TEST_ASSERT_FALSE(accept({0x01, 0x02}, -101, -10.0f)); // RSSI zuerst, SNR wird nicht mehr gezählt
+  TEST_ASSERT_FALSE(accept({0x01, 0x02}, -90, -2.75f));
+  TEST_ASSERT_FALSE(accept({0x01}));
+  TEST_ASSERT_FALSE(accept({0x01, 0x02, 0x03, 0x04, 0x05}));
+  TEST_ASSERT_FALSE(accept({0xA7, 0xB3, 0x00}));          // Maskiert gleich a0 b0
+  TEST_ASSERT_TRUE(accept({0xA7, 0xC3, 0x00}));
+
+  TEST_ASSERT_EQUAL(1, getRxFilterRule(0)->hits);
+  TEST_ASSERT_EQUAL(1, getRxFilterRule(1)->hits);
+  TEST_ASSERT_EQUAL(2, getRxFilterRule(2)->hits);
+  TEST_ASSERT_EQUAL(1, getRxFilterRule(3)->hits);
+  TEST_ASSERT_EQUAL(0, getRxFilterStats().unmatched);
+
+  // Abgeschaltet lässt die Kette alles durch, ohne zu zählen
+  setRxFilterEnabled(false);
+  TEST_ASSERT_TRUE(accept({0x01}));
+  TEST_ASSERT_EQUAL(2, getRxFilterRule(2)->hits);
+  resetRxFilterStats();
+  TEST_ASSERT_EQUAL(0, getRxFilterRule(3)->hits);
+  TEST_ASSERT_EQUAL(0, getRxFilterStats().rejected);
+}
+
+void test_invalid_rules_are_refused() {
+  RxFilterRule r;
+  TEST_ASSERT_TRUE(makeRxFilterRule("match", {}, {}, 0, "zz", "", r).length() > 0);
+  TEST_ASSERT_TRUE(makeRxFilterRule("deny", {}, {}, 0, "a0b0", "f0", r).length() > 0);
+  TEST_ASSERT_TRUE(makeRxFilterRule("len", 10.0f, 2.0f, 0, "", "", r).length() > 0);
+  TEST_ASSERT_TRUE(makeRxFilterRule("rssi", {}, {}, 0, "", "", r).length() > 0);
+
+  RxFilterRule rules[LORA_RX_FILTER_RULES + 1];
+  for (RxFilterRule& x : rules) {
+    x = rule("rssi", -120.0f, {});
+  }
+  TEST_ASSERT_FALSE(setRxFilterRules(rules, LORA_RX_FILTER_RULES + 1, true));
+  TEST_ASSERT_EQUAL(0, getRxFilterRuleCount());
+  TEST_ASSERT_TRUE(setRxFilterRules(rules, LORA_RX_FILTER_RULES, true));
+  TEST_ASSERT_FALSE(addRxFilterRule(rules[0]));
+}
+
+void test_command_filters_received_packets() {
+  simSerialInject(simNow(), "{\"command\":{\"rxFilter\":{\"enabled\":true,\"rules\":"
+                            "[{\"type\":\"deny\",\"offset\":1,\"value\":\"C0\",\"mask\":\"F0\"}]}}}");
+  runLoop(100000);
+  TEST_ASSERT_TRUE(isRxFilterEnabled());
+  TEST_ASSERT_EQUAL(1, getRxFilterRuleCount());
+
+  const uint8_t denied[] = {0x01, 0xC5, 0x02};
+  const uint8_t allowed[] = {0x01, 0xB5, 0x02};
+  simRadioInjectPacket(simNow() + 1000, denied, sizeof(denied), -90, 5.0f, 0.0f);
+  simRadioInjectPacket(simNow() + 50000, allowed, sizeof(allowed), -90, 5.0f, 0.0f);
+  runLoop(300000);
+
+  TEST_ASSERT_EQUAL(1, rxLines.size());
+  TEST_ASSERT_EQUAL(1, getRxFilterRule(0)->hits);
+}
+
+int main(int argc, char** argv) {
+  simSerialSetLineHandler(onLine);
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_masked_match_is_an_allow_list);
+  RUN_TEST(test_deny_and_thresholds_stop_at_first_rejecting_rule);
+  RUN_TEST(test_invalid_rules_are_refused);
+  RUN_TEST(test_command_filters_received_packets);
+  return UNITY_END();
+}
@@ -0,0 +1,169 @@
+// Geplantes Senden ('at_us'): Der Sendebeginn trifft den Zeitpunkt, und das Modul bleibt bis
+// kurz davor (LORA_TX_SCHEDULE_SPIN_US) im Empfang statt im gesperrten aktiven Warten.
+// Ein weit vorausgeplanter Auftrag hält spätere sofortige und früher fällige nicht auf.
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include <unity.h>
+#include <string>
+#include <vector>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "0_config.h"
+#include "lora.h"
+#include "power.h"
+#include "timebase.h"
+
+void setup();
+void loop();
+
+static uint32_t rxLines = 0;
+static uint32_t txStarts = 0;
+static std::vector<uint8_t> txFirstBytes;
+static std::vector<uint64_t> txStartTimes;
+
+static void onLine(const std::string& line, uint64_t) {
+  if (line.find("\"type\":\"lora_rx\"") != std::string::npos) {
+    rxLines++;
+  }
+}
+
+static void onTxStart(uint64_t at_us, const uint8_t* payload, size_t) {
+  txStarts++;
+  txFirstBytes.push_back(payload[0]);
+  txStartTimes.push_back(at_us);
+}
+
+static void runLoop(uint64_t duration_us) {
+  uint64_t end = simNow() + duration_us;
+  while (simNow() < end) {
+    loop();
+    simAdvance(5);
+  }
+}
+
+// Fehler des gemessenen Sendebeginns gegenüber 'at_us' seit 'before'
+static uint64_t scheduleError(const LoRaTxScheduleStats& before) {
+  return getLoRaTxScheduleStats().absError_us - before.absError_us;
+}
+
+static uint64_t queueScheduled(uint64_t ahead_us, uint8_t first = 0x10) {
+  const uint8_t payload[] = {first, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80};
+  uint64_t at_us = timebaseMicros() + ahead_us;
+  uint16_t id = 0;
+  String result = queueLoRaPacket(payload, sizeof(payload), id, true, at_us);
+  TEST_ASSERT_EQUAL_STRING("", result.c_str());
+  return at_us;
+}
+
+void setUp() {
+  runLoop(3000000); // Vorherige Sendungen abschließen
+  rxLines = 0;
+  txStarts = 0;
+  txFirstBytes.clear();
+  txStartTimes.clear();
+}
+
+void tearDown() {
+  setPowerProfile(POWER_CONTINUOUS);
+}
+
+void test_scheduled_tx_starts_on_time() {
+  // Der erste Auftrag misst den tatsächlichen Vorlauf (Startwert LORA_TX_SCHEDULE_LEAD_US)
+  LoRaTxScheduleStats before = getLoRaTxScheduleStats();
+  queueScheduled(100000);
+  runLoop(3000000); // Bis einschließlich TxDone
+  TEST_ASSERT_EQUAL(before.sent + 1, getLoRaTxScheduleStats().sent);
+  TEST_ASSERT_LESS_THAN(LORA_TX_SCHEDULE_LATE_US, scheduleError(before));
+
+  before = getLoRaTxScheduleStats();
+  queueScheduled(100000);
+  runLoop(3000000);
+
+  LoRaTxScheduleStats after = getLoRaTxScheduleStats();
+  TEST_ASSERT_EQUAL(before.sent + 1, after.sent);
+  TEST_ASSERT_EQUAL(before.late, after.late);
+  TEST_ASSERT_EQUAL(2, txStarts);
+  TEST_ASSERT_LESS_THAN(50, scheduleError(before));
+}
+
+void test_radio_keeps_receiving_until_final_spin() {
+  LoRaTxScheduleStats before = getLoRaTxScheduleStats();
+  uint64_t at_us = queueScheduled(100000);
+
+  // Empfangsende 1 ms vor dem Sendezeitpunkt: innerhalb von LORA_TX_SCHEDULE_GUARD_US,
+  // aber vor dem aktiven Warten
+  static const uint8_t rx[] = {0xAA, 0xBB, 0xCC, 0xDD};
+  simRadioInjectPacket(simNow() + (at_us - timebaseMicros()) - 1000, rx, sizeof(rx), -80, 6.0f, 0.0f);
+  runLoop(3000000); // Bis einschließlich TxDone
+
+  TEST_ASSERT_EQUAL(1, rxLines);
+  TEST_ASSERT_EQUAL(1, txStarts);
+TEST_ASSERT_LESS_THAN(50, scheduleError(before));
+}
+
+void test_scheduled_tx_on_time_with_wfi_idle() {
+  // Im letzten Abschnitt vor dem Zeitpunkt darf powerIdle() nicht bis zum nächsten SysTick
+  // schlafen; verschiedene Lagen des Zeitpunkts zwischen zwei SysTicks
+  setPowerProfile(POWER_IDLE);
+  for (uint32_t offset_us = 0; offset_us < 1000; offset_us += 125) {
+    LoRaTxScheduleStats before = getLoRaTxScheduleStats();
+    queueScheduled(100000 + offset_us);
+    runLoop(3000000);
+    TEST_ASSERT_EQUAL(before.sent + 1, getLoRaTxScheduleStats().sent);
+    TEST_ASSERT_LESS_THAN(50, scheduleError(before));
+  }
+}
+
+void test_far_scheduled_entry_does_not_block_queue() {
+  LoRaTxScheduleStats before = getLoRaTxScheduleStats();
+  uint64_t queued_us = simNow();
+  queueScheduled(5000000, 0xA1);
+  static const uint8_t now[] = {0xB1, 0x02, 0x03};
+  uint16_t id = 0;
+  TEST_ASSERT_EQUAL_STRING("", queueLoRaPacket(now, sizeof(now), id).c_str());
+  queueScheduled(1000000, 0xA2); // Später eingereiht, aber früher fällig
+
+  runLoop(500000);
+  TEST_ASSERT_EQUAL(1, txStarts);
+  TEST_ASSERT_EQUAL_HEX8(0xB1, txFirstBytes[0]);
+  TEST_ASSERT_LESS_THAN(100000, txStartTimes[0] - queued_us);
+
+  runLoop(6000000);
+  TEST_ASSERT_EQUAL(3, txStarts);
+  TEST_ASSERT_EQUAL_HEX8(0xA2, txFirstBytes[1]);
+  TEST_ASSERT_EQUAL_HEX8(0xA1, txFirstBytes[2]);
+  LoRaTxScheduleStats after = getLoRaTxScheduleStats();
+  TEST_ASSERT_EQUAL(before.sent + 2, after.sent);
+  TEST_ASSERT_EQUAL(before.late, after.late);
+  TEST_ASSERT_LESS_THAN(100, scheduleError(before));
+}
+
+void test_immediate_entry_waits_if_it_would_delay_schedule() {
+  LoRaTxScheduleStats before = getLoRaTxScheduleStats();
+  queueScheduled(20000, 0xA3); // Kürzer als die Sendedauer des sofortigen Auftrags
+  static const uint8_t now[] = {0xB2, 0x02, 0x03};
+  uint16_t id = 0;
+  TEST_ASSERT_EQUAL_STRING("", queueLoRaPacket(now, sizeof(now), id).c_str());
+
+  runLoop(3000000);
+  TEST_ASSERT_EQUAL(2, txStarts);
+  TEST_ASSERT_EQUAL_HEX8(0xA3, txFirstBytes[0]);
+  TEST_ASSERT_EQUAL_HEX8(0xB2, txFirstBytes[1]);
+  TEST_ASSERT_EQUAL(before.late, getLoRaTxScheduleStats().late);
+  TEST_ASSERT_LESS_THAN(50, scheduleError(before));
+}
+
+int main(int argc, char** argv) {
+  simSerialSetLineHandler(onLine);
+  simRadioSetTxStartHandler(onTxStart);
+  setup();
+  UNITY_BEGIN();
+  RUN_TEST(test_scheduled_tx_starts_on_time);
+  RUN_TEST(test_radio_keeps_receiving_until_final_spin);
+  RUN_TEST(test_scheduled_tx_on_time_with_wfi_idle);
+  RUN_TEST(test_far_scheduled_entry_does_not_block_queue);
+  RUN_TEST(test_immediate_entry_waits_if_it_would_delay_schedule);
+  return UNITY_END();
+}
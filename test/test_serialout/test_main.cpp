@@ -0,0 +1,140 @@
+// Gepufferte serielle Ausgabe: Datensätze kommen vollständig und in Reihenfolge am
+// simulierten UART an, zu große werden ganz verworfen und gezählt (siehe serialout.h).
+
+#include <Arduino.h>
+#include <unity.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "SimCore.h"
+#include "SimSerial.h"
+#include "0_config.h"
+#include "serialout.h"
+
+// Vom UART empfangene Zeilen, wie der Host sie sieht
+static std::vector<std::string> lines;
+
+static void onLine(const std::string& line, uint64_t) {
+  lines.push_back(line);
+}
+
+static void writeRecord(const std::string& text) {
+  serialOut.beginRecord();
+  serialOut.print(text.c_str());
+  serialOut.print('\n');
+  serialOut.endRecord();
+}
+
+void setUp() {
+  flushSerialOutput();
+  lines.clear();
+}
+
+void tearDown() {}
+
+void test_records_arrive_complete_and_in_order() {
+  SerialOutputStats before = getSerialOutputStats();
+  // Über mehrere Umläufe des Ringpuffers, damit Datensätze am Pufferende geteilt werden
+  std::vector<std::string> sent;
+  for (int i = 0; i < 200; i++) {
+    std::string text = "{\"n\":" + std::to_string(i) + ",\"pad\":\"" + std::string(i % 53, 'x') + "\"}";
+    sent.push_back(text);
+    writeRecord(text);
+    handleSerialOutput();
+    simAdvance(5000);
+  }
+  flushSerialOutput();
+
+  SerialOutputStats after = getSerialOutputStats();
+  TEST_ASSERT_EQUAL(200, after.records - before.records);
+  TEST_ASSERT_EQUAL(before.droppedRecords, after.droppedRecords);
+  TEST_ASSERT_EQUAL(0, serialOut.pending());
+  TEST_ASSERT_EQUAL(sent.size(), lines.size());
+  for (size_t i = 0; i < sent.size(); i++) {
+    TEST_ASSERT_EQUAL_STRING(sent[i].c_str(), lines[i].c_str());
+  }
+}
+
+void test_record_that_does_not_fit_is_dropped_whole() {
+  SerialOutputStats before = getSerialOutputStats();
+  uint64_t uartBefore = simSerialTxBytes();
+
+  // Puffer ohne Leeren fast füllen
+  std::string filler(SERIAL_OUT_BUFFER_SIZE / 4 - 1, 'a');
+  for (int i = 0; i < 3; i++) {
+    writeRecord(filler);
+  }
+  size_t pending = serialOut.pending();
+  TEST_ASSERT_EQUAL(3 * SERIAL_OUT_BUFFER_SIZE / 4, pending);
+
+  // Passt nur zur Hälfte: darf weder teilweise noch später erscheinen
+  writeRecord(std::string(SERIAL_OUT_BUFFER_SIZE / 2, 'b'));
+  TEST_ASSERT_EQUAL(pending, serialOut.pending());
+  TEST_ASSERT_EQUAL(before.droppedRecords + 1, getSerialOutputStats().droppedRecords);
+
+  // Ein kleiner Datensatz passt danach weiterhin
+  writeRecord("ok");
+  flushSerialOutput();
+
+  TEST_ASSERT_EQUAL(4, lines.size());
+  TEST_ASSERT_EQUAL_STRING(filler.c_str(), lines[2].c_str());
+  TEST_ASSERT_EQUAL_STRING("ok", lines[3].c_str());
+  TEST_ASSERT_EQUAL(pending + 3, simSerialTxBytes() - uartBefore);
+  TEST_ASSERT_GREATER_OR_EQUAL(pending + 3, getSerialOutputStats().highWater);
+}
+
+void test_write_outside_record_is_its_own_record() {
+  SerialOutputStats before = getSerialOutputStats();
+  serialOut.write('x');
+  serialOut.write('\n');
+  TEST_ASSERT_EQUAL(before.records + 2, getSerialOutputStats().records);
+  flushSerialOutput();
+  TEST_ASSERT_EQUAL(1, lines.size());
+  TEST_ASSERT_EQUAL_STRING("x", lines[0].c_str());
+}
+
+void test_drain_never_blocks_on_full_uart() {
+  writeRecord(std::string(SERIAL_OUT_BUFFER_SIZE / 2, 'c'));
+  uint64_t start = simNow();
+  SerialOutputStats before = getSerialOutputStats();
+  handleSerialOutput();
+
+  // Nur so viel, wie der UART-Sendepuffer fasst, und praktisch ohne Wartezeit
+  TEST_ASSERT_EQUAL(SERIAL_TX_BUFFER_SIZE, getSerialOutputStats().bytesWritten - before.bytesWritten);
+  TEST_ASSERT_LESS_THAN(10, simNow() - start);
+  TEST_ASSERT_EQUAL(SERIAL_OUT_BUFFER_SIZE / 2 + 1 - SERIAL_TX_BUFFER_SIZE, serialOut.pending());
+
+  // Nach der Übertragungszeit von 10 Bytes passen 10 weitere
+  simAdvance(10 * 10 * 1000000ULL / getSerialBaudRate() + 1);
+  handleSerialOutput();
+  TEST_ASSERT_EQUAL(SERIAL_TX_BUFFER_SIZE + 10, getSerialOutputStats().bytesWritten - before.bytesWritten);
+  flushSerialOutput();
+}
+
+void test_baud_rate_switch() {
+  TEST_ASSERT_TRUE(isSupportedBaudRate(921600));
+  TEST_ASSERT_TRUE(isSupportedBaudRate(460800));
+  TEST_ASSERT_FALSE(isSupportedBaudRate(123456));
+
+  // Gepufferte Ausgabe geht vor dem Umschalten noch mit der alten Baudrate raus
+  writeRecord("vorher");
+  setSerialBaudRate(921600);
+  TEST_ASSERT_EQUAL(0, serialOut.pending());
+  TEST_ASSERT_EQUAL(1, lines.size());
+  TEST_ASSERT_EQUAL(921600, getSerialBaudRate());
+  setSerialBaudRate(SERIAL_BAUD_DEFAULT);
+}
+
+int main(int argc, char** argv) {
+  setupSerialOutput();
+  simSerialSetLineHandler(onLine);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_records_arrive_complete_and_in_order);
+  RUN_TEST(test_record_that_does_not_fit_is_dropped_whole);
+  RUN_TEST(test_write_outside_record_is_its_own_record);
+  RUN_TEST(test_drain_never_blocks_on_full_uart);
+  RUN_TEST(test_baud_rate_switch);
+  return UNITY_END();
+}
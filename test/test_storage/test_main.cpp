@@ -0,0 +1,117 @@
+// Konfiguration im Flash: Verschleißausgleich über beide Seiten, kein Schreiben bei
+// unverändertem Stand und Rückfall auf den letzten gültigen Datensatz nach einem beim
+// Schreiben unterbrochenen Datensatz (siehe storage.h, Flash-Modell in SimFlash.cpp).
+
+#include <Arduino.h>
+#include <unity.h>
+#include <string.h>
+
+#include "SimCore.h"
+#include "0_config.h"
+#include "lora.h"
+#include "storage.h"
+
+void setup();
+void loop();
+
+static const uint32_t STORE_START = FLASH_BANK1_END + 1 - CONFIG_STORE_PAGES * FLASH_PAGE_SIZE;
+
+static uint32_t totalErases() {
+  uint32_t erases = 0;
+  for (uint8_t page = 0; page < CONFIG_STORE_PAGES; page++) {
+    erases += simFlashEraseCount(STORE_START + page * FLASH_PAGE_SIZE);
+  }
+  return erases;
+}
+
+// Übernimmt eine andere Sendeleistung als aktuellen Stand
+static void applyOutputPower(int8_t power) {
+  LoRaSettings s = getCurrentLoRaSettings();
+  setLoRaParameters(s.base_frequency_MHz, s.frequency_offset_kHz, s.bandwidth_kHz, s.spreadingFactor,
+                    s.codingRate, s.syncWord, power, s.preambleLength);
+  TEST_ASSERT_EQUAL(power, getCurrentLoRaSettings().outputPower_dBm);
+}
+
+static int8_t storedOutputPower() {
+  LoRaSettings stored;
+  TEST_ASSERT_TRUE(loadStoredConfig(stored));
+  return stored.outputPower_dBm;
+}
+
+void setUp() {
+  simFlashCutPowerAfter(0);
+}
+
+void tearDown() {}
+
+void test_unchanged_state_is_not_written() {
+  applyOutputPower(10);
+  TEST_ASSERT_TRUE(saveStoredConfig());
+
+  uint8_t before[CONFIG_STORE_PAGES * FLASH_PAGE_SIZE];
+  memcpy(before, simFlashPointer(STORE_START), sizeof(before));
+  uint64_t start = simNow();
+  TEST_ASSERT_TRUE(saveStoredConfig());
+  TEST_ASSERT_EQUAL_MEMORY(before, simFlashPointer(STORE_START), sizeof(before));
+  TEST_ASSERT_EQUAL(start, simNow()); // Kein Programmierzugriff, keine Wartezeit
+}
+
+// Speichert so lange wechselnde Stände, bis 'erases' weitere Löschvorgänge nötig waren
+static uint32_t savesUntilErases(uint32_t erases) {
+  static uint32_t counter = 0;
+  uint32_t target = totalErases() + erases;
+  uint32_t saves = 0;
+  while (totalErases() < target) {
+    int8_t power = (int8_t)(2 + counter++ % 20);
+    applyOutputPower(power);
+    TEST_ASSERT_TRUE(saveStoredConfig());
+    TEST_ASSERT_EQUAL(power, storedOutputPower());
+    saves++;
+    TEST_ASSERT_LESS_THAN(100000, saves);
+  }
+  return saves;
+}
+
+void test_saves_are_spread_over_both_pages() {
+  // Auf einen Seitenwechsel synchronisieren, dann Datensätze je Seite zählen
+  savesUntilErases(1);
+  uint32_t recordsPerPage = savesUntilErases(1);
+  TEST_ASSERT_GREATER_THAN(1, recordsPerPage);
+
+  // Genau ein Löschvorgang je voller Seite ...
+  const uint32_t ROUNDS = 10 * CONFIG_STORE_PAGES;
+  TEST_ASSERT_EQUAL(ROUNDS * recordsPerPage, savesUntilErases(ROUNDS));
+
+  // ... und beide Seiten werden gleich oft gelöscht
+  uint32_t first = simFlashEraseCount(STORE_START);
+  uint32_t second = simFlashEraseCount(STORE_START + FLASH_PAGE_SIZE);
+  TEST_ASSERT_LESS_OR_EQUAL(1, first > second ? first - second : second - first);
+}
+
+void test_torn_record_falls_back_to_previous() {
+  applyOutputPower(14);
+  TEST_ASSERT_TRUE(saveStoredConfig());
+
+  // Stromausfall nach Kopf und wenigen Nutzdaten des nächsten Datensatzes
+  applyOutputPower(17);
+  simFlashCutPowerAfter(6);
+  TEST_ASSERT_FALSE(saveStoredConfig());
+  simFlashCutPowerAfter(0);
+
+  // Neustart: der unvollständige Datensatz fällt durch die CRC-Prüfung
+  TEST_ASSERT_EQUAL(14, storedOutputPower());
+
+  // Der nächste Speichervorgang setzt hinter dem defekten Datensatz fort
+  TEST_ASSERT_TRUE(saveStoredConfig());
+  TEST_ASSERT_EQUAL(17, storedOutputPower());
+}
+
+int main(int argc, char** argv) {
+  setup();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_unchanged_state_is_not_written);
+  RUN_TEST(test_saves_are_spread_over_both_pages);
+  RUN_TEST(test_torn_record_falls_back_to_previous);
+  return UNITY_END();
+}